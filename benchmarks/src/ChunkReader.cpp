@@ -0,0 +1,79 @@
+#include "exerciceCPP/io/ChunkReader.hpp"
+#include "exerciceCPP/containers/Vector.hpp"
+#include <benchmark/benchmark.h>
+#include <charconv>
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <string_view>
+
+// Loading a 64 MiB file of one integer per line into a Vector<uint64_t>:
+// the whole file staged in memory then parsed, against a ChunkReader
+// parsing a chunk while the next one loads. The counter is the memory held
+// for the file.
+
+static const std::filesystem::path& numbers_file(){
+    static const std::filesystem::path path = []{
+        const std::filesystem::path file = std::filesystem::temp_directory_path() / "ChunkReader_Benchmarks.txt";
+        std::ofstream out(file, std::ios::trunc);
+        std::uint64_t value = 88172645463325252ULL;
+        for(std::size_t size=0; size < (std::size_t{64} << 20); ){
+            value ^= value << 13;
+            value ^= value >> 7;
+            value ^= value << 17;
+            const std::string line = std::to_string(value % 1000000000) + '\n';
+            out << line;
+            size += line.size();
+        }
+        return file;
+    }();
+    return path;
+}
+
+static std::uint64_t parse(std::string_view line){
+    std::uint64_t value = 0;
+    std::from_chars(line.data(), line.data() + line.size(), value);
+    return value;
+}
+
+static void BM_StagedFile(benchmark::State& state){
+    const std::filesystem::path& path = numbers_file();
+    const auto size = static_cast<std::size_t>(std::filesystem::file_size(path));
+    for(auto _ : state){
+        yadej::Vector<char> text;
+        text.resize_for_overwrite(size);
+        std::ifstream file(path, std::ios::binary);
+        file.read(text.data(), static_cast<std::streamsize>(size));
+
+        yadej::Vector<std::uint64_t> values;
+        std::string_view left(text.data(), text.size());
+        while( !left.empty()){
+            const std::size_t cut = std::min(left.find('\n'), left.size());
+            values.push_back(parse(left.substr(0, cut)));
+            left.remove_prefix(std::min(cut + 1, left.size()));
+        }
+        benchmark::DoNotOptimize(values.data());
+    }
+    state.counters["held_MiB"] = static_cast<double>(size) / (1 << 20);
+    state.SetBytesProcessed(state.iterations() * static_cast<std::int64_t>(size));
+}
+
+static void BM_ChunkReaderLines(benchmark::State& state){
+    const std::filesystem::path& path = numbers_file();
+    const yadej::io::ChunkOptions options{.chunk_size = std::size_t{1} << 20, .chunks = static_cast<std::size_t>(state.range(0))};
+    for(auto _ : state){
+        yadej::io::ChunkReader reader(path, options);
+        yadej::Vector<std::uint64_t> values;
+        yadej::io::read_lines(reader, values, parse);
+        benchmark::DoNotOptimize(values.data());
+    }
+    state.counters["held_MiB"] = static_cast<double>(options.chunk_size * options.chunks) / (1 << 20);
+    state.SetBytesProcessed(state.iterations() * static_cast<std::int64_t>(std::filesystem::file_size(path)));
+}
+
+BENCHMARK(BM_StagedFile)->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_ChunkReaderLines)->Arg(2)->Arg(4)->Unit(benchmark::kMillisecond);
+
+BENCHMARK_MAIN();
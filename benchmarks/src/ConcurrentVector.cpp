@@ -0,0 +1,55 @@
+#include "exerciceCPP/containers/ConcurrentVector.hpp"
+#include "exerciceCPP/containers/Vector.hpp"
+#include <benchmark/benchmark.h>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+
+// Every thread appends range(0) elements to one shared container,
+// ConcurrentVector against the Vector guarded by a mutex it replaces
+
+// Vector::push_back serialized by a mutex
+template<class T>
+class LockedVector {
+public:
+    void push_back(const T& value){
+        std::lock_guard lock(m_mutex);
+        m_vector.push_back(value);
+    }
+    std::size_t size(){
+        std::lock_guard lock(m_mutex);
+        return m_vector.size();
+    }
+
+private:
+    std::mutex m_mutex;
+    yadej::Vector<T> m_vector;
+};
+
+template<class Container>
+static void BM_SharedPushBack(benchmark::State& state){
+    static std::unique_ptr<Container> container;
+    const auto count = static_cast<std::size_t>(state.range(0));
+    // The threads start the loop together, after thread 0 built the container
+    if( state.thread_index() == 0)
+        container = std::make_unique<Container>();
+    for(auto _ : state){
+        for(std::size_t i=0; i < count; ++i)
+            container->push_back(static_cast<std::uint64_t>(i));
+    }
+    if( state.thread_index() == 0){
+        benchmark::DoNotOptimize(container->size());
+        container.reset();
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+#define CONCURRENT_BENCHMARK(container)                      \
+    BENCHMARK_TEMPLATE(BM_SharedPushBack, container)         \
+        ->Arg(1 << 14)->ThreadRange(1, 64)->UseRealTime()
+
+CONCURRENT_BENCHMARK(yadej::ConcurrentVector<std::uint64_t>);
+CONCURRENT_BENCHMARK(LockedVector<std::uint64_t>);
+
+BENCHMARK_MAIN();
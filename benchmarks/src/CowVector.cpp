@@ -0,0 +1,56 @@
+#include "exerciceCPP/containers/CowVector.hpp"
+#include "exerciceCPP/containers/Vector.hpp"
+#include <benchmark/benchmark.h>
+#include <cstddef>
+#include <cstdint>
+#include <thread>
+
+// Handing a copy of a big vector to a reader: deep copy of a Vector against
+// a shared CowVector snapshot, and snapshots of an AtomicCowVector taken by
+// several threads while one of them publishes new versions
+
+static yadej::Vector<std::uint64_t> make_values(std::size_t count){
+    yadej::Vector<std::uint64_t> values;
+    values.resize_for_overwrite(count);
+    for(std::size_t i=0; i < count; ++i)
+        values[i] = i;
+    return values;
+}
+
+static void BM_VectorCopy(benchmark::State& state){
+    const yadej::Vector<std::uint64_t> values = make_values(static_cast<std::size_t>(state.range(0)));
+    for(auto _ : state){
+        yadej::Vector<std::uint64_t> copy(values);
+        benchmark::DoNotOptimize(copy.data());
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+
+static void BM_CowVectorCopy(benchmark::State& state){
+    const yadej::CowVector<std::uint64_t> values(make_values(static_cast<std::size_t>(state.range(0))));
+    for(auto _ : state){
+        yadej::CowVector<std::uint64_t> copy(values);
+        benchmark::DoNotOptimize(copy.data());
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+
+static yadej::AtomicCowVector<std::uint64_t> g_current(yadej::CowVector<std::uint64_t>(make_values(1 << 16)));
+
+// Thread 0 publishes a version every 64 loads, the others only read
+static void BM_AtomicCowVectorLoad(benchmark::State& state){
+    std::uint64_t loads = 0;
+    for(auto _ : state){
+        const yadej::CowVector<std::uint64_t> snapshot = g_current.load();
+        benchmark::DoNotOptimize(snapshot.data());
+        if( state.thread_index() == 0 && ++loads % 64 == 0)
+            g_current.store(snapshot);
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+
+BENCHMARK(BM_VectorCopy)->Arg(1 << 10)->Arg(1 << 20);
+BENCHMARK(BM_CowVectorCopy)->Arg(1 << 10)->Arg(1 << 20);
+BENCHMARK(BM_AtomicCowVectorLoad)->ThreadRange(1, 8);
+
+BENCHMARK_MAIN();
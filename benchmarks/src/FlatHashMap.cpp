@@ -0,0 +1,63 @@
+#include "exerciceCPP/containers/FlatHashMap.hpp"
+#include <benchmark/benchmark.h>
+#include <cstddef>
+#include <cstdint>
+#include <random>
+#include <unordered_map>
+#include <vector>
+
+// A dedup stage: ids with many repeats go through a hash map, the first
+// time an id is seen it is kept. std::unordered_map against FlatHashMap,
+// for the whole stage and for the lookups alone.
+
+static std::vector<std::uint64_t> make_ids(std::size_t count){
+    std::mt19937_64 random(42);
+    std::vector<std::uint64_t> ids;
+    for(std::size_t i=0; i < count; ++i)
+        ids.push_back(random() % (count / 4));
+    return ids;
+}
+
+template<class Map>
+static void BM_Dedup(benchmark::State& state){
+    const auto ids = make_ids(static_cast<std::size_t>(state.range(0)));
+    for(auto _ : state){
+        Map seen;
+        std::size_t kept = 0;
+        for(std::uint64_t id : ids)
+            kept += seen.try_emplace(id, kept).second ? 1 : 0;
+        benchmark::DoNotOptimize(kept);
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+template<class Map>
+static void BM_Find(benchmark::State& state){
+    const auto ids = make_ids(static_cast<std::size_t>(state.range(0)));
+    Map map;
+    for(std::uint64_t id : ids)
+        map.try_emplace(id, id);
+    std::mt19937_64 random(7);
+    std::vector<std::uint64_t> queries;
+    for(std::size_t i=0; i < 4096; ++i)
+        queries.push_back(random() % (ids.size() / 2));
+    for(auto _ : state){
+        std::uint64_t sum = 0;
+        for(std::uint64_t query : queries){
+            auto it = map.find(query);
+            sum += it != map.end() ? it->second : 0;
+        }
+        benchmark::DoNotOptimize(sum);
+    }
+    state.SetItemsProcessed(state.iterations() * static_cast<std::int64_t>(queries.size()));
+}
+
+using StdMap = std::unordered_map<std::uint64_t, std::uint64_t>;
+using FlatMap = yadej::FlatHashMap<std::uint64_t, std::uint64_t>;
+
+BENCHMARK(BM_Dedup<StdMap>)->Arg(1 << 16)->Arg(1 << 22);
+BENCHMARK(BM_Dedup<FlatMap>)->Arg(1 << 16)->Arg(1 << 22);
+BENCHMARK(BM_Find<StdMap>)->Arg(1 << 16)->Arg(1 << 22);
+BENCHMARK(BM_Find<FlatMap>)->Arg(1 << 16)->Arg(1 << 22);
+
+BENCHMARK_MAIN();
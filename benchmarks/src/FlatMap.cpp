@@ -0,0 +1,86 @@
+#include "exerciceCPP/containers/FlatMap.hpp"
+#include <benchmark/benchmark.h>
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <random>
+#include <utility>
+#include <vector>
+
+// Lookups in a read mostly table of a few thousand keys: std::map against
+// FlatMap, and building the table one key at a time or in one batch
+
+static std::vector<std::pair<std::uint64_t, std::uint64_t>> make_entries(std::size_t count){
+    std::mt19937_64 random(42);
+    std::vector<std::pair<std::uint64_t, std::uint64_t>> entries;
+    for(std::size_t i=0; i < count; ++i)
+        entries.emplace_back(random() % (count * 4), i);
+    return entries;
+}
+
+static std::vector<std::uint64_t> make_queries(std::size_t count){
+    std::mt19937_64 random(7);
+    std::vector<std::uint64_t> queries;
+    for(std::size_t i=0; i < 4096; ++i)
+        queries.push_back(random() % (count * 4));
+    return queries;
+}
+
+static void BM_StdMapFind(benchmark::State& state){
+    const auto count = static_cast<std::size_t>(state.range(0));
+    const auto entries = make_entries(count);
+    const std::map<std::uint64_t, std::uint64_t> map(entries.begin(), entries.end());
+    const auto queries = make_queries(count);
+    for(auto _ : state){
+        std::uint64_t sum = 0;
+        for(std::uint64_t query : queries){
+            auto it = map.find(query);
+            sum += it != map.end() ? it->second : 0;
+        }
+        benchmark::DoNotOptimize(sum);
+    }
+    state.SetItemsProcessed(state.iterations() * static_cast<std::int64_t>(queries.size()));
+}
+
+static void BM_FlatMapFind(benchmark::State& state){
+    const auto count = static_cast<std::size_t>(state.range(0));
+    const yadej::FlatMap<std::uint64_t, std::uint64_t> map(yadej::from_range, make_entries(count));
+    const auto queries = make_queries(count);
+    for(auto _ : state){
+        std::uint64_t sum = 0;
+        for(std::uint64_t query : queries){
+            auto it = map.find(query);
+            sum += it != map.end() ? (*it).second : 0;
+        }
+        benchmark::DoNotOptimize(sum);
+    }
+    state.SetItemsProcessed(state.iterations() * static_cast<std::int64_t>(queries.size()));
+}
+
+static void BM_FlatMapInsertOne(benchmark::State& state){
+    const auto entries = make_entries(static_cast<std::size_t>(state.range(0)));
+    for(auto _ : state){
+        yadej::FlatMap<std::uint64_t, std::uint64_t> map;
+        for(const auto& entry : entries)
+            map.insert(entry);
+        benchmark::DoNotOptimize(map.keys().data());
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+static void BM_FlatMapInsertBatch(benchmark::State& state){
+    const auto entries = make_entries(static_cast<std::size_t>(state.range(0)));
+    for(auto _ : state){
+        yadej::FlatMap<std::uint64_t, std::uint64_t> map;
+        map.insert_batch(entries);
+        benchmark::DoNotOptimize(map.keys().data());
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+BENCHMARK(BM_StdMapFind)->Arg(1 << 10)->Arg(1 << 13)->Arg(1 << 16);
+BENCHMARK(BM_FlatMapFind)->Arg(1 << 10)->Arg(1 << 13)->Arg(1 << 16);
+BENCHMARK(BM_FlatMapInsertOne)->Arg(1 << 13);
+BENCHMARK(BM_FlatMapInsertBatch)->Arg(1 << 13);
+
+BENCHMARK_MAIN();
@@ -0,0 +1,48 @@
+#include "exerciceCPP/memory/HugePageAllocator.hpp"
+#include "exerciceCPP/containers/Vector.hpp"
+#include <benchmark/benchmark.h>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+// Random gather over a Vector much bigger than the TLB reach, with the
+// buffer on 4 KiB pages (std::allocator) and on huge pages
+
+struct Edge {
+    std::uint64_t from;
+    std::uint64_t to;
+};
+
+template<class Allocator>
+static void BM_RandomGather(benchmark::State& state){
+    const std::size_t count = static_cast<std::size_t>(state.range(0)) / sizeof(Edge);
+    yadej::Vector<Edge, Allocator> edges;
+    edges.resize_for_overwrite(count);
+    for(std::size_t i=0; i < count; ++i)
+        edges[i] = Edge{i, i + 1};
+
+    std::uint64_t state_rng = 88172645463325252ULL;
+    for(auto _ : state){
+        std::uint64_t sum = 0;
+        // Indices from xorshift, nothing but the gather touches memory
+        for(int i=0; i < 4096; ++i){
+            state_rng ^= state_rng << 13;
+            state_rng ^= state_rng >> 7;
+            state_rng ^= state_rng << 17;
+            sum += edges[state_rng % count].to;
+        }
+        benchmark::DoNotOptimize(sum);
+    }
+    state.SetItemsProcessed(state.iterations() * 4096);
+}
+
+static void gather_sizes(benchmark::internal::Benchmark* benchmark){
+    // Bytes of the vector
+    for(std::int64_t size : {std::int64_t{64} << 20, std::int64_t{1} << 30})
+        benchmark->Arg(size);
+}
+
+BENCHMARK_TEMPLATE(BM_RandomGather, std::allocator<Edge>)->Apply(gather_sizes);
+BENCHMARK_TEMPLATE(BM_RandomGather, yadej::HugePageAllocator<Edge>)->Apply(gather_sizes);
+
+BENCHMARK_MAIN();
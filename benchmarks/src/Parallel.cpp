@@ -0,0 +1,114 @@
+#include "exerciceCPP/parallel/Algorithms.hpp"
+#include "exerciceCPP/containers/Vector.hpp"
+#include <benchmark/benchmark.h>
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <numeric>
+
+// std serial algorithms against yadej::parallel on the default pool,
+// over range(0) 64 bits values
+
+static yadej::Vector<std::uint64_t> make_values(std::size_t count){
+    yadej::Vector<std::uint64_t> values;
+    values.resize_for_overwrite(count);
+    std::uint64_t state = 12345;
+    for(std::uint64_t& value : values){
+        state = state * 6364136223846793005ULL + 1442695040888963407ULL;
+        value = state >> 20;
+    }
+    return values;
+}
+
+static void set_processed(benchmark::State& state){
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+static void BM_SerialReduce(benchmark::State& state){
+    const auto values = make_values(static_cast<std::size_t>(state.range(0)));
+    for(auto _ : state)
+        benchmark::DoNotOptimize(std::reduce(values.begin(), values.end(), std::uint64_t{0}));
+    set_processed(state);
+}
+
+static void BM_ParallelReduce(benchmark::State& state){
+    const auto values = make_values(static_cast<std::size_t>(state.range(0)));
+    for(auto _ : state)
+        benchmark::DoNotOptimize(yadej::parallel::reduce(values, std::uint64_t{0}));
+    set_processed(state);
+}
+
+static void BM_SerialTransform(benchmark::State& state){
+    const auto values = make_values(static_cast<std::size_t>(state.range(0)));
+    yadej::Vector<double> out(values.size());
+    for(auto _ : state){
+        std::transform(values.begin(), values.end(), out.begin(), [](std::uint64_t value){ return static_cast<double>(value) * 0.5; });
+        benchmark::DoNotOptimize(out.data());
+    }
+    set_processed(state);
+}
+
+static void BM_ParallelTransform(benchmark::State& state){
+    const auto values = make_values(static_cast<std::size_t>(state.range(0)));
+    yadej::Vector<double> out(values.size());
+    for(auto _ : state){
+        yadej::parallel::transform(values, out, [](std::uint64_t value){ return static_cast<double>(value) * 0.5; });
+        benchmark::DoNotOptimize(out.data());
+    }
+    set_processed(state);
+}
+
+static void BM_SerialSort(benchmark::State& state){
+    const auto source = make_values(static_cast<std::size_t>(state.range(0)));
+    for(auto _ : state){
+        state.PauseTiming();
+        auto values = source;
+        state.ResumeTiming();
+        std::sort(values.begin(), values.end());
+        benchmark::DoNotOptimize(values.data());
+    }
+    set_processed(state);
+}
+
+static void BM_ParallelSort(benchmark::State& state){
+    const auto source = make_values(static_cast<std::size_t>(state.range(0)));
+    for(auto _ : state){
+        state.PauseTiming();
+        auto values = source;
+        state.ResumeTiming();
+        yadej::parallel::sort(values);
+        benchmark::DoNotOptimize(values.data());
+    }
+    set_processed(state);
+}
+
+static void BM_SerialScan(benchmark::State& state){
+    const auto values = make_values(static_cast<std::size_t>(state.range(0)));
+    yadej::Vector<std::uint64_t> out(values.size());
+    for(auto _ : state){
+        std::inclusive_scan(values.begin(), values.end(), out.begin());
+        benchmark::DoNotOptimize(out.data());
+    }
+    set_processed(state);
+}
+
+static void BM_ParallelScan(benchmark::State& state){
+    const auto values = make_values(static_cast<std::size_t>(state.range(0)));
+    yadej::Vector<std::uint64_t> out(values.size());
+    for(auto _ : state){
+        yadej::parallel::inclusive_scan(values, out);
+        benchmark::DoNotOptimize(out.data());
+    }
+    set_processed(state);
+}
+
+#define PARALLEL_BENCHMARK(name)                                                      \
+    BENCHMARK(BM_Serial##name)->Arg(1 << 16)->Arg(1 << 24)->Unit(benchmark::kMillisecond)->UseRealTime(); \
+    BENCHMARK(BM_Parallel##name)->Arg(1 << 16)->Arg(1 << 24)->Unit(benchmark::kMillisecond)->UseRealTime()
+
+PARALLEL_BENCHMARK(Reduce);
+PARALLEL_BENCHMARK(Transform);
+PARALLEL_BENCHMARK(Sort);
+PARALLEL_BENCHMARK(Scan);
+
+BENCHMARK_MAIN();
@@ -0,0 +1,82 @@
+#include "exerciceCPP/containers/PersistentVector.hpp"
+#include "exerciceCPP/containers/Vector.hpp"
+#include <benchmark/benchmark.h>
+#include <cstddef>
+#include <cstdint>
+
+// Keeping every version of a big vector: copy of a Vector for each change
+// against a PersistentVector sharing its nodes, then building one with
+// persistent push_back and with a transient
+
+static yadej::PersistentVector<std::uint64_t> make_persistent(std::size_t count){
+    auto batch = yadej::PersistentVector<std::uint64_t>().transient();
+    for(std::size_t i=0; i < count; ++i)
+        batch.push_back(i);
+    return std::move(batch).persistent();
+}
+
+static void BM_VectorCopySet(benchmark::State& state){
+    const auto count = static_cast<std::size_t>(state.range(0));
+    yadej::Vector<std::uint64_t> values;
+    for(std::size_t i=0; i < count; ++i)
+        values.push_back(i);
+    std::size_t position = 0;
+    for(auto _ : state){
+        yadej::Vector<std::uint64_t> version(values);
+        version[position] = 0;
+        benchmark::DoNotOptimize(version.data());
+        position = (position + 7919) % count;
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+
+static void BM_PersistentVectorSet(benchmark::State& state){
+    const auto count = static_cast<std::size_t>(state.range(0));
+    const yadej::PersistentVector<std::uint64_t> values = make_persistent(count);
+    std::size_t position = 0;
+    for(auto _ : state){
+        const yadej::PersistentVector<std::uint64_t> version = values.set(position, 0);
+        benchmark::DoNotOptimize(&version[position]);
+        position = (position + 7919) % count;
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+
+static void BM_PersistentVectorPushBack(benchmark::State& state){
+    const auto count = static_cast<std::size_t>(state.range(0));
+    for(auto _ : state){
+        yadej::PersistentVector<std::uint64_t> values;
+        for(std::size_t i=0; i < count; ++i)
+            values = values.push_back(i);
+        benchmark::DoNotOptimize(&values.back());
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+static void BM_TransientPushBack(benchmark::State& state){
+    const auto count = static_cast<std::size_t>(state.range(0));
+    for(auto _ : state){
+        const yadej::PersistentVector<std::uint64_t> values = make_persistent(count);
+        benchmark::DoNotOptimize(&values.back());
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+static void BM_PersistentVectorIterate(benchmark::State& state){
+    const yadej::PersistentVector<std::uint64_t> values = make_persistent(static_cast<std::size_t>(state.range(0)));
+    for(auto _ : state){
+        std::uint64_t sum = 0;
+        for(std::uint64_t value : values)
+            sum += value;
+        benchmark::DoNotOptimize(sum);
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+BENCHMARK(BM_VectorCopySet)->Arg(1 << 10)->Arg(1 << 20);
+BENCHMARK(BM_PersistentVectorSet)->Arg(1 << 10)->Arg(1 << 20);
+BENCHMARK(BM_PersistentVectorPushBack)->Arg(1 << 16);
+BENCHMARK(BM_TransientPushBack)->Arg(1 << 16);
+BENCHMARK(BM_PersistentVectorIterate)->Arg(1 << 16);
+
+BENCHMARK_MAIN();
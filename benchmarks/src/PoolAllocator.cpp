@@ -0,0 +1,55 @@
+#include "exerciceCPP/memory/PoolAllocator.hpp"
+#include "exerciceCPP/containers/Vector.hpp"
+#include <benchmark/benchmark.h>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+// Many short lived small vectors: each iteration builds range(0) vectors
+// of 1 to 64 elements by push_back and destroys them, with std::allocator
+// and with the pool. The threaded runs churn on every thread at once.
+
+template<class Allocator>
+static void BM_Churn(benchmark::State& state){
+    using Vector = yadej::Vector<std::uint32_t, Allocator>;
+    const std::size_t count = static_cast<std::size_t>(state.range(0));
+    for(auto _ : state){
+        std::uint64_t sum = 0;
+        for(std::size_t i=0; i < count; ++i){
+            Vector values;
+            const std::uint32_t size = static_cast<std::uint32_t>(i % 64) + 1;
+            for(std::uint32_t j=0; j < size; ++j)
+                values.push_back(j);
+            sum += values.back();
+        }
+        benchmark::DoNotOptimize(sum);
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+// Vectors kept alive together, then freed in the order they were made
+template<class Allocator>
+static void BM_BatchChurn(benchmark::State& state){
+    using Vector = yadej::Vector<std::uint32_t, Allocator>;
+    const std::size_t count = static_cast<std::size_t>(state.range(0));
+    yadej::Vector<Vector> batch;
+    batch.reserve(count);
+    for(auto _ : state){
+        for(std::size_t i=0; i < count; ++i){
+            batch.emplace_back();
+            const std::uint32_t size = static_cast<std::uint32_t>(i % 16) + 1;
+            for(std::uint32_t j=0; j < size; ++j)
+                batch.back().push_back(j);
+        }
+        benchmark::DoNotOptimize(batch.data());
+        batch.erase(batch.begin(), batch.end());
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+BENCHMARK_TEMPLATE(BM_Churn, std::allocator<std::uint32_t>)->Arg(1024)->ThreadRange(1, 4);
+BENCHMARK_TEMPLATE(BM_Churn, yadej::PoolAllocator<std::uint32_t>)->Arg(1024)->ThreadRange(1, 4);
+BENCHMARK_TEMPLATE(BM_BatchChurn, std::allocator<std::uint32_t>)->Arg(4096);
+BENCHMARK_TEMPLATE(BM_BatchChurn, yadej::PoolAllocator<std::uint32_t>)->Arg(4096);
+
+BENCHMARK_MAIN();
@@ -0,0 +1,71 @@
+#include "exerciceCPP/containers/SearchIndex.hpp"
+#include "exerciceCPP/containers/Vector.hpp"
+#include <benchmark/benchmark.h>
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <random>
+#include <vector>
+
+// Point lookups in a sorted array of uint32: std::lower_bound on the
+// Vector against a SearchIndex, one query at a time and by batches
+
+static yadej::Vector<std::uint32_t> make_sorted(std::size_t count){
+    yadej::Vector<std::uint32_t> sorted;
+    sorted.resize_for_overwrite(count);
+    for(std::size_t i=0; i < count; ++i)
+        sorted[i] = static_cast<std::uint32_t>(3 * i);
+    return sorted;
+}
+
+static std::vector<std::uint32_t> make_queries(std::size_t count){
+    std::mt19937 random(7);
+    std::vector<std::uint32_t> queries(1 << 14);
+    for(std::uint32_t& query : queries)
+        query = static_cast<std::uint32_t>(random() % (3 * count));
+    return queries;
+}
+
+static void BM_StdLowerBound(benchmark::State& state){
+    const auto count = static_cast<std::size_t>(state.range(0));
+    const yadej::Vector<std::uint32_t> sorted = make_sorted(count);
+    const auto queries = make_queries(count);
+    for(auto _ : state){
+        std::size_t sum = 0;
+        for(std::uint32_t query : queries)
+            sum += static_cast<std::size_t>(std::lower_bound(sorted.begin(), sorted.end(), query) - sorted.begin());
+        benchmark::DoNotOptimize(sum);
+    }
+    state.SetItemsProcessed(state.iterations() * static_cast<std::int64_t>(queries.size()));
+}
+
+static void BM_SearchIndexLowerBound(benchmark::State& state){
+    const auto count = static_cast<std::size_t>(state.range(0));
+    const yadej::SearchIndex<std::uint32_t> index(make_sorted(count));
+    const auto queries = make_queries(count);
+    for(auto _ : state){
+        std::size_t sum = 0;
+        for(std::uint32_t query : queries)
+            sum += index.lower_bound(query);
+        benchmark::DoNotOptimize(sum);
+    }
+    state.SetItemsProcessed(state.iterations() * static_cast<std::int64_t>(queries.size()));
+}
+
+static void BM_SearchIndexBatch(benchmark::State& state){
+    const auto count = static_cast<std::size_t>(state.range(0));
+    const yadej::SearchIndex<std::uint32_t> index(make_sorted(count));
+    const auto queries = make_queries(count);
+    std::vector<std::size_t> positions(queries.size());
+    for(auto _ : state){
+        index.lower_bound_batch(queries, positions);
+        benchmark::DoNotOptimize(positions.data());
+    }
+    state.SetItemsProcessed(state.iterations() * static_cast<std::int64_t>(queries.size()));
+}
+
+BENCHMARK(BM_StdLowerBound)->Arg(1 << 16)->Arg(1 << 24);
+BENCHMARK(BM_SearchIndexLowerBound)->Arg(1 << 16)->Arg(1 << 24);
+BENCHMARK(BM_SearchIndexBatch)->Arg(1 << 16)->Arg(1 << 24);
+
+BENCHMARK_MAIN();
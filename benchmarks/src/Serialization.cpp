@@ -0,0 +1,96 @@
+#include "exerciceCPP/io/Serialization.hpp"
+#include "exerciceCPP/containers/Vector.hpp"
+#include <benchmark/benchmark.h>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <span>
+
+// Shipping a 64 MiB Vector<uint64_t> through a buffer: an element by
+// element loop against serialize, and loading it back by copy, through a
+// VectorView, and with the checksum checked
+
+static constexpr std::size_t count = std::size_t{8} << 20;
+
+static yadej::Vector<std::uint64_t> make_values(){
+    yadej::Vector<std::uint64_t> values;
+    values.resize_for_overwrite(count);
+    for(std::size_t i=0; i < count; ++i)
+        values[i] = i * 2654435761u;
+    return values;
+}
+
+static void BM_WriteLoop(benchmark::State& state){
+    const yadej::Vector<std::uint64_t> values = make_values();
+    for(auto _ : state){
+        yadej::io::BufferWriter out;
+        for(std::uint64_t value : values)
+            out.write(std::as_bytes(std::span<const std::uint64_t>(&value, 1)));
+        benchmark::DoNotOptimize(out.bytes().data());
+    }
+    state.SetBytesProcessed(state.iterations() * static_cast<std::int64_t>(count * sizeof(std::uint64_t)));
+}
+
+static void BM_Serialize(benchmark::State& state){
+    const yadej::Vector<std::uint64_t> values = make_values();
+    for(auto _ : state){
+        yadej::io::BufferWriter out;
+        yadej::io::serialize(values, out);
+        benchmark::DoNotOptimize(out.bytes().data());
+    }
+    state.SetBytesProcessed(state.iterations() * static_cast<std::int64_t>(count * sizeof(std::uint64_t)));
+}
+
+static void BM_ReadLoop(benchmark::State& state){
+    yadej::io::BufferWriter out;
+    yadej::io::serialize(make_values(), out);
+    const std::span<const std::byte> bytes = out.bytes().subspan(yadej::io::header_size);
+    for(auto _ : state){
+        yadej::Vector<std::uint64_t> values;
+        for(std::size_t i=0; i < count; ++i){
+            std::uint64_t value;
+            std::memcpy(&value, bytes.data() + i * sizeof(value), sizeof(value));
+            values.push_back(value);
+        }
+        benchmark::DoNotOptimize(values.data());
+    }
+    state.SetBytesProcessed(state.iterations() * static_cast<std::int64_t>(count * sizeof(std::uint64_t)));
+}
+
+static void BM_Deserialize(benchmark::State& state){
+    yadej::io::BufferWriter out;
+    yadej::io::serialize(make_values(), out);
+    for(auto _ : state){
+        const yadej::Vector<std::uint64_t> values = yadej::io::deserialize<std::uint64_t>(out.bytes());
+        benchmark::DoNotOptimize(values.data());
+    }
+    state.SetBytesProcessed(state.iterations() * static_cast<std::int64_t>(count * sizeof(std::uint64_t)));
+}
+
+static void BM_ViewOpen(benchmark::State& state){
+    yadej::io::BufferWriter out;
+    yadej::io::serialize(make_values(), out);
+    for(auto _ : state){
+        const yadej::io::VectorView<std::uint64_t> view(out.bytes());
+        benchmark::DoNotOptimize(view.data());
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+
+static void BM_ViewVerify(benchmark::State& state){
+    yadej::io::BufferWriter out;
+    yadej::io::serialize(make_values(), out);
+    const yadej::io::VectorView<std::uint64_t> view(out.bytes());
+    for(auto _ : state)
+        benchmark::DoNotOptimize(view.verify());
+    state.SetBytesProcessed(state.iterations() * static_cast<std::int64_t>(count * sizeof(std::uint64_t)));
+}
+
+BENCHMARK(BM_WriteLoop)->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_Serialize)->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_ReadLoop)->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_Deserialize)->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_ViewOpen);
+BENCHMARK(BM_ViewVerify)->Unit(benchmark::kMillisecond);
+
+BENCHMARK_MAIN();
@@ -0,0 +1,128 @@
+#include "exerciceCPP/simd/Kernels.hpp"
+#include "exerciceCPP/containers/Vector.hpp"
+#include <benchmark/benchmark.h>
+#include <cstddef>
+#include <cstdint>
+
+// Naive loops over a Vector<float> against the kernels, state.range(1)
+// being the instruction set (0 scalar, 1 SSE2, 2 AVX2, 3 AVX-512)
+
+yadej::simd::AlignedBuffer<float> make_values(std::size_t count){
+    yadej::simd::AlignedBuffer<float> values;
+    values.resize_for_overwrite(count);
+    for(std::size_t i=0; i < count; ++i)
+        values[i] = static_cast<float>(i % 1000) * 0.5F;
+    return values;
+}
+
+void set_processed(benchmark::State& state, std::size_t arrays){
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+    state.SetBytesProcessed(state.iterations() * state.range(0)
+                            * static_cast<std::int64_t>(sizeof(float) * arrays));
+}
+
+// False when the CPU lacks the instruction set, the benchmark is skipped
+bool use_isa(benchmark::State& state){
+    const auto isa = static_cast<yadej::simd::Isa>(state.range(1));
+    if( yadej::simd::set_isa(isa) != isa){
+        state.SkipWithError("instruction set not supported");
+        return false;
+    }
+    return true;
+}
+
+static void BM_NaiveSum(benchmark::State& state){
+    const yadej::simd::AlignedBuffer<float> values = make_values(static_cast<std::size_t>(state.range(0)));
+    for(auto _ : state){
+        float sum = 0;
+        for(float value : values)
+            sum += value;
+        benchmark::DoNotOptimize(sum);
+    }
+    set_processed(state, 1);
+}
+
+static void BM_SimdSum(benchmark::State& state){
+    const yadej::simd::AlignedBuffer<float> values = make_values(static_cast<std::size_t>(state.range(0)));
+    if( !use_isa(state))
+        return;
+    for(auto _ : state)
+        benchmark::DoNotOptimize(yadej::simd::sum(values));
+    set_processed(state, 1);
+}
+
+static void BM_NaiveDot(benchmark::State& state){
+    const yadej::simd::AlignedBuffer<float> l_values = make_values(static_cast<std::size_t>(state.range(0)));
+    const yadej::simd::AlignedBuffer<float> r_values = make_values(static_cast<std::size_t>(state.range(0)));
+    for(auto _ : state){
+        float dot = 0;
+        for(std::size_t i=0; i < l_values.size(); ++i)
+            dot += l_values[i] * r_values[i];
+        benchmark::DoNotOptimize(dot);
+    }
+    set_processed(state, 2);
+}
+
+static void BM_SimdDot(benchmark::State& state){
+    const yadej::simd::AlignedBuffer<float> l_values = make_values(static_cast<std::size_t>(state.range(0)));
+    const yadej::simd::AlignedBuffer<float> r_values = make_values(static_cast<std::size_t>(state.range(0)));
+    if( !use_isa(state))
+        return;
+    for(auto _ : state)
+        benchmark::DoNotOptimize(yadej::simd::dot(l_values, r_values));
+    set_processed(state, 2);
+}
+
+static void BM_NaiveCount(benchmark::State& state){
+    const yadej::simd::AlignedBuffer<float> values = make_values(static_cast<std::size_t>(state.range(0)));
+    for(auto _ : state){
+        std::size_t count = 0;
+        for(float value : values)
+            count += value == 42.0F;
+        benchmark::DoNotOptimize(count);
+    }
+    set_processed(state, 1);
+}
+
+static void BM_SimdCount(benchmark::State& state){
+    const yadej::simd::AlignedBuffer<float> values = make_values(static_cast<std::size_t>(state.range(0)));
+    if( !use_isa(state))
+        return;
+    for(auto _ : state)
+        benchmark::DoNotOptimize(yadej::simd::count(values, 42.0F));
+    set_processed(state, 1);
+}
+
+static void BM_SimdFma(benchmark::State& state){
+    const yadej::simd::AlignedBuffer<float> a = make_values(static_cast<std::size_t>(state.range(0)));
+    const yadej::simd::AlignedBuffer<float> b = make_values(static_cast<std::size_t>(state.range(0)));
+    yadej::simd::AlignedBuffer<float> out = make_values(static_cast<std::size_t>(state.range(0)));
+    if( !use_isa(state))
+        return;
+    for(auto _ : state){
+        yadej::simd::fma(a, b, out, out);
+        benchmark::DoNotOptimize(out.data());
+    }
+    set_processed(state, 3);
+}
+
+static void naive_sizes(benchmark::internal::Benchmark* benchmark){
+    for(std::int64_t size : {4096, 1 << 20})
+        benchmark->Args({size, 0});
+}
+
+static void simd_sizes(benchmark::internal::Benchmark* benchmark){
+    for(std::int64_t size : {4096, 1 << 20})
+        for(std::int64_t isa=0; isa <= 3; ++isa)
+            benchmark->Args({size, isa});
+}
+
+BENCHMARK(BM_NaiveSum)->Apply(naive_sizes);
+BENCHMARK(BM_SimdSum)->Apply(simd_sizes);
+BENCHMARK(BM_NaiveDot)->Apply(naive_sizes);
+BENCHMARK(BM_SimdDot)->Apply(simd_sizes);
+BENCHMARK(BM_NaiveCount)->Apply(naive_sizes);
+BENCHMARK(BM_SimdCount)->Apply(simd_sizes);
+BENCHMARK(BM_SimdFma)->Apply(simd_sizes);
+
+BENCHMARK_MAIN();
@@ -0,0 +1,84 @@
+#include "exerciceCPP/containers/SmallVector.hpp"
+#include "exerciceCPP/containers/Vector.hpp"
+#include <benchmark/benchmark.h>
+#include <cstddef>
+#include <memory>
+
+// Allocator counting the calls to allocate, reported per operation
+template<class T>
+struct CountingAllocator {
+    using value_type = T;
+    inline static std::size_t allocations = 0;
+
+    CountingAllocator() = default;
+    template<class U>
+    CountingAllocator(const CountingAllocator<U>&){}
+
+    T* allocate(std::size_t n){
+        ++allocations;
+        return std::allocator<T>().allocate(n);
+    }
+    void deallocate(T* p, std::size_t n){
+        std::allocator<T>().deallocate(p, n);
+    }
+    friend bool operator==(const CountingAllocator&, const CountingAllocator&){ return true; }
+};
+
+using CountedVector = yadej::Vector<int, CountingAllocator<int>>;
+using CountedSmallVector = yadej::SmallVector<int, 8, CountingAllocator<int>>;
+
+static void report_allocations(benchmark::State& state){
+    state.counters["allocs_per_op"] = benchmark::Counter(static_cast<double>(CountingAllocator<int>::allocations),
+                                                         benchmark::Counter::kAvgIterations);
+}
+
+// Build a container of range(0) elements with push_back then destroy it
+template<class Container>
+static void BM_PushBack(benchmark::State& state){
+    const int count = static_cast<int>(state.range(0));
+    CountingAllocator<int>::allocations = 0;
+    for(auto _ : state){
+        Container vec;
+        for(int i=0; i < count; ++i)
+            vec.push_back(i);
+        benchmark::DoNotOptimize(vec.data());
+    }
+    report_allocations(state);
+}
+
+// Build a container of range(0) elements by inserting at the front
+template<class Container>
+static void BM_InsertFront(benchmark::State& state){
+    const int count = static_cast<int>(state.range(0));
+    CountingAllocator<int>::allocations = 0;
+    for(auto _ : state){
+        Container vec;
+        for(int i=0; i < count; ++i)
+            vec.insert(vec.begin(), i);
+        benchmark::DoNotOptimize(vec.data());
+    }
+    report_allocations(state);
+}
+
+// Copy a container of range(0) elements
+template<class Container>
+static void BM_Copy(benchmark::State& state){
+    Container source;
+    for(int i=0; i < state.range(0); ++i)
+        source.push_back(i);
+    CountingAllocator<int>::allocations = 0;
+    for(auto _ : state){
+        Container copy(source);
+        benchmark::DoNotOptimize(copy.data());
+    }
+    report_allocations(state);
+}
+
+BENCHMARK_TEMPLATE(BM_PushBack, CountedVector)->Arg(2)->Arg(4)->Arg(8)->Arg(16);
+BENCHMARK_TEMPLATE(BM_PushBack, CountedSmallVector)->Arg(2)->Arg(4)->Arg(8)->Arg(16);
+BENCHMARK_TEMPLATE(BM_InsertFront, CountedVector)->Arg(2)->Arg(4)->Arg(8)->Arg(16);
+BENCHMARK_TEMPLATE(BM_InsertFront, CountedSmallVector)->Arg(2)->Arg(4)->Arg(8)->Arg(16);
+BENCHMARK_TEMPLATE(BM_Copy, CountedVector)->Arg(2)->Arg(4)->Arg(8)->Arg(16);
+BENCHMARK_TEMPLATE(BM_Copy, CountedSmallVector)->Arg(2)->Arg(4)->Arg(8)->Arg(16);
+
+BENCHMARK_MAIN();
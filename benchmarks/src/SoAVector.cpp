@@ -0,0 +1,57 @@
+#include "exerciceCPP/containers/SoAVector.hpp"
+#include "exerciceCPP/containers/Vector.hpp"
+#include <benchmark/benchmark.h>
+#include <cstddef>
+#include <cstdint>
+
+// Sum one field of range(0) records of 8 fields, stored as a Vector of
+// structs against a SoAVector column
+
+struct Record {
+    std::uint64_t id;
+    double price;
+    double quantity;
+    std::uint64_t timestamp;
+    std::uint32_t flags;
+    std::uint32_t region;
+    double weight;
+    std::uint64_t owner;
+};
+
+using Records = yadej::SoAVector<std::uint64_t, double, double, std::uint64_t,
+                                 std::uint32_t, std::uint32_t, double, std::uint64_t>;
+
+static void BM_ScanStruct(benchmark::State& state){
+    const auto count = static_cast<std::size_t>(state.range(0));
+    yadej::Vector<Record> records;
+    records.reserve(count);
+    for(std::size_t i=0; i < count; ++i)
+        records.push_back(Record{i, static_cast<double>(i), 1.0, i, 0, 0, 1.0, i});
+    for(auto _ : state){
+        double sum = 0;
+        for(const Record& record : records)
+            sum += record.price;
+        benchmark::DoNotOptimize(sum);
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+static void BM_ScanColumn(benchmark::State& state){
+    const auto count = static_cast<std::size_t>(state.range(0));
+    Records records;
+    records.reserve(count);
+    for(std::size_t i=0; i < count; ++i)
+        records.emplace_back(i, static_cast<double>(i), 1.0, i, 0u, 0u, 1.0, i);
+    for(auto _ : state){
+        double sum = 0;
+        for(double price : records.column<1>())
+            sum += price;
+        benchmark::DoNotOptimize(sum);
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+BENCHMARK(BM_ScanStruct)->RangeMultiplier(64)->Range(1 << 10, 1 << 22);
+BENCHMARK(BM_ScanColumn)->RangeMultiplier(64)->Range(1 << 10, 1 << 22);
+
+BENCHMARK_MAIN();
@@ -0,0 +1,195 @@
+#include "exerciceCPP/containers/Vector.hpp"
+#include <benchmark/benchmark.h>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <utility>
+#include <vector>
+
+// Every benchmark is instantiated for std::vector as the baseline and
+// yadej::Vector, with int, a 64 bytes POD and std::string elements
+
+struct Pod64 {
+    std::uint64_t values[8];
+};
+
+template<class T>
+T make_value(std::size_t i);
+
+template<>
+int make_value<int>(std::size_t i){
+    return static_cast<int>(i);
+}
+
+template<>
+Pod64 make_value<Pod64>(std::size_t i){
+    return Pod64{{i, i, i, i, i, i, i, i}};
+}
+
+// Long enough to escape the small string optimisation
+template<>
+std::string make_value<std::string>(std::size_t i){
+    return std::string(32, static_cast<char>('a' + i % 26));
+}
+
+template<class Container>
+Container make_container(std::size_t count){
+    Container container;
+    for(std::size_t i=0; i < count; ++i)
+        container.push_back(make_value<typename Container::value_type>(i));
+    return container;
+}
+
+template<class Container>
+void set_processed(benchmark::State& state){
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+    state.SetBytesProcessed(state.iterations() * state.range(0)
+                            * static_cast<std::int64_t>(sizeof(typename Container::value_type)));
+}
+
+template<class Container>
+static void BM_PushBack(benchmark::State& state){
+    using T = typename Container::value_type;
+    const std::size_t count = static_cast<std::size_t>(state.range(0));
+    const T value = make_value<T>(1);
+    for(auto _ : state){
+        Container container;
+        for(std::size_t i=0; i < count; ++i)
+            container.push_back(value);
+        benchmark::DoNotOptimize(container.data());
+    }
+    set_processed<Container>(state);
+}
+
+template<class Container>
+static void BM_EmplaceBack(benchmark::State& state){
+    using T = typename Container::value_type;
+    const std::size_t count = static_cast<std::size_t>(state.range(0));
+    for(auto _ : state){
+        Container container;
+        for(std::size_t i=0; i < count; ++i)
+            container.emplace_back(make_value<T>(i));
+        benchmark::DoNotOptimize(container.data());
+    }
+    set_processed<Container>(state);
+}
+
+template<class Container>
+static void BM_ReserveFill(benchmark::State& state){
+    using T = typename Container::value_type;
+    const std::size_t count = static_cast<std::size_t>(state.range(0));
+    const T value = make_value<T>(1);
+    for(auto _ : state){
+        Container container;
+        container.reserve(count);
+        for(std::size_t i=0; i < count; ++i)
+            container.push_back(value);
+        benchmark::DoNotOptimize(container.data());
+    }
+    set_processed<Container>(state);
+}
+
+// Insert then erase one element in the middle, the size stays range(0)
+template<class Container>
+static void BM_InsertEraseMiddle(benchmark::State& state){
+    using T = typename Container::value_type;
+    Container container = make_container<Container>(static_cast<std::size_t>(state.range(0)));
+    container.reserve(container.size() + 1);
+    const T value = make_value<T>(0);
+    const auto middle = static_cast<std::ptrdiff_t>(container.size() / 2);
+    for(auto _ : state){
+        container.insert(container.begin() + middle, value);
+        container.erase(container.begin() + middle);
+        benchmark::DoNotOptimize(container.data());
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+
+// Insert range(0) elements in the middle of a container of range(0) elements
+template<class Container>
+static void BM_RangeInsert(benchmark::State& state){
+    const std::size_t count = static_cast<std::size_t>(state.range(0));
+    const Container source = make_container<Container>(count);
+    for(auto _ : state){
+        Container container = source;
+        container.insert(container.begin() + static_cast<std::ptrdiff_t>(count / 2), source.begin(), source.end());
+        benchmark::DoNotOptimize(container.data());
+    }
+    set_processed<Container>(state);
+}
+
+template<class Container>
+static void BM_CopyConstruct(benchmark::State& state){
+    const Container source = make_container<Container>(static_cast<std::size_t>(state.range(0)));
+    for(auto _ : state){
+        Container copy(source);
+        benchmark::DoNotOptimize(copy.data());
+    }
+    set_processed<Container>(state);
+}
+
+template<class Container>
+static void BM_MoveConstruct(benchmark::State& state){
+    Container source = make_container<Container>(static_cast<std::size_t>(state.range(0)));
+    for(auto _ : state){
+        Container moved(std::move(source));
+        benchmark::DoNotOptimize(moved.data());
+        source = std::move(moved);
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+
+template<class T>
+std::size_t weight(const T& value);
+
+template<>
+std::size_t weight<int>(const int& value){
+    return static_cast<std::size_t>(value);
+}
+
+template<>
+std::size_t weight<Pod64>(const Pod64& value){
+    return value.values[0];
+}
+
+template<>
+std::size_t weight<std::string>(const std::string& value){
+    return value.size();
+}
+
+template<class Container>
+static void BM_Iterate(benchmark::State& state){
+    const Container container = make_container<Container>(static_cast<std::size_t>(state.range(0)));
+    for(auto _ : state){
+        std::size_t sum = 0;
+        for(const auto& value : container)
+            sum += weight(value);
+        benchmark::DoNotOptimize(sum);
+    }
+    set_processed<Container>(state);
+}
+
+static void vector_sizes(benchmark::internal::Benchmark* benchmark){
+    for(std::int64_t size : {16, 1024, 65536, 1 << 20})
+        benchmark->Arg(size);
+}
+
+#define VECTOR_BENCHMARK(name, type)                                     \
+    BENCHMARK_TEMPLATE(name, std::vector<type>)->Apply(vector_sizes);   \
+    BENCHMARK_TEMPLATE(name, yadej::Vector<type>)->Apply(vector_sizes)
+
+#define VECTOR_BENCHMARK_ALL_TYPES(name) \
+    VECTOR_BENCHMARK(name, int);         \
+    VECTOR_BENCHMARK(name, Pod64);       \
+    VECTOR_BENCHMARK(name, std::string)
+
+VECTOR_BENCHMARK_ALL_TYPES(BM_PushBack);
+VECTOR_BENCHMARK_ALL_TYPES(BM_EmplaceBack);
+VECTOR_BENCHMARK_ALL_TYPES(BM_ReserveFill);
+VECTOR_BENCHMARK_ALL_TYPES(BM_InsertEraseMiddle);
+VECTOR_BENCHMARK_ALL_TYPES(BM_RangeInsert);
+VECTOR_BENCHMARK_ALL_TYPES(BM_CopyConstruct);
+VECTOR_BENCHMARK_ALL_TYPES(BM_MoveConstruct);
+VECTOR_BENCHMARK_ALL_TYPES(BM_Iterate);
+
+BENCHMARK_MAIN();
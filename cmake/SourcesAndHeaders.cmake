@@ -1,8 +1,69 @@
-
 set(headers
-    include/exerciceCPP/container/Vector.hpp
+    include/exerciceCPP/containers/ConcurrentVector.hpp
+    include/exerciceCPP/containers/CowVector.hpp
+    include/exerciceCPP/containers/FlatHashMap.hpp
+    include/exerciceCPP/containers/FlatMap.hpp
+    include/exerciceCPP/containers/GrowthPolicy.hpp
+    include/exerciceCPP/containers/InplaceVector.hpp
+    include/exerciceCPP/containers/Iterator.hpp
+    include/exerciceCPP/containers/MappedVector.hpp
+    include/exerciceCPP/containers/PersistentVector.hpp
+    include/exerciceCPP/containers/Relocation.hpp
+    include/exerciceCPP/containers/SearchIndex.hpp
+    include/exerciceCPP/containers/SegmentedVector.hpp
+    include/exerciceCPP/containers/SmallVector.hpp
+    include/exerciceCPP/containers/SoAVector.hpp
+    include/exerciceCPP/containers/Vector.hpp
+    include/exerciceCPP/containers/VectorStats.hpp
+    include/exerciceCPP/io/ChunkReader.hpp
+    include/exerciceCPP/io/Serialization.hpp
+    include/exerciceCPP/memory/AlignedAllocator.hpp
+    include/exerciceCPP/memory/ArenaResource.hpp
+    include/exerciceCPP/memory/CachePadded.hpp
+    include/exerciceCPP/memory/HugePageAllocator.hpp
+    include/exerciceCPP/memory/PoolAllocator.hpp
+    include/exerciceCPP/parallel/Algorithms.hpp
+    include/exerciceCPP/parallel/ThreadPool.hpp
+    include/exerciceCPP/simd/Kernels.hpp
 )
 
 set(test_sources
     src/main.cpp
+    src/AlignedAllocator.cpp
+    src/ArenaResource.cpp
+    src/ChunkReader.cpp
+    src/ConcurrentVector.cpp
+    src/CowVector.cpp
+    src/FlatHashMap.cpp
+    src/FlatMap.cpp
+    src/HugePageAllocator.cpp
+    src/InplaceVector.cpp
+    src/MappedVector.cpp
+    src/Parallel.cpp
+    src/PersistentVector.cpp
+    src/PoolAllocator.cpp
+    src/SearchIndex.cpp
+    src/SegmentedVector.cpp
+    src/Serialization.cpp
+    src/Simd.cpp
+    src/SmallVector.cpp
+    src/SoAVector.cpp
+)
+
+set(benchmark_sources
+    src/ChunkReader.cpp
+    src/ConcurrentVector.cpp
+    src/CowVector.cpp
+    src/FlatHashMap.cpp
+    src/FlatMap.cpp
+    src/HugePageAllocator.cpp
+    src/Parallel.cpp
+    src/PersistentVector.cpp
+    src/PoolAllocator.cpp
+    src/SearchIndex.cpp
+    src/Serialization.cpp
+    src/Simd.cpp
+    src/SmallVector.cpp
+    src/SoAVector.cpp
+    src/Vector.cpp
 )
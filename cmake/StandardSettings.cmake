@@ -32,6 +32,13 @@ option(${PROJECT_NAME}_USE_GOOGLE_MOCK "Use the GoogleMock project for extending
 
 option(${PROJECT_NAME}_USE_CATCH2 "Use the Catch2 project for creating unit tests." OFF)
 
+#
+# Benchmarking
+#
+# Currently supporting: Google Benchmark.
+
+option(${PROJECT_NAME}_ENABLE_BENCHMARKING "Enable benchmarks for the projects (from the `benchmarks` subfolder)." OFF)
+
 #
 # Static analyzers
 #
@@ -88,6 +95,8 @@ if(CCACHE_FOUND)
   set_property(GLOBAL PROPERTY RULE_LAUNCH_LINK ccache)
 endif()
 
+option(${PROJECT_NAME}_ENABLE_VECTOR_STATS "Record allocation and copy statistics in every Vector by default (see VectorStats.hpp)." OFF)
+
 option(${PROJECT_NAME}_ENABLE_ASAN "Enable Address Sanitize to detect memory error." OFF)
 if(${PROJECT_NAME}_ENABLE_ASAN)
     add_compile_options(-fsanitize=address)
@@ -0,0 +1,286 @@
+#pragma once
+
+#include <algorithm> // min
+#include <atomic> // atomic memory_order
+#include <bit> // bit_width
+#include <cstddef> // size_t
+#include <memory> // allocator allocator_traits
+#include <stdexcept> // out_of_range
+#include <utility> // forward
+
+namespace yadej {
+
+// Append only vector filled concurrently from any number of threads.
+//
+// Elements live in segments which are never moved: segment k holds
+// first_segment_size << k elements, so the index of an element gives its
+// segment and offset with a bit_width, and a reference stays valid until
+// clear() or destruction.
+//
+// push_back and emplace_back are lock-free: the slot is claimed with a
+// fetch_add, a missing segment is allocated and published with a CAS (the
+// loser gives its own back), then the element is constructed and marked
+// ready. Reads by index are wait-free. size() counts the claimed slots,
+// an element can be read once the push_back which returned it is visible
+// to the reader, or checked with try_get which tells if it is ready.
+//
+// clear, reserve_exactly and destruction are not thread safe.
+template<class T, class Allocator = std::allocator<T>>
+class ConcurrentVector {
+public:
+
+    // Declaration of type
+    using value_type = T;
+    using allocator_type = Allocator;
+    using size_type = std::size_t;
+    using reference = T&;
+    using const_reference = const T&;
+    using pointer = T*;
+    using const_pointer = const T*;
+
+    static constexpr size_type first_segment_size = 32;
+
+    // Constructors and Destructors
+    ConcurrentVector() noexcept(noexcept(Allocator())) = default;
+    explicit ConcurrentVector( const allocator_type& alloc) noexcept;
+    ConcurrentVector(const ConcurrentVector&) = delete;
+    ConcurrentVector &operator=(const ConcurrentVector&) = delete;
+    ~ConcurrentVector();
+
+    // Element access, wait-free
+    reference operator[](size_type position);
+    const_reference operator[](size_type position) const;
+    reference at(size_type position);
+    const_reference at(size_type position) const;
+    // nullptr while the element is still being constructed
+    pointer try_get(size_type position) noexcept;
+    const_pointer try_get(size_type position) const noexcept;
+
+    // Container
+    //
+    bool empty() const noexcept;
+    size_type size() const noexcept;
+    size_type capacity() const noexcept;
+    // Allocate the segments needed for count elements, thread safe
+    void reserve(size_type count);
+
+    // Modifiers, lock-free
+    reference push_back(const T& value);
+    reference push_back(T&& value);
+    template<class... Args>
+    reference emplace_back(Args&&... args);
+
+    // Not thread safe
+    void clear() noexcept;
+
+private:
+    static constexpr size_type first_segment_bits = std::bit_width(first_segment_size) - 1;
+    static constexpr size_type segment_count = sizeof(size_type) * 8 - first_segment_bits;
+
+    struct Segment {
+        T* elements;
+        std::atomic<bool>* ready;
+    };
+
+    using element_allocator = typename std::allocator_traits<Allocator>::template rebind_alloc<T>;
+    using ready_allocator = typename std::allocator_traits<Allocator>::template rebind_alloc<std::atomic<bool>>;
+    using segment_allocator = typename std::allocator_traits<Allocator>::template rebind_alloc<Segment>;
+
+    static constexpr size_type segment_of(size_type position) noexcept{
+        return std::bit_width(position + first_segment_size) - 1 - first_segment_bits;
+    }
+    static constexpr size_type segment_size(size_type segment) noexcept{
+        return first_segment_size << segment;
+    }
+    // Index of the first element of segment
+    static constexpr size_type segment_start(size_type segment) noexcept{
+        return segment_size(segment) - first_segment_size;
+    }
+
+    Segment* segment(size_type index);
+    Segment* new_segment(size_type index);
+    void delete_segment(Segment* segment, size_type index, size_type used) noexcept;
+
+    std::atomic<Segment*> m_segments[segment_count]{};
+    std::atomic<size_type> m_size{0};
+    Allocator allocator{};
+};
+
+template<class T, class Allocator>
+ConcurrentVector<T, Allocator>::ConcurrentVector(const allocator_type& alloc) noexcept
+    : allocator(alloc){
+}
+
+template<class T, class Allocator>
+ConcurrentVector<T, Allocator>::~ConcurrentVector(){
+    clear();
+}
+
+template<class T, class Allocator>
+T& ConcurrentVector<T, Allocator>::operator[](size_type position){
+    const size_type index = segment_of(position);
+    return m_segments[index].load(std::memory_order_acquire)->elements[position - segment_start(index)];
+}
+
+template<class T, class Allocator>
+const T& ConcurrentVector<T, Allocator>::operator[](size_type position) const{
+    const size_type index = segment_of(position);
+    return m_segments[index].load(std::memory_order_acquire)->elements[position - segment_start(index)];
+}
+
+template<class T, class Allocator>
+T& ConcurrentVector<T, Allocator>::at(size_type position){
+    pointer element = try_get(position);
+    if( element == nullptr)
+        throw std::out_of_range("Out of Range");
+    return *element;
+}
+
+template<class T, class Allocator>
+const T& ConcurrentVector<T, Allocator>::at(size_type position) const{
+    const_pointer element = try_get(position);
+    if( element == nullptr)
+        throw std::out_of_range("Out of Range");
+    return *element;
+}
+
+template<class T, class Allocator>
+T* ConcurrentVector<T, Allocator>::try_get(size_type position) noexcept{
+    if( position >= size())
+        return nullptr;
+    const size_type index = segment_of(position);
+    Segment* current = m_segments[index].load(std::memory_order_acquire);
+    const size_type offset = position - segment_start(index);
+    if( current == nullptr || !current->ready[offset].load(std::memory_order_acquire))
+        return nullptr;
+    return current->elements + offset;
+}
+
+template<class T, class Allocator>
+const T* ConcurrentVector<T, Allocator>::try_get(size_type position) const noexcept{
+    return const_cast<ConcurrentVector*>(this)->try_get(position);
+}
+
+template<class T, class Allocator>
+bool ConcurrentVector<T, Allocator>::empty() const noexcept{
+    return size() == 0;
+}
+
+template<class T, class Allocator>
+std::size_t ConcurrentVector<T, Allocator>::size() const noexcept{
+    return m_size.load(std::memory_order_acquire);
+}
+
+template<class T, class Allocator>
+std::size_t ConcurrentVector<T, Allocator>::capacity() const noexcept{
+    size_type index = 0;
+    while( index < segment_count && m_segments[index].load(std::memory_order_acquire) != nullptr)
+        ++index;
+    return segment_start(index);
+}
+
+template<class T, class Allocator>
+void ConcurrentVector<T, Allocator>::reserve(size_type count){
+    if( count == 0)
+        return;
+    for(size_type index=0; index <= segment_of(count - 1); ++index)
+        segment(index);
+}
+
+template<class T, class Allocator>
+T& ConcurrentVector<T, Allocator>::push_back(const T& value){
+    return emplace_back(value);
+}
+
+template<class T, class Allocator>
+T& ConcurrentVector<T, Allocator>::push_back(T&& value){
+    return emplace_back(std::move(value));
+}
+
+template<class T, class Allocator>
+template<class... Args>
+T& ConcurrentVector<T, Allocator>::emplace_back(Args&&... args){
+    const size_type position = m_size.fetch_add(1, std::memory_order_acq_rel);
+    const size_type index = segment_of(position);
+    Segment* current = segment(index);
+    const size_type offset = position - segment_start(index);
+    // A throwing constructor leaves the slot never ready, it is skipped on destruction
+    element_allocator alloc(allocator);
+    std::allocator_traits<element_allocator>::construct(alloc, current->elements + offset, std::forward<Args>(args)...);
+    current->ready[offset].store(true, std::memory_order_release);
+    return current->elements[offset];
+}
+
+template<class T, class Allocator>
+void ConcurrentVector<T, Allocator>::clear() noexcept{
+    const size_type used = m_size.load(std::memory_order_acquire);
+    for(size_type index=0; index < segment_count; ++index){
+        Segment* current = m_segments[index].exchange(nullptr, std::memory_order_acq_rel);
+        if( current == nullptr)
+            continue;
+        const size_type start = segment_start(index);
+        const size_type in_segment = used > start ? std::min(used - start, segment_size(index)) : 0;
+        delete_segment(current, index, in_segment);
+    }
+    m_size.store(0, std::memory_order_release);
+}
+
+// Segment index, allocated and published by the first thread needing it
+template<class T, class Allocator>
+typename ConcurrentVector<T, Allocator>::Segment* ConcurrentVector<T, Allocator>::segment(size_type index){
+    Segment* current = m_segments[index].load(std::memory_order_acquire);
+    if( current != nullptr)
+        return current;
+
+    Segment* created = new_segment(index);
+    if( m_segments[index].compare_exchange_strong(current, created, std::memory_order_acq_rel, std::memory_order_acquire))
+        return created;
+    // Another thread won, current holds its segment
+    delete_segment(created, index, 0);
+    return current;
+}
+
+template<class T, class Allocator>
+typename ConcurrentVector<T, Allocator>::Segment* ConcurrentVector<T, Allocator>::new_segment(size_type index){
+    const size_type count = segment_size(index);
+    element_allocator elements_alloc(allocator);
+    ready_allocator ready_alloc(allocator);
+    segment_allocator segments_alloc(allocator);
+
+    Segment* created = std::allocator_traits<segment_allocator>::allocate(segments_alloc, 1);
+    created->elements = nullptr;
+    created->ready = nullptr;
+    try {
+        created->elements = std::allocator_traits<element_allocator>::allocate(elements_alloc, count);
+        created->ready = std::allocator_traits<ready_allocator>::allocate(ready_alloc, count);
+    }catch(...){
+        if( created->elements != nullptr)
+            std::allocator_traits<element_allocator>::deallocate(elements_alloc, created->elements, count);
+        std::allocator_traits<segment_allocator>::deallocate(segments_alloc, created, 1);
+        throw;
+    }
+    for(size_type i=0; i < count; ++i)
+        std::allocator_traits<ready_allocator>::construct(ready_alloc, created->ready + i, false);
+    return created;
+}
+
+// Destroy the ready elements among the first used ones and free the segment
+template<class T, class Allocator>
+void ConcurrentVector<T, Allocator>::delete_segment(Segment* current, size_type index, size_type used) noexcept{
+    const size_type count = segment_size(index);
+    element_allocator elements_alloc(allocator);
+    ready_allocator ready_alloc(allocator);
+    segment_allocator segments_alloc(allocator);
+
+    for(size_type i=0; i < used; ++i){
+        if( current->ready[i].load(std::memory_order_relaxed))
+            std::allocator_traits<element_allocator>::destroy(elements_alloc, current->elements + i);
+    }
+    for(size_type i=0; i < count; ++i)
+        std::allocator_traits<ready_allocator>::destroy(ready_alloc, current->ready + i);
+    std::allocator_traits<ready_allocator>::deallocate(ready_alloc, current->ready, count);
+    std::allocator_traits<element_allocator>::deallocate(elements_alloc, current->elements, count);
+    std::allocator_traits<segment_allocator>::deallocate(segments_alloc, current, 1);
+}
+
+}
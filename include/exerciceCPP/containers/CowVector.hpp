@@ -0,0 +1,319 @@
+#pragma once
+
+#include <atomic> // atomic
+#include <cstddef> // size_t ptrdiff_t
+#include <cstdint> // uint64_t
+#include <initializer_list> // initializer_list
+#include <memory> // allocator allocator_traits
+#include <stdexcept> // out_of_range
+#include <utility> // move forward exchange swap
+#include "Iterator.hpp"
+#include "Vector.hpp"
+
+namespace yadej {
+
+template<class T, class Allocator>
+class AtomicCowVector;
+
+// Copy on write Vector. Copies share one buffer with an atomic reference
+// count, so a copy is O(1) and can be handed to another thread. Reads never
+// copy. The first write through a shared copy clones the buffer.
+//
+// There is no non-const operator[], a write access has to be asked for:
+// write(i), set(i, value), push_back... or edit() which gives the Vector
+// itself for a batch of changes.
+//
+//     yadej::CowVector<Rule> rules = load_rules();
+//     reader.start(rules);          // O(1), both share the buffer
+//     rules.push_back(extra_rule);  // clones, the reader still sees the old rules
+template<class T, class Allocator = std::allocator<T>>
+class CowVector {
+public:
+    using value_type = T;
+    using allocator_type = Allocator;
+    using size_type = std::size_t;
+    using difference_type = std::ptrdiff_t;
+    using reference = T&;
+    using const_reference = const T&;
+    using pointer = T*;
+    using const_pointer = const T*;
+    using const_iterator = iterator_base<const T>;
+    using vector_type = Vector<T, Allocator>;
+
+    CowVector() noexcept(noexcept(Allocator())) = default;
+    explicit CowVector(const allocator_type& alloc) noexcept: m_allocator(alloc){}
+    CowVector(size_type count, const_reference value, const allocator_type& alloc = Allocator())
+        : CowVector(vector_type(count, value, alloc)){}
+    CowVector(std::initializer_list<T> init, const allocator_type& alloc = Allocator())
+        : CowVector(vector_type(init, alloc)){}
+    // Take the buffer of elements, without copy
+    explicit CowVector(vector_type&& elements);
+
+    CowVector(const CowVector& other) noexcept;
+    CowVector(CowVector&& other) noexcept;
+    CowVector& operator=(const CowVector& other) noexcept;
+    CowVector& operator=(CowVector&& other) noexcept;
+    ~CowVector();
+
+    allocator_type get_allocator() const noexcept{ return m_allocator; }
+
+    // Element access, never copies
+    const_reference at(size_type position) const;
+    const_reference operator[](size_type position) const noexcept{ return m_shared->elements[position]; }
+    const_reference front() const noexcept{ return m_shared->elements.front(); }
+    const_reference back() const noexcept{ return m_shared->elements.back(); }
+    const_pointer data() const noexcept{ return m_shared ? m_shared->elements.data() : nullptr; }
+
+    const_iterator begin() const noexcept{ return const_iterator(data()); }
+    const_iterator end() const noexcept{ return const_iterator(data() + size()); }
+    const_iterator cbegin() const noexcept{ return begin(); }
+    const_iterator cend() const noexcept{ return end(); }
+
+    bool empty() const noexcept{ return size() == 0; }
+    size_type size() const noexcept{ return m_shared ? m_shared->elements.size() : 0; }
+    size_type capacity() const noexcept{ return m_shared ? m_shared->elements.capacity() : 0; }
+
+    // Number of CowVector sharing the buffer, 0 without buffer
+    size_type use_count() const noexcept{
+        return m_shared ? m_shared->refs.load(std::memory_order_acquire) : 0;
+    }
+
+    // Write access, the buffer is cloned first when shared
+    vector_type& edit();
+    reference write(size_type position);
+    void set(size_type position, const_reference value){ write(position) = value; }
+    void set(size_type position, value_type&& value){ write(position) = std::move(value); }
+    void push_back(const_reference value){ edit().push_back(value); }
+    void push_back(value_type&& value){ edit().push_back(std::move(value)); }
+    template<class... Args>
+    reference emplace_back(Args&&... args){ return edit().emplace_back(std::forward<Args>(args)...); }
+    void pop_back(){ edit().pop_back(); }
+    void resize(size_type count){ edit().resize(count); }
+    void reserve(size_type new_cap){ edit().reserve(new_cap); }
+    // Drop the buffer, the other copies keep it
+    void clear() noexcept;
+
+    void swap(CowVector& other) noexcept;
+    friend void swap(CowVector& l_arg, CowVector& r_arg) noexcept{ l_arg.swap(r_arg); }
+
+    friend bool operator==(const CowVector& l_arg, const CowVector& r_arg){
+        if( l_arg.m_shared == r_arg.m_shared)
+            return true;
+        if( l_arg.size() != r_arg.size())
+            return false;
+        for(size_type i=0; i < l_arg.size(); ++i)
+            if( !(l_arg[i] == r_arg[i]))
+                return false;
+        return true;
+    }
+
+private:
+    template<class, class>
+    friend class AtomicCowVector;
+
+    struct Shared {
+        explicit Shared(vector_type&& values) noexcept: elements(std::move(values)){}
+        std::atomic<size_type> refs{1};
+        vector_type elements;
+    };
+    using shared_allocator = typename std::allocator_traits<Allocator>::template rebind_alloc<Shared>;
+    using shared_traits = std::allocator_traits<shared_allocator>;
+
+    // Adopt a reference already counted in shared
+    explicit CowVector(Shared* shared) noexcept;
+
+    Shared* make_shared(vector_type&& elements);
+    static void release(Shared* shared) noexcept;
+
+    Shared* m_shared{nullptr};
+    Allocator m_allocator{};
+};
+
+template<class T, class Allocator>
+CowVector<T, Allocator>::CowVector(vector_type&& elements)
+        : m_allocator(elements.get_allocator()){
+    m_shared = make_shared(std::move(elements));
+}
+
+template<class T, class Allocator>
+CowVector<T, Allocator>::CowVector(Shared* shared) noexcept
+        : m_shared(shared){
+    if( shared)
+        m_allocator = shared->elements.get_allocator();
+}
+
+template<class T, class Allocator>
+CowVector<T, Allocator>::CowVector(const CowVector& other) noexcept
+        : m_shared(other.m_shared), m_allocator(other.m_allocator){
+    // A new owner needs no ordering, it is made from an existing one
+    if( m_shared)
+        m_shared->refs.fetch_add(1, std::memory_order_relaxed);
+}
+
+template<class T, class Allocator>
+CowVector<T, Allocator>::CowVector(CowVector&& other) noexcept
+        : m_shared(std::exchange(other.m_shared, nullptr)), m_allocator(other.m_allocator){
+}
+
+template<class T, class Allocator>
+CowVector<T, Allocator>& CowVector<T, Allocator>::operator=(const CowVector& other) noexcept{
+    CowVector copy(other);
+    swap(copy);
+    return *this;
+}
+
+template<class T, class Allocator>
+CowVector<T, Allocator>& CowVector<T, Allocator>::operator=(CowVector&& other) noexcept{
+    CowVector moved(std::move(other));
+    swap(moved);
+    return *this;
+}
+
+template<class T, class Allocator>
+CowVector<T, Allocator>::~CowVector(){
+    release(m_shared);
+}
+
+template<class T, class Allocator>
+typename CowVector<T, Allocator>::const_reference CowVector<T, Allocator>::at(size_type position) const{
+    if( position >= size())
+        throw std::out_of_range("Index out of range");
+    return (*this)[position];
+}
+
+template<class T, class Allocator>
+typename CowVector<T, Allocator>::vector_type& CowVector<T, Allocator>::edit(){
+    // Acquire pairs with the release of the other owners: seeing a count
+    // of 1, their last reads of the buffer are done before this write
+    if( !m_shared){
+        m_shared = make_shared(vector_type(m_allocator));
+    } else if( m_shared->refs.load(std::memory_order_acquire) != 1){
+        Shared* copy = make_shared(vector_type(m_shared->elements, m_allocator));
+        release(std::exchange(m_shared, copy));
+    }
+    return m_shared->elements;
+}
+
+template<class T, class Allocator>
+typename CowVector<T, Allocator>::reference CowVector<T, Allocator>::write(size_type position){
+    if( position >= size())
+        throw std::out_of_range("Index out of range");
+    return edit()[position];
+}
+
+template<class T, class Allocator>
+void CowVector<T, Allocator>::clear() noexcept{
+    release(std::exchange(m_shared, nullptr));
+}
+
+template<class T, class Allocator>
+void CowVector<T, Allocator>::swap(CowVector& other) noexcept{
+    std::swap(m_shared, other.m_shared);
+    std::swap(m_allocator, other.m_allocator);
+}
+
+template<class T, class Allocator>
+typename CowVector<T, Allocator>::Shared* CowVector<T, Allocator>::make_shared(vector_type&& elements){
+    shared_allocator alloc(m_allocator);
+    Shared* shared = shared_traits::allocate(alloc, 1);
+    shared_traits::construct(alloc, shared, std::move(elements));
+    return shared;
+}
+
+template<class T, class Allocator>
+void CowVector<T, Allocator>::release(Shared* shared) noexcept{
+    if( !shared || shared->refs.fetch_sub(1, std::memory_order_acq_rel) != 1)
+        return;
+    shared_allocator alloc(shared->elements.get_allocator());
+    shared_traits::destroy(alloc, shared);
+    shared_traits::deallocate(alloc, shared, 1);
+}
+
+// Slot holding the current version of a CowVector. Writers publish a new
+// version in O(1) with store, readers take a snapshot with load, and
+// neither of them ever waits for a lock.
+//
+// The slot keeps the pointer to the buffer and, in its 16 high bits, the
+// number of loads in progress: a load bumps this count to pin the buffer,
+// adds its own reference to the buffer, then takes the count back. A store
+// moves the pending count of the old buffer into its reference count, so
+// that the buffer is not freed under a load that has not finished.
+// The pointer has to fit in 48 bits, true for user space on x86-64 and
+// aarch64.
+//
+//     yadej::AtomicCowVector<Rule> current_rules;
+//     // writer
+//     yadej::CowVector<Rule> next = current_rules.load();
+//     next.push_back(rule);
+//     current_rules.store(std::move(next));
+//     // readers
+//     for(const Rule& rule : current_rules.load()) ...
+template<class T, class Allocator = std::allocator<T>>
+class AtomicCowVector {
+public:
+    using value_type = CowVector<T, Allocator>;
+
+    AtomicCowVector() noexcept = default;
+    explicit AtomicCowVector(value_type value) noexcept
+        : m_word(pack(std::exchange(value.m_shared, nullptr))){}
+    AtomicCowVector(const AtomicCowVector&) = delete;
+    AtomicCowVector& operator=(const AtomicCowVector&) = delete;
+    ~AtomicCowVector(){
+        value_type::release(pointer_of(m_word.load(std::memory_order_acquire)));
+    }
+
+    value_type load() const noexcept;
+    void store(value_type value) noexcept{
+        static_cast<void>(exchange(std::move(value)));
+    }
+    value_type exchange(value_type value) noexcept;
+
+private:
+    using Shared = typename value_type::Shared;
+
+    static_assert(sizeof(void*) == sizeof(std::uint64_t), "AtomicCowVector needs 64 bits pointers");
+    static constexpr unsigned count_shift = 48;
+    static constexpr std::uint64_t count_one = std::uint64_t{1} << count_shift;
+    static constexpr std::uint64_t pointer_mask = count_one - 1;
+
+    static std::uint64_t pack(Shared* shared) noexcept{
+        return reinterpret_cast<std::uint64_t>(shared);
+    }
+    static Shared* pointer_of(std::uint64_t word) noexcept{
+        return reinterpret_cast<Shared*>(word & pointer_mask);
+    }
+
+    mutable std::atomic<std::uint64_t> m_word{0};
+};
+
+template<class T, class Allocator>
+typename AtomicCowVector<T, Allocator>::value_type AtomicCowVector<T, Allocator>::load() const noexcept{
+    // Pin the buffer, a store can not free it while the count is pending
+    std::uint64_t word = m_word.fetch_add(count_one, std::memory_order_acquire) + count_one;
+    Shared* shared = pointer_of(word);
+    if( shared)
+        shared->refs.fetch_add(1, std::memory_order_relaxed);
+
+    // Take the pending count back while the same buffer is published
+    while( pointer_of(word) == shared && (word >> count_shift) != 0){
+        if( m_word.compare_exchange_weak(word, word - count_one, std::memory_order_relaxed))
+            return value_type(shared);
+    }
+    // A store moved the pending count into refs, it is one too many
+    if( shared)
+        shared->refs.fetch_sub(1, std::memory_order_relaxed);
+    return value_type(shared);
+}
+
+template<class T, class Allocator>
+typename AtomicCowVector<T, Allocator>::value_type AtomicCowVector<T, Allocator>::exchange(value_type value) noexcept{
+    Shared* desired = std::exchange(value.m_shared, nullptr);
+    const std::uint64_t word = m_word.exchange(pack(desired), std::memory_order_acq_rel);
+    Shared* previous = pointer_of(word);
+    const std::uint64_t pending = word >> count_shift;
+    if( previous && pending != 0)
+        previous->refs.fetch_add(static_cast<std::size_t>(pending), std::memory_order_relaxed);
+    return value_type(previous);
+}
+
+}
@@ -0,0 +1,653 @@
+#pragma once
+
+#include <bit> // countr_zero
+#include <cstddef> // size_t ptrdiff_t byte
+#include <cstdint> // int8_t uint32_t uint64_t
+#include <functional> // hash equal_to
+#include <initializer_list> // initializer_list
+#include <iterator> // forward_iterator_tag
+#include <memory> // allocator allocator_traits
+#include <new> // launder
+#include <ranges> // sized_range size
+#include <stdexcept> // out_of_range invalid_argument
+#include <tuple> // forward_as_tuple
+#include <type_traits> // is_nothrow_move_constructible_v remove_const_t
+#include <utility> // pair piecewise_construct move forward exchange swap
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+#include "Relocation.hpp"
+#include "Vector.hpp"
+
+namespace yadej {
+
+namespace hash {
+
+// One control byte per slot: empty, deleted, or the 7 low bits of the hash
+// of a full slot (h2). The sign bit tells a free slot from a full one.
+using ctrl_t = std::int8_t;
+inline constexpr ctrl_t empty = -128;
+inline constexpr ctrl_t deleted = -2;
+
+// Slots probed together, the control bytes of a group are one SSE2 load
+inline constexpr std::size_t group_width = 16;
+
+// std::hash of an integer is the integer, the bits are spread before use
+inline std::size_t mix(std::size_t hash) noexcept{
+    std::uint64_t product = hash;
+    product *= 0x9E3779B97F4A7C15ull;
+    return product ^ (product >> 32);
+}
+
+inline ctrl_t h2(std::size_t hash) noexcept{
+    return static_cast<ctrl_t>(hash & 0x7F);
+}
+
+inline std::size_t h1(std::size_t hash) noexcept{
+    return hash >> 7;
+}
+
+// Bit i of a mask is set when slot i of the group matches
+class Group {
+public:
+    explicit Group(const ctrl_t* ctrl) noexcept
+#ifdef __SSE2__
+        : m_ctrl(_mm_loadu_si128(reinterpret_cast<const __m128i*>(ctrl))){
+    }
+
+    std::uint32_t match(ctrl_t h2) const noexcept{
+        return static_cast<std::uint32_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(m_ctrl, _mm_set1_epi8(h2))));
+    }
+
+    std::uint32_t match_empty() const noexcept{
+        return match(empty);
+    }
+
+    // Empty or deleted
+    std::uint32_t match_free() const noexcept{
+        return static_cast<std::uint32_t>(_mm_movemask_epi8(m_ctrl));
+    }
+
+private:
+    __m128i m_ctrl;
+#else
+        : m_ctrl(ctrl){
+    }
+
+    std::uint32_t match(ctrl_t h2) const noexcept{
+        std::uint32_t mask = 0;
+        for(std::size_t i=0; i < group_width; ++i)
+            mask |= static_cast<std::uint32_t>(m_ctrl[i] == h2) << i;
+        return mask;
+    }
+
+    std::uint32_t match_empty() const noexcept{
+        return match(empty);
+    }
+
+    std::uint32_t match_free() const noexcept{
+        std::uint32_t mask = 0;
+        for(std::size_t i=0; i < group_width; ++i)
+            mask |= static_cast<std::uint32_t>(m_ctrl[i] < 0) << i;
+        return mask;
+    }
+
+private:
+    const ctrl_t* m_ctrl;
+#endif
+};
+
+}
+
+// Forward iterator over the full slots of a FlatHashMap
+template<class Owner, class Value>
+class flat_hash_iterator {
+    public:
+    using iterator_category = std::forward_iterator_tag;
+    using difference_type = std::ptrdiff_t;
+    using value_type = typename std::remove_const_t<Owner>::value_type;
+    using pointer = Value*;
+    using reference = Value&;
+
+    constexpr flat_hash_iterator() = default;
+
+    flat_hash_iterator( Owner* owner, std::size_t index): m_owner(owner), m_index(index){
+        skip_free();
+    }
+
+    // iterator to const_iterator
+    template<class OtherOwner, class OtherValue> requires std::is_same_v<const OtherOwner, Owner>
+    flat_hash_iterator( const flat_hash_iterator<OtherOwner, OtherValue>& other)
+        : m_owner(other.owner()), m_index(other.index()){
+    }
+
+    flat_hash_iterator& operator++(){
+        ++m_index;
+        skip_free();
+        return *this;
+    }
+    flat_hash_iterator operator++(int){
+        flat_hash_iterator temp = *this;
+        ++*this;
+        return temp;
+    }
+
+    reference operator*() const {
+        return *m_owner->slot(m_index);
+    }
+
+    pointer operator->() const {
+        return m_owner->slot(m_index);
+    }
+
+    Owner* owner() const {
+        return m_owner;
+    }
+
+    std::size_t index() const {
+        return m_index;
+    }
+
+    friend bool operator==(const flat_hash_iterator& l_arg, const flat_hash_iterator& r_arg){
+        return l_arg.m_index == r_arg.m_index;
+    }
+
+    friend bool operator!=(const flat_hash_iterator& l_arg, const flat_hash_iterator& r_arg){
+        return !(l_arg == r_arg);
+    }
+
+private:
+    void skip_free(){
+        while( m_index < m_owner->capacity() && m_owner->m_ctrl[m_index] < 0)
+            ++m_index;
+    }
+
+    Owner* m_owner{nullptr};
+    std::size_t m_index{0};
+};
+
+// Open addressing hash map for hot lookup and dedup loops: no node per
+// element, the pairs live in one array of slots and a lookup reads one
+// group of 16 control bytes at a time, compared with the 7 bit tag of the
+// hash in a couple of SSE2 instructions (the Swiss table layout).
+//
+// The control bytes and the slots are two Vectors using the Allocator, the
+// probe sequence goes over groups, quadratic in the number of groups.
+// The table doubles when the slots in use (full or deleted) would go over
+// max_load_factor. A rehash relocates the pairs with yadej::relocate, a
+// memmove for trivially relocatable keys and values.
+//
+// Iterators and references are invalidated by any insertion that grows
+// the table, erasing does not move the other elements.
+//
+//     yadej::FlatHashMap<std::uint64_t, std::uint32_t> seen;
+//     seen.reserve(expected);
+//     if( seen.try_emplace(id, row).second)
+//         keep(row);
+template<class Key,
+         class T,
+         class Hash = std::hash<Key>,
+         class KeyEqual = std::equal_to<Key>,
+         class Allocator = std::allocator<std::pair<const Key, T>>>
+class FlatHashMap {
+public:
+    using key_type = Key;
+    using mapped_type = T;
+    using value_type = std::pair<const Key, T>;
+    using size_type = std::size_t;
+    using difference_type = std::ptrdiff_t;
+    using hasher = Hash;
+    using key_equal = KeyEqual;
+    using allocator_type = Allocator;
+    using reference = value_type&;
+    using const_reference = const value_type&;
+    using iterator = flat_hash_iterator<FlatHashMap, value_type>;
+    using const_iterator = flat_hash_iterator<const FlatHashMap, const value_type>;
+
+    static constexpr float default_max_load_factor = 0.875f;
+
+    FlatHashMap() = default;
+    explicit FlatHashMap( size_type count, const Hash& hash = Hash(), const KeyEqual& equal = KeyEqual(),
+                          const Allocator& alloc = Allocator());
+    FlatHashMap( std::initializer_list<value_type> init, const Hash& hash = Hash(), const KeyEqual& equal = KeyEqual(),
+                 const Allocator& alloc = Allocator());
+    template<container_compatible_range<value_type> Range>
+    FlatHashMap( from_range_t, Range&& range, const Hash& hash = Hash(), const KeyEqual& equal = KeyEqual(),
+                 const Allocator& alloc = Allocator());
+    FlatHashMap(const FlatHashMap& other);
+    FlatHashMap(FlatHashMap&& other) noexcept;
+    FlatHashMap& operator=(const FlatHashMap& other);
+    FlatHashMap& operator=(FlatHashMap&& other) noexcept;
+    ~FlatHashMap();
+
+    allocator_type get_allocator() const{ return allocator_type(m_slots.get_allocator()); }
+
+    // Element access
+    T& at(const Key& key);
+    const T& at(const Key& key) const;
+    T& operator[](const Key& key){ return try_emplace(key).first->second; }
+    T& operator[](Key&& key){ return try_emplace(std::move(key)).first->second; }
+
+    iterator begin(){ return iterator(this, 0); }
+    const_iterator begin() const{ return const_iterator(this, 0); }
+    iterator end(){ return iterator(this, capacity()); }
+    const_iterator end() const{ return const_iterator(this, capacity()); }
+    const_iterator cbegin() const{ return begin(); }
+    const_iterator cend() const{ return end(); }
+
+    // Capacity
+    bool empty() const noexcept{ return m_size == 0; }
+    size_type size() const noexcept{ return m_size; }
+    // Number of slots, a multiple of hash::group_width
+    size_type capacity() const noexcept{ return m_ctrl.size(); }
+    float load_factor() const noexcept;
+    float max_load_factor() const noexcept{ return m_max_load_factor; }
+    // Between 0 and 1 excluded, the table is rehashed to match it
+    void max_load_factor(float ml);
+    // Room for count elements without rehash
+    void reserve(size_type count);
+
+    // Lookup
+    iterator find(const Key& key);
+    const_iterator find(const Key& key) const;
+    bool contains(const Key& key) const{ return find_position(key, hash_of(key)) != npos; }
+    size_type count(const Key& key) const{ return contains(key) ? 1 : 0; }
+
+    // Modifiers, an existing key keeps its value
+    template<class... Args>
+    std::pair<iterator, bool> try_emplace(const Key& key, Args&&... args){ return emplace_key(key, std::forward<Args>(args)...); }
+    template<class... Args>
+    std::pair<iterator, bool> try_emplace(Key&& key, Args&&... args){ return emplace_key(std::move(key), std::forward<Args>(args)...); }
+    std::pair<iterator, bool> insert(const value_type& value){ return emplace_key(value.first, value.second); }
+    std::pair<iterator, bool> insert(value_type&& value){ return emplace_key(value.first, std::move(value.second)); }
+    template<container_compatible_range<value_type> Range>
+    void insert_range(Range&& range);
+    size_type erase(const Key& key);
+    // Iterator to the next element
+    iterator erase(const_iterator pos);
+    // Capacity is kept
+    void clear() noexcept;
+
+    hasher hash_function() const{ return m_hash; }
+    key_equal key_eq() const{ return m_equal; }
+
+    void swap(FlatHashMap& other) noexcept;
+    friend void swap(FlatHashMap& l_arg, FlatHashMap& r_arg) noexcept{ l_arg.swap(r_arg); }
+
+private:
+    template<class, class>
+    friend class flat_hash_iterator;
+
+    struct Slot {
+        alignas(value_type) std::byte bytes[sizeof(value_type)];
+    };
+
+    using traits = std::allocator_traits<Allocator>;
+    using value_allocator = typename traits::template rebind_alloc<value_type>;
+    using value_traits = std::allocator_traits<value_allocator>;
+    using ctrl_vector = Vector<hash::ctrl_t, typename traits::template rebind_alloc<hash::ctrl_t>>;
+    using slot_vector = Vector<Slot, typename traits::template rebind_alloc<Slot>>;
+
+    static constexpr size_type npos = static_cast<size_type>(-1);
+
+    value_type* slot(size_type index) noexcept{
+        return std::launder(reinterpret_cast<value_type*>(m_slots[index].bytes));
+    }
+    const value_type* slot(size_type index) const noexcept{
+        return std::launder(reinterpret_cast<const value_type*>(m_slots[index].bytes));
+    }
+
+    size_type hash_of(const Key& key) const{ return hash::mix(m_hash(key)); }
+    // Slots that can be used (full or deleted) in a table of capacity slots,
+    // one is always left empty so that every probe ends
+    size_type growth_limit(size_type capacity) const noexcept;
+    size_type capacity_for(size_type count) const noexcept;
+
+    // Slot holding key, npos when absent
+    size_type find_position(const Key& key, size_type hash) const;
+    // First free slot of the probe sequence of hash
+    static size_type find_free(const ctrl_vector& ctrl, size_type hash) noexcept;
+
+    template<class K, class... Args>
+    std::pair<iterator, bool> emplace_key(K&& key, Args&&... args);
+    // Move every element to a table of new_capacity slots
+    void rehash(size_type new_capacity);
+    void destroy_elements() noexcept;
+
+    ctrl_vector m_ctrl;
+    slot_vector m_slots;
+    size_type m_size{0};
+    // Empty slots that can still be filled before a rehash
+    size_type m_growth_left{0};
+    float m_max_load_factor{default_max_load_factor};
+    [[no_unique_address]] Hash m_hash;
+    [[no_unique_address]] KeyEqual m_equal;
+};
+
+template<class Key, class T, class Hash, class KeyEqual, class Allocator>
+FlatHashMap<Key, T, Hash, KeyEqual, Allocator>::FlatHashMap( size_type count, const Hash& hash, const KeyEqual& equal,
+                                                            const Allocator& alloc)
+        : m_ctrl(alloc), m_slots(alloc), m_hash(hash), m_equal(equal){
+    reserve(count);
+}
+
+template<class Key, class T, class Hash, class KeyEqual, class Allocator>
+FlatHashMap<Key, T, Hash, KeyEqual, Allocator>::FlatHashMap( std::initializer_list<value_type> init, const Hash& hash,
+                                                            const KeyEqual& equal, const Allocator& alloc)
+        : FlatHashMap(init.size(), hash, equal, alloc){
+    insert_range(init);
+}
+
+template<class Key, class T, class Hash, class KeyEqual, class Allocator>
+template<container_compatible_range<typename FlatHashMap<Key, T, Hash, KeyEqual, Allocator>::value_type> Range>
+FlatHashMap<Key, T, Hash, KeyEqual, Allocator>::FlatHashMap( from_range_t, Range&& range, const Hash& hash,
+                                                            const KeyEqual& equal, const Allocator& alloc)
+        : FlatHashMap(0, hash, equal, alloc){
+    insert_range(std::forward<Range>(range));
+}
+
+template<class Key, class T, class Hash, class KeyEqual, class Allocator>
+FlatHashMap<Key, T, Hash, KeyEqual, Allocator>::FlatHashMap(const FlatHashMap& other)
+        : m_ctrl(other.m_ctrl),
+          m_slots(traits::select_on_container_copy_construction(other.get_allocator())),
+          m_growth_left(other.m_growth_left), m_max_load_factor(other.m_max_load_factor),
+          m_hash(other.m_hash), m_equal(other.m_equal){
+    // Same layout, every element is copied to the slot it has in other
+    m_slots.resize_for_overwrite(other.capacity());
+    value_allocator alloc(m_slots.get_allocator());
+    size_type index = 0;
+    try {
+        for(; index < capacity(); ++index){
+            if( m_ctrl[index] >= 0)
+                value_traits::construct(alloc, slot(index), *other.slot(index));
+        }
+    } catch(...) {
+        for(size_type i=0; i < index; ++i){
+            if( m_ctrl[i] >= 0)
+                value_traits::destroy(alloc, slot(i));
+        }
+        throw;
+    }
+    m_size = other.m_size;
+}
+
+template<class Key, class T, class Hash, class KeyEqual, class Allocator>
+FlatHashMap<Key, T, Hash, KeyEqual, Allocator>::FlatHashMap(FlatHashMap&& other) noexcept
+        : m_ctrl(std::move(other.m_ctrl)), m_slots(std::move(other.m_slots)),
+          m_size(std::exchange(other.m_size, 0)), m_growth_left(std::exchange(other.m_growth_left, 0)),
+          m_max_load_factor(other.m_max_load_factor), m_hash(other.m_hash), m_equal(other.m_equal){
+}
+
+template<class Key, class T, class Hash, class KeyEqual, class Allocator>
+FlatHashMap<Key, T, Hash, KeyEqual, Allocator>& FlatHashMap<Key, T, Hash, KeyEqual, Allocator>::operator=(const FlatHashMap& other){
+    if( this != &other){
+        FlatHashMap copy(other);
+        swap(copy);
+    }
+    return *this;
+}
+
+template<class Key, class T, class Hash, class KeyEqual, class Allocator>
+FlatHashMap<Key, T, Hash, KeyEqual, Allocator>& FlatHashMap<Key, T, Hash, KeyEqual, Allocator>::operator=(FlatHashMap&& other) noexcept{
+    if( this != &other){
+        FlatHashMap moved(std::move(other));
+        swap(moved);
+    }
+    return *this;
+}
+
+template<class Key, class T, class Hash, class KeyEqual, class Allocator>
+FlatHashMap<Key, T, Hash, KeyEqual, Allocator>::~FlatHashMap(){
+    destroy_elements();
+}
+
+template<class Key, class T, class Hash, class KeyEqual, class Allocator>
+T& FlatHashMap<Key, T, Hash, KeyEqual, Allocator>::at(const Key& key){
+    const size_type position = find_position(key, hash_of(key));
+    if( position == npos)
+        throw std::out_of_range("Key not found");
+    return slot(position)->second;
+}
+
+template<class Key, class T, class Hash, class KeyEqual, class Allocator>
+const T& FlatHashMap<Key, T, Hash, KeyEqual, Allocator>::at(const Key& key) const{
+    const size_type position = find_position(key, hash_of(key));
+    if( position == npos)
+        throw std::out_of_range("Key not found");
+    return slot(position)->second;
+}
+
+template<class Key, class T, class Hash, class KeyEqual, class Allocator>
+float FlatHashMap<Key, T, Hash, KeyEqual, Allocator>::load_factor() const noexcept{
+    return capacity() == 0 ? 0.0f : static_cast<float>(m_size) / static_cast<float>(capacity());
+}
+
+template<class Key, class T, class Hash, class KeyEqual, class Allocator>
+void FlatHashMap<Key, T, Hash, KeyEqual, Allocator>::max_load_factor(float ml){
+    if( !(ml > 0.0f && ml < 1.0f))
+        throw std::invalid_argument("max_load_factor must be between 0 and 1");
+    m_max_load_factor = ml;
+    if( capacity() != 0)
+        rehash(capacity_for(m_size));
+}
+
+template<class Key, class T, class Hash, class KeyEqual, class Allocator>
+void FlatHashMap<Key, T, Hash, KeyEqual, Allocator>::reserve(size_type count){
+    if( count > m_size + m_growth_left)
+        rehash(capacity_for(count));
+}
+
+template<class Key, class T, class Hash, class KeyEqual, class Allocator>
+typename FlatHashMap<Key, T, Hash, KeyEqual, Allocator>::iterator FlatHashMap<Key, T, Hash, KeyEqual, Allocator>::find(const Key& key){
+    const size_type position = find_position(key, hash_of(key));
+    return position == npos ? end() : iterator(this, position);
+}
+
+template<class Key, class T, class Hash, class KeyEqual, class Allocator>
+typename FlatHashMap<Key, T, Hash, KeyEqual, Allocator>::const_iterator FlatHashMap<Key, T, Hash, KeyEqual, Allocator>::find(const Key& key) const{
+    const size_type position = find_position(key, hash_of(key));
+    return position == npos ? end() : const_iterator(this, position);
+}
+
+template<class Key, class T, class Hash, class KeyEqual, class Allocator>
+template<container_compatible_range<typename FlatHashMap<Key, T, Hash, KeyEqual, Allocator>::value_type> Range>
+void FlatHashMap<Key, T, Hash, KeyEqual, Allocator>::insert_range(Range&& range){
+    if constexpr (std::ranges::sized_range<Range>)
+        reserve(m_size + static_cast<size_type>(std::ranges::size(range)));
+    for(auto&& value : range)
+        insert(std::forward<decltype(value)>(value));
+}
+
+template<class Key, class T, class Hash, class KeyEqual, class Allocator>
+typename FlatHashMap<Key, T, Hash, KeyEqual, Allocator>::size_type FlatHashMap<Key, T, Hash, KeyEqual, Allocator>::erase(const Key& key){
+    const size_type position = find_position(key, hash_of(key));
+    if( position == npos)
+        return 0;
+    erase(const_iterator(this, position));
+    return 1;
+}
+
+template<class Key, class T, class Hash, class KeyEqual, class Allocator>
+typename FlatHashMap<Key, T, Hash, KeyEqual, Allocator>::iterator FlatHashMap<Key, T, Hash, KeyEqual, Allocator>::erase(const_iterator pos){
+    const size_type index = pos.index();
+    value_allocator alloc(m_slots.get_allocator());
+    value_traits::destroy(alloc, slot(index));
+    --m_size;
+    // A probe only goes past a group without empty slot: when the group
+    // still has one, no probe goes through this slot and it can be empty
+    const hash::Group group(m_ctrl.data() + index / hash::group_width * hash::group_width);
+    if( group.match_empty()){
+        m_ctrl[index] = hash::empty;
+        ++m_growth_left;
+    } else {
+        m_ctrl[index] = hash::deleted;
+    }
+    return iterator(this, index + 1);
+}
+
+template<class Key, class T, class Hash, class KeyEqual, class Allocator>
+void FlatHashMap<Key, T, Hash, KeyEqual, Allocator>::clear() noexcept{
+    destroy_elements();
+    for(hash::ctrl_t& ctrl : m_ctrl)
+        ctrl = hash::empty;
+    m_size = 0;
+    m_growth_left = growth_limit(capacity());
+}
+
+template<class Key, class T, class Hash, class KeyEqual, class Allocator>
+void FlatHashMap<Key, T, Hash, KeyEqual, Allocator>::swap(FlatHashMap& other) noexcept{
+    m_ctrl.swap(other.m_ctrl);
+    m_slots.swap(other.m_slots);
+    std::swap(m_size, other.m_size);
+    std::swap(m_growth_left, other.m_growth_left);
+    std::swap(m_max_load_factor, other.m_max_load_factor);
+    std::swap(m_hash, other.m_hash);
+    std::swap(m_equal, other.m_equal);
+}
+
+template<class Key, class T, class Hash, class KeyEqual, class Allocator>
+typename FlatHashMap<Key, T, Hash, KeyEqual, Allocator>::size_type
+FlatHashMap<Key, T, Hash, KeyEqual, Allocator>::growth_limit(size_type capacity) const noexcept{
+    if( capacity == 0)
+        return 0;
+    const auto limit = static_cast<size_type>(static_cast<float>(capacity) * m_max_load_factor);
+    return limit < capacity ? limit : capacity - 1;
+}
+
+template<class Key, class T, class Hash, class KeyEqual, class Allocator>
+typename FlatHashMap<Key, T, Hash, KeyEqual, Allocator>::size_type
+FlatHashMap<Key, T, Hash, KeyEqual, Allocator>::capacity_for(size_type count) const noexcept{
+    size_type capacity = hash::group_width;
+    while( growth_limit(capacity) < count)
+        capacity *= 2;
+    return capacity;
+}
+
+template<class Key, class T, class Hash, class KeyEqual, class Allocator>
+typename FlatHashMap<Key, T, Hash, KeyEqual, Allocator>::size_type
+FlatHashMap<Key, T, Hash, KeyEqual, Allocator>::find_position(const Key& key, size_type hash) const{
+    if( m_size == 0)
+        return npos;
+    const size_type group_mask = capacity() / hash::group_width - 1;
+    const hash::ctrl_t tag = hash::h2(hash);
+    size_type group = hash::h1(hash) & group_mask;
+    for(size_type step=1; ; ++step){
+        const size_type first = group * hash::group_width;
+        const hash::Group control(m_ctrl.data() + first);
+        for(std::uint32_t match = control.match(tag); match != 0; match &= match - 1){
+            const size_type index = first + static_cast<size_type>(std::countr_zero(match));
+            if( m_equal(slot(index)->first, key))
+                return index;
+        }
+        if( control.match_empty())
+            return npos;
+        group = (group + step) & group_mask;
+    }
+}
+
+template<class Key, class T, class Hash, class KeyEqual, class Allocator>
+typename FlatHashMap<Key, T, Hash, KeyEqual, Allocator>::size_type
+FlatHashMap<Key, T, Hash, KeyEqual, Allocator>::find_free(const ctrl_vector& ctrl, size_type hash) noexcept{
+    const size_type group_mask = ctrl.size() / hash::group_width - 1;
+    size_type group = hash::h1(hash) & group_mask;
+    for(size_type step=1; ; ++step){
+        const size_type first = group * hash::group_width;
+        const std::uint32_t match = hash::Group(ctrl.data() + first).match_free();
+        if( match != 0)
+            return first + static_cast<size_type>(std::countr_zero(match));
+        group = (group + step) & group_mask;
+    }
+}
+
+template<class Key, class T, class Hash, class KeyEqual, class Allocator>
+template<class K, class... Args>
+std::pair<typename FlatHashMap<Key, T, Hash, KeyEqual, Allocator>::iterator, bool>
+FlatHashMap<Key, T, Hash, KeyEqual, Allocator>::emplace_key(K&& key, Args&&... args){
+    const size_type hash = hash_of(key);
+    const size_type found = find_position(key, hash);
+    if( found != npos)
+        return {iterator(this, found), false};
+
+    if( m_growth_left == 0){
+        // Mostly deleted slots: cleaned at the same size, else doubled
+        const size_type limit = growth_limit(capacity());
+        rehash(capacity() != 0 && m_size < limit / 2 ? capacity() : capacity_for(limit + 1));
+    }
+    const size_type index = find_free(m_ctrl, hash);
+    value_allocator alloc(m_slots.get_allocator());
+    value_traits::construct(alloc, slot(index), std::piecewise_construct,
+                            std::forward_as_tuple(std::forward<K>(key)),
+                            std::forward_as_tuple(std::forward<Args>(args)...));
+    if( m_ctrl[index] == hash::empty)
+        --m_growth_left;
+    m_ctrl[index] = hash::h2(hash);
+    ++m_size;
+    return {iterator(this, index), true};
+}
+
+template<class Key, class T, class Hash, class KeyEqual, class Allocator>
+void FlatHashMap<Key, T, Hash, KeyEqual, Allocator>::rehash(size_type new_capacity){
+    ctrl_vector ctrl(new_capacity, hash::empty, m_ctrl.get_allocator());
+    slot_vector slots(m_slots.get_allocator());
+    slots.resize_for_overwrite(new_capacity);
+    value_allocator alloc(m_slots.get_allocator());
+    const auto target = [&slots](size_type index){
+        return std::launder(reinterpret_cast<value_type*>(slots[index].bytes));
+    };
+
+    if constexpr (is_trivially_relocatable_v<value_type> || std::is_nothrow_move_constructible_v<value_type>){
+        // Nothing throws but the hash, computed for every element first
+        Vector<size_type> positions;
+        positions.reserve(m_size);
+        for(size_type index=0; index < capacity(); ++index){
+            if( m_ctrl[index] < 0)
+                continue;
+            const size_type hash = hash_of(slot(index)->first);
+            const size_type position = find_free(ctrl, hash);
+            ctrl[position] = hash::h2(hash);
+            positions.push_back(position);
+        }
+        size_type moved = 0;
+        for(size_type index=0; index < capacity(); ++index){
+            if( m_ctrl[index] >= 0)
+                relocate(alloc, slot(index), 1, target(positions[moved++]));
+        }
+    } else {
+        // Copies for the strong guarantee, the old elements go at the end
+        size_type index = 0;
+        try {
+            for(; index < capacity(); ++index){
+                if( m_ctrl[index] < 0)
+                    continue;
+                const size_type hash = hash_of(slot(index)->first);
+                const size_type position = find_free(ctrl, hash);
+                value_traits::construct(alloc, target(position), std::move_if_noexcept(*slot(index)));
+                ctrl[position] = hash::h2(hash);
+            }
+        } catch(...) {
+            for(size_type position=0; position < new_capacity; ++position){
+                if( ctrl[position] >= 0)
+                    value_traits::destroy(alloc, target(position));
+            }
+            throw;
+        }
+        destroy_elements();
+    }
+
+    m_ctrl.swap(ctrl);
+    m_slots.swap(slots);
+    m_growth_left = growth_limit(new_capacity) - m_size;
+}
+
+template<class Key, class T, class Hash, class KeyEqual, class Allocator>
+void FlatHashMap<Key, T, Hash, KeyEqual, Allocator>::destroy_elements() noexcept{
+    if constexpr (!std::is_trivially_destructible_v<value_type>){
+        value_allocator alloc(m_slots.get_allocator());
+        for(size_type index=0; index < capacity(); ++index){
+            if( m_ctrl[index] >= 0)
+                value_traits::destroy(alloc, slot(index));
+        }
+    }
+}
+
+}
@@ -0,0 +1,501 @@
+#pragma once
+
+#include <algorithm> // stable_sort is_sorted unique equal
+#include <cstddef> // size_t ptrdiff_t
+#include <functional> // less
+#include <initializer_list> // initializer_list
+#include <stdexcept> // out_of_range
+#include <utility> // pair move forward
+#include "SoAVector.hpp"
+#include "Vector.hpp"
+
+namespace yadej {
+
+// Tag of the constructors and insert_batch taking keys already sorted
+// without duplicates
+struct sorted_unique_t {
+    explicit sorted_unique_t() = default;
+};
+inline constexpr sorted_unique_t sorted_unique{};
+
+// Index of the first of the count keys at first not ordered before key.
+// The loop always runs log2(count) times and the comparison only masks the
+// step: no branch to mispredict, a ternary here is compiled to a jump.
+template<class Key, class K, class Compare>
+std::size_t branchless_lower_bound(const Key* first, std::size_t count, const K& key, const Compare& comp){
+    if( count == 0)
+        return 0;
+    std::size_t base = 0;
+    while( count > 1){
+        const std::size_t half = count / 2;
+        const auto before = static_cast<std::size_t>(comp(first[base + half - 1], key));
+        base += half & (std::size_t{0} - before);
+        count -= half;
+    }
+    return base + static_cast<std::size_t>(comp(first[base], key));
+}
+
+// Sorted map for read mostly lookup tables: the keys and the values are in
+// two Vectors, a lookup is a branchless binary search over the keys only.
+// Inserting or erasing one element moves the ones after it, build the map
+// in bulk or with insert_batch instead.
+//
+// Dereferencing an iterator gives a pair of references, as soa_iterator.
+//
+//     yadej::FlatMap<int, std::string> names = {{3, "c"}, {1, "a"}};
+//     names.insert_batch(more_names);
+//     if( auto it = names.find(1); it != names.end())
+//         use((*it).second);
+template<class Key, class T, class Compare = std::less<Key>>
+class FlatMap {
+public:
+    using key_type = Key;
+    using mapped_type = T;
+    using value_type = std::pair<Key, T>;
+    using key_compare = Compare;
+    using size_type = std::size_t;
+    using difference_type = std::ptrdiff_t;
+    using reference = std::pair<const Key&, T&>;
+    using const_reference = std::pair<const Key&, const T&>;
+    using key_container_type = Vector<Key>;
+    using mapped_container_type = Vector<T>;
+    using iterator = soa_iterator<FlatMap, reference>;
+    using const_iterator = soa_iterator<const FlatMap, const_reference>;
+
+    FlatMap() = default;
+    explicit FlatMap( const Compare& comp): m_comp(comp){}
+    // Sorted once, the first of equal keys is kept
+    FlatMap( key_container_type keys, mapped_container_type values, const Compare& comp = Compare());
+    FlatMap( sorted_unique_t, key_container_type keys, mapped_container_type values, const Compare& comp = Compare());
+    FlatMap( std::initializer_list<value_type> init, const Compare& comp = Compare());
+    template<container_compatible_range<value_type> Range>
+    FlatMap( from_range_t, Range&& range, const Compare& comp = Compare());
+
+    // Element access
+    T& at(const Key& key);
+    const T& at(const Key& key) const;
+    T& operator[](const Key& key);
+
+    iterator begin(){ return iterator(this, 0); }
+    const_iterator begin() const{ return const_iterator(this, 0); }
+    iterator end(){ return iterator(this, size()); }
+    const_iterator end() const{ return const_iterator(this, size()); }
+    const_iterator cbegin() const{ return begin(); }
+    const_iterator cend() const{ return end(); }
+
+    bool empty() const noexcept{ return m_keys.empty(); }
+    size_type size() const noexcept{ return m_keys.size(); }
+    void reserve(size_type new_cap);
+    void clear() noexcept;
+
+    // Lookup
+    iterator find(const Key& key);
+    const_iterator find(const Key& key) const;
+    bool contains(const Key& key) const;
+    size_type count(const Key& key) const{ return contains(key) ? 1 : 0; }
+    iterator lower_bound(const Key& key){ return iterator(this, position_of(key)); }
+    const_iterator lower_bound(const Key& key) const{ return const_iterator(this, position_of(key)); }
+
+    // Modifiers, an existing key keeps its value
+    template<class... Args>
+    std::pair<iterator, bool> try_emplace(const Key& key, Args&&... args);
+    std::pair<iterator, bool> insert(const value_type& value){ return try_emplace(value.first, value.second); }
+    std::pair<iterator, bool> insert(value_type&& value){ return try_emplace(value.first, std::move(value.second)); }
+    // Merge a batch with the map in one pass over both, the batch is sorted
+    // first unless it comes with sorted_unique
+    template<container_compatible_range<value_type> Range>
+    void insert_batch(Range&& range);
+    template<container_compatible_range<value_type> Range>
+    void insert_batch(sorted_unique_t, Range&& range);
+    size_type erase(const Key& key);
+    void erase(const_iterator pos);
+
+    const key_container_type& keys() const noexcept{ return m_keys; }
+    const mapped_container_type& values() const noexcept{ return m_values; }
+    key_compare key_comp() const{ return m_comp; }
+
+    void swap(FlatMap& other) noexcept;
+
+    friend bool operator==(const FlatMap& l_arg, const FlatMap& r_arg){
+        return l_arg.m_keys.size() == r_arg.m_keys.size()
+            && std::equal(l_arg.m_keys.begin(), l_arg.m_keys.end(), r_arg.m_keys.begin())
+            && std::equal(l_arg.m_values.begin(), l_arg.m_values.end(), r_arg.m_values.begin());
+    }
+
+private:
+    size_type position_of(const Key& key) const{
+        return branchless_lower_bound(m_keys.data(), m_keys.size(), key, m_comp);
+    }
+    bool found(size_type position, const Key& key) const{
+        return position < m_keys.size() && !m_comp(key, m_keys[position]);
+    }
+    bool equivalent(const Key& l_arg, const Key& r_arg) const{
+        return !m_comp(l_arg, r_arg) && !m_comp(r_arg, l_arg);
+    }
+    // Sort entries by key, keep the first of equal keys
+    void sort_unique(Vector<value_type>& entries) const;
+
+    template<class, class>
+    friend class soa_iterator;
+    // Row of the iterators, not an operator[] to stay apart from the key lookup
+    reference row(size_type position){ return reference(m_keys[position], m_values[position]); }
+    const_reference row(size_type position) const{ return const_reference(m_keys[position], m_values[position]); }
+    void merge(Vector<value_type>&& batch);
+
+    key_container_type m_keys;
+    mapped_container_type m_values;
+    [[no_unique_address]] Compare m_comp;
+};
+
+// Sorted set over one Vector, with the lookups of FlatMap
+template<class Key, class Compare = std::less<Key>>
+class FlatSet {
+public:
+    using key_type = Key;
+    using value_type = Key;
+    using key_compare = Compare;
+    using size_type = std::size_t;
+    using difference_type = std::ptrdiff_t;
+    using reference = const Key&;
+    using const_reference = const Key&;
+    using container_type = Vector<Key>;
+    using const_iterator = iterator_base<const Key>;
+    using iterator = const_iterator;
+
+    FlatSet() = default;
+    explicit FlatSet( const Compare& comp): m_comp(comp){}
+    // Sorted once, the first of equal keys is kept
+    explicit FlatSet( container_type keys, const Compare& comp = Compare());
+    FlatSet( sorted_unique_t, container_type keys, const Compare& comp = Compare());
+    FlatSet( std::initializer_list<Key> init, const Compare& comp = Compare());
+    template<container_compatible_range<Key> Range>
+    FlatSet( from_range_t, Range&& range, const Compare& comp = Compare());
+
+    const_reference operator[](size_type position) const noexcept{ return m_keys[position]; }
+    const Key* data() const noexcept{ return m_keys.data(); }
+
+    const_iterator begin() const noexcept{ return const_iterator(m_keys.data()); }
+    const_iterator end() const noexcept{ return const_iterator(m_keys.data() + m_keys.size()); }
+    const_iterator cbegin() const noexcept{ return begin(); }
+    const_iterator cend() const noexcept{ return end(); }
+
+    bool empty() const noexcept{ return m_keys.empty(); }
+    size_type size() const noexcept{ return m_keys.size(); }
+    void reserve(size_type new_cap){ m_keys.reserve(new_cap); }
+    void clear() noexcept{ m_keys.clear(); }
+
+    // Lookup
+    const_iterator find(const Key& key) const;
+    bool contains(const Key& key) const;
+    size_type count(const Key& key) const{ return contains(key) ? 1 : 0; }
+    const_iterator lower_bound(const Key& key) const{ return begin() + static_cast<difference_type>(position_of(key)); }
+
+    // Modifiers
+    std::pair<const_iterator, bool> insert(Key key);
+    template<container_compatible_range<Key> Range>
+    void insert_batch(Range&& range);
+    template<container_compatible_range<Key> Range>
+    void insert_batch(sorted_unique_t, Range&& range);
+    size_type erase(const Key& key);
+
+    const container_type& keys() const noexcept{ return m_keys; }
+    key_compare key_comp() const{ return m_comp; }
+
+    void swap(FlatSet& other) noexcept;
+
+    friend bool operator==(const FlatSet& l_arg, const FlatSet& r_arg){
+        return l_arg.m_keys.size() == r_arg.m_keys.size()
+            && std::equal(l_arg.m_keys.begin(), l_arg.m_keys.end(), r_arg.m_keys.begin());
+    }
+
+private:
+    size_type position_of(const Key& key) const{
+        return branchless_lower_bound(m_keys.data(), m_keys.size(), key, m_comp);
+    }
+    bool found(size_type position, const Key& key) const{
+        return position < m_keys.size() && !m_comp(key, m_keys[position]);
+    }
+    void sort_unique(Vector<Key>& keys) const;
+    void merge(Vector<Key>&& batch);
+
+    container_type m_keys;
+    [[no_unique_address]] Compare m_comp;
+};
+
+template<class Key, class T, class Compare>
+FlatMap<Key, T, Compare>::FlatMap( key_container_type keys, mapped_container_type values, const Compare& comp)
+        : m_comp(comp){
+    if( keys.size() != values.size())
+        throw std::length_error("Keys and values of different sizes");
+    Vector<value_type> entries;
+    entries.reserve(keys.size());
+    for(size_type i=0; i < keys.size(); ++i)
+        entries.emplace_back(std::move(keys[i]), std::move(values[i]));
+    sort_unique(entries);
+    merge(std::move(entries));
+}
+
+template<class Key, class T, class Compare>
+FlatMap<Key, T, Compare>::FlatMap( sorted_unique_t, key_container_type keys, mapped_container_type values, const Compare& comp)
+        : m_keys(std::move(keys)), m_values(std::move(values)), m_comp(comp){
+    if( m_keys.size() != m_values.size())
+        throw std::length_error("Keys and values of different sizes");
+}
+
+template<class Key, class T, class Compare>
+FlatMap<Key, T, Compare>::FlatMap( std::initializer_list<value_type> init, const Compare& comp)
+        : m_comp(comp){
+    insert_batch(init);
+}
+
+template<class Key, class T, class Compare>
+template<container_compatible_range<typename FlatMap<Key, T, Compare>::value_type> Range>
+FlatMap<Key, T, Compare>::FlatMap( from_range_t, Range&& range, const Compare& comp)
+        : m_comp(comp){
+    insert_batch(std::forward<Range>(range));
+}
+
+template<class Key, class T, class Compare>
+T& FlatMap<Key, T, Compare>::at(const Key& key){
+    const size_type position = position_of(key);
+    if( !found(position, key))
+        throw std::out_of_range("Key not found");
+    return m_values[position];
+}
+
+template<class Key, class T, class Compare>
+const T& FlatMap<Key, T, Compare>::at(const Key& key) const{
+    const size_type position = position_of(key);
+    if( !found(position, key))
+        throw std::out_of_range("Key not found");
+    return m_values[position];
+}
+
+template<class Key, class T, class Compare>
+T& FlatMap<Key, T, Compare>::operator[](const Key& key){
+    return m_values[try_emplace(key).first.index()];
+}
+
+template<class Key, class T, class Compare>
+void FlatMap<Key, T, Compare>::reserve(size_type new_cap){
+    m_keys.reserve(new_cap);
+    m_values.reserve(new_cap);
+}
+
+template<class Key, class T, class Compare>
+void FlatMap<Key, T, Compare>::clear() noexcept{
+    m_keys.clear();
+    m_values.clear();
+}
+
+template<class Key, class T, class Compare>
+typename FlatMap<Key, T, Compare>::iterator FlatMap<Key, T, Compare>::find(const Key& key){
+    const size_type position = position_of(key);
+    return found(position, key) ? iterator(this, position) : end();
+}
+
+template<class Key, class T, class Compare>
+typename FlatMap<Key, T, Compare>::const_iterator FlatMap<Key, T, Compare>::find(const Key& key) const{
+    const size_type position = position_of(key);
+    return found(position, key) ? const_iterator(this, position) : end();
+}
+
+template<class Key, class T, class Compare>
+bool FlatMap<Key, T, Compare>::contains(const Key& key) const{
+    return found(position_of(key), key);
+}
+
+template<class Key, class T, class Compare>
+template<class... Args>
+std::pair<typename FlatMap<Key, T, Compare>::iterator, bool> FlatMap<Key, T, Compare>::try_emplace(const Key& key, Args&&... args){
+    const size_type position = position_of(key);
+    if( found(position, key))
+        return {iterator(this, position), false};
+    m_values.emplace(m_values.begin() + static_cast<difference_type>(position), std::forward<Args>(args)...);
+    try {
+        m_keys.insert(m_keys.begin() + static_cast<difference_type>(position), key);
+    } catch(...) {
+        m_values.erase(m_values.begin() + static_cast<difference_type>(position));
+        throw;
+    }
+    return {iterator(this, position), true};
+}
+
+template<class Key, class T, class Compare>
+template<container_compatible_range<typename FlatMap<Key, T, Compare>::value_type> Range>
+void FlatMap<Key, T, Compare>::insert_batch(Range&& range){
+    Vector<value_type> batch(from_range, std::forward<Range>(range));
+    sort_unique(batch);
+    merge(std::move(batch));
+}
+
+template<class Key, class T, class Compare>
+template<container_compatible_range<typename FlatMap<Key, T, Compare>::value_type> Range>
+void FlatMap<Key, T, Compare>::insert_batch(sorted_unique_t, Range&& range){
+    merge(Vector<value_type>(from_range, std::forward<Range>(range)));
+}
+
+template<class Key, class T, class Compare>
+typename FlatMap<Key, T, Compare>::size_type FlatMap<Key, T, Compare>::erase(const Key& key){
+    const size_type position = position_of(key);
+    if( !found(position, key))
+        return 0;
+    erase(const_iterator(this, position));
+    return 1;
+}
+
+template<class Key, class T, class Compare>
+void FlatMap<Key, T, Compare>::erase(const_iterator pos){
+    const auto offset = static_cast<difference_type>(pos.index());
+    m_keys.erase(m_keys.begin() + offset);
+    m_values.erase(m_values.begin() + offset);
+}
+
+template<class Key, class T, class Compare>
+void FlatMap<Key, T, Compare>::swap(FlatMap& other) noexcept{
+    m_keys.swap(other.m_keys);
+    m_values.swap(other.m_values);
+    std::swap(m_comp, other.m_comp);
+}
+
+template<class Key, class T, class Compare>
+void FlatMap<Key, T, Compare>::sort_unique(Vector<value_type>& entries) const{
+    const auto by_key = [this](const value_type& l_arg, const value_type& r_arg){ return m_comp(l_arg.first, r_arg.first); };
+    if( !std::is_sorted(entries.begin(), entries.end(), by_key))
+        std::stable_sort(entries.begin(), entries.end(), by_key);
+    const auto last = std::unique(entries.begin(), entries.end(),
+        [this](const value_type& l_arg, const value_type& r_arg){ return equivalent(l_arg.first, r_arg.first); });
+    entries.erase(last, entries.end());
+}
+
+template<class Key, class T, class Compare>
+void FlatMap<Key, T, Compare>::merge(Vector<value_type>&& batch){
+    if( batch.empty())
+        return;
+    // Both runs are sorted, one pass into new columns
+    key_container_type keys;
+    mapped_container_type values;
+    keys.reserve(m_keys.size() + batch.size());
+    values.reserve(m_keys.size() + batch.size());
+    size_type current = 0;
+    for(value_type& entry : batch){
+        while( current < m_keys.size() && m_comp(m_keys[current], entry.first)){
+            keys.push_back(std::move(m_keys[current]));
+            values.push_back(std::move(m_values[current]));
+            ++current;
+        }
+        // The key already in the map wins
+        if( current < m_keys.size() && !m_comp(entry.first, m_keys[current]))
+            continue;
+        keys.push_back(std::move(entry.first));
+        values.push_back(std::move(entry.second));
+    }
+    for(; current < m_keys.size(); ++current){
+        keys.push_back(std::move(m_keys[current]));
+        values.push_back(std::move(m_values[current]));
+    }
+    m_keys = std::move(keys);
+    m_values = std::move(values);
+}
+
+template<class Key, class Compare>
+FlatSet<Key, Compare>::FlatSet( container_type keys, const Compare& comp)
+        : m_comp(comp){
+    sort_unique(keys);
+    m_keys = std::move(keys);
+}
+
+template<class Key, class Compare>
+FlatSet<Key, Compare>::FlatSet( sorted_unique_t, container_type keys, const Compare& comp)
+        : m_keys(std::move(keys)), m_comp(comp){
+}
+
+template<class Key, class Compare>
+FlatSet<Key, Compare>::FlatSet( std::initializer_list<Key> init, const Compare& comp)
+        : FlatSet(container_type(init), comp){
+}
+
+template<class Key, class Compare>
+template<container_compatible_range<Key> Range>
+FlatSet<Key, Compare>::FlatSet( from_range_t, Range&& range, const Compare& comp)
+        : FlatSet(container_type(from_range, std::forward<Range>(range)), comp){
+}
+
+template<class Key, class Compare>
+typename FlatSet<Key, Compare>::const_iterator FlatSet<Key, Compare>::find(const Key& key) const{
+    const size_type position = position_of(key);
+    return found(position, key) ? begin() + static_cast<difference_type>(position) : end();
+}
+
+template<class Key, class Compare>
+bool FlatSet<Key, Compare>::contains(const Key& key) const{
+    return found(position_of(key), key);
+}
+
+template<class Key, class Compare>
+std::pair<typename FlatSet<Key, Compare>::const_iterator, bool> FlatSet<Key, Compare>::insert(Key key){
+    const size_type position = position_of(key);
+    if( found(position, key))
+        return {begin() + static_cast<difference_type>(position), false};
+    m_keys.insert(m_keys.begin() + static_cast<difference_type>(position), std::move(key));
+    return {begin() + static_cast<difference_type>(position), true};
+}
+
+template<class Key, class Compare>
+template<container_compatible_range<Key> Range>
+void FlatSet<Key, Compare>::insert_batch(Range&& range){
+    Vector<Key> batch(from_range, std::forward<Range>(range));
+    sort_unique(batch);
+    merge(std::move(batch));
+}
+
+template<class Key, class Compare>
+template<container_compatible_range<Key> Range>
+void FlatSet<Key, Compare>::insert_batch(sorted_unique_t, Range&& range){
+    merge(Vector<Key>(from_range, std::forward<Range>(range)));
+}
+
+template<class Key, class Compare>
+typename FlatSet<Key, Compare>::size_type FlatSet<Key, Compare>::erase(const Key& key){
+    const size_type position = position_of(key);
+    if( !found(position, key))
+        return 0;
+    m_keys.erase(m_keys.begin() + static_cast<difference_type>(position));
+    return 1;
+}
+
+template<class Key, class Compare>
+void FlatSet<Key, Compare>::swap(FlatSet& other) noexcept{
+    m_keys.swap(other.m_keys);
+    std::swap(m_comp, other.m_comp);
+}
+
+template<class Key, class Compare>
+void FlatSet<Key, Compare>::sort_unique(Vector<Key>& keys) const{
+    if( !std::is_sorted(keys.begin(), keys.end(), m_comp))
+        std::stable_sort(keys.begin(), keys.end(), m_comp);
+    const auto last = std::unique(keys.begin(), keys.end(),
+        [this](const Key& l_arg, const Key& r_arg){ return !m_comp(l_arg, r_arg) && !m_comp(r_arg, l_arg); });
+    keys.erase(last, keys.end());
+}
+
+template<class Key, class Compare>
+void FlatSet<Key, Compare>::merge(Vector<Key>&& batch){
+    if( batch.empty())
+        return;
+    container_type keys;
+    keys.reserve(m_keys.size() + batch.size());
+    size_type current = 0;
+    for(Key& key : batch){
+        while( current < m_keys.size() && m_comp(m_keys[current], key))
+            keys.push_back(std::move(m_keys[current++]));
+        if( current < m_keys.size() && !m_comp(key, m_keys[current]))
+            continue;
+        keys.push_back(std::move(key));
+    }
+    for(; current < m_keys.size(); ++current)
+        keys.push_back(std::move(m_keys[current]));
+    m_keys = std::move(keys);
+}
+
+}
@@ -0,0 +1,84 @@
+#pragma once
+
+#include <algorithm> // max
+#include <bit> // bit_ceil
+#include <concepts> // same_as
+#include <cstddef> // size_t
+#include <limits> // numeric_limits
+
+namespace yadej {
+
+// A growth policy tells the Vector how many elements to allocate when it
+// needs room for required elements and currently holds capacity slots.
+// capacity is 0 for a fresh allocation (constructors, copy).
+// The result must be at least required.
+template<class Policy>
+concept growth_policy = requires(std::size_t capacity, std::size_t required) {
+    { Policy::template next_capacity<int>(capacity, required) } -> std::same_as<std::size_t>;
+};
+
+namespace growth {
+
+// Round to the next power of two: few reallocations, up to 2x memory
+// and a peak of 3x during the relocation
+struct Doubling {
+    template<class T>
+    static constexpr std::size_t next_capacity(std::size_t capacity, std::size_t required) noexcept{
+        if( required > std::numeric_limits<std::size_t>::max() / 2 + 1)
+            return required;
+        return std::max(std::bit_ceil(required), capacity);
+    }
+};
+
+// Grow by half of the capacity, the sum of the previous blocks
+// eventually becomes big enough to be reused by the allocator
+struct OneAndHalf {
+    template<class T>
+    static constexpr std::size_t next_capacity(std::size_t capacity, std::size_t required) noexcept{
+        if( capacity > std::numeric_limits<std::size_t>::max() / 3 * 2)
+            return required;
+        return std::max(required, capacity + capacity / 2);
+    }
+};
+
+// Grow by a constant number of elements, minimal memory
+// but a linear number of reallocations
+template<std::size_t Increment>
+struct FixedIncrement {
+    static_assert(Increment > 0, "Increment must be strictly positive");
+
+    template<class T>
+    static constexpr std::size_t next_capacity(std::size_t capacity, std::size_t required) noexcept{
+        if( capacity > std::numeric_limits<std::size_t>::max() - Increment)
+            return required;
+        return std::max(required, capacity + Increment);
+    }
+};
+
+// Use Inner then round the buffer size up to a multiple of PageSize bytes
+// once it is at least one page, the tail of the last page is used instead
+// of wasted
+template<std::size_t PageSize = 4096, class Inner = OneAndHalf>
+struct PageAligned {
+    static_assert(std::has_single_bit(PageSize), "PageSize must be a power of two");
+
+    template<class T>
+    static constexpr std::size_t next_capacity(std::size_t capacity, std::size_t required) noexcept{
+        std::size_t new_capacity = Inner::template next_capacity<T>(capacity, required);
+        if( new_capacity > std::numeric_limits<std::size_t>::max() / sizeof(T) - PageSize)
+            return new_capacity;
+
+        std::size_t bytes = new_capacity * sizeof(T);
+        if( bytes < PageSize)
+            return new_capacity;
+        bytes = (bytes + PageSize - 1) & ~(PageSize - 1);
+        return bytes / sizeof(T);
+    }
+};
+
+template<class Inner = OneAndHalf>
+using HugePageAligned = PageAligned<std::size_t{2} << 20, Inner>;
+
+}
+
+}
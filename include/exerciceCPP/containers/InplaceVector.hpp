@@ -0,0 +1,469 @@
+#pragma once
+
+#include <algorithm> // fill_n copy_n
+#include <cstddef> // size_t ptrdiff_t
+#include <initializer_list> // initializer_list
+#include <iterator> // distance next iter_difference_t
+#include <memory> // allocator construct_at destroy_at
+#include <new> // bad_alloc
+#include <stdexcept> // invalid_argument out_of_range
+#include <utility> // forward move
+#include "Iterator.hpp"
+#include "Relocation.hpp"
+#include "Vector.hpp"
+
+namespace yadej {
+
+// Vector of at most Capacity elements stored inside the object.
+// No allocator is ever involved so the whole API works in constant
+// expressions. Going past Capacity throws std::bad_alloc, the try_
+// functions return nullptr instead.
+template<class T, std::size_t Capacity>
+class InplaceVector {
+public:
+
+    // Declaration of type
+    using value_type = T;
+    using size_type = std::size_t;
+    using difference_type = std::ptrdiff_t;
+    using reference = T&;
+    using const_reference = const T&;
+    using pointer = T*;
+    using const_pointer = const T*;
+    // Constructors and Destructors
+    constexpr InplaceVector() noexcept;
+    constexpr InplaceVector( size_type count, const_reference value);
+    constexpr explicit InplaceVector( size_type count);
+    template<class InputIt> requires is_iterator<InputIt>
+    constexpr InplaceVector( InputIt first, InputIt last);
+    constexpr InplaceVector(InplaceVector && other);
+    constexpr InplaceVector(const InplaceVector & other);
+    constexpr InplaceVector( std::initializer_list<T> init);
+    constexpr InplaceVector &operator=(InplaceVector &&);
+    constexpr InplaceVector &operator=(const InplaceVector &);
+    constexpr ~InplaceVector();
+
+    // Element access
+    constexpr reference at(size_type position);
+    constexpr const_reference at(size_type position) const;
+
+    constexpr reference operator[](size_type position);
+    constexpr const_reference operator[](size_type position) const;
+
+    constexpr reference front();
+    constexpr const_reference front() const;
+
+    constexpr reference back();
+    constexpr const_reference back() const;
+
+    constexpr pointer data();
+    constexpr const_pointer data() const;
+
+    // iterator
+    //
+    using iterator = iterator_base<T>;
+    using const_iterator = const iterator_base<T>;
+    constexpr iterator begin();
+    constexpr const_iterator begin() const noexcept;
+    constexpr iterator end();
+    constexpr const_iterator end() const noexcept;
+    constexpr const_iterator cbegin() const noexcept;
+    constexpr const_iterator cend() const noexcept;
+
+    // Container
+    //
+    constexpr bool empty() const noexcept;
+    constexpr size_type size() const noexcept;
+    static constexpr size_type max_size() noexcept { return Capacity; }
+    static constexpr size_type capacity() noexcept { return Capacity; }
+    // Only check new_cap fits, the storage never changes
+    constexpr void reserve( const size_type new_cap);
+    constexpr void shrink_to_fit() noexcept {}
+
+    // Modifier
+    constexpr void clear() noexcept;
+
+    constexpr iterator insert( const_iterator pos, const_reference value);
+    constexpr iterator insert( const_iterator pos, T&& value);
+    constexpr iterator insert( const_iterator pos, size_type count, const_reference value);
+    template<class InputIt> requires is_iterator<InputIt>
+    constexpr iterator insert( const_iterator pos, InputIt first, InputIt last);
+    constexpr iterator insert( const_iterator pos, std::initializer_list<T> ilist);
+    template<class... Args>
+    constexpr iterator emplace( const_iterator pos, Args&&... args);
+    constexpr void erase( const_iterator pos);
+    constexpr void erase( const_iterator first, const_iterator last);
+
+    constexpr void push_back( const_reference value);
+    constexpr void push_back( value_type&& value);
+    template<class... Args>
+    constexpr reference emplace_back( Args&&... args);
+    // Append without throwing, return nullptr when the vector is full
+    constexpr pointer try_push_back( const_reference value);
+    constexpr pointer try_push_back( value_type&& value);
+    template<class... Args>
+    constexpr pointer try_emplace_back( Args&&... args);
+    constexpr void pop_back();
+    constexpr void resize(size_type count);
+    constexpr void resize(size_type count, const_reference value);
+private:
+    // The union leaves the elements uninitialized, they are started
+    // one by one with construct_at
+    union Storage {
+        constexpr Storage() noexcept {}
+        constexpr ~Storage() {}
+        T elements[Capacity == 0 ? 1 : Capacity];
+    };
+    Storage m_storage;
+    size_type m_current_size{0};
+
+    constexpr void destroy_elements(iterator first, iterator last);
+    // Check count more elements fit, throw std::bad_alloc otherwise
+    constexpr void check_room(size_type count) const;
+};
+
+template<class T, std::size_t Capacity>
+constexpr InplaceVector<T, Capacity>::InplaceVector() noexcept{
+}
+
+template<class T, std::size_t Capacity>
+constexpr InplaceVector<T, Capacity>::InplaceVector( size_type count, const_reference value){
+    resize(count, value);
+}
+
+template<class T, std::size_t Capacity>
+constexpr InplaceVector<T, Capacity>::InplaceVector( size_type count){
+    resize(count);
+}
+
+template<class T, std::size_t Capacity>
+template<class InputIt> requires is_iterator<InputIt>
+constexpr InplaceVector<T, Capacity>::InplaceVector( InputIt first, InputIt last){
+    insert(end(), first, last);
+}
+
+template<class T, std::size_t Capacity>
+constexpr InplaceVector<T, Capacity>::InplaceVector(InplaceVector && other){
+    relocate(other.data(), other.m_current_size, data());
+    m_current_size = other.m_current_size;
+    other.m_current_size = 0;
+}
+
+template<class T, std::size_t Capacity>
+constexpr InplaceVector<T, Capacity>::InplaceVector(const InplaceVector & other){
+    std::allocator<T> alloc;
+    construct_range(alloc, data(), other.data(), other.m_current_size);
+    m_current_size = other.m_current_size;
+}
+
+template<class T, std::size_t Capacity>
+constexpr InplaceVector<T, Capacity>::InplaceVector(std::initializer_list<T> init){
+    insert(end(), init.begin(), init.end());
+}
+
+template<class T, std::size_t Capacity>
+constexpr InplaceVector<T, Capacity>& InplaceVector<T, Capacity>::operator=(InplaceVector && other){
+    if( this == &other)
+        return *this;
+
+    clear();
+    relocate(other.data(), other.m_current_size, data());
+    m_current_size = other.m_current_size;
+    other.m_current_size = 0;
+    return *this;
+}
+
+template<class T, std::size_t Capacity>
+constexpr InplaceVector<T, Capacity>& InplaceVector<T, Capacity>::operator=(const InplaceVector& other){
+    if( this == &other)
+        return *this;
+
+    clear();
+    std::allocator<T> alloc;
+    construct_range(alloc, data(), other.data(), other.m_current_size);
+    m_current_size = other.m_current_size;
+    return *this;
+}
+
+template<class T, std::size_t Capacity>
+constexpr InplaceVector<T, Capacity>::~InplaceVector() {
+    destroy_elements(begin(), end());
+}
+
+template<class T, std::size_t Capacity>
+constexpr T& InplaceVector<T, Capacity>::at(size_type position){
+    if( position >= m_current_size )
+        throw std::out_of_range("InplaceVector::at position out of range");
+    return m_storage.elements[position];
+}
+template<class T, std::size_t Capacity>
+constexpr const T& InplaceVector<T, Capacity>::at(size_type position) const{
+    if( position >= m_current_size )
+        throw std::out_of_range("InplaceVector::at position out of range");
+    return m_storage.elements[position];
+}
+
+template<class T, std::size_t Capacity>
+constexpr T& InplaceVector<T, Capacity>::operator[](size_type position){
+    return m_storage.elements[position];
+}
+template<class T, std::size_t Capacity>
+constexpr const T& InplaceVector<T, Capacity>::operator[](size_type position) const{
+    return m_storage.elements[position];
+}
+
+template<class T, std::size_t Capacity>
+constexpr T& InplaceVector<T, Capacity>::front(){
+    return at(0);
+}
+template<class T, std::size_t Capacity>
+constexpr const T& InplaceVector<T, Capacity>::front() const{
+    return at(0);
+}
+
+template<class T, std::size_t Capacity>
+constexpr T& InplaceVector<T, Capacity>::back(){
+    return at(m_current_size - 1);
+}
+template<class T, std::size_t Capacity>
+constexpr const T& InplaceVector<T, Capacity>::back() const{
+    return at(m_current_size - 1);
+}
+
+template<class T, std::size_t Capacity>
+constexpr T* InplaceVector<T, Capacity>::data(){
+    return m_storage.elements;
+}
+template<class T, std::size_t Capacity>
+constexpr const T* InplaceVector<T, Capacity>::data() const{
+    return m_storage.elements;
+}
+
+template<class T, std::size_t Capacity>
+constexpr InplaceVector<T, Capacity>::iterator InplaceVector<T, Capacity>::begin(){
+    return iterator(m_storage.elements);
+}
+
+template<class T, std::size_t Capacity>
+constexpr const InplaceVector<T, Capacity>::iterator InplaceVector<T, Capacity>::begin() const noexcept{
+    return iterator(const_cast<pointer>(m_storage.elements));
+}
+
+template<class T, std::size_t Capacity>
+constexpr InplaceVector<T, Capacity>::iterator InplaceVector<T, Capacity>::end(){
+    return iterator(m_storage.elements + m_current_size);
+}
+
+template<class T, std::size_t Capacity>
+constexpr const InplaceVector<T, Capacity>::iterator InplaceVector<T, Capacity>::end() const noexcept{
+    return iterator(const_cast<pointer>(m_storage.elements) + m_current_size);
+}
+
+template<class T, std::size_t Capacity>
+constexpr const InplaceVector<T, Capacity>::iterator InplaceVector<T, Capacity>::cbegin() const noexcept{
+    return begin();
+}
+
+template<class T, std::size_t Capacity>
+constexpr const InplaceVector<T, Capacity>::iterator InplaceVector<T, Capacity>::cend() const noexcept{
+    return end();
+}
+
+template<class T, std::size_t Capacity>
+constexpr bool InplaceVector<T, Capacity>::empty() const noexcept{
+    return ( m_current_size == 0);
+}
+
+template<class T, std::size_t Capacity>
+constexpr std::size_t InplaceVector<T, Capacity>::size() const noexcept{
+    return m_current_size;
+}
+
+template<class T, std::size_t Capacity>
+constexpr void InplaceVector<T, Capacity>::reserve(const size_type new_cap){
+    if( new_cap > Capacity)
+        throw std::bad_alloc();
+}
+
+template<class T, std::size_t Capacity>
+constexpr void InplaceVector<T, Capacity>::clear() noexcept{
+    destroy_elements(begin(), end());
+    m_current_size = 0;
+}
+
+template<class T, std::size_t Capacity>
+constexpr InplaceVector<T, Capacity>::iterator InplaceVector<T, Capacity>::insert( const_iterator pos, const_reference value){
+    return emplace(pos, value);
+}
+
+template<class T, std::size_t Capacity>
+constexpr InplaceVector<T, Capacity>::iterator InplaceVector<T, Capacity>::insert( const_iterator pos, T&& value){
+    return emplace(pos, std::move(value));
+}
+
+template<class T, std::size_t Capacity>
+constexpr InplaceVector<T, Capacity>::iterator InplaceVector<T, Capacity>::insert( const_iterator pos, size_type count, const_reference value){
+    if( pos < begin() || end() < pos)
+        throw std::invalid_argument("insert position not in container");
+    check_room(count);
+
+    size_type insert_pos = static_cast<size_type>(std::distance(begin(), pos));
+    // value can be an element of the container, keep a copy before shifting
+    value_type copy(value);
+    std::allocator<T> alloc;
+    insert_in_place(alloc, data(), m_current_size, insert_pos, count,
+        [&](pointer dest, size_type, size_type n){ construct_n(alloc, dest, n, copy); },
+        [&](pointer dest, size_type, size_type n){ std::fill_n(dest, n, copy); });
+    return begin() + static_cast<difference_type>(insert_pos);
+}
+
+template<class T, std::size_t Capacity>
+template<class InputIt> requires is_iterator<InputIt>
+constexpr InplaceVector<T, Capacity>::iterator InplaceVector<T, Capacity>::insert( const_iterator pos, InputIt first, InputIt last){
+    if( pos < begin() || end() < pos)
+        throw std::invalid_argument("insert position not in container");
+
+    size_type insert_pos = static_cast<size_type>(std::distance(begin(), pos));
+    size_type size_insert = static_cast<size_type>(std::distance(first, last));
+    check_room(size_insert);
+
+    using step = std::iter_difference_t<InputIt>;
+    std::allocator<T> alloc;
+    insert_in_place(alloc, data(), m_current_size, insert_pos, size_insert,
+        [&](pointer dest, size_type from, size_type n){ construct_range(alloc, dest, std::next(first, static_cast<step>(from)), n); },
+        [&](pointer dest, size_type from, size_type n){ std::copy_n(std::next(first, static_cast<step>(from)), n, dest); });
+    return begin() + static_cast<difference_type>(insert_pos);
+}
+
+template<class T, std::size_t Capacity>
+constexpr InplaceVector<T, Capacity>::iterator InplaceVector<T, Capacity>::insert( const_iterator pos, std::initializer_list<T> ilist){
+    return insert(pos, ilist.begin(), ilist.end());
+}
+
+template<class T, std::size_t Capacity>
+template<class... Args>
+constexpr InplaceVector<T, Capacity>::iterator InplaceVector<T, Capacity>::emplace( const_iterator pos, Args&&... args){
+    if( pos < begin() || end() < pos)
+        throw std::invalid_argument("insert position not in container");
+    check_room(1);
+
+    size_type insert_pos = static_cast<size_type>(std::distance(begin(), pos));
+    if( insert_pos == m_current_size){
+        std::construct_at(data() + m_current_size, std::forward<Args>(args)...);
+        ++m_current_size;
+    } else {
+        // args can refer to an element of the container, build the value before shifting
+        value_type new_value(std::forward<Args>(args)...);
+        std::allocator<T> alloc;
+        insert_in_place(alloc, data(), m_current_size, insert_pos, 1,
+            [&](pointer dest, size_type, size_type){ std::construct_at(dest, std::move(new_value)); },
+            [&](pointer dest, size_type, size_type){ *dest = std::move(new_value); });
+    }
+    return begin() + static_cast<difference_type>(insert_pos);
+}
+
+template<class T, std::size_t Capacity>
+constexpr void InplaceVector<T, Capacity>::erase( const_iterator pos){
+    if( pos < begin() || pos >= end())
+        return;
+
+    size_type erase_pos = static_cast<size_type>(std::distance(begin(), pos));
+    std::allocator<T> alloc;
+    erase_in_place(alloc, data(), m_current_size, erase_pos, 1);
+}
+
+template<class T, std::size_t Capacity>
+constexpr void InplaceVector<T, Capacity>::erase( const_iterator first, const_iterator last){
+    if( first < begin() || first > end() || last < first || last > end())
+        return;
+    size_type erase_pos = static_cast<size_type>(std::distance(begin(), first));
+    size_type erase_count = static_cast<size_type>(std::distance(first, last));
+    std::allocator<T> alloc;
+    erase_in_place(alloc, data(), m_current_size, erase_pos, erase_count);
+}
+
+template<class T, std::size_t Capacity>
+constexpr void InplaceVector<T, Capacity>::push_back( const_reference value){
+    emplace_back(value);
+}
+
+template<class T, std::size_t Capacity>
+constexpr void InplaceVector<T, Capacity>::push_back( value_type&& value){
+    emplace_back(std::move(value));
+}
+
+template<class T, std::size_t Capacity>
+template<class... Args>
+constexpr T& InplaceVector<T, Capacity>::emplace_back(Args&&... args){
+    check_room(1);
+    return *try_emplace_back(std::forward<Args>(args)...);
+}
+
+template<class T, std::size_t Capacity>
+constexpr T* InplaceVector<T, Capacity>::try_push_back( const_reference value){
+    return try_emplace_back(value);
+}
+
+template<class T, std::size_t Capacity>
+constexpr T* InplaceVector<T, Capacity>::try_push_back( value_type&& value){
+    return try_emplace_back(std::move(value));
+}
+
+template<class T, std::size_t Capacity>
+template<class... Args>
+constexpr T* InplaceVector<T, Capacity>::try_emplace_back(Args&&... args){
+    if( m_current_size == Capacity)
+        return nullptr;
+
+    pointer new_element = std::construct_at(data() + m_current_size, std::forward<Args>(args)...);
+    ++m_current_size;
+    return new_element;
+}
+
+template<class T, std::size_t Capacity>
+constexpr void InplaceVector<T, Capacity>::pop_back(){
+    if(m_current_size == 0)
+        return;
+
+    std::destroy_at(data() + m_current_size - 1);
+    m_current_size--;
+}
+
+template<class T, std::size_t Capacity>
+constexpr void InplaceVector<T, Capacity>::resize(size_type count){
+    if( count < m_current_size){
+        destroy_elements(begin() + static_cast<difference_type>(count), end());
+    } else {
+        check_room(count - m_current_size);
+        std::allocator<T> alloc;
+        construct_n(alloc, data() + m_current_size, count - m_current_size);
+    }
+    m_current_size = count;
+}
+
+template<class T, std::size_t Capacity>
+constexpr void InplaceVector<T, Capacity>::resize(size_type count, const_reference value){
+    if( count < m_current_size){
+        destroy_elements(begin() + static_cast<difference_type>(count), end());
+    } else {
+        check_room(count - m_current_size);
+        std::allocator<T> alloc;
+        construct_n(alloc, data() + m_current_size, count - m_current_size, value);
+    }
+    m_current_size = count;
+}
+
+template<class T, std::size_t Capacity>
+constexpr void InplaceVector<T, Capacity>::destroy_elements(iterator first, iterator last){
+    for(; first != last; first++){
+        std::destroy_at(first.get());
+    }
+}
+
+template<class T, std::size_t Capacity>
+constexpr void InplaceVector<T, Capacity>::check_room(size_type count) const{
+    if( count > Capacity - m_current_size)
+        throw std::bad_alloc();
+}
+
+}
@@ -2,117 +2,247 @@
 
 #include <cstddef>
 #include <iterator>
+#include <type_traits>
 
 template<class T>
 class iterator_base {
     public:
     using iterator_base_category = std::random_access_iterator_tag;
+    // The elements are contiguous, std::to_address goes through operator->
+    using iterator_concept = std::contiguous_iterator_tag;
     using difference_type = std::ptrdiff_t; 
     using value_type = T;
     using pointer = T*; 
     using reference =  T&;
 
-    iterator_base(): m_curr(nullptr){
+    constexpr iterator_base(): m_curr(nullptr){
     }
 
-    iterator_base( pointer it): m_curr(it){
+    constexpr iterator_base( pointer it): m_curr(it){
     }
 
 
-    iterator_base& operator++(){
+    constexpr iterator_base& operator++(){
         ++m_curr;
         return *this;
     }
-    iterator_base operator++(int){
+    constexpr iterator_base operator++(int){
         iterator_base temp = *this;
         ++m_curr;
         return temp;
     }
     
-    iterator_base& operator--(){
+    constexpr iterator_base& operator--(){
         --m_curr;
         return *this;
     }
-    iterator_base operator--(int){
+    constexpr iterator_base operator--(int){
         iterator_base temp = *this;
         --m_curr;
         return temp;
     }
     
-    iterator_base& operator+=(difference_type n){
+    constexpr iterator_base& operator+=(difference_type n){
         m_curr += n;
         return *this;
     }
 
-    iterator_base& operator-=(difference_type n){
+    constexpr iterator_base& operator-=(difference_type n){
         m_curr -= n;
         return *this;
     }
 
-    reference operator*() const {
+    constexpr reference operator*() const {
         return *m_curr;
     }
 
-    pointer operator->() const {
+    constexpr pointer operator->() const {
         return m_curr;
     }
     
-    reference operator[](difference_type n) const {
+    constexpr reference operator[](difference_type n) const {
         return *(m_curr + n);
     }
 
-    pointer get() const {
+    constexpr pointer get() const {
         return m_curr;
     }
 
-    friend bool operator==(const iterator_base& l_arg, const iterator_base& r_arg){
+    friend constexpr bool operator==(const iterator_base& l_arg, const iterator_base& r_arg){
         return l_arg.m_curr == r_arg.m_curr;
     }
 
-    friend bool operator!=(const iterator_base& l_arg, const iterator_base& r_arg){
+    friend constexpr bool operator!=(const iterator_base& l_arg, const iterator_base& r_arg){
         return !(l_arg == r_arg);
     }
 
-    friend bool operator<(const iterator_base& l_arg, const iterator_base& r_arg){
+    friend constexpr bool operator<(const iterator_base& l_arg, const iterator_base& r_arg){
         return l_arg.m_curr < r_arg.m_curr;
     }
 
-    friend bool operator>(const iterator_base& l_arg, const iterator_base& r_arg){
+    friend constexpr bool operator>(const iterator_base& l_arg, const iterator_base& r_arg){
         return r_arg < l_arg;
     }
 
-    friend bool operator>=(const iterator_base& l_arg, const iterator_base& r_arg){
+    friend constexpr bool operator>=(const iterator_base& l_arg, const iterator_base& r_arg){
         return !(l_arg< r_arg);
     }
 
-    friend bool operator<=(const iterator_base& l_arg, const iterator_base& r_arg){
+    friend constexpr bool operator<=(const iterator_base& l_arg, const iterator_base& r_arg){
         return !(r_arg < l_arg);
     }
 
-    friend iterator_base operator+(const iterator_base& it, difference_type n){
+    friend constexpr iterator_base operator+(const iterator_base& it, difference_type n){
         iterator_base temp = it;
         temp += n;
         return temp;
     }
 
-    friend iterator_base operator+(difference_type n, const iterator_base& it){
+    friend constexpr iterator_base operator+(difference_type n, const iterator_base& it){
         return it + n;
     }
 
-    friend iterator_base operator-(const iterator_base& it, difference_type n){
+    friend constexpr iterator_base operator-(const iterator_base& it, difference_type n){
         iterator_base temp = it;
         temp -= n;
         return temp;
     }
     
-    friend iterator_base operator-(difference_type n, const iterator_base& it){
+    friend constexpr iterator_base operator-(difference_type n, const iterator_base& it){
         return it - n;
     }
 
-    friend difference_type operator-(const iterator_base& l_arg, const iterator_base& r_arg){
+    friend constexpr difference_type operator-(const iterator_base& l_arg, const iterator_base& r_arg){
         return l_arg.m_curr - r_arg.m_curr;
     }
 
 private:
     pointer m_curr{nullptr};
 };
+
+// Random access iterator over elements stored in chunks of 1 << ChunkShift
+// elements, chunks[index >> ChunkShift][index & mask]. Same interface as
+// iterator_base. It points into the chunk table, so like a std::deque
+// iterator it is invalidated when the table grows, the elements are not.
+template<class T, std::size_t ChunkShift>
+class segmented_iterator {
+    public:
+    using iterator_base_category = std::random_access_iterator_tag;
+    using iterator_category = std::random_access_iterator_tag;
+    using difference_type = std::ptrdiff_t;
+    using value_type = std::remove_const_t<T>;
+    using pointer = T*;
+    using reference = T&;
+    using chunk_pointer = value_type* const*;
+
+    static constexpr std::size_t chunk_mask = (std::size_t{1} << ChunkShift) - 1;
+
+    constexpr segmented_iterator() = default;
+
+    constexpr segmented_iterator( chunk_pointer chunks, std::size_t index): m_chunks(chunks), m_index(index){
+    }
+
+    // iterator to const_iterator
+    template<class U> requires std::is_same_v<const U, T>
+    constexpr segmented_iterator( const segmented_iterator<U, ChunkShift>& other)
+        : m_chunks(other.chunks()), m_index(other.index()){
+    }
+
+    constexpr segmented_iterator& operator++(){
+        ++m_index;
+        return *this;
+    }
+    constexpr segmented_iterator operator++(int){
+        segmented_iterator temp = *this;
+        ++m_index;
+        return temp;
+    }
+
+    constexpr segmented_iterator& operator--(){
+        --m_index;
+        return *this;
+    }
+    constexpr segmented_iterator operator--(int){
+        segmented_iterator temp = *this;
+        --m_index;
+        return temp;
+    }
+
+    constexpr segmented_iterator& operator+=(difference_type n){
+        m_index += static_cast<std::size_t>(n);
+        return *this;
+    }
+
+    constexpr segmented_iterator& operator-=(difference_type n){
+        m_index -= static_cast<std::size_t>(n);
+        return *this;
+    }
+
+    constexpr reference operator*() const {
+        return m_chunks[m_index >> ChunkShift][m_index & chunk_mask];
+    }
+
+    constexpr pointer operator->() const {
+        return &**this;
+    }
+
+    constexpr reference operator[](difference_type n) const {
+        return *(*this + n);
+    }
+
+    constexpr chunk_pointer chunks() const {
+        return m_chunks;
+    }
+
+    constexpr std::size_t index() const {
+        return m_index;
+    }
+
+    friend constexpr bool operator==(const segmented_iterator& l_arg, const segmented_iterator& r_arg){
+        return l_arg.m_index == r_arg.m_index;
+    }
+
+    friend constexpr bool operator!=(const segmented_iterator& l_arg, const segmented_iterator& r_arg){
+        return !(l_arg == r_arg);
+    }
+
+    friend constexpr bool operator<(const segmented_iterator& l_arg, const segmented_iterator& r_arg){
+        return l_arg.m_index < r_arg.m_index;
+    }
+
+    friend constexpr bool operator>(const segmented_iterator& l_arg, const segmented_iterator& r_arg){
+        return r_arg < l_arg;
+    }
+
+    friend constexpr bool operator>=(const segmented_iterator& l_arg, const segmented_iterator& r_arg){
+        return !(l_arg< r_arg);
+    }
+
+    friend constexpr bool operator<=(const segmented_iterator& l_arg, const segmented_iterator& r_arg){
+        return !(r_arg < l_arg);
+    }
+
+    friend constexpr segmented_iterator operator+(const segmented_iterator& it, difference_type n){
+        segmented_iterator temp = it;
+        temp += n;
+        return temp;
+    }
+
+    friend constexpr segmented_iterator operator+(difference_type n, const segmented_iterator& it){
+        return it + n;
+    }
+
+    friend constexpr segmented_iterator operator-(const segmented_iterator& it, difference_type n){
+        segmented_iterator temp = it;
+        temp -= n;
+        return temp;
+    }
+
+    friend constexpr difference_type operator-(const segmented_iterator& l_arg, const segmented_iterator& r_arg){
+        return static_cast<difference_type>(l_arg.m_index - r_arg.m_index);
+    }
+
+private:
+    chunk_pointer m_chunks{nullptr};
+    std::size_t m_index{0};
+};
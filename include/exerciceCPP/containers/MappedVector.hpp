@@ -0,0 +1,523 @@
+#pragma once
+
+#include <cerrno> // errno
+#include <cstddef> // size_t ptrdiff_t
+#include <cstring> // memmove
+#include <filesystem> // path
+#include <iterator> // distance
+#include <limits> // numeric_limits -> max
+#include <stdexcept> // invalid_argument out_of_range length_error logic_error
+#include <system_error> // system_error generic_category
+#include <type_traits> // is_trivially_copyable_v
+#include <utility> // exchange
+#include <fcntl.h> // open
+#include <sys/mman.h> // mmap mremap munmap madvise msync
+#include <sys/stat.h> // fstat
+#include <unistd.h> // ftruncate close
+#include "GrowthPolicy.hpp"
+#include "Iterator.hpp"
+#include "Vector.hpp"
+
+namespace yadej {
+
+// Hints given to the kernel about how the mapping is going to be read
+enum class MapAdvice {
+    normal,
+    sequential,
+    random,
+    willneed,
+    dontneed,
+    hugepage,
+};
+
+// madvise of bytes bytes mapped at address, false when it fails or the
+// advice is not supported
+inline bool advise_mapping(void* address, std::size_t bytes, MapAdvice advice) noexcept{
+    int native = MADV_NORMAL;
+    switch( advice){
+        case MapAdvice::normal: native = MADV_NORMAL; break;
+        case MapAdvice::sequential: native = MADV_SEQUENTIAL; break;
+        case MapAdvice::random: native = MADV_RANDOM; break;
+        case MapAdvice::willneed: native = MADV_WILLNEED; break;
+        case MapAdvice::dontneed: native = MADV_DONTNEED; break;
+        case MapAdvice::hugepage:
+#ifdef MADV_HUGEPAGE
+            native = MADV_HUGEPAGE;
+            break;
+#else
+            return false;
+#endif
+    }
+    return ::madvise(address, bytes, native) == 0;
+}
+
+enum class MapMode {
+    // Shared read only mapping, every modifier throws std::logic_error
+    read_only,
+    // Shared writable mapping, the file is created when missing
+    read_write,
+};
+
+// Vector of trivially copyable elements living in a memory mapped file.
+//
+// The file is the raw array of elements, without header: opening it is a
+// single mmap, the pages are read by the kernel on first access and never
+// copied. Growing extends the file with ftruncate and the mapping with
+// mremap, so like Vector the pointers and iterators are invalidated by a
+// reallocation. The capacity past the size is part of the file while it is
+// open, the file is truncated back to the size when the MappedVector is
+// destroyed.
+template<class T, growth_policy GrowthPolicy = growth::Doubling>
+class MappedVector {
+    static_assert(std::is_trivially_copyable_v<T>, "MappedVector elements are stored as raw bytes in the file");
+public:
+
+    // Declaration of type
+    using value_type = T;
+    using size_type = std::size_t;
+    using difference_type = std::ptrdiff_t;
+    using reference = T&;
+    using const_reference = const T&;
+    using pointer = T*;
+    using const_pointer = const T*;
+
+    // Constructors and Destructors
+    explicit MappedVector( const std::filesystem::path& path, MapMode mode = MapMode::read_write);
+    MappedVector(MappedVector && other) noexcept;
+    MappedVector(const MappedVector & other) = delete;
+    MappedVector &operator=(MappedVector &&) noexcept;
+    MappedVector &operator=(const MappedVector &) = delete;
+    ~MappedVector();
+
+    // Element access
+    reference at(size_type position);
+    const_reference at(size_type position) const;
+
+    reference operator[](size_type position);
+    const_reference operator[](size_type position) const;
+
+    reference front();
+    const_reference front() const;
+
+    reference back();
+    const_reference back() const;
+
+    pointer data();
+    const_pointer data() const;
+
+    // iterator
+    //
+    using iterator = iterator_base<T>;
+    using const_iterator = const iterator_base<T>;
+    iterator begin() noexcept;
+    const_iterator begin() const noexcept;
+    iterator end() noexcept;
+    const_iterator end() const noexcept;
+    const_iterator cbegin() const noexcept;
+    const_iterator cend() const noexcept;
+
+    // Container
+    //
+    bool empty() const noexcept;
+    size_type size() const noexcept;
+    size_type max_size() const noexcept;
+    void reserve( const size_type new_cap);
+    size_type capacity() const noexcept;
+    void shrink_to_fit();
+
+    // Mapping
+    //
+    const std::filesystem::path& path() const noexcept { return m_path; }
+    bool writable() const noexcept { return m_mode == MapMode::read_write; }
+    // Best effort, false when the kernel refused the hint
+    bool advise( MapAdvice advice) noexcept;
+    // Write the dirty pages back to the file, waiting for the IO unless async
+    void flush( bool async = false);
+
+    // Modifier
+    void clear();
+
+    iterator insert( const_iterator pos, const_reference value);
+    template<class InputIt> requires is_iterator<InputIt>
+    iterator insert( const_iterator pos, InputIt first, InputIt last);
+    void erase( const_iterator pos);
+    void erase( const_iterator first, const_iterator last);
+
+    void push_back( const_reference value);
+    template<class... Args>
+    reference emplace_back( Args&&... args);
+    void pop_back();
+    void resize(size_type count);
+    void resize(size_type count, const_reference value);
+private:
+    // error is read before anything else can overwrite errno
+    [[noreturn]] static void throw_errno(const char* what, int error = errno);
+    void check_writable() const;
+    // Resize the file and the mapping to new_cap elements
+    void remap(size_type new_cap);
+    void unmap() noexcept;
+    // Truncate the file to the size and close it
+    void close() noexcept;
+    size_type checked_position(const_iterator pos) const;
+
+    std::filesystem::path m_path;
+    MapMode m_mode;
+    int m_fd{-1};
+    pointer m_elements{nullptr};
+    size_type m_current_size{0};
+    size_type m_max_size{0};
+};
+
+template<class T, growth_policy GrowthPolicy>
+MappedVector<T, GrowthPolicy>::MappedVector( const std::filesystem::path& path, MapMode mode)
+        : m_path(path), m_mode(mode){
+    const int flags = mode == MapMode::read_write ? O_RDWR | O_CREAT : O_RDONLY;
+    m_fd = ::open(m_path.c_str(), flags | O_CLOEXEC, 0644);
+    if( m_fd < 0)
+        throw_errno("MappedVector open");
+
+    struct stat status{};
+    if( ::fstat(m_fd, &status) != 0){
+        const int error = errno;
+        ::close(m_fd);
+        throw_errno("MappedVector fstat", error);
+    }
+    const auto bytes = static_cast<size_type>(status.st_size);
+    if( bytes % sizeof(T) != 0){
+        ::close(m_fd);
+        throw std::length_error("MappedVector file size is not a multiple of the element size");
+    }
+    m_current_size = bytes / sizeof(T);
+    if( m_current_size == 0)
+        return;
+
+    const int protection = writable() ? PROT_READ | PROT_WRITE : PROT_READ;
+    void* mapping = ::mmap(nullptr, bytes, protection, MAP_SHARED, m_fd, 0);
+    if( mapping == MAP_FAILED){
+        const int error = errno;
+        ::close(m_fd);
+        throw_errno("MappedVector mmap", error);
+    }
+    m_elements = static_cast<pointer>(mapping);
+    m_max_size = m_current_size;
+}
+
+template<class T, growth_policy GrowthPolicy>
+MappedVector<T, GrowthPolicy>::MappedVector(MappedVector && other) noexcept
+        : m_path(std::move(other.m_path)),
+          m_mode(other.m_mode),
+          m_fd(std::exchange(other.m_fd, -1)),
+          m_elements(std::exchange(other.m_elements, nullptr)),
+          m_current_size(std::exchange(other.m_current_size, 0)),
+          m_max_size(std::exchange(other.m_max_size, 0)){
+}
+
+template<class T, growth_policy GrowthPolicy>
+MappedVector<T, GrowthPolicy>& MappedVector<T, GrowthPolicy>::operator=(MappedVector && other) noexcept{
+    if( this == &other)
+        return *this;
+
+    close();
+    m_path = std::move(other.m_path);
+    m_mode = other.m_mode;
+    m_fd = std::exchange(other.m_fd, -1);
+    m_elements = std::exchange(other.m_elements, nullptr);
+    m_current_size = std::exchange(other.m_current_size, 0);
+    m_max_size = std::exchange(other.m_max_size, 0);
+    return *this;
+}
+
+template<class T, growth_policy GrowthPolicy>
+MappedVector<T, GrowthPolicy>::~MappedVector(){
+    close();
+}
+
+template<class T, growth_policy GrowthPolicy>
+T& MappedVector<T, GrowthPolicy>::at(size_type position){
+    if( position >= m_current_size )
+        throw std::out_of_range("MappedVector::at position out of range");
+    return m_elements[position];
+}
+template<class T, growth_policy GrowthPolicy>
+const T& MappedVector<T, GrowthPolicy>::at(size_type position) const{
+    if( position >= m_current_size )
+        throw std::out_of_range("MappedVector::at position out of range");
+    return m_elements[position];
+}
+
+template<class T, growth_policy GrowthPolicy>
+T& MappedVector<T, GrowthPolicy>::operator[](size_type position){
+    return m_elements[position];
+}
+template<class T, growth_policy GrowthPolicy>
+const T& MappedVector<T, GrowthPolicy>::operator[](size_type position) const{
+    return m_elements[position];
+}
+
+template<class T, growth_policy GrowthPolicy>
+T& MappedVector<T, GrowthPolicy>::front(){
+    return at(0);
+}
+template<class T, growth_policy GrowthPolicy>
+const T& MappedVector<T, GrowthPolicy>::front() const{
+    return at(0);
+}
+
+template<class T, growth_policy GrowthPolicy>
+T& MappedVector<T, GrowthPolicy>::back(){
+    return at(m_current_size - 1);
+}
+template<class T, growth_policy GrowthPolicy>
+const T& MappedVector<T, GrowthPolicy>::back() const{
+    return at(m_current_size - 1);
+}
+
+template<class T, growth_policy GrowthPolicy>
+T* MappedVector<T, GrowthPolicy>::data(){
+    return m_elements;
+}
+template<class T, growth_policy GrowthPolicy>
+const T* MappedVector<T, GrowthPolicy>::data() const{
+    return m_elements;
+}
+
+template<class T, growth_policy GrowthPolicy>
+typename MappedVector<T, GrowthPolicy>::iterator MappedVector<T, GrowthPolicy>::begin() noexcept{
+    return iterator(m_elements);
+}
+template<class T, growth_policy GrowthPolicy>
+typename MappedVector<T, GrowthPolicy>::const_iterator MappedVector<T, GrowthPolicy>::begin() const noexcept{
+    return iterator(m_elements);
+}
+template<class T, growth_policy GrowthPolicy>
+typename MappedVector<T, GrowthPolicy>::iterator MappedVector<T, GrowthPolicy>::end() noexcept{
+    return iterator(m_elements + m_current_size);
+}
+template<class T, growth_policy GrowthPolicy>
+typename MappedVector<T, GrowthPolicy>::const_iterator MappedVector<T, GrowthPolicy>::end() const noexcept{
+    return iterator(m_elements + m_current_size);
+}
+template<class T, growth_policy GrowthPolicy>
+typename MappedVector<T, GrowthPolicy>::const_iterator MappedVector<T, GrowthPolicy>::cbegin() const noexcept{
+    return begin();
+}
+template<class T, growth_policy GrowthPolicy>
+typename MappedVector<T, GrowthPolicy>::const_iterator MappedVector<T, GrowthPolicy>::cend() const noexcept{
+    return end();
+}
+
+template<class T, growth_policy GrowthPolicy>
+bool MappedVector<T, GrowthPolicy>::empty() const noexcept{
+    return ( m_current_size == 0);
+}
+
+template<class T, growth_policy GrowthPolicy>
+std::size_t MappedVector<T, GrowthPolicy>::size() const noexcept{
+    return m_current_size;
+}
+
+template<class T, growth_policy GrowthPolicy>
+std::size_t MappedVector<T, GrowthPolicy>::max_size() const noexcept{
+    return std::numeric_limits<off_t>::max() / sizeof(T);
+}
+
+template<class T, growth_policy GrowthPolicy>
+void MappedVector<T, GrowthPolicy>::reserve(const size_type new_cap){
+    if (new_cap > max_size())
+        throw std::length_error(" The new cap exceed the absolute maximum size");
+    if (new_cap <= m_max_size)
+        return;
+
+    remap(new_cap);
+}
+
+template<class T, growth_policy GrowthPolicy>
+std::size_t MappedVector<T, GrowthPolicy>::capacity() const noexcept{
+    return m_max_size;
+}
+
+template<class T, growth_policy GrowthPolicy>
+void MappedVector<T, GrowthPolicy>::shrink_to_fit(){
+    if( m_current_size == m_max_size)
+        return;
+
+    remap(m_current_size);
+}
+
+template<class T, growth_policy GrowthPolicy>
+bool MappedVector<T, GrowthPolicy>::advise(MapAdvice advice) noexcept{
+    if( m_elements == nullptr)
+        return true;
+
+    return advise_mapping(m_elements, m_max_size * sizeof(T), advice);
+}
+
+template<class T, growth_policy GrowthPolicy>
+void MappedVector<T, GrowthPolicy>::flush(bool async){
+    if( m_elements == nullptr || !writable())
+        return;
+    if( ::msync(m_elements, m_max_size * sizeof(T), async ? MS_ASYNC : MS_SYNC) != 0)
+        throw_errno("MappedVector msync");
+}
+
+template<class T, growth_policy GrowthPolicy>
+void MappedVector<T, GrowthPolicy>::clear(){
+    check_writable();
+    m_current_size = 0;
+}
+
+template<class T, growth_policy GrowthPolicy>
+typename MappedVector<T, GrowthPolicy>::iterator MappedVector<T, GrowthPolicy>::insert( const_iterator pos, const_reference value){
+    // value can be an element of the mapping, keep a copy before shifting
+    const value_type copy = value;
+    return insert(pos, &copy, &copy + 1);
+}
+
+template<class T, growth_policy GrowthPolicy>
+template<class InputIt> requires is_iterator<InputIt>
+typename MappedVector<T, GrowthPolicy>::iterator MappedVector<T, GrowthPolicy>::insert( const_iterator pos, InputIt first, InputIt last){
+    check_writable();
+    const size_type insert_pos = checked_position(pos);
+    const auto count = static_cast<size_type>(std::distance(first, last));
+    if( m_current_size + count > m_max_size)
+        remap(GrowthPolicy::template next_capacity<T>(m_max_size, m_current_size + count));
+
+    std::memmove(static_cast<void*>(m_elements + insert_pos + count), static_cast<const void*>(m_elements + insert_pos),
+                 (m_current_size - insert_pos) * sizeof(T));
+    for(size_type i=0; i < count; ++i, ++first)
+        m_elements[insert_pos + i] = *first;
+    m_current_size += count;
+    return iterator(m_elements + insert_pos);
+}
+
+template<class T, growth_policy GrowthPolicy>
+void MappedVector<T, GrowthPolicy>::erase( const_iterator pos){
+    erase(pos, pos + 1);
+}
+
+template<class T, growth_policy GrowthPolicy>
+void MappedVector<T, GrowthPolicy>::erase( const_iterator first, const_iterator last){
+    check_writable();
+    if( first > last || first < cbegin() || last > cend())
+        throw std::invalid_argument("erase range not in container");
+    const auto erase_pos = static_cast<size_type>(first - cbegin());
+    const auto count = static_cast<size_type>(last - first);
+    std::memmove(static_cast<void*>(m_elements + erase_pos), static_cast<const void*>(m_elements + erase_pos + count),
+                 (m_current_size - erase_pos - count) * sizeof(T));
+    m_current_size -= count;
+}
+
+template<class T, growth_policy GrowthPolicy>
+void MappedVector<T, GrowthPolicy>::push_back(const_reference value){
+    emplace_back(value);
+}
+
+template<class T, growth_policy GrowthPolicy>
+template<class... Args>
+T& MappedVector<T, GrowthPolicy>::emplace_back(Args&&... args){
+    check_writable();
+    // Built before a remap can move the arguments pointing in the mapping
+    const value_type value(std::forward<Args>(args)...);
+    if( m_current_size == m_max_size)
+        remap(GrowthPolicy::template next_capacity<T>(m_max_size, m_current_size + 1));
+    m_elements[m_current_size] = value;
+    return m_elements[m_current_size++];
+}
+
+template<class T, growth_policy GrowthPolicy>
+void MappedVector<T, GrowthPolicy>::pop_back(){
+    check_writable();
+    if( m_current_size == 0)
+        return;
+    --m_current_size;
+}
+
+template<class T, growth_policy GrowthPolicy>
+void MappedVector<T, GrowthPolicy>::resize(size_type count){
+    resize(count, value_type());
+}
+
+template<class T, growth_policy GrowthPolicy>
+void MappedVector<T, GrowthPolicy>::resize(size_type count, const_reference value){
+    check_writable();
+    if( count <= m_current_size){
+        m_current_size = count;
+        return;
+    }
+    const value_type copy = value;
+    reserve(count);
+    for(; m_current_size < count; ++m_current_size)
+        m_elements[m_current_size] = copy;
+}
+
+template<class T, growth_policy GrowthPolicy>
+void MappedVector<T, GrowthPolicy>::throw_errno(const char* what, int error){
+    throw std::system_error(error, std::generic_category(), what);
+}
+
+template<class T, growth_policy GrowthPolicy>
+void MappedVector<T, GrowthPolicy>::check_writable() const{
+    if( !writable())
+        throw std::logic_error("MappedVector opened read only");
+}
+
+template<class T, growth_policy GrowthPolicy>
+void MappedVector<T, GrowthPolicy>::remap(size_type new_cap){
+    check_writable();
+    const size_type old_bytes = m_max_size * sizeof(T);
+    const size_type new_bytes = new_cap * sizeof(T);
+    if( new_bytes > old_bytes && ::ftruncate(m_fd, static_cast<off_t>(new_bytes)) != 0)
+        throw_errno("MappedVector ftruncate");
+
+    void* mapping = nullptr;
+    if( new_bytes == 0){
+        unmap();
+    } else if( m_elements == nullptr){
+        mapping = ::mmap(nullptr, new_bytes, PROT_READ | PROT_WRITE, MAP_SHARED, m_fd, 0);
+    } else {
+#ifdef __linux__
+        mapping = ::mremap(m_elements, old_bytes, new_bytes, MREMAP_MAYMOVE);
+#else
+        mapping = ::mmap(nullptr, new_bytes, PROT_READ | PROT_WRITE, MAP_SHARED, m_fd, 0);
+        if( mapping != MAP_FAILED)
+            unmap();
+#endif
+    }
+    if( mapping == MAP_FAILED)
+        throw_errno("MappedVector mremap");
+    m_elements = static_cast<pointer>(mapping);
+    m_max_size = new_cap;
+
+    // Shrinking cuts the file once nothing maps the dropped pages
+    if( new_bytes < old_bytes && ::ftruncate(m_fd, static_cast<off_t>(new_bytes)) != 0)
+        throw_errno("MappedVector ftruncate");
+}
+
+template<class T, growth_policy GrowthPolicy>
+void MappedVector<T, GrowthPolicy>::unmap() noexcept{
+    if( m_elements != nullptr)
+        ::munmap(m_elements, m_max_size * sizeof(T));
+    m_elements = nullptr;
+}
+
+template<class T, growth_policy GrowthPolicy>
+void MappedVector<T, GrowthPolicy>::close() noexcept{
+    if( m_fd < 0)
+        return;
+    unmap();
+    if( writable())
+        static_cast<void>(::ftruncate(m_fd, static_cast<off_t>(m_current_size * sizeof(T))));
+    ::close(m_fd);
+    m_fd = -1;
+    m_current_size = 0;
+    m_max_size = 0;
+}
+
+template<class T, growth_policy GrowthPolicy>
+std::size_t MappedVector<T, GrowthPolicy>::checked_position(const_iterator pos) const{
+    if( pos < cbegin() || cend() < pos)
+        throw std::invalid_argument("insert position not in container");
+    return static_cast<size_type>(pos - cbegin());
+}
+
+}
@@ -0,0 +1,648 @@
+#pragma once
+
+#include <atomic> // atomic
+#include <cstddef> // size_t ptrdiff_t byte
+#include <initializer_list> // initializer_list
+#include <iterator> // random_access_iterator_tag
+#include <memory> // destroy_n destroy_at uninitialized_copy_n
+#include <new> // launder
+#include <ranges> // begin end
+#include <stdexcept> // out_of_range
+#include <utility> // move exchange swap
+#include "Vector.hpp"
+
+namespace yadej {
+
+// Random access iterator over a PersistentVector. It keeps a pointer to
+// the leaf of the current element, the trie is only walked again when the
+// iterator leaves it. Same interface as iterator_base, on const elements.
+template<class Owner>
+class persistent_iterator {
+    public:
+    using iterator_base_category = std::random_access_iterator_tag;
+    using iterator_category = std::random_access_iterator_tag;
+    using difference_type = std::ptrdiff_t;
+    using value_type = typename Owner::value_type;
+    using pointer = const value_type*;
+    using reference = const value_type&;
+
+    constexpr persistent_iterator() = default;
+
+    persistent_iterator( const Owner* owner, std::size_t index): m_owner(owner), m_index(index){
+        locate();
+    }
+
+    persistent_iterator& operator++(){
+        ++m_index;
+        locate_if_outside();
+        return *this;
+    }
+    persistent_iterator operator++(int){
+        persistent_iterator temp = *this;
+        ++*this;
+        return temp;
+    }
+
+    persistent_iterator& operator--(){
+        --m_index;
+        locate_if_outside();
+        return *this;
+    }
+    persistent_iterator operator--(int){
+        persistent_iterator temp = *this;
+        --*this;
+        return temp;
+    }
+
+    persistent_iterator& operator+=(difference_type n){
+        m_index += static_cast<std::size_t>(n);
+        locate_if_outside();
+        return *this;
+    }
+
+    persistent_iterator& operator-=(difference_type n){
+        m_index -= static_cast<std::size_t>(n);
+        locate_if_outside();
+        return *this;
+    }
+
+    reference operator*() const {
+        return m_leaf[m_index - m_leaf_first];
+    }
+
+    pointer operator->() const {
+        return &**this;
+    }
+
+    reference operator[](difference_type n) const {
+        return *(*this + n);
+    }
+
+    std::size_t index() const {
+        return m_index;
+    }
+
+    friend bool operator==(const persistent_iterator& l_arg, const persistent_iterator& r_arg){
+        return l_arg.m_index == r_arg.m_index;
+    }
+
+    friend bool operator!=(const persistent_iterator& l_arg, const persistent_iterator& r_arg){
+        return !(l_arg == r_arg);
+    }
+
+    friend bool operator<(const persistent_iterator& l_arg, const persistent_iterator& r_arg){
+        return l_arg.m_index < r_arg.m_index;
+    }
+
+    friend bool operator>(const persistent_iterator& l_arg, const persistent_iterator& r_arg){
+        return r_arg < l_arg;
+    }
+
+    friend bool operator>=(const persistent_iterator& l_arg, const persistent_iterator& r_arg){
+        return !(l_arg < r_arg);
+    }
+
+    friend bool operator<=(const persistent_iterator& l_arg, const persistent_iterator& r_arg){
+        return !(r_arg < l_arg);
+    }
+
+    friend persistent_iterator operator+(const persistent_iterator& it, difference_type n){
+        persistent_iterator temp = it;
+        temp += n;
+        return temp;
+    }
+
+    friend persistent_iterator operator+(difference_type n, const persistent_iterator& it){
+        return it + n;
+    }
+
+    friend persistent_iterator operator-(const persistent_iterator& it, difference_type n){
+        persistent_iterator temp = it;
+        temp -= n;
+        return temp;
+    }
+
+    friend difference_type operator-(const persistent_iterator& l_arg, const persistent_iterator& r_arg){
+        return static_cast<difference_type>(l_arg.m_index - r_arg.m_index);
+    }
+
+private:
+    void locate_if_outside(){
+        if( !m_leaf || m_index - m_leaf_first >= Owner::branching)
+            locate();
+    }
+
+    // The end iterator has no leaf
+    void locate(){
+        if( m_owner && m_index < m_owner->size()){
+            m_leaf = m_owner->leaf_data(m_index);
+            m_leaf_first = m_index & ~(Owner::branching - 1);
+        } else {
+            m_leaf = nullptr;
+        }
+    }
+
+    const Owner* m_owner{nullptr};
+    std::size_t m_index{0};
+    pointer m_leaf{nullptr};
+    std::size_t m_leaf_first{0};
+};
+
+// Immutable vector sharing its structure between versions, for undo
+// histories and MVCC readers keeping many versions of a big sequence.
+//
+// The elements live in leaves of 32 elements under a 32-way trie indexed
+// by the bits of the position (radix balanced), the last leaf being kept
+// apart as the tail. push_back, set and pop_back leave the vector alone
+// and return a new version, which copies the O(log32 n) nodes on the way
+// to the element and shares all the others. push_back and pop_back
+// mostly touch the tail only.
+//
+// Nodes are reference counted with atomics, versions can be read and
+// released from any thread. A node owned by one version only is updated
+// in place: this is what makes the && overloads and a Transient fast, a
+// transient copies a path once and then writes to its own nodes.
+//
+//     yadej::PersistentVector<int> v1 = v0.push_back(4);  // v0 unchanged
+//     auto batch = v1.transient();
+//     for(int i=0; i < 1000; ++i)
+//         batch.push_back(i);
+//     yadej::PersistentVector<int> v2 = std::move(batch).persistent();
+template<class T>
+class PersistentVector {
+public:
+    using value_type = T;
+    using size_type = std::size_t;
+    using difference_type = std::ptrdiff_t;
+    using reference = const T&;
+    using const_reference = const T&;
+    using const_iterator = persistent_iterator<PersistentVector>;
+    using iterator = const_iterator;
+
+    static constexpr unsigned bits = 5;
+    static constexpr size_type branching = size_type{1} << bits;
+
+    class Transient;
+
+    PersistentVector() noexcept = default;
+    PersistentVector( std::initializer_list<T> init);
+    template<container_compatible_range<T> Range>
+    PersistentVector( from_range_t, Range&& range);
+    PersistentVector(const PersistentVector& other) noexcept;
+    PersistentVector(PersistentVector&& other) noexcept;
+    PersistentVector& operator=(const PersistentVector& other) noexcept;
+    PersistentVector& operator=(PersistentVector&& other) noexcept;
+    ~PersistentVector();
+
+    // Element access
+    const_reference at(size_type position) const;
+    const_reference operator[](size_type position) const noexcept{
+        return leaf_of(position)->values()[position & mask];
+    }
+    const_reference front() const noexcept{ return (*this)[0]; }
+    const_reference back() const noexcept{ return (*this)[m_size - 1]; }
+    // First element of the leaf holding position, the branching elements
+    // of a leaf are contiguous (the tail may have fewer)
+    const T* leaf_data(size_type position) const noexcept{ return leaf_of(position)->values(); }
+
+    const_iterator begin() const{ return const_iterator(this, 0); }
+    const_iterator end() const{ return const_iterator(this, m_size); }
+    const_iterator cbegin() const{ return begin(); }
+    const_iterator cend() const{ return end(); }
+
+    bool empty() const noexcept{ return m_size == 0; }
+    size_type size() const noexcept{ return m_size; }
+
+    // New versions, the && overloads reuse the nodes of a unique version
+    [[nodiscard]] PersistentVector push_back(T value) const&;
+    [[nodiscard]] PersistentVector push_back(T value) &&;
+    [[nodiscard]] PersistentVector set(size_type position, T value) const&;
+    [[nodiscard]] PersistentVector set(size_type position, T value) &&;
+    // Without element, the same empty vector
+    [[nodiscard]] PersistentVector pop_back() const&;
+    [[nodiscard]] PersistentVector pop_back() &&;
+
+    // Mutable copy for a batch of changes
+    [[nodiscard]] Transient transient() const&{ return Transient(*this); }
+    [[nodiscard]] Transient transient() &&{ return Transient(std::move(*this)); }
+
+    void swap(PersistentVector& other) noexcept;
+    friend void swap(PersistentVector& l_arg, PersistentVector& r_arg) noexcept{ l_arg.swap(r_arg); }
+
+private:
+    static constexpr size_type mask = branching - 1;
+
+    struct Node {
+        std::atomic<size_type> refs{1};
+    };
+
+    struct Inner : Node {
+        Node* children[branching]{};
+    };
+
+    struct Leaf : Node {
+        size_type count{0};
+        alignas(T) std::byte storage[branching * sizeof(T)];
+
+        T* values() noexcept{ return std::launder(reinterpret_cast<T*>(storage)); }
+        const T* values() const noexcept{ return std::launder(reinterpret_cast<const T*>(storage)); }
+    };
+
+    size_type tail_offset() const noexcept{ return m_size - (m_tail ? m_tail->count : 0); }
+    const Leaf* leaf_of(size_type position) const noexcept;
+
+    // Changes in place, copying the nodes shared with other versions
+    void push_back_in_place(T&& value);
+    void set_in_place(size_type position, T&& value);
+    void pop_back_in_place();
+
+    // Move the full tail into the trie
+    void push_tail();
+    void push_tail_into(Node*& slot, unsigned level, size_type first, Leaf* leaf);
+    // Drop the last leaf of the trie, index is the last element it holds
+    void pop_tail(Node*& slot, unsigned level, size_type index);
+    // Chain of new inner nodes from level down to leaf
+    static Node* new_path(unsigned level, Leaf* leaf);
+
+    static bool unique(const Node* node) noexcept{
+        return node->refs.load(std::memory_order_acquire) == 1;
+    }
+    static void retain(Node* node) noexcept{
+        if( node)
+            node->refs.fetch_add(1, std::memory_order_relaxed);
+    }
+    // level 0 is a leaf
+    static void release(Node* node, unsigned level) noexcept;
+    // node itself when unique, else a copy replacing the reference to node
+    static Inner* unique_inner(Node* node, unsigned level);
+    static Leaf* unique_leaf(Leaf* leaf);
+
+    size_type m_size{0};
+    // Level of the root, bits for a root whose children are leaves
+    unsigned m_shift{bits};
+    Node* m_root{nullptr};
+    Leaf* m_tail{nullptr};
+};
+
+// PersistentVector edited in place, then frozen by persistent().
+// Reads are the ones of PersistentVector.
+template<class T>
+class PersistentVector<T>::Transient {
+public:
+    explicit Transient(PersistentVector vector) noexcept: m_vector(std::move(vector)){}
+
+    size_type size() const noexcept{ return m_vector.size(); }
+    bool empty() const noexcept{ return m_vector.empty(); }
+    const_reference operator[](size_type position) const noexcept{ return m_vector[position]; }
+
+    Transient& push_back(T value){
+        m_vector.push_back_in_place(std::move(value));
+        return *this;
+    }
+    Transient& set(size_type position, T value){
+        if( position >= m_vector.size())
+            throw std::out_of_range("Index out of range");
+        m_vector.set_in_place(position, std::move(value));
+        return *this;
+    }
+    Transient& pop_back(){
+        m_vector.pop_back_in_place();
+        return *this;
+    }
+
+    // The transient is left empty
+    [[nodiscard]] PersistentVector persistent() &&{ return std::move(m_vector); }
+
+private:
+    PersistentVector m_vector;
+};
+
+template<class T>
+PersistentVector<T>::PersistentVector( std::initializer_list<T> init){
+    for(const T& value : init)
+        push_back_in_place(T(value));
+}
+
+template<class T>
+template<container_compatible_range<T> Range>
+PersistentVector<T>::PersistentVector( from_range_t, Range&& range){
+    for(auto&& value : range)
+        push_back_in_place(T(std::forward<decltype(value)>(value)));
+}
+
+template<class T>
+PersistentVector<T>::PersistentVector(const PersistentVector& other) noexcept
+        : m_size(other.m_size), m_shift(other.m_shift), m_root(other.m_root), m_tail(other.m_tail){
+    retain(m_root);
+    retain(m_tail);
+}
+
+template<class T>
+PersistentVector<T>::PersistentVector(PersistentVector&& other) noexcept
+        : m_size(std::exchange(other.m_size, 0)), m_shift(std::exchange(other.m_shift, bits)),
+          m_root(std::exchange(other.m_root, nullptr)), m_tail(std::exchange(other.m_tail, nullptr)){
+}
+
+template<class T>
+PersistentVector<T>& PersistentVector<T>::operator=(const PersistentVector& other) noexcept{
+    PersistentVector copy(other);
+    swap(copy);
+    return *this;
+}
+
+template<class T>
+PersistentVector<T>& PersistentVector<T>::operator=(PersistentVector&& other) noexcept{
+    PersistentVector moved(std::move(other));
+    swap(moved);
+    return *this;
+}
+
+template<class T>
+PersistentVector<T>::~PersistentVector(){
+    release(m_root, m_shift);
+    release(m_tail, 0);
+}
+
+template<class T>
+typename PersistentVector<T>::const_reference PersistentVector<T>::at(size_type position) const{
+    if( position >= m_size)
+        throw std::out_of_range("Index out of range");
+    return (*this)[position];
+}
+
+template<class T>
+PersistentVector<T> PersistentVector<T>::push_back(T value) const&{
+    PersistentVector result(*this);
+    result.push_back_in_place(std::move(value));
+    return result;
+}
+
+template<class T>
+PersistentVector<T> PersistentVector<T>::push_back(T value) &&{
+    push_back_in_place(std::move(value));
+    return std::move(*this);
+}
+
+template<class T>
+PersistentVector<T> PersistentVector<T>::set(size_type position, T value) const&{
+    if( position >= m_size)
+        throw std::out_of_range("Index out of range");
+    PersistentVector result(*this);
+    result.set_in_place(position, std::move(value));
+    return result;
+}
+
+template<class T>
+PersistentVector<T> PersistentVector<T>::set(size_type position, T value) &&{
+    if( position >= m_size)
+        throw std::out_of_range("Index out of range");
+    set_in_place(position, std::move(value));
+    return std::move(*this);
+}
+
+template<class T>
+PersistentVector<T> PersistentVector<T>::pop_back() const&{
+    PersistentVector result(*this);
+    result.pop_back_in_place();
+    return result;
+}
+
+template<class T>
+PersistentVector<T> PersistentVector<T>::pop_back() &&{
+    pop_back_in_place();
+    return std::move(*this);
+}
+
+template<class T>
+void PersistentVector<T>::swap(PersistentVector& other) noexcept{
+    std::swap(m_size, other.m_size);
+    std::swap(m_shift, other.m_shift);
+    std::swap(m_root, other.m_root);
+    std::swap(m_tail, other.m_tail);
+}
+
+template<class T>
+const typename PersistentVector<T>::Leaf* PersistentVector<T>::leaf_of(size_type position) const noexcept{
+    if( position >= tail_offset())
+        return m_tail;
+    const Node* node = m_root;
+    for(unsigned level = m_shift; level > 0; level -= bits)
+        node = static_cast<const Inner*>(node)->children[(position >> level) & mask];
+    return static_cast<const Leaf*>(node);
+}
+
+template<class T>
+void PersistentVector<T>::push_back_in_place(T&& value){
+    if( m_tail && m_tail->count < branching){
+        m_tail = unique_leaf(m_tail);
+        ::new(static_cast<void*>(m_tail->values() + m_tail->count)) T(std::move(value));
+        ++m_tail->count;
+        ++m_size;
+        return;
+    }
+
+    // The new tail is built first, nothing changes when T throws
+    Leaf* tail = new Leaf();
+    try {
+        ::new(static_cast<void*>(tail->values())) T(std::move(value));
+    } catch(...) {
+        delete tail;
+        throw;
+    }
+    tail->count = 1;
+    if( m_tail){
+        try {
+            push_tail();
+        } catch(...) {
+            release(tail, 0);
+            throw;
+        }
+    }
+    m_tail = tail;
+    ++m_size;
+}
+
+template<class T>
+void PersistentVector<T>::push_tail(){
+    // The reference of m_tail is moved to the trie
+    if( !m_root){
+        Inner* root = new Inner();
+        root->children[0] = m_tail;
+        m_root = root;
+        m_shift = bits;
+    } else if( tail_offset() == branching << m_shift){
+        // The trie is full, it becomes the first child of a new root
+        Inner* root = new Inner();
+        try {
+            root->children[1] = new_path(m_shift, m_tail);
+        } catch(...) {
+            delete root;
+            throw;
+        }
+        root->children[0] = m_root;
+        m_root = root;
+        m_shift += bits;
+    } else {
+        push_tail_into(m_root, m_shift, tail_offset(), m_tail);
+    }
+    m_tail = nullptr;
+}
+
+template<class T>
+void PersistentVector<T>::push_tail_into(Node*& slot, unsigned level, size_type first, Leaf* leaf){
+    Inner* node = unique_inner(slot, level);
+    slot = node;
+    const size_type sub = (first >> level) & mask;
+    if( level == bits)
+        node->children[sub] = leaf;
+    else if( node->children[sub])
+        push_tail_into(node->children[sub], level - bits, first, leaf);
+    else
+        node->children[sub] = new_path(level - bits, leaf);
+}
+
+template<class T>
+typename PersistentVector<T>::Node* PersistentVector<T>::new_path(unsigned level, Leaf* leaf){
+    Node* node = leaf;
+    try {
+        for(unsigned current = bits; current <= level; current += bits){
+            Inner* parent = new Inner();
+            parent->children[0] = node;
+            node = parent;
+        }
+    } catch(...) {
+        while( node != leaf){
+            Inner* inner = static_cast<Inner*>(node);
+            node = inner->children[0];
+            delete inner;
+        }
+        throw;
+    }
+    return node;
+}
+
+template<class T>
+void PersistentVector<T>::set_in_place(size_type position, T&& value){
+    if( position >= tail_offset()){
+        m_tail = unique_leaf(m_tail);
+        m_tail->values()[position & mask] = std::move(value);
+        return;
+    }
+    Node** slot = &m_root;
+    for(unsigned level = m_shift; level > 0; level -= bits){
+        Inner* node = unique_inner(*slot, level);
+        *slot = node;
+        slot = &node->children[(position >> level) & mask];
+    }
+    Leaf* leaf = unique_leaf(static_cast<Leaf*>(*slot));
+    *slot = leaf;
+    leaf->values()[position & mask] = std::move(value);
+}
+
+template<class T>
+void PersistentVector<T>::pop_back_in_place(){
+    if( m_size == 0)
+        return;
+    if( m_tail->count > 1 || m_size == 1){
+        m_tail = unique_leaf(m_tail);
+        std::destroy_at(m_tail->values() + m_tail->count - 1);
+        --m_tail->count;
+        --m_size;
+        if( m_size == 0){
+            release(m_tail, 0);
+            m_tail = nullptr;
+        }
+        return;
+    }
+
+    // The tail empties, the last leaf of the trie becomes the tail
+    Leaf* tail = const_cast<Leaf*>(leaf_of(m_size - 2));
+    retain(tail);
+    try {
+        pop_tail(m_root, m_shift, m_size - 2);
+    } catch(...) {
+        release(tail, 0);
+        throw;
+    }
+    release(m_tail, 0);
+    m_tail = tail;
+    --m_size;
+
+    if( !m_root){
+        m_shift = bits;
+    } else if( m_shift > bits && !static_cast<Inner*>(m_root)->children[1]){
+        // One child left, it becomes the root
+        Node* child = static_cast<Inner*>(m_root)->children[0];
+        retain(child);
+        release(m_root, m_shift);
+        m_root = child;
+        m_shift -= bits;
+    }
+}
+
+template<class T>
+void PersistentVector<T>::pop_tail(Node*& slot, unsigned level, size_type index){
+    // The leaf is the first one under slot, nothing is left under it
+    if( (index & ((branching << level) - 1)) < branching){
+        release(slot, level);
+        slot = nullptr;
+        return;
+    }
+    Inner* node = unique_inner(slot, level);
+    slot = node;
+    const size_type sub = (index >> level) & mask;
+    if( level == bits){
+        release(node->children[sub], 0);
+        node->children[sub] = nullptr;
+    } else {
+        pop_tail(node->children[sub], level - bits, index);
+    }
+}
+
+template<class T>
+void PersistentVector<T>::release(Node* node, unsigned level) noexcept{
+    if( !node || node->refs.fetch_sub(1, std::memory_order_acq_rel) != 1)
+        return;
+    if( level == 0){
+        Leaf* leaf = static_cast<Leaf*>(node);
+        std::destroy_n(leaf->values(), leaf->count);
+        delete leaf;
+    } else {
+        Inner* inner = static_cast<Inner*>(node);
+        for(Node* child : inner->children)
+            release(child, level - bits);
+        delete inner;
+    }
+}
+
+template<class T>
+typename PersistentVector<T>::Inner* PersistentVector<T>::unique_inner(Node* node, unsigned level){
+    if( unique(node))
+        return static_cast<Inner*>(node);
+    Inner* copy = new Inner();
+    const Inner* source = static_cast<const Inner*>(node);
+    for(size_type i=0; i < branching; ++i){
+        copy->children[i] = source->children[i];
+        retain(copy->children[i]);
+    }
+    release(node, level);
+    return copy;
+}
+
+template<class T>
+typename PersistentVector<T>::Leaf* PersistentVector<T>::unique_leaf(Leaf* leaf){
+    if( unique(leaf))
+        return leaf;
+    Leaf* copy = new Leaf();
+    try {
+        std::uninitialized_copy_n(static_cast<const Leaf*>(leaf)->values(), leaf->count, copy->values());
+    } catch(...) {
+        delete copy;
+        throw;
+    }
+    copy->count = leaf->count;
+    release(leaf, 0);
+    return copy;
+}
+
+}
@@ -0,0 +1,257 @@
+#pragma once
+
+#include <algorithm> // move move_backward
+#include <cstddef> // size_t
+#include <cstring> // memmove memcpy
+#include <iterator> // contiguous_iterator iter_value_t
+#include <memory> // allocator_traits to_address
+#include <type_traits> // is_trivially_copyable is_nothrow_move_constructible is_constant_evaluated is_same_v
+#include <utility> // move move_if_noexcept pair
+
+namespace yadej {
+
+// A type is trivially relocatable when moving it to a new address can be
+// done with a raw memmove, the source being forgotten without calling its
+// destructor. Every trivially copyable type is, and a user type can opt in
+// with:
+//     template<> struct yadej::is_trivially_relocatable<MyType> : std::true_type {};
+template<class T>
+struct is_trivially_relocatable : std::is_trivially_copyable<T> {};
+
+template<class T>
+inline constexpr bool is_trivially_relocatable_v = is_trivially_relocatable<T>::value;
+
+// std::pair is not trivially copyable (its assignments are user provided)
+// but it is relocatable with a memmove when both of its members are
+template<class First, class Second>
+struct is_trivially_relocatable<std::pair<First, Second>>
+    : std::bool_constant<is_trivially_relocatable_v<First> && is_trivially_relocatable_v<Second>> {};
+
+// A relocation can be done element by element without any risk of throwing
+// for trivially relocatable types and types with a noexcept move
+template<class T>
+inline constexpr bool is_nothrow_relocatable_v = is_trivially_relocatable_v<T> || std::is_nothrow_move_constructible_v<T>;
+
+// Destroy count elements from first, leaving raw memory.
+template<class Allocator, class T>
+constexpr void destroy_n(Allocator& alloc, T* first, std::size_t count) noexcept{
+    for(std::size_t i=0; i < count; ++i)
+        std::allocator_traits<Allocator>::destroy(alloc, first + i);
+}
+
+// Construct count elements in the raw memory at dest from the ones at
+// first with move_if_noexcept, the source stays alive. If one throws the
+// ones already built are destroyed and the source is untouched.
+template<class Allocator, class T>
+constexpr void move_construct(Allocator& alloc, T* first, std::size_t count, T* dest){
+    std::size_t i = 0;
+    try {
+        for(; i < count; ++i)
+            std::allocator_traits<Allocator>::construct(alloc, dest + i, std::move_if_noexcept(first[i]));
+    } catch(...) {
+        destroy_n(alloc, dest, i);
+        throw;
+    }
+}
+
+// Relocate count elements from first to the uninitialized dest, the two
+// ranges must not overlap (see shift to move elements inside a buffer).
+// After the call the source range is raw memory.
+//
+// Trivially relocatable types are moved with a single memcpy. Other types
+// are built with move_if_noexcept before the source is destroyed: on
+// exception the new elements are destroyed and the source is untouched.
+template<class Allocator, class T>
+constexpr void relocate(Allocator& alloc, T* first, std::size_t count, T* dest){
+    if( count == 0)
+        return;
+
+    if constexpr (is_trivially_relocatable_v<T>){
+        if( !std::is_constant_evaluated()){
+            std::memcpy(static_cast<void*>(dest), static_cast<const void*>(first), count * sizeof(T));
+            return;
+        }
+    }
+    move_construct(alloc, first, count, dest);
+    destroy_n(alloc, first, count);
+}
+
+// Same for elements living outside of any allocator (inline storage),
+// they are built with construct_at and destroyed with destroy_at
+template<class T>
+constexpr void relocate(T* first, std::size_t count, T* dest){
+    std::allocator<T> alloc;
+    relocate(alloc, first, count, dest);
+}
+
+// Relocate size elements from first to the uninitialized dest, leaving gap
+// slots at pos for the caller. Both halves are built before the source is
+// destroyed, so on exception dest is raw again and the source untouched.
+template<class Allocator, class T>
+constexpr void relocate_around(Allocator& alloc, T* first, std::size_t size, T* dest, std::size_t pos, std::size_t gap){
+    if constexpr (is_trivially_relocatable_v<T>){
+        if( !std::is_constant_evaluated()){
+            relocate(alloc, first, pos, dest);
+            relocate(alloc, first + pos, size - pos, dest + pos + gap);
+            return;
+        }
+    }
+    move_construct(alloc, first, pos, dest);
+    try {
+        move_construct(alloc, first + pos, size - pos, dest + pos + gap);
+    } catch(...) {
+        destroy_n(alloc, dest, pos);
+        throw;
+    }
+    destroy_n(alloc, first, size);
+}
+
+// Move count elements from first to dest inside the same buffer, the
+// destination slots not overlapping the source being raw memory. Each
+// element is constructed at its new place then destroyed at the old one,
+// walking in the direction that never overwrites a live element. A throw
+// half way would leave destroyed slots behind, so only types relocatable
+// without throwing can be shifted this way.
+template<class Allocator, class T>
+constexpr void shift(Allocator& alloc, T* first, std::size_t count, T* dest) noexcept{
+    static_assert(is_nothrow_relocatable_v<T>, "shift needs a type relocatable without throwing");
+    using traits = std::allocator_traits<Allocator>;
+
+    if( count == 0 || first == dest)
+        return;
+
+    if constexpr (is_trivially_relocatable_v<T>){
+        if( !std::is_constant_evaluated()){
+            std::memmove(static_cast<void*>(dest), static_cast<const void*>(first), count * sizeof(T));
+            return;
+        }
+    }
+
+    if( dest < first){
+        for(std::size_t i=0; i < count; ++i){
+            traits::construct(alloc, dest + i, std::move(first[i]));
+            traits::destroy(alloc, first + i);
+        }
+    } else {
+        for(std::size_t i=count; i > 0; --i){
+            traits::construct(alloc, dest + i - 1, std::move(first[i - 1]));
+            traits::destroy(alloc, first + i - 1);
+        }
+    }
+}
+
+template<class T>
+constexpr void shift(T* first, std::size_t count, T* dest) noexcept{
+    std::allocator<T> alloc;
+    shift(alloc, first, count, dest);
+}
+
+// Insert count elements at pos in a buffer holding size elements, with
+// room for count more. construct(dest, from, n) builds the new elements
+// [from, from + n) in raw memory and assign(dest, from, n) assigns them
+// over live ones, both cleaning up after themselves if they throw. size
+// follows the elements coming alive.
+// - Types relocatable without throwing shift the tail up and build the
+//   new elements in the gap, the tail shifts back if that throws.
+// - Others follow std::vector: what has to be constructed is built first
+//   in raw memory and destroyed if that throws, then the tail is shifted
+//   with move assignments and the new values assigned over it. A throwing
+//   assignment leaves every slot alive.
+template<class Allocator, class T, class Construct, class Assign>
+constexpr void insert_in_place(Allocator& alloc, T* elements, std::size_t& size, std::size_t pos, std::size_t count,
+                               Construct&& construct, Assign&& assign){
+    T* const at = elements + pos;
+    T* const old_end = elements + size;
+    const std::size_t after = size - pos;
+
+    if constexpr (is_nothrow_relocatable_v<T>){
+        shift(alloc, at, after, at + count);
+        try {
+            construct(at, 0, count);
+        } catch(...) {
+            shift(alloc, at + count, after, at);
+            throw;
+        }
+        size += count;
+    } else if( count < after){
+        // The last count elements go to raw memory, the others are assigned
+        move_construct(alloc, old_end - count, count, old_end);
+        size += count;
+        std::move_backward(at, old_end - count, old_end);
+        assign(at, 0, count);
+    } else {
+        // The new elements landing past the old end first, then the tail
+        if( count > after)
+            construct(old_end, after, count - after);
+        try {
+            move_construct(alloc, at, after, old_end + count - after);
+        } catch(...) {
+            destroy_n(alloc, old_end, count - after);
+            throw;
+        }
+        size += count;
+        if( after > 0)
+            assign(at, 0, after);
+    }
+}
+
+// Erase count elements at pos from a buffer holding size elements. Types
+// relocatable without throwing are destroyed and the tail shifted down,
+// others have the tail move assigned over them as std::vector does, so a
+// throwing assignment leaves every slot alive.
+template<class Allocator, class T>
+constexpr void erase_in_place(Allocator& alloc, T* elements, std::size_t& size, std::size_t pos, std::size_t count){
+    T* const at = elements + pos;
+    const std::size_t after = size - pos - count;
+
+    if constexpr (is_nothrow_relocatable_v<T>){
+        destroy_n(alloc, at, count);
+        shift(alloc, at + count, after, at);
+    } else {
+        std::move(at + count, at + count + after, at);
+        destroy_n(alloc, at + after, count);
+    }
+    size -= count;
+}
+
+// Construct count elements from args in the raw memory at dest. If one
+// throws the ones already built are destroyed and dest is raw again.
+template<class Allocator, class T, class... Args>
+constexpr void construct_n(Allocator& alloc, T* dest, std::size_t count, const Args&... args){
+    using traits = std::allocator_traits<Allocator>;
+    std::size_t i = 0;
+    try {
+        for(; i < count; ++i)
+            traits::construct(alloc, dest + i, args...);
+    } catch(...) {
+        destroy_n(alloc, dest, i);
+        throw;
+    }
+}
+
+// Construct count elements from the range at first in the raw memory at
+// dest, with the same rollback. A contiguous range of the same trivially
+// copyable type is a single memcpy.
+template<class Allocator, class T, class InputIt>
+constexpr void construct_range(Allocator& alloc, T* dest, InputIt first, std::size_t count){
+    using traits = std::allocator_traits<Allocator>;
+    if constexpr (std::contiguous_iterator<InputIt> && std::is_trivially_copyable_v<T>
+                  && std::is_same_v<std::iter_value_t<InputIt>, T>){
+        if( !std::is_constant_evaluated()){
+            if( count != 0)
+                std::memcpy(static_cast<void*>(dest), static_cast<const void*>(std::to_address(first)), count * sizeof(T));
+            return;
+        }
+    }
+
+    std::size_t i = 0;
+    try {
+        for(; i < count; ++i, ++first)
+            traits::construct(alloc, dest + i, *first);
+    } catch(...) {
+        destroy_n(alloc, dest, i);
+        throw;
+    }
+}
+
+}
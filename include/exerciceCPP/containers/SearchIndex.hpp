@@ -0,0 +1,185 @@
+#pragma once
+
+#include <algorithm> // min
+#include <bit> // countr_one bit_width
+#include <cstddef> // size_t ptrdiff_t
+#include <cstdint> // uintptr_t
+#include <functional> // less
+#include <span> // span
+#include <stdexcept> // length_error
+#include "Vector.hpp"
+#include "../memory/CachePadded.hpp"
+
+namespace yadej {
+
+// Static search structure over a sorted sequence, for many point lookups
+// against a big immutable array.
+//
+// The elements are stored in Eytzinger order (the breadth first order of
+// the implicit binary search tree: the children of slot k are 2k and
+// 2k+1), so the first levels of every search share the same few cache
+// lines and a search reads one line per level deep in the tree. The
+// descent has no branch, and the line holding the descendants of the
+// current slot a few levels down is prefetched while the comparisons of
+// the levels in between go on. The buffer starts on a cache line so those
+// descendants fill whole lines.
+//
+// lower_bound gives the position in the sorted sequence, taken from a
+// rank kept for each slot. The batch lookups move several queries down the
+// tree level by level, their cache misses overlap.
+//
+//     yadej::SearchIndex<std::uint32_t> index(sorted_ids);
+//     const std::size_t position = index.lower_bound(id);
+template<class T, class Compare = std::less<T>>
+class SearchIndex {
+public:
+    using value_type = T;
+    using size_type = std::size_t;
+    using difference_type = std::ptrdiff_t;
+    using key_compare = Compare;
+
+    // Queries moving down the tree together in the batch lookups
+    static constexpr size_type batch_size = 16;
+
+    SearchIndex() = default;
+    // sorted must be sorted by comp, it is read once in order
+    explicit SearchIndex( std::span<const T> sorted, const Compare& comp = Compare());
+
+    bool empty() const noexcept{ return m_size == 0; }
+    size_type size() const noexcept{ return m_size; }
+
+    // Position of the first element not ordered before key, size() if none
+    size_type lower_bound(const T& key) const;
+    bool contains(const T& key) const;
+
+    // lower_bound and contains of every key, positions and found must have
+    // the size of keys
+    void lower_bound_batch(std::span<const T> keys, std::span<size_type> positions) const;
+    void contains_batch(std::span<const T> keys, std::span<bool> found) const;
+
+    key_compare key_comp() const{ return m_comp; }
+
+private:
+    // Elements of T sharing a cache line: the descendants of slot k that
+    // many levels down are the line starting at slot k * line_elements
+    static constexpr size_type line_elements = sizeof(T) < cache_line_size ? cache_line_size / sizeof(T) : 1;
+    static_assert((line_elements & (line_elements - 1)) == 0);
+
+    // In order walk of the tree under slot, the next element of sorted
+    // goes to each slot. Gives the position of the next element.
+    size_type build(std::span<const T> sorted, size_type position, size_type slot);
+
+    void prefetch(size_type slot) const noexcept{
+        // Only a hint, the address may be past the end and is not computed
+        // with pointer arithmetic
+        const std::uintptr_t address = reinterpret_cast<std::uintptr_t>(m_tree.data()) + slot * line_elements * sizeof(T);
+        __builtin_prefetch(reinterpret_cast<const void*>(address));
+    }
+
+    // Slot of the first element not ordered before key, 0 if none
+    size_type search(const T& key) const;
+    // Slot of each key as search
+    void search_batch(std::span<const T> keys, size_type* slots) const;
+    static size_type resolve(size_type slot) noexcept{
+        // The descent went right after the slot of the answer, then only
+        // left: dropping those lefts and the last right gives it
+        return slot >> (std::countr_one(slot) + 1);
+    }
+
+    // Slot 0 is unused, the tree is in slots 1 to m_size
+    AlignedVector<T, cache_line_size> m_tree;
+    Vector<size_type> m_rank;
+    size_type m_size{0};
+    [[no_unique_address]] Compare m_comp;
+};
+
+template<class T, class Compare>
+SearchIndex<T, Compare>::SearchIndex( std::span<const T> sorted, const Compare& comp)
+        : m_size(sorted.size()), m_comp(comp){
+    if( sorted.empty())
+        return;
+    m_tree.resize(m_size + 1, sorted.front());
+    m_rank.resize(m_size + 1, 0);
+    build(sorted, 0, 1);
+}
+
+template<class T, class Compare>
+typename SearchIndex<T, Compare>::size_type SearchIndex<T, Compare>::build(std::span<const T> sorted, size_type position, size_type slot){
+    if( slot > m_size)
+        return position;
+    position = build(sorted, position, 2 * slot);
+    m_tree[slot] = sorted[position];
+    m_rank[slot] = position;
+    return build(sorted, position + 1, 2 * slot + 1);
+}
+
+template<class T, class Compare>
+typename SearchIndex<T, Compare>::size_type SearchIndex<T, Compare>::search(const T& key) const{
+    const T* tree = m_tree.data();
+    size_type slot = 1;
+    while( slot <= m_size){
+        prefetch(slot);
+        slot = 2 * slot + static_cast<size_type>(m_comp(tree[slot], key));
+    }
+    return resolve(slot);
+}
+
+template<class T, class Compare>
+void SearchIndex<T, Compare>::search_batch(std::span<const T> keys, size_type* slots) const{
+    const T* tree = m_tree.data();
+    // A descent takes at most one step per level of the tree
+    const auto levels = static_cast<size_type>(std::bit_width(m_size));
+    for(size_type i=0; i < keys.size(); ++i)
+        slots[i] = 1;
+    for(size_type level=0; level < levels; ++level){
+        for(size_type i=0; i < keys.size(); ++i){
+            const size_type slot = slots[i];
+            if( slot <= m_size){
+                prefetch(slot);
+                slots[i] = 2 * slot + static_cast<size_type>(m_comp(tree[slot], keys[i]));
+            }
+        }
+    }
+    for(size_type i=0; i < keys.size(); ++i)
+        slots[i] = resolve(slots[i]);
+}
+
+template<class T, class Compare>
+typename SearchIndex<T, Compare>::size_type SearchIndex<T, Compare>::lower_bound(const T& key) const{
+    const size_type slot = search(key);
+    return slot == 0 ? m_size : m_rank[slot];
+}
+
+template<class T, class Compare>
+bool SearchIndex<T, Compare>::contains(const T& key) const{
+    const size_type slot = search(key);
+    return slot != 0 && !m_comp(key, m_tree[slot]);
+}
+
+template<class T, class Compare>
+void SearchIndex<T, Compare>::lower_bound_batch(std::span<const T> keys, std::span<size_type> positions) const{
+    if( keys.size() != positions.size())
+        throw std::length_error("Keys and positions of different sizes");
+    size_type slots[batch_size];
+    for(size_type first=0; first < keys.size(); first += batch_size){
+        const std::span<const T> block = keys.subspan(first, std::min(batch_size, keys.size() - first));
+        search_batch(block, slots);
+        for(size_type i=0; i < block.size(); ++i)
+            positions[first + i] = slots[i] == 0 ? m_size : m_rank[slots[i]];
+    }
+}
+
+template<class T, class Compare>
+void SearchIndex<T, Compare>::contains_batch(std::span<const T> keys, std::span<bool> found) const{
+    if( keys.size() != found.size())
+        throw std::length_error("Keys and results of different sizes");
+    size_type slots[batch_size];
+    for(size_type first=0; first < keys.size(); first += batch_size){
+        const std::span<const T> block = keys.subspan(first, std::min(batch_size, keys.size() - first));
+        search_batch(block, slots);
+        for(size_type i=0; i < block.size(); ++i)
+            found[first + i] = slots[i] != 0 && !m_comp(block[i], m_tree[slots[i]]);
+    }
+}
+
+}
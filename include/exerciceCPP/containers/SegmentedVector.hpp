@@ -0,0 +1,410 @@
+#pragma once
+
+#include <algorithm> // max min
+#include <bit> // bit_floor countr_zero has_single_bit
+#include <cstddef> // size_t ptrdiff_t
+#include <initializer_list> // initializer_list
+#include <limits> // numeric_limits -> max
+#include <memory> // allocator allocator_traits
+#include <span> // span
+#include <stdexcept> // out_of_range length_error
+#include <utility> // forward move swap
+#include "Iterator.hpp"
+#include "Vector.hpp"
+
+namespace yadej {
+
+// Default chunk: as many elements as fit in 64 KiB, rounded down to a power of two
+template<class T>
+inline constexpr std::size_t segmented_chunk_size = std::bit_floor(std::max<std::size_t>(1, 65536 / sizeof(T)));
+
+// Vector storing its elements in fixed chunks of ChunkSize elements.
+// Appending allocates a new chunk when the last one is full and never
+// moves an element, so references stay valid and growing a huge vector
+// neither copies it nor needs twice its memory. Only the table of chunk
+// pointers is a Vector which grows as usual.
+// Element i lives in chunk i >> shift at offset i & mask.
+template<class T, std::size_t ChunkSize = segmented_chunk_size<T>, class Allocator = std::allocator<T>>
+class SegmentedVector {
+    static_assert(std::has_single_bit(ChunkSize), "SegmentedVector chunk size must be a power of two");
+public:
+
+    // Declaration of type
+    using value_type = T;
+    using allocator_type = Allocator;
+    using size_type = std::size_t;
+    using difference_type = std::ptrdiff_t;
+    using reference = T&;
+    using const_reference = const T&;
+    using pointer = T*;
+    using const_pointer = const T*;
+
+    static constexpr size_type chunk_shift = std::countr_zero(ChunkSize);
+    static constexpr size_type chunk_mask = ChunkSize - 1;
+
+    // Constructors and Destructors
+    SegmentedVector() noexcept(noexcept(Allocator())) = default;
+    explicit SegmentedVector( const allocator_type& alloc) noexcept;
+    SegmentedVector( size_type count, const_reference value, const allocator_type& alloc = Allocator());
+    explicit SegmentedVector( size_type count, const allocator_type& alloc = Allocator());
+    template<class InputIt> requires is_iterator<InputIt>
+    SegmentedVector( InputIt first, InputIt last, const allocator_type& alloc = Allocator());
+    SegmentedVector( std::initializer_list<T> init, const allocator_type& alloc = Allocator());
+    SegmentedVector(SegmentedVector && other) noexcept;
+    SegmentedVector(const SegmentedVector & other);
+    SegmentedVector &operator=(SegmentedVector &&) noexcept;
+    SegmentedVector &operator=(const SegmentedVector &);
+    ~SegmentedVector();
+
+    // Element access
+    reference at(size_type position);
+    const_reference at(size_type position) const;
+
+    reference operator[](size_type position);
+    const_reference operator[](size_type position) const;
+
+    reference front();
+    const_reference front() const;
+
+    reference back();
+    const_reference back() const;
+
+    // Contiguous pieces, chunk(i) holds the elements [i * ChunkSize, min(size, (i + 1) * ChunkSize))
+    size_type chunk_count() const noexcept;
+    std::span<T> chunk(size_type index);
+    std::span<const T> chunk(size_type index) const;
+    static constexpr size_type chunk_size() noexcept { return ChunkSize; }
+
+    // iterator
+    //
+    using iterator = segmented_iterator<T, chunk_shift>;
+    using const_iterator = segmented_iterator<const T, chunk_shift>;
+    iterator begin() noexcept;
+    const_iterator begin() const noexcept;
+    iterator end() noexcept;
+    const_iterator end() const noexcept;
+    const_iterator cbegin() const noexcept;
+    const_iterator cend() const noexcept;
+
+    // Container
+    //
+    bool empty() const noexcept;
+    size_type size() const noexcept;
+    size_type max_size() const noexcept;
+    // Allocate the chunks needed for new_cap elements
+    void reserve( const size_type new_cap);
+    size_type capacity() const noexcept;
+    // Give back the chunks holding no element
+    void shrink_to_fit();
+
+    // Modifier, the chunks are kept by clear
+    void clear() noexcept;
+
+    void push_back( const_reference value);
+    void push_back( value_type&& value);
+    template<class... Args>
+    reference emplace_back( Args&&... args);
+    void pop_back();
+    void resize(size_type count);
+    void resize(size_type count, const_reference value);
+    void swap(SegmentedVector& other) noexcept;
+private:
+    using chunk_allocator = typename std::allocator_traits<Allocator>::template rebind_alloc<pointer>;
+
+    void add_chunk();
+    void destroy_elements(size_type from) noexcept;
+    void deallocate_chunks(size_type from) noexcept;
+
+    Vector<pointer, chunk_allocator> m_chunks;
+    size_type m_current_size{0};
+    Allocator allocator{};
+};
+
+template<class T, std::size_t ChunkSize, class Allocator>
+SegmentedVector<T, ChunkSize, Allocator>::SegmentedVector( const allocator_type& alloc) noexcept
+        : m_chunks(chunk_allocator(alloc)), allocator(alloc){
+}
+
+template<class T, std::size_t ChunkSize, class Allocator>
+SegmentedVector<T, ChunkSize, Allocator>::SegmentedVector( size_type count,
+                                                           const_reference value,
+                                                           const allocator_type& alloc )
+        : SegmentedVector(alloc){
+    resize(count, value);
+}
+
+template<class T, std::size_t ChunkSize, class Allocator>
+SegmentedVector<T, ChunkSize, Allocator>::SegmentedVector( size_type count, const allocator_type& alloc )
+        : SegmentedVector(alloc){
+    resize(count);
+}
+
+template<class T, std::size_t ChunkSize, class Allocator>
+template<class InputIt> requires is_iterator<InputIt>
+SegmentedVector<T, ChunkSize, Allocator>::SegmentedVector( InputIt first, InputIt last, const allocator_type& alloc )
+        : SegmentedVector(alloc){
+    for(; first != last; ++first)
+        emplace_back(*first);
+}
+
+template<class T, std::size_t ChunkSize, class Allocator>
+SegmentedVector<T, ChunkSize, Allocator>::SegmentedVector( std::initializer_list<T> init, const allocator_type& alloc )
+        : SegmentedVector(init.begin(), init.end(), alloc){
+}
+
+template<class T, std::size_t ChunkSize, class Allocator>
+SegmentedVector<T, ChunkSize, Allocator>::SegmentedVector(SegmentedVector && other) noexcept
+        : m_chunks(std::move(other.m_chunks)), m_current_size(other.m_current_size), allocator(std::move(other.allocator)){
+    other.m_current_size = 0;
+}
+
+template<class T, std::size_t ChunkSize, class Allocator>
+SegmentedVector<T, ChunkSize, Allocator>::SegmentedVector(const SegmentedVector & other)
+        : SegmentedVector(std::allocator_traits<Allocator>::select_on_container_copy_construction(other.allocator)){
+    reserve(other.m_current_size);
+    for(const_reference value : other)
+        emplace_back(value);
+}
+
+template<class T, std::size_t ChunkSize, class Allocator>
+SegmentedVector<T, ChunkSize, Allocator>& SegmentedVector<T, ChunkSize, Allocator>::operator=(SegmentedVector && other) noexcept{
+    SegmentedVector moved(std::move(other));
+    swap(moved);
+    return *this;
+}
+
+template<class T, std::size_t ChunkSize, class Allocator>
+SegmentedVector<T, ChunkSize, Allocator>& SegmentedVector<T, ChunkSize, Allocator>::operator=(const SegmentedVector& other){
+    if( this == &other)
+        return *this;
+
+    SegmentedVector copy(other);
+    swap(copy);
+    return *this;
+}
+
+template<class T, std::size_t ChunkSize, class Allocator>
+SegmentedVector<T, ChunkSize, Allocator>::~SegmentedVector() {
+    destroy_elements(0);
+    deallocate_chunks(0);
+}
+
+template<class T, std::size_t ChunkSize, class Allocator>
+T& SegmentedVector<T, ChunkSize, Allocator>::at(size_type position){
+    if( position >= m_current_size )
+        throw std::out_of_range("SegmentedVector::at position out of range");
+    return (*this)[position];
+}
+template<class T, std::size_t ChunkSize, class Allocator>
+const T& SegmentedVector<T, ChunkSize, Allocator>::at(size_type position) const{
+    if( position >= m_current_size )
+        throw std::out_of_range("SegmentedVector::at position out of range");
+    return (*this)[position];
+}
+
+template<class T, std::size_t ChunkSize, class Allocator>
+T& SegmentedVector<T, ChunkSize, Allocator>::operator[](size_type position){
+    return m_chunks[position >> chunk_shift][position & chunk_mask];
+}
+template<class T, std::size_t ChunkSize, class Allocator>
+const T& SegmentedVector<T, ChunkSize, Allocator>::operator[](size_type position) const{
+    return m_chunks[position >> chunk_shift][position & chunk_mask];
+}
+
+template<class T, std::size_t ChunkSize, class Allocator>
+T& SegmentedVector<T, ChunkSize, Allocator>::front(){
+    return at(0);
+}
+template<class T, std::size_t ChunkSize, class Allocator>
+const T& SegmentedVector<T, ChunkSize, Allocator>::front() const{
+    return at(0);
+}
+
+template<class T, std::size_t ChunkSize, class Allocator>
+T& SegmentedVector<T, ChunkSize, Allocator>::back(){
+    return at(m_current_size - 1);
+}
+template<class T, std::size_t ChunkSize, class Allocator>
+const T& SegmentedVector<T, ChunkSize, Allocator>::back() const{
+    return at(m_current_size - 1);
+}
+
+template<class T, std::size_t ChunkSize, class Allocator>
+std::size_t SegmentedVector<T, ChunkSize, Allocator>::chunk_count() const noexcept{
+    return (m_current_size + chunk_mask) >> chunk_shift;
+}
+
+template<class T, std::size_t ChunkSize, class Allocator>
+std::span<T> SegmentedVector<T, ChunkSize, Allocator>::chunk(size_type index){
+    const size_type start = index << chunk_shift;
+    return std::span<T>(m_chunks[index], std::min(ChunkSize, m_current_size - start));
+}
+template<class T, std::size_t ChunkSize, class Allocator>
+std::span<const T> SegmentedVector<T, ChunkSize, Allocator>::chunk(size_type index) const{
+    const size_type start = index << chunk_shift;
+    return std::span<const T>(m_chunks[index], std::min(ChunkSize, m_current_size - start));
+}
+
+template<class T, std::size_t ChunkSize, class Allocator>
+SegmentedVector<T, ChunkSize, Allocator>::iterator SegmentedVector<T, ChunkSize, Allocator>::begin() noexcept{
+    return iterator(m_chunks.data(), 0);
+}
+
+template<class T, std::size_t ChunkSize, class Allocator>
+SegmentedVector<T, ChunkSize, Allocator>::const_iterator SegmentedVector<T, ChunkSize, Allocator>::begin() const noexcept{
+    return const_iterator(m_chunks.data(), 0);
+}
+
+template<class T, std::size_t ChunkSize, class Allocator>
+SegmentedVector<T, ChunkSize, Allocator>::iterator SegmentedVector<T, ChunkSize, Allocator>::end() noexcept{
+    return iterator(m_chunks.data(), m_current_size);
+}
+
+template<class T, std::size_t ChunkSize, class Allocator>
+SegmentedVector<T, ChunkSize, Allocator>::const_iterator SegmentedVector<T, ChunkSize, Allocator>::end() const noexcept{
+    return const_iterator(m_chunks.data(), m_current_size);
+}
+
+template<class T, std::size_t ChunkSize, class Allocator>
+SegmentedVector<T, ChunkSize, Allocator>::const_iterator SegmentedVector<T, ChunkSize, Allocator>::cbegin() const noexcept{
+    return begin();
+}
+
+template<class T, std::size_t ChunkSize, class Allocator>
+SegmentedVector<T, ChunkSize, Allocator>::const_iterator SegmentedVector<T, ChunkSize, Allocator>::cend() const noexcept{
+    return end();
+}
+
+template<class T, std::size_t ChunkSize, class Allocator>
+bool SegmentedVector<T, ChunkSize, Allocator>::empty() const noexcept{
+    return ( m_current_size == 0);
+}
+
+template<class T, std::size_t ChunkSize, class Allocator>
+std::size_t SegmentedVector<T, ChunkSize, Allocator>::size() const noexcept{
+    return m_current_size;
+}
+
+template<class T, std::size_t ChunkSize, class Allocator>
+std::size_t SegmentedVector<T, ChunkSize, Allocator>::max_size() const noexcept{
+    return std::numeric_limits<ptrdiff_t>::max();
+}
+
+template<class T, std::size_t ChunkSize, class Allocator>
+void SegmentedVector<T, ChunkSize, Allocator>::reserve(const size_type new_cap){
+    if (new_cap > max_size())
+        throw std::length_error(" The new cap exceed the absolute maximum size");
+    const size_type needed = (new_cap + chunk_mask) >> chunk_shift;
+    m_chunks.reserve(needed);
+    while( m_chunks.size() < needed)
+        add_chunk();
+}
+
+template<class T, std::size_t ChunkSize, class Allocator>
+std::size_t SegmentedVector<T, ChunkSize, Allocator>::capacity() const noexcept{
+    return m_chunks.size() << chunk_shift;
+}
+
+template<class T, std::size_t ChunkSize, class Allocator>
+void SegmentedVector<T, ChunkSize, Allocator>::shrink_to_fit(){
+    deallocate_chunks(chunk_count());
+    m_chunks.shrink_to_fit();
+}
+
+template<class T, std::size_t ChunkSize, class Allocator>
+void SegmentedVector<T, ChunkSize, Allocator>::clear() noexcept{
+    destroy_elements(0);
+}
+
+template<class T, std::size_t ChunkSize, class Allocator>
+void SegmentedVector<T, ChunkSize, Allocator>::push_back(const_reference value){
+    emplace_back(value);
+}
+
+template<class T, std::size_t ChunkSize, class Allocator>
+void SegmentedVector<T, ChunkSize, Allocator>::push_back(value_type&& value){
+    emplace_back(std::move(value));
+}
+
+template<class T, std::size_t ChunkSize, class Allocator>
+template<class... Args>
+T& SegmentedVector<T, ChunkSize, Allocator>::emplace_back(Args&&... args){
+    if( m_current_size == capacity())
+        add_chunk();
+    pointer slot = m_chunks[m_current_size >> chunk_shift] + (m_current_size & chunk_mask);
+    std::allocator_traits<Allocator>::construct(allocator, slot, std::forward<Args>(args)...);
+    ++m_current_size;
+    return *slot;
+}
+
+template<class T, std::size_t ChunkSize, class Allocator>
+void SegmentedVector<T, ChunkSize, Allocator>::pop_back(){
+    destroy_elements(m_current_size - 1);
+}
+
+template<class T, std::size_t ChunkSize, class Allocator>
+void SegmentedVector<T, ChunkSize, Allocator>::resize(size_type count){
+    if( count <= m_current_size){
+        destroy_elements(count);
+        return;
+    }
+    reserve(count);
+    while( m_current_size < count)
+        emplace_back();
+}
+
+template<class T, std::size_t ChunkSize, class Allocator>
+void SegmentedVector<T, ChunkSize, Allocator>::resize(size_type count, const_reference value){
+    if( count <= m_current_size){
+        destroy_elements(count);
+        return;
+    }
+    reserve(count);
+    while( m_current_size < count)
+        emplace_back(value);
+}
+
+template<class T, std::size_t ChunkSize, class Allocator>
+void SegmentedVector<T, ChunkSize, Allocator>::swap(SegmentedVector& other) noexcept{
+    m_chunks.swap(other.m_chunks);
+    std::swap(m_current_size, other.m_current_size);
+    if constexpr (std::allocator_traits<Allocator>::propagate_on_container_swap::value){
+        using std::swap;
+        swap(allocator, other.allocator);
+    }
+}
+
+template<class T, std::size_t ChunkSize, class Allocator>
+void SegmentedVector<T, ChunkSize, Allocator>::add_chunk(){
+    pointer chunk = std::allocator_traits<Allocator>::allocate(allocator, ChunkSize);
+    try {
+        m_chunks.push_back(chunk);
+    }catch(...){
+        std::allocator_traits<Allocator>::deallocate(allocator, chunk, ChunkSize);
+        throw;
+    }
+}
+
+// Destroy the elements from position to the end, the size becomes position
+template<class T, std::size_t ChunkSize, class Allocator>
+void SegmentedVector<T, ChunkSize, Allocator>::destroy_elements(size_type from) noexcept{
+    for(size_type i=from; i < m_current_size; ++i)
+        std::allocator_traits<Allocator>::destroy(allocator, &(*this)[i]);
+    m_current_size = std::min(from, m_current_size);
+}
+
+// Give back the chunks from index from, they must hold no element
+template<class T, std::size_t ChunkSize, class Allocator>
+void SegmentedVector<T, ChunkSize, Allocator>::deallocate_chunks(size_type from) noexcept{
+    while( m_chunks.size() > from){
+        std::allocator_traits<Allocator>::deallocate(allocator, m_chunks.back(), ChunkSize);
+        m_chunks.pop_back();
+    }
+}
+
+template<class T, std::size_t ChunkSize, class Allocator>
+void swap(SegmentedVector<T, ChunkSize, Allocator>& l_arg, SegmentedVector<T, ChunkSize, Allocator>& r_arg) noexcept{
+    l_arg.swap(r_arg);
+}
+
+}
@@ -0,0 +1,638 @@
+#pragma once
+
+#include <algorithm> // fill_n copy_n
+#include <cstddef> // size_t ptrdiff_t byte
+#include <initializer_list> // initializer_list
+#include <iterator> // distance next make_move_iterator iter_difference_t
+#include <limits> // numeric_limits -> max
+#include <memory> // allocator allocator_traits
+#include <stdexcept> // invalid_argument out_of_range length_error
+#include <utility> // forward move
+#include "GrowthPolicy.hpp"
+#include "Iterator.hpp"
+#include "Relocation.hpp"
+#include "Vector.hpp"
+
+namespace yadej {
+
+// Vector storing up to N elements inside the object itself.
+// The allocator is only used once the size goes past N,
+// clear and shrink_to_fit come back to the inline storage when possible.
+template<class T, std::size_t N, class Allocator = std::allocator<T>, growth_policy GrowthPolicy = growth::Doubling>
+class SmallVector {
+    static_assert(N > 0, "SmallVector needs at least one inline element, use Vector otherwise");
+public:
+
+    // Declaration of type
+    using value_type = T;
+    using allocator_type = Allocator;
+    using size_type = std::size_t;
+    using difference_type = std::ptrdiff_t;
+    using reference = T&;
+    using const_reference = const T&;
+    using pointer = T*;
+    using const_pointer = const T*;
+    // Constructors and Destructors
+    constexpr SmallVector() noexcept(noexcept(Allocator()));
+    constexpr SmallVector( const allocator_type& alloc) noexcept;
+    SmallVector( size_type count, const_reference value, const allocator_type& alloc = Allocator());
+    explicit SmallVector( size_type count, const allocator_type& alloc = Allocator());
+    template<class InputIt> requires is_iterator<InputIt>
+    constexpr SmallVector( InputIt first, InputIt last, const allocator_type& alloc = Allocator());
+    // Inline elements are relocated, so moving is noexcept when they relocate without throwing
+    constexpr SmallVector(SmallVector && other) noexcept(is_nothrow_relocatable_v<T>);
+    constexpr SmallVector(SmallVector && other, const allocator_type& alloc);
+    constexpr SmallVector(const SmallVector & other);
+    constexpr SmallVector(const SmallVector & other, const allocator_type& alloc);
+    constexpr SmallVector( std::initializer_list<T> init, const allocator_type& alloc = Allocator());
+    // The allocator propagates as for Vector
+    constexpr SmallVector &operator=(SmallVector &&) noexcept((std::allocator_traits<Allocator>::propagate_on_container_move_assignment::value
+                                                               || std::allocator_traits<Allocator>::is_always_equal::value)
+                                                              && is_nothrow_relocatable_v<T>);
+    constexpr SmallVector &operator=(const SmallVector &);
+    constexpr ~SmallVector();
+
+    constexpr allocator_type get_allocator() const noexcept{ return allocator; }
+
+    // Element access
+    constexpr reference at(size_type position);
+    constexpr const_reference at(size_type position) const;
+
+    constexpr reference operator[](size_type position);
+    constexpr const_reference operator[](size_type position) const;
+
+    constexpr reference front();
+    constexpr const_reference front() const;
+
+    constexpr reference back();
+    constexpr const_reference back() const;
+
+    constexpr pointer data();
+    constexpr const_pointer data() const;
+
+    // iterator
+    //
+    using iterator = iterator_base<T>;
+    using const_iterator = const iterator_base<T>;
+    constexpr iterator begin();
+    constexpr const_iterator begin() const noexcept;
+    constexpr iterator end();
+    constexpr const_iterator end() const noexcept;
+    constexpr const_iterator cbegin() const noexcept;
+    constexpr const_iterator cend() const noexcept;
+
+    // Container
+    //
+    constexpr bool empty() const noexcept;
+    constexpr size_type size() const noexcept;
+    constexpr size_type max_size() const noexcept;
+    constexpr void reserve( const size_type new_cap);
+    constexpr size_type capacity() const noexcept;
+    constexpr void shrink_to_fit();
+    // True while the elements live in the inline storage
+    constexpr bool is_inline() const noexcept;
+    static constexpr size_type inline_capacity() noexcept { return N; }
+
+    // Modifier
+    constexpr void clear() noexcept;
+
+    constexpr iterator insert( const_iterator pos, const_reference value);
+    constexpr iterator insert( const_iterator pos, T&& value);
+    constexpr iterator insert( const_iterator pos, size_type count, const_reference value);
+    template<class InputIt> requires is_iterator<InputIt>
+    constexpr iterator insert( const_iterator pos, InputIt first, InputIt last);
+    constexpr iterator insert( const_iterator pos, std::initializer_list<T> ilist);
+    template<class... Args>
+    constexpr iterator emplace( const_iterator pos, Args&&... args);
+    constexpr void erase( const_iterator pos);
+    constexpr void erase( const_iterator first, const_iterator last);
+
+    constexpr void push_back( const_reference value);
+    constexpr void push_back( value_type&& value);
+    template<class... Args>
+    constexpr reference emplace_back( Args&&... args);
+    constexpr void pop_back();
+    constexpr void resize(size_type count);
+    constexpr void resize(size_type count, const_reference value);
+private:
+    alignas(T) std::byte m_inline[N * sizeof(T)];
+    pointer m_elements = inline_elements();
+    size_type m_current_size{0};
+    size_type m_max_size{N};
+    Allocator allocator{};
+
+    constexpr pointer inline_elements() noexcept;
+    void destroy_elements(iterator first, iterator last);
+    // Give the heap buffer back to the allocator, nothing to do for the inline storage
+    void deallocate_elements(pointer elements);
+
+    static constexpr size_type grow_capacity(size_type capacity, size_type required);
+    // Allocate count elements, the inline storage is used when they fit in it
+    constexpr pointer allocate_elements(size_type count);
+    // Take the elements of other, leaving it empty. A heap buffer is
+    // stolen, inline elements are relocated in our inline storage
+    constexpr void steal_elements(SmallVector& other);
+    template<class Construct>
+    constexpr void reallocate(size_type new_cap, size_type gap_pos, size_type gap_count, Construct&& construct_gap);
+};
+
+template<class T, std::size_t N, class Allocator, growth_policy GrowthPolicy>
+constexpr SmallVector<T, N, Allocator, GrowthPolicy>::SmallVector() noexcept(noexcept(Allocator()))
+        : allocator(Allocator()){
+}
+
+template<class T, std::size_t N, class Allocator, growth_policy GrowthPolicy>
+constexpr SmallVector<T, N, Allocator, GrowthPolicy>::SmallVector( const allocator_type& alloc) noexcept
+        : allocator(alloc){
+}
+
+template<class T, std::size_t N, class Allocator, growth_policy GrowthPolicy>
+SmallVector<T, N, Allocator, GrowthPolicy>::SmallVector( size_type count,
+                                                         const_reference value,
+                                                         const allocator_type& alloc )
+        : allocator(alloc){
+    resize(count, value);
+}
+
+template<class T, std::size_t N, class Allocator, growth_policy GrowthPolicy>
+SmallVector<T, N, Allocator, GrowthPolicy>::SmallVector( size_type count, const allocator_type& alloc )
+        : allocator(alloc){
+    resize(count);
+}
+
+template<class T, std::size_t N, class Allocator, growth_policy GrowthPolicy>
+template<class InputIt> requires is_iterator<InputIt>
+constexpr SmallVector<T, N, Allocator, GrowthPolicy>::SmallVector( InputIt first, InputIt last, const allocator_type& alloc )
+        : allocator(alloc){
+    insert(end(), first, last);
+}
+
+template<class T, std::size_t N, class Allocator, growth_policy GrowthPolicy>
+constexpr SmallVector<T, N, Allocator, GrowthPolicy>::SmallVector(SmallVector && other) noexcept(is_nothrow_relocatable_v<T>)
+        : allocator(std::move(other.allocator)){
+    steal_elements(other);
+}
+
+template<class T, std::size_t N, class Allocator, growth_policy GrowthPolicy>
+constexpr SmallVector<T, N, Allocator, GrowthPolicy>::SmallVector(SmallVector && other, const allocator_type& alloc)
+        : allocator(alloc){
+    // Inline elements are relocated whatever the allocator, a heap buffer
+    // of another allocator is not ours to keep
+    if( other.is_inline() || allocator == other.allocator){
+        steal_elements(other);
+        return;
+    }
+    reserve(other.m_current_size);
+    construct_range(allocator, m_elements, std::make_move_iterator(other.m_elements), other.m_current_size);
+    m_current_size = other.m_current_size;
+}
+
+template<class T, std::size_t N, class Allocator, growth_policy GrowthPolicy>
+constexpr SmallVector<T, N, Allocator, GrowthPolicy>::SmallVector(const SmallVector & other)
+        : SmallVector(other, std::allocator_traits<Allocator>::select_on_container_copy_construction(other.allocator)){
+}
+
+template<class T, std::size_t N, class Allocator, growth_policy GrowthPolicy>
+constexpr SmallVector<T, N, Allocator, GrowthPolicy>::SmallVector(const SmallVector & other, const allocator_type& alloc)
+        : allocator(alloc){
+    insert(end(), other.begin(), other.end());
+}
+
+template<class T, std::size_t N, class Allocator, growth_policy GrowthPolicy>
+constexpr SmallVector<T, N, Allocator, GrowthPolicy>::SmallVector(std::initializer_list<T> init, const Allocator& alloc)
+        : allocator(alloc){
+    insert(end(), init.begin(), init.end());
+}
+
+template<class T, std::size_t N, class Allocator, growth_policy GrowthPolicy>
+constexpr SmallVector<T, N, Allocator, GrowthPolicy>& SmallVector<T, N, Allocator, GrowthPolicy>::operator=(SmallVector && other)
+        noexcept((std::allocator_traits<Allocator>::propagate_on_container_move_assignment::value
+                  || std::allocator_traits<Allocator>::is_always_equal::value)
+                 && is_nothrow_relocatable_v<T>){
+    if( this == &other)
+        return *this;
+
+    clear();
+    if constexpr (std::allocator_traits<Allocator>::propagate_on_container_move_assignment::value){
+        allocator = std::move(other.allocator);
+        steal_elements(other);
+    } else if constexpr (std::allocator_traits<Allocator>::is_always_equal::value){
+        steal_elements(other);
+    } else {
+        if( other.is_inline() || allocator == other.allocator){
+            steal_elements(other);
+            return *this;
+        }
+
+        // Our allocator stays, the elements have to be moved in memory it owns
+        reserve(other.m_current_size);
+        construct_range(allocator, m_elements, std::make_move_iterator(other.m_elements), other.m_current_size);
+        m_current_size = other.m_current_size;
+    }
+    return *this;
+}
+
+template<class T, std::size_t N, class Allocator, growth_policy GrowthPolicy>
+constexpr SmallVector<T, N, Allocator, GrowthPolicy>& SmallVector<T, N, Allocator, GrowthPolicy>::operator=(const SmallVector& other){
+    if( this == &other)
+        return *this;
+
+    // Release the memory with the allocator which gave it before propagating
+    clear();
+    if constexpr (std::allocator_traits<Allocator>::propagate_on_container_copy_assignment::value)
+        allocator = other.allocator;
+    insert(end(), other.begin(), other.end());
+    return *this;
+}
+
+template<class T, std::size_t N, class Allocator, growth_policy GrowthPolicy>
+constexpr SmallVector<T, N, Allocator, GrowthPolicy>::~SmallVector() {
+    destroy_elements(begin(), end());
+    deallocate_elements(m_elements);
+}
+
+template<class T, std::size_t N, class Allocator, growth_policy GrowthPolicy>
+constexpr T& SmallVector<T, N, Allocator, GrowthPolicy>::at(size_type position){
+    if( position >= m_current_size )
+        throw std::out_of_range("SmallVector::at position out of range");
+    return m_elements[position];
+}
+template<class T, std::size_t N, class Allocator, growth_policy GrowthPolicy>
+constexpr const T& SmallVector<T, N, Allocator, GrowthPolicy>::at(size_type position) const{
+    if( position >= m_current_size )
+        throw std::out_of_range("SmallVector::at position out of range");
+    return m_elements[position];
+}
+
+template<class T, std::size_t N, class Allocator, growth_policy GrowthPolicy>
+constexpr T& SmallVector<T, N, Allocator, GrowthPolicy>::operator[](size_type position){
+    return m_elements[position];
+}
+template<class T, std::size_t N, class Allocator, growth_policy GrowthPolicy>
+constexpr const T& SmallVector<T, N, Allocator, GrowthPolicy>::operator[](size_type position) const{
+    return m_elements[position];
+}
+
+template<class T, std::size_t N, class Allocator, growth_policy GrowthPolicy>
+constexpr T& SmallVector<T, N, Allocator, GrowthPolicy>::front(){
+    return at(0);
+}
+template<class T, std::size_t N, class Allocator, growth_policy GrowthPolicy>
+constexpr const T& SmallVector<T, N, Allocator, GrowthPolicy>::front() const{
+    return at(0);
+}
+
+template<class T, std::size_t N, class Allocator, growth_policy GrowthPolicy>
+constexpr T& SmallVector<T, N, Allocator, GrowthPolicy>::back(){
+    return at(m_current_size - 1);
+}
+template<class T, std::size_t N, class Allocator, growth_policy GrowthPolicy>
+constexpr const T& SmallVector<T, N, Allocator, GrowthPolicy>::back() const{
+    return at(m_current_size - 1);
+}
+
+template<class T, std::size_t N, class Allocator, growth_policy GrowthPolicy>
+constexpr T* SmallVector<T, N, Allocator, GrowthPolicy>::data(){
+    return m_elements;
+}
+template<class T, std::size_t N, class Allocator, growth_policy GrowthPolicy>
+constexpr const T* SmallVector<T, N, Allocator, GrowthPolicy>::data() const{
+    return m_elements;
+}
+
+template<class T, std::size_t N, class Allocator, growth_policy GrowthPolicy>
+constexpr SmallVector<T, N, Allocator, GrowthPolicy>::iterator SmallVector<T, N, Allocator, GrowthPolicy>::begin(){
+    return iterator(m_elements);
+}
+
+template<class T, std::size_t N, class Allocator, growth_policy GrowthPolicy>
+constexpr const SmallVector<T, N, Allocator, GrowthPolicy>::iterator SmallVector<T, N, Allocator, GrowthPolicy>::begin() const noexcept{
+    return iterator(m_elements);
+}
+
+template<class T, std::size_t N, class Allocator, growth_policy GrowthPolicy>
+constexpr SmallVector<T, N, Allocator, GrowthPolicy>::iterator SmallVector<T, N, Allocator, GrowthPolicy>::end(){
+    return iterator(m_elements + m_current_size);
+}
+
+template<class T, std::size_t N, class Allocator, growth_policy GrowthPolicy>
+constexpr const SmallVector<T, N, Allocator, GrowthPolicy>::iterator SmallVector<T, N, Allocator, GrowthPolicy>::end() const noexcept{
+    return iterator(m_elements + m_current_size);
+}
+
+template<class T, std::size_t N, class Allocator, growth_policy GrowthPolicy>
+constexpr const SmallVector<T, N, Allocator, GrowthPolicy>::iterator SmallVector<T, N, Allocator, GrowthPolicy>::cbegin() const noexcept{
+    return iterator(m_elements);
+}
+
+template<class T, std::size_t N, class Allocator, growth_policy GrowthPolicy>
+constexpr const SmallVector<T, N, Allocator, GrowthPolicy>::iterator SmallVector<T, N, Allocator, GrowthPolicy>::cend() const noexcept{
+    return iterator(m_elements + m_current_size);
+}
+
+template<class T, std::size_t N, class Allocator, growth_policy GrowthPolicy>
+constexpr bool SmallVector<T, N, Allocator, GrowthPolicy>::empty() const noexcept{
+    return ( m_current_size == 0);
+}
+
+template<class T, std::size_t N, class Allocator, growth_policy GrowthPolicy>
+constexpr std::size_t SmallVector<T, N, Allocator, GrowthPolicy>::size() const noexcept{
+    return m_current_size;
+}
+
+template<class T, std::size_t N, class Allocator, growth_policy GrowthPolicy>
+constexpr std::size_t SmallVector<T, N, Allocator, GrowthPolicy>::max_size() const noexcept{
+    return std::numeric_limits<ptrdiff_t>::max();
+}
+
+template<class T, std::size_t N, class Allocator, growth_policy GrowthPolicy>
+constexpr void SmallVector<T, N, Allocator, GrowthPolicy>::reserve(const size_type new_cap){
+    if (new_cap > max_size())
+        throw std::length_error(" The new cap exceed the absolute maximum size");
+    if (new_cap <= m_max_size)
+        return;
+
+    reallocate(new_cap, m_current_size, 0, [](pointer){});
+}
+
+template<class T, std::size_t N, class Allocator, growth_policy GrowthPolicy>
+constexpr std::size_t SmallVector<T, N, Allocator, GrowthPolicy>::capacity() const noexcept{
+    return m_max_size;
+}
+
+template<class T, std::size_t N, class Allocator, growth_policy GrowthPolicy>
+constexpr void SmallVector<T, N, Allocator, GrowthPolicy>::shrink_to_fit(){
+    if( is_inline() || m_current_size == m_max_size)
+        return;
+
+    reallocate(m_current_size, m_current_size, 0, [](pointer){});
+}
+
+template<class T, std::size_t N, class Allocator, growth_policy GrowthPolicy>
+constexpr bool SmallVector<T, N, Allocator, GrowthPolicy>::is_inline() const noexcept{
+    return m_elements == reinterpret_cast<const_pointer>(m_inline);
+}
+
+template<class T, std::size_t N, class Allocator, growth_policy GrowthPolicy>
+constexpr void SmallVector<T, N, Allocator, GrowthPolicy>::clear() noexcept{
+    destroy_elements(begin(), end());
+    deallocate_elements(m_elements);
+    m_elements = inline_elements();
+    m_max_size = N;
+    m_current_size = 0;
+}
+
+template<class T, std::size_t N, class Allocator, growth_policy GrowthPolicy>
+constexpr SmallVector<T, N, Allocator, GrowthPolicy>::iterator SmallVector<T, N, Allocator, GrowthPolicy>::insert( const_iterator pos,
+                                                                                                                  const_reference value){
+    return emplace(pos, value);
+}
+
+template<class T, std::size_t N, class Allocator, growth_policy GrowthPolicy>
+constexpr SmallVector<T, N, Allocator, GrowthPolicy>::iterator SmallVector<T, N, Allocator, GrowthPolicy>::insert( const_iterator pos, T&& value){
+    return emplace(pos, std::move(value));
+}
+
+template<class T, std::size_t N, class Allocator, growth_policy GrowthPolicy>
+constexpr SmallVector<T, N, Allocator, GrowthPolicy>::iterator SmallVector<T, N, Allocator, GrowthPolicy>::insert( const_iterator pos, size_type count, const_reference value){
+    if( pos < begin() || end() < pos)
+        throw std::invalid_argument("insert position not in container");
+
+    size_type insert_pos = static_cast<size_type>(std::distance(begin(), pos));
+    if( count == 0)
+        return begin() + static_cast<difference_type>(insert_pos);
+
+    if( m_current_size + count > m_max_size){
+        reallocate(grow_capacity(m_max_size, m_current_size + count), insert_pos, count, [&](pointer gap){
+            construct_n(allocator, gap, count, value);
+        });
+        m_current_size += count;
+    } else {
+        // value can be an element of the container, keep a copy before shifting
+        value_type copy(value);
+        insert_in_place(allocator, m_elements, m_current_size, insert_pos, count,
+            [&](pointer dest, size_type, size_type n){ construct_n(allocator, dest, n, copy); },
+            [&](pointer dest, size_type, size_type n){ std::fill_n(dest, n, copy); });
+    }
+    return begin() + static_cast<difference_type>(insert_pos);
+}
+
+template<class T, std::size_t N, class Allocator, growth_policy GrowthPolicy>
+template<class InputIt> requires is_iterator<InputIt>
+constexpr SmallVector<T, N, Allocator, GrowthPolicy>::iterator SmallVector<T, N, Allocator, GrowthPolicy>::insert( const_iterator pos, InputIt first, InputIt last){
+    if( pos < begin() || end() < pos)
+        throw std::invalid_argument("insert position not in container");
+
+    size_type insert_pos = static_cast<size_type>(std::distance(begin(), pos));
+    size_type size_insert = static_cast<size_type>(std::distance(first, last));
+    if( size_insert == 0)
+        return begin() + static_cast<difference_type>(insert_pos);
+
+    if( m_current_size + size_insert > m_max_size){
+        reallocate(grow_capacity(m_max_size, m_current_size + size_insert), insert_pos, size_insert, [&](pointer gap){
+            construct_range(allocator, gap, first, size_insert);
+        });
+        m_current_size += size_insert;
+    } else {
+        using step = std::iter_difference_t<InputIt>;
+        insert_in_place(allocator, m_elements, m_current_size, insert_pos, size_insert,
+            [&](pointer dest, size_type from, size_type n){ construct_range(allocator, dest, std::next(first, static_cast<step>(from)), n); },
+            [&](pointer dest, size_type from, size_type n){ std::copy_n(std::next(first, static_cast<step>(from)), n, dest); });
+    }
+    return begin() + static_cast<difference_type>(insert_pos);
+}
+
+template<class T, std::size_t N, class Allocator, growth_policy GrowthPolicy>
+constexpr SmallVector<T, N, Allocator, GrowthPolicy>::iterator SmallVector<T, N, Allocator, GrowthPolicy>::insert( const_iterator pos, std::initializer_list<T> ilist){
+    return insert(pos, ilist.begin(), ilist.end());
+}
+
+template<class T, std::size_t N, class Allocator, growth_policy GrowthPolicy>
+template<class... Args>
+constexpr SmallVector<T, N, Allocator, GrowthPolicy>::iterator SmallVector<T, N, Allocator, GrowthPolicy>::emplace( const_iterator pos, Args&&... args){
+    if( pos < begin() || end() < pos)
+        throw std::invalid_argument("insert position not in container");
+
+    size_type insert_pos = static_cast<size_type>(std::distance(begin(), pos));
+
+    if( m_current_size == m_max_size){
+        reallocate(grow_capacity(m_max_size, m_current_size + 1), insert_pos, 1, [&](pointer gap){
+            std::allocator_traits<Allocator>::construct(allocator, gap, std::forward<Args>(args)...);
+        });
+        ++m_current_size;
+    } else if( insert_pos == m_current_size){
+        std::allocator_traits<Allocator>::construct(allocator, m_elements + m_current_size, std::forward<Args>(args)...);
+        ++m_current_size;
+    } else {
+        // args can refer to an element of the container, build the value before shifting
+        value_type new_value(std::forward<Args>(args)...);
+        insert_in_place(allocator, m_elements, m_current_size, insert_pos, 1,
+            [&](pointer dest, size_type, size_type){ std::allocator_traits<Allocator>::construct(allocator, dest, std::move(new_value)); },
+            [&](pointer dest, size_type, size_type){ *dest = std::move(new_value); });
+    }
+    return begin() + static_cast<difference_type>(insert_pos);
+}
+
+template<class T, std::size_t N, class Allocator, growth_policy GrowthPolicy>
+constexpr void SmallVector<T, N, Allocator, GrowthPolicy>::erase( const_iterator pos){
+    if( pos < begin() || pos >= end())
+        return;
+
+    size_type erase_pos = static_cast<size_type>(std::distance(begin(), pos));
+    erase_in_place(allocator, m_elements, m_current_size, erase_pos, 1);
+}
+
+template<class T, std::size_t N, class Allocator, growth_policy GrowthPolicy>
+constexpr void SmallVector<T, N, Allocator, GrowthPolicy>::erase( const_iterator first, const_iterator last){
+    if( first < begin() || first > end() || last < first || last > end())
+        return;
+    size_type erase_pos = static_cast<size_type>(std::distance(begin(), first));
+    size_type erase_count = static_cast<size_type>(std::distance(first, last));
+    erase_in_place(allocator, m_elements, m_current_size, erase_pos, erase_count);
+}
+
+template<class T, std::size_t N, class Allocator, growth_policy GrowthPolicy>
+constexpr void SmallVector<T, N, Allocator, GrowthPolicy>::push_back( const_reference value){
+    emplace_back(value);
+}
+
+template<class T, std::size_t N, class Allocator, growth_policy GrowthPolicy>
+constexpr void SmallVector<T, N, Allocator, GrowthPolicy>::push_back( value_type&& value){
+    emplace_back(std::move(value));
+}
+
+template<class T, std::size_t N, class Allocator, growth_policy GrowthPolicy>
+template<class... Args>
+constexpr T& SmallVector<T, N, Allocator, GrowthPolicy>::emplace_back(Args&&... args){
+    if( m_current_size == m_max_size){
+        reallocate(grow_capacity(m_max_size, m_current_size + 1), m_current_size, 1, [&](pointer gap){
+            std::allocator_traits<Allocator>::construct(allocator, gap, std::forward<Args>(args)...);
+        });
+    } else {
+        std::allocator_traits<Allocator>::construct(allocator, m_elements + m_current_size, std::forward<Args>(args)...);
+    }
+    ++m_current_size;
+    return m_elements[m_current_size - 1];
+}
+
+template<class T, std::size_t N, class Allocator, growth_policy GrowthPolicy>
+constexpr void SmallVector<T, N, Allocator, GrowthPolicy>::pop_back(){
+    if(m_current_size == 0)
+        return;
+
+    std::allocator_traits<Allocator>::destroy(allocator, &m_elements[m_current_size - 1]);
+    m_current_size--;
+}
+
+template<class T, std::size_t N, class Allocator, growth_policy GrowthPolicy>
+constexpr void SmallVector<T, N, Allocator, GrowthPolicy>::resize(size_type count){
+    if( count < m_current_size){
+        destroy_elements(begin() + static_cast<difference_type>(count), end());
+    } else if( count <= m_max_size){
+        construct_n(allocator, m_elements + m_current_size, count - m_current_size);
+    } else {
+        reallocate(grow_capacity(m_max_size, count), m_current_size, count - m_current_size, [&](pointer gap){
+            construct_n(allocator, gap, count - m_current_size);
+        });
+    }
+    m_current_size = count;
+}
+
+template<class T, std::size_t N, class Allocator, growth_policy GrowthPolicy>
+constexpr void SmallVector<T, N, Allocator, GrowthPolicy>::resize(size_type count, const_reference value){
+    if( count < m_current_size){
+        destroy_elements(begin() + static_cast<difference_type>(count), end());
+    } else if( count <= m_max_size){
+        construct_n(allocator, m_elements + m_current_size, count - m_current_size, value);
+    } else {
+        reallocate(grow_capacity(m_max_size, count), m_current_size, count - m_current_size, [&](pointer gap){
+            construct_n(allocator, gap, count - m_current_size, value);
+        });
+    }
+    m_current_size = count;
+}
+
+template<class T, std::size_t N, class Allocator, growth_policy GrowthPolicy>
+constexpr T* SmallVector<T, N, Allocator, GrowthPolicy>::inline_elements() noexcept{
+    return reinterpret_cast<pointer>(m_inline);
+}
+
+template<class T, std::size_t N, class Allocator, growth_policy GrowthPolicy>
+void SmallVector<T, N, Allocator, GrowthPolicy>::destroy_elements(iterator first, iterator last){
+    for(; first != last; first++){
+        std::allocator_traits<Allocator>::destroy(allocator, first.get());
+    }
+}
+
+template<class T, std::size_t N, class Allocator, growth_policy GrowthPolicy>
+void SmallVector<T, N, Allocator, GrowthPolicy>::deallocate_elements(pointer elements){
+    if( elements == inline_elements())
+        return;
+
+    std::allocator_traits<Allocator>::deallocate(allocator, elements, m_max_size);
+}
+
+template<class T, std::size_t N, class Allocator, growth_policy GrowthPolicy>
+constexpr std::size_t SmallVector<T, N, Allocator, GrowthPolicy>::grow_capacity(size_type capacity, size_type required){
+    return GrowthPolicy::template next_capacity<T>(capacity, required);
+}
+
+template<class T, std::size_t N, class Allocator, growth_policy GrowthPolicy>
+constexpr T* SmallVector<T, N, Allocator, GrowthPolicy>::allocate_elements(size_type count){
+    if( count <= N)
+        return inline_elements();
+    return std::allocator_traits<Allocator>::allocate(allocator, count);
+}
+
+template<class T, std::size_t N, class Allocator, growth_policy GrowthPolicy>
+constexpr void SmallVector<T, N, Allocator, GrowthPolicy>::steal_elements(SmallVector& other){
+    if( other.is_inline()){
+        relocate(allocator, other.m_elements, other.m_current_size, inline_elements());
+        m_elements = inline_elements();
+        m_max_size = N;
+    } else {
+        m_elements = other.m_elements;
+        m_max_size = other.m_max_size;
+        other.m_elements = other.inline_elements();
+        other.m_max_size = N;
+    }
+    m_current_size = other.m_current_size;
+    other.m_current_size = 0;
+}
+
+template<class T, std::size_t N, class Allocator, growth_policy GrowthPolicy>
+template<class Construct>
+constexpr void SmallVector<T, N, Allocator, GrowthPolicy>::reallocate(size_type new_cap,
+                                                                      size_type gap_pos,
+                                                                      size_type gap_count,
+                                                                      Construct&& construct_gap){
+    // A heap buffer shrinking under N goes back to the inline storage
+    if( new_cap <= N)
+        new_cap = N;
+    pointer new_elements = allocate_elements(new_cap);
+    auto release = [&](){
+        if( new_elements != inline_elements())
+            std::allocator_traits<Allocator>::deallocate(allocator, new_elements, new_cap);
+    };
+
+    try {
+        construct_gap(new_elements + gap_pos);
+    } catch(...) {
+        release();
+        throw;
+    }
+
+    try {
+        relocate_around(allocator, m_elements, m_current_size, new_elements, gap_pos, gap_count);
+    } catch(...) {
+        destroy_n(allocator, new_elements + gap_pos, gap_count);
+        release();
+        throw;
+    }
+
+    deallocate_elements(m_elements);
+    m_elements = new_elements;
+    m_max_size = new_cap;
+}
+
+}
@@ -0,0 +1,739 @@
+#pragma once
+
+#include <algorithm> // max
+#include <array> // array
+#include <cstddef> // size_t ptrdiff_t
+#include <initializer_list> // initializer_list
+#include <iterator> // random_access_iterator_tag input_iterator_tag
+#include <limits> // numeric_limits -> max
+#include <memory> // construct_at destroy_at
+#include <new> // operator new align_val_t
+#include <span> // span
+#include <stdexcept> // invalid_argument out_of_range length_error
+#include <tuple> // tuple apply get
+#include <type_traits> // is_nothrow_move_constructible_v integral_constant
+#include <utility> // forward move index_sequence
+#include "GrowthPolicy.hpp"
+#include "Relocation.hpp"
+
+namespace yadej {
+
+// Row iterator of SoAVector, dereferencing gives a tuple of references
+// to the fields of one row. It is a proxy: std algorithms needing to swap
+// rows do not work on it, scan the columns instead. The row comes from
+// owner->row(index), the owner makes soa_iterator a friend.
+template<class Owner, class Reference>
+class soa_iterator {
+    public:
+    using iterator_base_category = std::random_access_iterator_tag;
+    using iterator_concept = std::random_access_iterator_tag;
+    using iterator_category = std::input_iterator_tag;
+    using difference_type = std::ptrdiff_t;
+    using value_type = typename std::remove_const_t<Owner>::value_type;
+    using reference = Reference;
+
+    constexpr soa_iterator() = default;
+
+    constexpr soa_iterator( Owner* owner, std::size_t index): m_owner(owner), m_index(index){
+    }
+
+    // iterator to const_iterator
+    template<class OtherOwner, class OtherReference> requires std::is_same_v<const OtherOwner, Owner>
+    constexpr soa_iterator( const soa_iterator<OtherOwner, OtherReference>& other)
+        : m_owner(other.owner()), m_index(other.index()){
+    }
+
+    constexpr soa_iterator& operator++(){
+        ++m_index;
+        return *this;
+    }
+    constexpr soa_iterator operator++(int){
+        soa_iterator temp = *this;
+        ++m_index;
+        return temp;
+    }
+
+    constexpr soa_iterator& operator--(){
+        --m_index;
+        return *this;
+    }
+    constexpr soa_iterator operator--(int){
+        soa_iterator temp = *this;
+        --m_index;
+        return temp;
+    }
+
+    constexpr soa_iterator& operator+=(difference_type n){
+        m_index += static_cast<std::size_t>(n);
+        return *this;
+    }
+
+    constexpr soa_iterator& operator-=(difference_type n){
+        m_index -= static_cast<std::size_t>(n);
+        return *this;
+    }
+
+    constexpr reference operator*() const {
+        return m_owner->row(m_index);
+    }
+
+    constexpr reference operator[](difference_type n) const {
+        return m_owner->row(m_index + static_cast<std::size_t>(n));
+    }
+
+    constexpr Owner* owner() const {
+        return m_owner;
+    }
+
+    constexpr std::size_t index() const {
+        return m_index;
+    }
+
+    friend constexpr bool operator==(const soa_iterator& l_arg, const soa_iterator& r_arg){
+        return l_arg.m_index == r_arg.m_index;
+    }
+
+    friend constexpr bool operator!=(const soa_iterator& l_arg, const soa_iterator& r_arg){
+        return !(l_arg == r_arg);
+    }
+
+    friend constexpr bool operator<(const soa_iterator& l_arg, const soa_iterator& r_arg){
+        return l_arg.m_index < r_arg.m_index;
+    }
+
+    friend constexpr bool operator>(const soa_iterator& l_arg, const soa_iterator& r_arg){
+        return r_arg < l_arg;
+    }
+
+    friend constexpr bool operator>=(const soa_iterator& l_arg, const soa_iterator& r_arg){
+        return !(l_arg< r_arg);
+    }
+
+    friend constexpr bool operator<=(const soa_iterator& l_arg, const soa_iterator& r_arg){
+        return !(r_arg < l_arg);
+    }
+
+    friend constexpr soa_iterator operator+(const soa_iterator& it, difference_type n){
+        soa_iterator temp = it;
+        temp += n;
+        return temp;
+    }
+
+    friend constexpr soa_iterator operator+(difference_type n, const soa_iterator& it){
+        return it + n;
+    }
+
+    friend constexpr soa_iterator operator-(const soa_iterator& it, difference_type n){
+        soa_iterator temp = it;
+        temp -= n;
+        return temp;
+    }
+
+    friend constexpr difference_type operator-(const soa_iterator& l_arg, const soa_iterator& r_arg){
+        return static_cast<difference_type>(l_arg.m_index - r_arg.m_index);
+    }
+
+private:
+    Owner* m_owner{nullptr};
+    std::size_t m_index{0};
+};
+
+// Vector of records stored as a structure of arrays: each field has its
+// own contiguous array, aligned on column_alignment bytes, so a loop over
+// one field only pulls that field through the cache and can be vectorized
+// over column<I>(). All the columns share one allocation and one size,
+// push_back, insert, erase and resize act on every column like Vector.
+//
+// Fields must be nothrow move constructible: rows are shifted column by
+// column, a throwing move could leave the columns out of step.
+template<class... Fields>
+class SoAVector {
+    static_assert(sizeof...(Fields) > 0, "SoAVector needs at least one field");
+    static_assert((std::is_nothrow_move_constructible_v<Fields> && ...),
+                  "SoAVector fields must be nothrow move constructible");
+public:
+
+    // Declaration of type
+    using value_type = std::tuple<Fields...>;
+    using size_type = std::size_t;
+    using difference_type = std::ptrdiff_t;
+    using reference = std::tuple<Fields&...>;
+    using const_reference = std::tuple<const Fields&...>;
+    template<std::size_t I>
+    using column_type = std::tuple_element_t<I, value_type>;
+
+    static constexpr size_type column_count = sizeof...(Fields);
+    static constexpr size_type column_alignment = 64;
+
+    // Constructors and Destructors
+    SoAVector() noexcept = default;
+    explicit SoAVector( size_type count);
+    SoAVector( size_type count, const value_type& value);
+    SoAVector( std::initializer_list<value_type> init);
+    SoAVector(SoAVector && other) noexcept;
+    SoAVector(const SoAVector & other);
+    SoAVector &operator=(SoAVector &&) noexcept;
+    SoAVector &operator=(const SoAVector &);
+    ~SoAVector();
+
+    // Element access, a row is a tuple of references
+    reference at(size_type position);
+    const_reference at(size_type position) const;
+
+    reference operator[](size_type position);
+    const_reference operator[](size_type position) const;
+
+    reference front();
+    const_reference front() const;
+
+    reference back();
+    const_reference back() const;
+
+    // Contiguous array of the field I
+    template<std::size_t I>
+    std::span<column_type<I>> column() noexcept;
+    template<std::size_t I>
+    std::span<const column_type<I>> column() const noexcept;
+    template<std::size_t I>
+    column_type<I>* data() noexcept;
+    template<std::size_t I>
+    const column_type<I>* data() const noexcept;
+
+    // iterator
+    //
+    using iterator = soa_iterator<SoAVector, reference>;
+    using const_iterator = soa_iterator<const SoAVector, const_reference>;
+    iterator begin() noexcept;
+    const_iterator begin() const noexcept;
+    iterator end() noexcept;
+    const_iterator end() const noexcept;
+    const_iterator cbegin() const noexcept;
+    const_iterator cend() const noexcept;
+
+    // Container
+    //
+    bool empty() const noexcept;
+    size_type size() const noexcept;
+    size_type max_size() const noexcept;
+    void reserve( const size_type new_cap);
+    size_type capacity() const noexcept;
+    void shrink_to_fit();
+
+    // Modifier
+    void clear() noexcept;
+
+    iterator insert( const_iterator pos, const value_type& value);
+    iterator insert( const_iterator pos, value_type&& value);
+    iterator insert( const_iterator pos, size_type count, const value_type& value);
+    // One argument per field
+    template<class... Args>
+    iterator emplace( const_iterator pos, Args&&... args);
+    void erase( const_iterator pos);
+    void erase( const_iterator first, const_iterator last);
+
+    void push_back( const value_type& value);
+    void push_back( value_type&& value);
+    template<class... Args>
+    reference emplace_back( Args&&... args);
+    void pop_back();
+    void resize(size_type count);
+    void resize(size_type count, const value_type& value);
+    void swap(SoAVector& other) noexcept;
+private:
+    template<class, class>
+    friend class soa_iterator;
+
+    reference row(size_type position){ return (*this)[position]; }
+    const_reference row(size_type position) const{ return (*this)[position]; }
+
+    using columns = std::tuple<Fields*...>;
+    using offsets = std::array<size_type, column_count + 1>;
+
+    // Call f(integral_constant<I>) for every column
+    template<class F>
+    static void for_each_column(F&& f);
+    // Start of every column in a block of capacity rows, the last one is the block size
+    static offsets column_offsets(size_type capacity) noexcept;
+    static columns allocate_columns(size_type capacity);
+    static void deallocate_columns(const columns& block, size_type capacity) noexcept;
+
+    // Construct the row dest of block, column I from the argument I
+    template<class... Args>
+    static void construct_row(const columns& block, size_type dest, Args&&... args);
+    static void destroy_rows(const columns& block, size_type first, size_type last) noexcept;
+    void destroy_rows(size_type first, size_type last) noexcept;
+
+    // Move to a block of new_cap rows leaving gap_count rows free at gap_pos,
+    // construct_gap(block) is called on the new block before anything moves
+    template<class Construct>
+    void reallocate(size_type new_cap, size_type gap_pos, size_type gap_count, Construct&& construct_gap);
+    // Shift the rows from pos by count, the size counts the gap
+    void open_gap(size_type pos, size_type count) noexcept;
+    // Shift the rows after the gap [pos, pos + count) back over it
+    void close_gap(size_type pos, size_type count) noexcept;
+    size_type checked_position(const_iterator pos) const;
+
+    columns m_columns{};
+    size_type m_current_size{0};
+    size_type m_max_size{0};
+};
+
+template<class... Fields>
+SoAVector<Fields...>::SoAVector( size_type count){
+    resize(count);
+}
+
+template<class... Fields>
+SoAVector<Fields...>::SoAVector( size_type count, const value_type& value){
+    resize(count, value);
+}
+
+template<class... Fields>
+SoAVector<Fields...>::SoAVector( std::initializer_list<value_type> init){
+    reserve(init.size());
+    for(const value_type& value : init)
+        push_back(value);
+}
+
+template<class... Fields>
+SoAVector<Fields...>::SoAVector(SoAVector && other) noexcept
+        : m_columns(other.m_columns), m_current_size(other.m_current_size), m_max_size(other.m_max_size){
+    other.m_columns = columns{};
+    other.m_current_size = 0;
+    other.m_max_size = 0;
+}
+
+template<class... Fields>
+SoAVector<Fields...>::SoAVector(const SoAVector & other){
+    reserve(other.m_current_size);
+    for(size_type row=0; row < other.m_current_size; ++row)
+        std::apply([&](const Fields&... fields){ emplace_back(fields...); }, other[row]);
+}
+
+template<class... Fields>
+SoAVector<Fields...>& SoAVector<Fields...>::operator=(SoAVector && other) noexcept{
+    SoAVector moved(std::move(other));
+    swap(moved);
+    return *this;
+}
+
+template<class... Fields>
+SoAVector<Fields...>& SoAVector<Fields...>::operator=(const SoAVector& other){
+    if( this == &other)
+        return *this;
+
+    SoAVector copy(other);
+    swap(copy);
+    return *this;
+}
+
+template<class... Fields>
+SoAVector<Fields...>::~SoAVector(){
+    destroy_rows(0, m_current_size);
+    deallocate_columns(m_columns, m_max_size);
+}
+
+template<class... Fields>
+typename SoAVector<Fields...>::reference SoAVector<Fields...>::at(size_type position){
+    if( position >= m_current_size )
+        throw std::out_of_range("SoAVector::at position out of range");
+    return (*this)[position];
+}
+template<class... Fields>
+typename SoAVector<Fields...>::const_reference SoAVector<Fields...>::at(size_type position) const{
+    if( position >= m_current_size )
+        throw std::out_of_range("SoAVector::at position out of range");
+    return (*this)[position];
+}
+
+template<class... Fields>
+typename SoAVector<Fields...>::reference SoAVector<Fields...>::operator[](size_type position){
+    return std::apply([position](Fields*... column){ return reference(column[position]...); }, m_columns);
+}
+template<class... Fields>
+typename SoAVector<Fields...>::const_reference SoAVector<Fields...>::operator[](size_type position) const{
+    return std::apply([position](Fields*... column){ return const_reference(column[position]...); }, m_columns);
+}
+
+template<class... Fields>
+typename SoAVector<Fields...>::reference SoAVector<Fields...>::front(){
+    return at(0);
+}
+template<class... Fields>
+typename SoAVector<Fields...>::const_reference SoAVector<Fields...>::front() const{
+    return at(0);
+}
+
+template<class... Fields>
+typename SoAVector<Fields...>::reference SoAVector<Fields...>::back(){
+    return at(m_current_size - 1);
+}
+template<class... Fields>
+typename SoAVector<Fields...>::const_reference SoAVector<Fields...>::back() const{
+    return at(m_current_size - 1);
+}
+
+template<class... Fields>
+template<std::size_t I>
+std::span<typename SoAVector<Fields...>::template column_type<I>> SoAVector<Fields...>::column() noexcept{
+    return std::span<column_type<I>>(std::get<I>(m_columns), m_current_size);
+}
+template<class... Fields>
+template<std::size_t I>
+std::span<const typename SoAVector<Fields...>::template column_type<I>> SoAVector<Fields...>::column() const noexcept{
+    return std::span<const column_type<I>>(std::get<I>(m_columns), m_current_size);
+}
+
+template<class... Fields>
+template<std::size_t I>
+typename SoAVector<Fields...>::template column_type<I>* SoAVector<Fields...>::data() noexcept{
+    return std::get<I>(m_columns);
+}
+template<class... Fields>
+template<std::size_t I>
+const typename SoAVector<Fields...>::template column_type<I>* SoAVector<Fields...>::data() const noexcept{
+    return std::get<I>(m_columns);
+}
+
+template<class... Fields>
+typename SoAVector<Fields...>::iterator SoAVector<Fields...>::begin() noexcept{
+    return iterator(this, 0);
+}
+template<class... Fields>
+typename SoAVector<Fields...>::const_iterator SoAVector<Fields...>::begin() const noexcept{
+    return const_iterator(this, 0);
+}
+template<class... Fields>
+typename SoAVector<Fields...>::iterator SoAVector<Fields...>::end() noexcept{
+    return iterator(this, m_current_size);
+}
+template<class... Fields>
+typename SoAVector<Fields...>::const_iterator SoAVector<Fields...>::end() const noexcept{
+    return const_iterator(this, m_current_size);
+}
+template<class... Fields>
+typename SoAVector<Fields...>::const_iterator SoAVector<Fields...>::cbegin() const noexcept{
+    return begin();
+}
+template<class... Fields>
+typename SoAVector<Fields...>::const_iterator SoAVector<Fields...>::cend() const noexcept{
+    return end();
+}
+
+template<class... Fields>
+bool SoAVector<Fields...>::empty() const noexcept{
+    return ( m_current_size == 0);
+}
+
+template<class... Fields>
+std::size_t SoAVector<Fields...>::size() const noexcept{
+    return m_current_size;
+}
+
+template<class... Fields>
+std::size_t SoAVector<Fields...>::max_size() const noexcept{
+    return std::numeric_limits<ptrdiff_t>::max() / (sizeof(Fields) + ...);
+}
+
+template<class... Fields>
+void SoAVector<Fields...>::reserve(const size_type new_cap){
+    if (new_cap > max_size())
+        throw std::length_error(" The new cap exceed the absolute maximum size");
+    if (new_cap <= m_max_size)
+        return;
+
+    reallocate(new_cap, m_current_size, 0, [](const columns&){});
+}
+
+template<class... Fields>
+std::size_t SoAVector<Fields...>::capacity() const noexcept{
+    return m_max_size;
+}
+
+template<class... Fields>
+void SoAVector<Fields...>::shrink_to_fit(){
+    if( m_current_size == m_max_size)
+        return;
+
+    reallocate(m_current_size, m_current_size, 0, [](const columns&){});
+}
+
+template<class... Fields>
+void SoAVector<Fields...>::clear() noexcept{
+    destroy_rows(0, m_current_size);
+    m_current_size = 0;
+}
+
+template<class... Fields>
+typename SoAVector<Fields...>::iterator SoAVector<Fields...>::insert( const_iterator pos, const value_type& value){
+    return std::apply([&](const Fields&... fields){ return emplace(pos, fields...); }, value);
+}
+
+template<class... Fields>
+typename SoAVector<Fields...>::iterator SoAVector<Fields...>::insert( const_iterator pos, value_type&& value){
+    return std::apply([&](Fields&... fields){ return emplace(pos, std::move(fields)...); }, value);
+}
+
+template<class... Fields>
+typename SoAVector<Fields...>::iterator SoAVector<Fields...>::insert( const_iterator pos, size_type count, const value_type& value){
+    size_type insert_pos = checked_position(pos);
+    if( count == 0)
+        return begin() + static_cast<difference_type>(insert_pos);
+
+    auto construct_gap = [&](const columns& block){
+        size_type row = 0;
+        try {
+            for(; row < count; ++row)
+                std::apply([&](const Fields&... fields){ construct_row(block, insert_pos + row, fields...); }, value);
+        } catch(...) {
+            destroy_rows(block, insert_pos, insert_pos + row);
+            throw;
+        }
+    };
+    if( m_current_size + count > m_max_size){
+        reallocate(growth::Doubling::next_capacity<value_type>(m_max_size, m_current_size + count), insert_pos, count, construct_gap);
+    } else {
+        open_gap(insert_pos, count);
+        try {
+            construct_gap(m_columns);
+        } catch(...) {
+            close_gap(insert_pos, count);
+            throw;
+        }
+    }
+    return begin() + static_cast<difference_type>(insert_pos);
+}
+
+template<class... Fields>
+template<class... Args>
+typename SoAVector<Fields...>::iterator SoAVector<Fields...>::emplace( const_iterator pos, Args&&... args){
+    static_assert(sizeof...(Args) == column_count, "SoAVector::emplace takes one argument per field");
+    size_type insert_pos = checked_position(pos);
+
+    if( m_current_size == m_max_size){
+        reallocate(growth::Doubling::next_capacity<value_type>(m_max_size, m_current_size + 1), insert_pos, 1, [&](const columns& block){
+            construct_row(block, insert_pos, std::forward<Args>(args)...);
+        });
+    } else {
+        // The arguments can be fields of the container, build the row before shifting
+        value_type row(std::forward<Args>(args)...);
+        open_gap(insert_pos, 1);
+        try {
+            std::apply([&](Fields&... fields){ construct_row(m_columns, insert_pos, std::move(fields)...); }, row);
+        } catch(...) {
+            close_gap(insert_pos, 1);
+            throw;
+        }
+    }
+    return begin() + static_cast<difference_type>(insert_pos);
+}
+
+template<class... Fields>
+void SoAVector<Fields...>::erase( const_iterator pos){
+    erase(pos, pos + 1);
+}
+
+template<class... Fields>
+void SoAVector<Fields...>::erase( const_iterator first, const_iterator last){
+    // Out of the container erase does nothing, as for Vector
+    if( first > last || first < cbegin() || last > cend())
+        return;
+    const size_type erase_pos = first.index();
+    const size_type count = last.index() - erase_pos;
+    if( count == 0)
+        return;
+
+    destroy_rows(erase_pos, erase_pos + count);
+    close_gap(erase_pos, count);
+}
+
+template<class... Fields>
+void SoAVector<Fields...>::push_back(const value_type& value){
+    insert(cend(), value);
+}
+
+template<class... Fields>
+void SoAVector<Fields...>::push_back(value_type&& value){
+    insert(cend(), std::move(value));
+}
+
+template<class... Fields>
+template<class... Args>
+typename SoAVector<Fields...>::reference SoAVector<Fields...>::emplace_back(Args&&... args){
+    return *emplace(cend(), std::forward<Args>(args)...);
+}
+
+template<class... Fields>
+void SoAVector<Fields...>::pop_back(){
+    if(m_current_size == 0)
+        return;
+
+    destroy_rows(m_current_size - 1, m_current_size);
+    --m_current_size;
+}
+
+template<class... Fields>
+void SoAVector<Fields...>::resize(size_type count){
+    if( count <= m_current_size){
+        destroy_rows(count, m_current_size);
+        m_current_size = count;
+        return;
+    }
+    reserve(count);
+    for(; m_current_size < count; ++m_current_size)
+        construct_row(m_columns, m_current_size, Fields()...);
+}
+
+template<class... Fields>
+void SoAVector<Fields...>::resize(size_type count, const value_type& value){
+    if( count <= m_current_size){
+        destroy_rows(count, m_current_size);
+        m_current_size = count;
+        return;
+    }
+    insert(cend(), count - m_current_size, value);
+}
+
+template<class... Fields>
+void SoAVector<Fields...>::swap(SoAVector& other) noexcept{
+    std::swap(m_columns, other.m_columns);
+    std::swap(m_current_size, other.m_current_size);
+    std::swap(m_max_size, other.m_max_size);
+}
+
+template<class... Fields>
+template<class F>
+void SoAVector<Fields...>::for_each_column(F&& f){
+    [&]<std::size_t... I>(std::index_sequence<I...>){
+        (f(std::integral_constant<std::size_t, I>{}), ...);
+    }(std::index_sequence_for<Fields...>{});
+}
+
+template<class... Fields>
+typename SoAVector<Fields...>::offsets SoAVector<Fields...>::column_offsets(size_type capacity) noexcept{
+    constexpr std::array<size_type, column_count> sizes{sizeof(Fields)...};
+    offsets result{};
+    size_type offset = 0;
+    for(size_type i=0; i < column_count; ++i){
+        result[i] = offset;
+        offset += (sizes[i] * capacity + column_alignment - 1) / column_alignment * column_alignment;
+    }
+    result[column_count] = offset;
+    return result;
+}
+
+template<class... Fields>
+typename SoAVector<Fields...>::columns SoAVector<Fields...>::allocate_columns(size_type capacity){
+    static_assert(((alignof(Fields) <= column_alignment) && ...), "SoAVector field over-aligned");
+    if( capacity == 0)
+        return columns{};
+
+    const offsets layout = column_offsets(capacity);
+    auto* block = static_cast<std::byte*>(::operator new(layout[column_count], std::align_val_t{column_alignment}));
+    columns result;
+    for_each_column([&](auto column){
+        constexpr std::size_t I = decltype(column)::value;
+        std::get<I>(result) = reinterpret_cast<column_type<I>*>(block + layout[I]);
+    });
+    return result;
+}
+
+template<class... Fields>
+void SoAVector<Fields...>::deallocate_columns(const columns& block, size_type capacity) noexcept{
+    if( capacity == 0)
+        return;
+    ::operator delete(static_cast<void*>(std::get<0>(block)), column_offsets(capacity)[column_count],
+                      std::align_val_t{column_alignment});
+}
+
+template<class... Fields>
+template<class... Args>
+void SoAVector<Fields...>::construct_row(const columns& block, size_type dest, Args&&... args){
+    std::tuple<Args&&...> arguments(std::forward<Args>(args)...);
+    size_type constructed = 0;
+    try {
+        for_each_column([&](auto column){
+            constexpr std::size_t I = decltype(column)::value;
+            std::construct_at(std::get<I>(block) + dest, std::get<I>(std::move(arguments)));
+            ++constructed;
+        });
+    } catch(...) {
+        // Only the columns before the throwing one hold an element
+        for_each_column([&](auto column){
+            constexpr std::size_t I = decltype(column)::value;
+            if( I < constructed)
+                std::destroy_at(std::get<I>(block) + dest);
+        });
+        throw;
+    }
+}
+
+template<class... Fields>
+void SoAVector<Fields...>::destroy_rows(const columns& block, size_type first, size_type last) noexcept{
+    for_each_column([&](auto column){
+        constexpr std::size_t I = decltype(column)::value;
+        if constexpr (!std::is_trivially_destructible_v<column_type<I>>){
+            for(size_type row=first; row < last; ++row)
+                std::destroy_at(std::get<I>(block) + row);
+        }
+    });
+}
+
+template<class... Fields>
+void SoAVector<Fields...>::destroy_rows(size_type first, size_type last) noexcept{
+    destroy_rows(m_columns, first, last);
+}
+
+template<class... Fields>
+template<class Construct>
+void SoAVector<Fields...>::reallocate(size_type new_cap, size_type gap_pos, size_type gap_count, Construct&& construct_gap){
+    columns block = allocate_columns(new_cap);
+    try {
+        construct_gap(block);
+    } catch(...) {
+        deallocate_columns(block, new_cap);
+        throw;
+    }
+
+    for_each_column([&](auto column){
+        constexpr std::size_t I = decltype(column)::value;
+        relocate(std::get<I>(m_columns), gap_pos, std::get<I>(block));
+        relocate(std::get<I>(m_columns) + gap_pos, m_current_size - gap_pos, std::get<I>(block) + gap_pos + gap_count);
+    });
+    deallocate_columns(m_columns, m_max_size);
+    m_columns = block;
+    m_max_size = new_cap;
+    m_current_size += gap_count;
+}
+
+template<class... Fields>
+void SoAVector<Fields...>::open_gap(size_type pos, size_type count) noexcept{
+    for_each_column([&](auto column){
+        constexpr std::size_t I = decltype(column)::value;
+        shift(std::get<I>(m_columns) + pos, m_current_size - pos, std::get<I>(m_columns) + pos + count);
+    });
+    m_current_size += count;
+}
+
+template<class... Fields>
+void SoAVector<Fields...>::close_gap(size_type pos, size_type count) noexcept{
+    for_each_column([&](auto column){
+        constexpr std::size_t I = decltype(column)::value;
+        shift(std::get<I>(m_columns) + pos + count, m_current_size - pos - count, std::get<I>(m_columns) + pos);
+    });
+    m_current_size -= count;
+}
+
+template<class... Fields>
+std::size_t SoAVector<Fields...>::checked_position(const_iterator pos) const{
+    if( pos < cbegin() || cend() < pos)
+        throw std::invalid_argument("insert position not in container");
+    return pos.index();
+}
+
+template<class... Fields>
+void swap(SoAVector<Fields...>& l_arg, SoAVector<Fields...>& r_arg) noexcept{
+    l_arg.swap(r_arg);
+}
+
+}
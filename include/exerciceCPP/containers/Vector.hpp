@@ -1,14 +1,23 @@
 #pragma once
 
+#include <algorithm> // max fill_n copy_n
 #include <cstddef> // size_t ptrdiff_t  
-#include <iterator> // random_access_iterator_tag
+#include <cstring> // memcpy
+#include <iterator> // random_access_iterator_tag next iter_difference_t
 #include <limits> // numeric_limits -> max
 #include <memory> // ptrdiff_t
+#include <memory_resource> // polymorphic_allocator
+#include <new> // placement new
+#include <ranges> // input_range sized_range distance
+#include <span> // span
 #include <stdexcept> // invalid_argument 
-#include <bit>  //For bit_ceil
 #include <type_traits> // is_constructible_v
 #include <utility> // forward move 
+#include "GrowthPolicy.hpp"
 #include "Iterator.hpp"
+#include "Relocation.hpp"
+#include "VectorStats.hpp"
+#include "../memory/AlignedAllocator.hpp"
 
 namespace yadej {
 
@@ -18,6 +27,15 @@ template<class Iter>
 concept is_iterator = std::random_access_iterator<Iter>;
 
 
+// Range whose elements can build a T, as the C++23 container_compatible_range
+template<class Range, class T>
+concept container_compatible_range = std::ranges::input_range<Range>
+                                  && std::convertible_to<std::ranges::range_reference_t<Range>, T>;
+
+// Tag of the range constructors, as the C++23 std::from_range
+struct from_range_t { explicit from_range_t() = default; };
+inline constexpr from_range_t from_range{};
+
 template<class T>
 concept default_construction = std::is_default_constructible_v<T>;
 
@@ -34,7 +52,10 @@ concept can_use_move_copy = std::is_move_assignable_v<T>
 
 // TODO: Add the requirement for all function when needed
 
-template<class T, class Allocator = std::allocator<T>> 
+template<class T,
+         class Allocator = std::allocator<T>,
+         growth_policy GrowthPolicy = growth::Doubling,
+         class StatsPolicy = stats::Default>
 class Vector {
 public:
     
@@ -54,13 +75,20 @@ public:
     explicit Vector( size_type count, const allocator_type& alloc = Allocator());
     template<class InputIt> requires is_iterator<InputIt>
     constexpr Vector( InputIt first, InputIt last, const allocator_type& alloc = Allocator());
-    constexpr Vector(Vector && other);
-    constexpr Vector(const Vector & other) noexcept;
+    constexpr Vector(Vector && other) noexcept;
+    constexpr Vector(Vector && other, const allocator_type& alloc);
+    constexpr Vector(const Vector & other);
+    constexpr Vector(const Vector & other, const allocator_type& alloc);
     constexpr Vector( std::initializer_list<T> init, const allocator_type& alloc = Allocator());
-    constexpr Vector &operator=(Vector &&);
+    template<container_compatible_range<T> Range>
+    constexpr Vector( from_range_t, Range&& range, const allocator_type& alloc = Allocator());
+    constexpr Vector &operator=(Vector &&) noexcept(std::allocator_traits<Allocator>::propagate_on_container_move_assignment::value
+                                                    || std::allocator_traits<Allocator>::is_always_equal::value);
     constexpr Vector &operator=(const Vector &);
     constexpr ~Vector();
 
+    constexpr allocator_type get_allocator() const noexcept;
+
     // Element access
     constexpr reference at(size_type position);
     constexpr const_reference at(size_type position) const;
@@ -112,6 +140,14 @@ public:
     constexpr void erase( const_iterator pos);
     constexpr void erase( const_iterator first, const_iterator last);
 
+    // Ranges, a sized or forward range is added with at most one allocation
+    template<container_compatible_range<T> Range>
+    constexpr iterator insert_range( const_iterator pos, Range&& range);
+    template<container_compatible_range<T> Range>
+    constexpr void append_range( Range&& range);
+    template<container_compatible_range<T> Range>
+    constexpr void assign_range( Range&& range);
+
     constexpr void push_back( const_reference value);
     constexpr void push_back( value_type&& value);
     template<class... Args>
@@ -119,164 +155,254 @@ public:
     constexpr void pop_back();
     constexpr void resize(size_type count);
     constexpr void resize(size_type count, const_reference value);
-    // TODO swap
+    // Like resize, but the new elements are default-initialized: left
+    // uninitialized for trivial types, ready to be overwritten
+    constexpr void resize_for_overwrite(size_type count);
+    // Grow to count elements as resize_for_overwrite then call
+    // op(std::span<T>) on the first count elements, op returns how many of
+    // them are kept, the following ones are destroyed. Writing straight in the
+    // buffer avoids both the zero-fill and a copy from a temporary buffer.
+    template<class Operation>
+    constexpr void resize_and_overwrite(size_type count, Operation op);
+
+    constexpr void swap(Vector& other) noexcept;
+
+    // Counters of the StatsPolicy, empty with stats::NoStats
+    constexpr StatsPolicy& stats() noexcept { return m_stats; }
+    constexpr const StatsPolicy& stats() const noexcept { return m_stats; }
     // TODO Do Some operator
 private:
     pointer m_elements=nullptr;
     size_type m_current_size{0};
     size_type m_max_size{0};
     Allocator allocator{};
+    [[no_unique_address]] StatsPolicy m_stats{};
     void destroy_elements(iterator first, iterator last);
     void deallocate_elements(pointer elements);
+
+    // Capacity to allocate, following GrowthPolicy, when a buffer of
+    // capacity elements must hold at least required elements
+    static constexpr size_type grow_capacity(size_type capacity, size_type required);
+    // Allocate count elements, no allocation is done for 0
+    constexpr pointer allocate_elements(size_type count);
+    // Take the buffer of other, leaving it empty
+    constexpr void steal_elements(Vector& other) noexcept;
+    // Move every element into a new buffer of new_cap elements, keeping a hole
+    // of gap_count slots at gap_pos which is filled by construct_gap
+    // before the old elements are relocated
+    template<class Construct>
+    constexpr void reallocate(size_type new_cap, size_type gap_pos, size_type gap_count, Construct&& construct_gap);
+    // Construct count elements in raw memory, destroy them back if one throws
+    template<class... Args>
+    constexpr void construct_n(pointer dest, size_type count, const Args&... args);
+    // Contiguous ranges of trivially copyable T are copied with one memcpy
+    template<class InputIt>
+    constexpr void construct_range(pointer dest, InputIt first, size_type count);
+    // Insert count elements read from first at pos
+    template<class InputIt>
+    constexpr iterator insert_counted( const_iterator pos, InputIt first, size_type count);
+    // Default-initialize count elements, nothing to do for trivial types
+    constexpr void construct_for_overwrite(pointer dest, size_type count);
 };
 
-template<class T, class Allocator>
-constexpr Vector<T, Allocator>::Vector() noexcept(noexcept(Allocator()))
+template<class T, class Allocator, growth_policy GrowthPolicy, class StatsPolicy>
+constexpr Vector<T, Allocator, GrowthPolicy, StatsPolicy>::Vector() noexcept(noexcept(Allocator()))
         : m_elements(nullptr), m_current_size{0}, m_max_size{0},
           allocator(Allocator()){
 }
 
-template<class T, class Allocator>
-constexpr Vector<T, Allocator>::Vector( const allocator_type& alloc) noexcept
+template<class T, class Allocator, growth_policy GrowthPolicy, class StatsPolicy>
+constexpr Vector<T, Allocator, GrowthPolicy, StatsPolicy>::Vector( const allocator_type& alloc) noexcept
         : m_elements(nullptr), m_current_size(0), m_max_size(0),
             allocator(alloc){
 }
 
-template<class T, class Allocator>
-Vector<T,Allocator>::Vector( size_type count, 
+template<class T, class Allocator, growth_policy GrowthPolicy, class StatsPolicy>
+Vector<T, Allocator, GrowthPolicy, StatsPolicy>::Vector( size_type count, 
                             const_reference value, 
                             const allocator_type& alloc )
-                    : m_current_size(count),
-                      m_max_size(std::bit_ceil(count)),
+                    : m_max_size(grow_capacity(0, count)),
                       allocator(alloc){
+    m_elements = allocate_elements(m_max_size);
     try {
-        m_elements = std::allocator_traits<Allocator>::allocate(allocator, m_max_size);
-        for (size_type i=0; i < count; ++i)
-            std::allocator_traits<Allocator>::construct(allocator, m_elements + i, value);
+        construct_n(m_elements, count, value);
     }
     catch(...) {
-        destroy_elements(begin(), end());
         deallocate_elements(m_elements);
         throw;
     }
+    m_current_size = count;
+    m_stats.on_size(m_current_size);
 }
 
-template<class T, class Allocator>
-Vector<T,Allocator>::Vector( size_type count, const allocator_type& alloc )
-        : m_current_size(count),
-          m_max_size(std::bit_ceil(count)),
+template<class T, class Allocator, growth_policy GrowthPolicy, class StatsPolicy>
+Vector<T, Allocator, GrowthPolicy, StatsPolicy>::Vector( size_type count, const allocator_type& alloc )
+        : m_max_size(grow_capacity(0, count)),
           allocator(alloc){
+    m_elements = allocate_elements(m_max_size);
     try {
-        m_elements = std::allocator_traits<Allocator>::allocate(allocator, m_max_size);
-        for( size_type i =0; i  < count; ++i ){
-            std::allocator_traits<Allocator>::construct(allocator, m_elements + i);
-        }
+        construct_n(m_elements, count);
     }catch (...){
-        destroy_elements(begin(), end());
         deallocate_elements(m_elements);
         throw;
     }
-
-
-
+    m_current_size = count;
+    m_stats.on_size(m_current_size);
 }
-template<class T, class Allocator>
+template<class T, class Allocator, growth_policy GrowthPolicy, class StatsPolicy>
 template<class InputIt> requires is_iterator<InputIt>
-constexpr Vector<T,Allocator>::Vector( InputIt first, InputIt last, const allocator_type& alloc )
+constexpr Vector<T, Allocator, GrowthPolicy, StatsPolicy>::Vector( InputIt first, InputIt last, const allocator_type& alloc )
         : allocator(alloc){
     // Get size of the Vector
-    m_current_size = static_cast<size_type>(std::distance(first, last));
-    m_max_size = std::bit_ceil(m_current_size);
+    size_type count = static_cast<size_type>(std::distance(first, last));
+    m_max_size = grow_capacity(0, count);
+    m_elements = allocate_elements(m_max_size);
 
     try {
-        m_elements = std::allocator_traits<Allocator>::allocate(allocator, m_max_size);
-        for(size_type i=0; i < m_current_size; first++,++i)
-            std::allocator_traits<Allocator>::construct(allocator, m_elements + i, *first);
+        construct_range(m_elements, first, count);
     } catch (...) {
-        destroy_elements(begin(), end());
         deallocate_elements(m_elements);
         throw;
     }
+    m_current_size = count;
+    m_stats.on_size(m_current_size);
 }
 
-template<class T, class Allocator>
-constexpr Vector<T,Allocator>::Vector(Vector && other)
-        : m_current_size(other.m_current_size), 
-          m_max_size(other.m_max_size),
-          m_elements(std::move(other.m_elements)),
-          allocator(other.allocator){
-    other.m_elements = nullptr;
-    other.m_max_size = 0;
-    other.m_current_size = 0;
+template<class T, class Allocator, growth_policy GrowthPolicy, class StatsPolicy>
+constexpr Vector<T, Allocator, GrowthPolicy, StatsPolicy>::Vector(Vector && other) noexcept
+        : allocator(std::move(other.allocator)){
+    steal_elements(other);
 }
 
-template<class T, class Allocator>
-constexpr Vector<T, Allocator>::Vector(const Vector & other) noexcept 
-            : m_current_size(other.m_current_size),
-              m_max_size(other.m_max_size),
-              allocator(other.allocator){
+template<class T, class Allocator, growth_policy GrowthPolicy, class StatsPolicy>
+constexpr Vector<T, Allocator, GrowthPolicy, StatsPolicy>::Vector(Vector && other, const allocator_type& alloc)
+        : allocator(alloc){
+    if( allocator == other.allocator){
+        steal_elements(other);
+        return;
+    }
+
+    // other memory belongs to another allocator, move the elements one by one
+    m_max_size = grow_capacity(0, other.m_current_size);
+    m_elements = allocate_elements(m_max_size);
     try {
-        m_elements = std::allocator_traits<Allocator>::allocate(allocator, m_max_size);
-        for(size_type i=0; i < m_current_size; ++i)
-            std::allocator_traits<Allocator>::construct(allocator, m_elements + i, other.m_elements[i]);
+        construct_range(m_elements, std::make_move_iterator(other.m_elements), other.m_current_size);
+    }catch(...){
+        deallocate_elements(m_elements);
+        throw;
+    }
+    m_current_size = other.m_current_size;
+    m_stats.on_size(m_current_size);
+}
+
+template<class T, class Allocator, growth_policy GrowthPolicy, class StatsPolicy>
+constexpr Vector<T, Allocator, GrowthPolicy, StatsPolicy>::Vector(const Vector & other)
+        : Vector(other, std::allocator_traits<Allocator>::select_on_container_copy_construction(other.allocator)){
+}
+
+template<class T, class Allocator, growth_policy GrowthPolicy, class StatsPolicy>
+constexpr Vector<T, Allocator, GrowthPolicy, StatsPolicy>::Vector(const Vector & other, const allocator_type& alloc)
+            : m_max_size(grow_capacity(0, other.m_current_size)),
+              allocator(alloc){
+    m_elements = allocate_elements(m_max_size);
+    try {
+        construct_range(m_elements, other.m_elements, other.m_current_size);
     }catch(...){
-        destroy_elements(begin(), end());
         deallocate_elements(m_elements);
-        //throw;
+        throw;
     }
+    m_current_size = other.m_current_size;
+    m_stats.on_size(m_current_size);
 }
 
-template<class T, class Allocator>
-constexpr Vector<T, Allocator>::Vector(std::initializer_list<T> init, const Allocator& alloc)
-    : m_current_size( init.size()), 
-      m_max_size( std::bit_ceil( init.size())), 
+template<class T, class Allocator, growth_policy GrowthPolicy, class StatsPolicy>
+constexpr Vector<T, Allocator, GrowthPolicy, StatsPolicy>::Vector(std::initializer_list<T> init, const Allocator& alloc)
+    : m_max_size( grow_capacity(0, init.size())), 
       allocator( alloc){
     
+    m_elements = allocate_elements(m_max_size);
     try {
-        m_elements = std::allocator_traits<Allocator>::allocate(allocator, m_max_size);
-        auto copy = init.begin();
-        for(size_type i=0 ;i < m_current_size; ++i, ++copy)
-            std::allocator_traits<Allocator>::construct(allocator, m_elements + i, *copy); 
+        construct_range(m_elements, init.begin(), init.size());
     }catch(...){
-        destroy_elements(begin(), end());
         deallocate_elements(m_elements);
         throw;
     }
+    m_current_size = init.size();
+    m_stats.on_size(m_current_size);
 }
 
-template<class T, class Allocator>
-constexpr Vector<T, Allocator>& Vector<T, Allocator>::operator=(Vector<T, Allocator> && other){
-    m_current_size = other.m_current_size;
-    m_max_size = other.m_max_size;
-    m_elements = other.m_elements;
-    allocator = other.allocator;
-    //other.m_elements = nullptr;
-    other.m_max_size = 0;
-    other.m_current_size = 0;
+template<class T, class Allocator, growth_policy GrowthPolicy, class StatsPolicy>
+template<container_compatible_range<T> Range>
+constexpr Vector<T, Allocator, GrowthPolicy, StatsPolicy>::Vector( from_range_t, Range&& range, const allocator_type& alloc )
+        : allocator(alloc){
+    append_range(std::forward<Range>(range));
+}
+
+template<class T, class Allocator, growth_policy GrowthPolicy, class StatsPolicy>
+constexpr Vector<T, Allocator, GrowthPolicy, StatsPolicy>& Vector<T, Allocator, GrowthPolicy, StatsPolicy>::operator=(Vector<T, Allocator, GrowthPolicy, StatsPolicy> && other)
+        noexcept(std::allocator_traits<Allocator>::propagate_on_container_move_assignment::value
+                 || std::allocator_traits<Allocator>::is_always_equal::value){
+    if( this == &other)
+        return *this;
+
+    clear();
+    if constexpr (std::allocator_traits<Allocator>::propagate_on_container_move_assignment::value){
+        allocator = std::move(other.allocator);
+        steal_elements(other);
+    } else if constexpr (std::allocator_traits<Allocator>::is_always_equal::value){
+        steal_elements(other);
+    } else {
+        if( allocator == other.allocator){
+            steal_elements(other);
+            return *this;
+        }
+
+        // Our allocator stays, the elements have to be moved in memory it owns
+        size_type new_max_size = grow_capacity(0, other.m_current_size);
+        pointer new_elements = allocate_elements(new_max_size);
+        try {
+            construct_range(new_elements, std::make_move_iterator(other.m_elements), other.m_current_size);
+        }
+        catch(...){
+            std::allocator_traits<Allocator>::deallocate(allocator, new_elements, new_max_size);
+            throw;
+        }
+        m_elements = new_elements;
+        m_max_size = new_max_size;
+        m_current_size = other.m_current_size;
+        m_stats.on_size(m_current_size);
+    }
     return *this;
 }
 
-template<class T, class Allocator>
-constexpr Vector<T,Allocator>& Vector<T, Allocator>::operator=(const Vector<T, Allocator>& other){
-    m_current_size =  other.m_current_size;
-    m_max_size = other.m_max_size;
-    allocator = other.allocator;
+template<class T, class Allocator, growth_policy GrowthPolicy, class StatsPolicy>
+constexpr Vector<T, Allocator, GrowthPolicy, StatsPolicy>& Vector<T, Allocator, GrowthPolicy, StatsPolicy>::operator=(const Vector<T, Allocator, GrowthPolicy, StatsPolicy>& other){
+    if( this == &other)
+        return *this;
+
+    // Release the memory with the allocator which gave it before propagating
+    clear();
+    if constexpr (std::allocator_traits<Allocator>::propagate_on_container_copy_assignment::value)
+        allocator = other.allocator;
+
+    size_type new_max_size = grow_capacity(0, other.m_current_size);
+    pointer new_elements = allocate_elements(new_max_size);
     try {
-        m_elements = std::allocator_traits<Allocator>::allocate(allocator, m_max_size);
-        for(size_type i=0; i < m_current_size; ++i)
-            std::allocator_traits<Allocator>::construct(allocator, &m_elements[i], other.m_elements[i]);
+        construct_range(new_elements, other.m_elements, other.m_current_size);
     }
     catch(...){
-        destroy_elements(begin(), end());
-        deallocate_elements(m_elements);
+        std::allocator_traits<Allocator>::deallocate(allocator, new_elements, new_max_size);
         throw;
     }
+    m_elements = new_elements;
+    m_max_size = new_max_size;
+    m_current_size = other.m_current_size;
+    m_stats.on_size(m_current_size);
     return *this;
 }
 
-
-template<class T, class Allocator>
-constexpr Vector<T, Allocator>::~Vector() {
+template<class T, class Allocator, growth_policy GrowthPolicy, class StatsPolicy>
+constexpr Vector<T, Allocator, GrowthPolicy, StatsPolicy>::~Vector() {
     if(m_max_size == 0)
         return;
 
@@ -288,146 +414,137 @@ constexpr Vector<T, Allocator>::~Vector() {
 }
 
 
-template<class T, class Allocator>
-constexpr T& Vector<T, Allocator>::at(size_type position){
-    if( position > m_current_size ) 
+template<class T, class Allocator, growth_policy GrowthPolicy, class StatsPolicy>
+constexpr Allocator Vector<T, Allocator, GrowthPolicy, StatsPolicy>::get_allocator() const noexcept{
+    return allocator;
+}
+
+template<class T, class Allocator, growth_policy GrowthPolicy, class StatsPolicy>
+constexpr T& Vector<T, Allocator, GrowthPolicy, StatsPolicy>::at(size_type position){
+    if( position >= m_current_size ) 
         throw std::out_of_range("");
     return m_elements[position];
 }
-template<class T, class Allocator>
-constexpr const T& Vector<T, Allocator>::at(size_type position) const{
-    if( position > m_current_size ) 
+template<class T, class Allocator, growth_policy GrowthPolicy, class StatsPolicy>
+constexpr const T& Vector<T, Allocator, GrowthPolicy, StatsPolicy>::at(size_type position) const{
+    if( position >= m_current_size ) 
         throw std::out_of_range("");
     return m_elements[position];
 }
 
-template<class T, class Allocator>
-constexpr T& Vector<T, Allocator>::operator[](size_type position){
+template<class T, class Allocator, growth_policy GrowthPolicy, class StatsPolicy>
+constexpr T& Vector<T, Allocator, GrowthPolicy, StatsPolicy>::operator[](size_type position){
     return m_elements[position];
 }
-template<class T, class Allocator>
-constexpr const T& Vector<T, Allocator>::operator[](size_type position) const{
+template<class T, class Allocator, growth_policy GrowthPolicy, class StatsPolicy>
+constexpr const T& Vector<T, Allocator, GrowthPolicy, StatsPolicy>::operator[](size_type position) const{
     return m_elements[position];
 }
 
-template<class T, class Allocator>
-constexpr T& Vector<T, Allocator>::front(){
+template<class T, class Allocator, growth_policy GrowthPolicy, class StatsPolicy>
+constexpr T& Vector<T, Allocator, GrowthPolicy, StatsPolicy>::front(){
     return at(0);
 }
-template<class T, class Allocator>
-constexpr const T& Vector<T, Allocator>::front()const{
+template<class T, class Allocator, growth_policy GrowthPolicy, class StatsPolicy>
+constexpr const T& Vector<T, Allocator, GrowthPolicy, StatsPolicy>::front()const{
     return at(0);
 }
 
 
-template<class T, class Allocator>
-constexpr T& Vector<T, Allocator>::back(){
+template<class T, class Allocator, growth_policy GrowthPolicy, class StatsPolicy>
+constexpr T& Vector<T, Allocator, GrowthPolicy, StatsPolicy>::back(){
     return at(m_current_size - 1);
 }
-template<class T, class Allocator>
-constexpr const T& Vector<T, Allocator>::back() const{
+template<class T, class Allocator, growth_policy GrowthPolicy, class StatsPolicy>
+constexpr const T& Vector<T, Allocator, GrowthPolicy, StatsPolicy>::back() const{
     return at(m_current_size - 1);
 }
 
-template<class T, class Allocator>
-constexpr T* Vector<T, Allocator>::data(){
+template<class T, class Allocator, growth_policy GrowthPolicy, class StatsPolicy>
+constexpr T* Vector<T, Allocator, GrowthPolicy, StatsPolicy>::data(){
     return m_elements;
 }
-template<class T, class Allocator>
-constexpr const T* Vector<T, Allocator>::data() const{
+template<class T, class Allocator, growth_policy GrowthPolicy, class StatsPolicy>
+constexpr const T* Vector<T, Allocator, GrowthPolicy, StatsPolicy>::data() const{
     return m_elements;
 }
 
-template<class T, class Allocator>
-constexpr Vector<T, Allocator>::iterator Vector<T, Allocator>::begin(){
-    return Vector<T, Allocator>::iterator(m_elements);
+template<class T, class Allocator, growth_policy GrowthPolicy, class StatsPolicy>
+constexpr Vector<T, Allocator, GrowthPolicy, StatsPolicy>::iterator Vector<T, Allocator, GrowthPolicy, StatsPolicy>::begin(){
+    return Vector<T, Allocator, GrowthPolicy, StatsPolicy>::iterator(m_elements);
 }
 
-template<class T, class Allocator>
-constexpr const Vector<T, Allocator>::iterator Vector<T, Allocator>::begin() const noexcept{
-    return Vector<T, Allocator>::iterator(m_elements);
+template<class T, class Allocator, growth_policy GrowthPolicy, class StatsPolicy>
+constexpr const Vector<T, Allocator, GrowthPolicy, StatsPolicy>::iterator Vector<T, Allocator, GrowthPolicy, StatsPolicy>::begin() const noexcept{
+    return Vector<T, Allocator, GrowthPolicy, StatsPolicy>::iterator(m_elements);
 }
 
-template<class T, class Allocator>
-constexpr Vector<T, Allocator>::iterator Vector<T, Allocator>::end(){
-    return Vector<T, Allocator>::iterator(&m_elements[m_current_size]);
+template<class T, class Allocator, growth_policy GrowthPolicy, class StatsPolicy>
+constexpr Vector<T, Allocator, GrowthPolicy, StatsPolicy>::iterator Vector<T, Allocator, GrowthPolicy, StatsPolicy>::end(){
+    return Vector<T, Allocator, GrowthPolicy, StatsPolicy>::iterator(&m_elements[m_current_size]);
 }
 
-template<class T, class Allocator>
-constexpr const Vector<T, Allocator>::iterator Vector<T, Allocator>::end() const noexcept{
-    return Vector<T, Allocator>::iterator(&m_elements[m_current_size]);
+template<class T, class Allocator, growth_policy GrowthPolicy, class StatsPolicy>
+constexpr const Vector<T, Allocator, GrowthPolicy, StatsPolicy>::iterator Vector<T, Allocator, GrowthPolicy, StatsPolicy>::end() const noexcept{
+    return Vector<T, Allocator, GrowthPolicy, StatsPolicy>::iterator(&m_elements[m_current_size]);
 }
 
-template<class T, class Allocator>
-constexpr const Vector<T, Allocator>::iterator Vector<T, Allocator>::cbegin() const noexcept{
-    return Vector<T, Allocator>::iterator(m_elements);
+template<class T, class Allocator, growth_policy GrowthPolicy, class StatsPolicy>
+constexpr const Vector<T, Allocator, GrowthPolicy, StatsPolicy>::iterator Vector<T, Allocator, GrowthPolicy, StatsPolicy>::cbegin() const noexcept{
+    return Vector<T, Allocator, GrowthPolicy, StatsPolicy>::iterator(m_elements);
 }
 
-template<class T, class Allocator>
-constexpr const Vector<T, Allocator>::iterator Vector<T, Allocator>::cend() const noexcept{
-    return Vector<T, Allocator>::iterator(&m_elements[m_current_size - 1]);
+template<class T, class Allocator, growth_policy GrowthPolicy, class StatsPolicy>
+constexpr const Vector<T, Allocator, GrowthPolicy, StatsPolicy>::iterator Vector<T, Allocator, GrowthPolicy, StatsPolicy>::cend() const noexcept{
+    return Vector<T, Allocator, GrowthPolicy, StatsPolicy>::iterator(m_elements + m_current_size);
 }
 
-template<class T, class Allocator>
-constexpr bool Vector<T, Allocator>::empty() const noexcept{
+template<class T, class Allocator, growth_policy GrowthPolicy, class StatsPolicy>
+constexpr bool Vector<T, Allocator, GrowthPolicy, StatsPolicy>::empty() const noexcept{
     return ( m_current_size == 0);
 }
 
-template<class T, class Allocator>
-constexpr std::size_t Vector<T, Allocator>::size() const noexcept{
+template<class T, class Allocator, growth_policy GrowthPolicy, class StatsPolicy>
+constexpr std::size_t Vector<T, Allocator, GrowthPolicy, StatsPolicy>::size() const noexcept{
     return m_current_size;
 }
 
-template<class T, class Allocator>
-constexpr std::size_t Vector<T, Allocator>::max_size() const noexcept{
+template<class T, class Allocator, growth_policy GrowthPolicy, class StatsPolicy>
+constexpr std::size_t Vector<T, Allocator, GrowthPolicy, StatsPolicy>::max_size() const noexcept{
     return std::numeric_limits<ptrdiff_t>::max();
 }
 
-template<class T, class Allocator>
-constexpr void Vector<T, Allocator>::reserve(const size_type new_cap){
+template<class T, class Allocator, growth_policy GrowthPolicy, class StatsPolicy>
+constexpr void Vector<T, Allocator, GrowthPolicy, StatsPolicy>::reserve(const size_type new_cap){
     if (new_cap > max_size())
         throw std::length_error(" The new cap exceed the absolute maximum size");
     if (new_cap <= m_max_size) 
         return;
 
-    pointer new_element = std::allocator_traits<Allocator>::allocate(allocator, new_cap);
-
-    for(size_type i=0; i < m_current_size; ++i)
-        std::allocator_traits<Allocator>::construct(allocator,new_element+i, m_elements[i]);
-
-    destroy_elements(begin(), end());
-    deallocate_elements( m_elements);
-
-    m_elements = new_element;
-
-    m_max_size = new_cap;
-
-
+    reallocate(new_cap, m_current_size, 0, [](pointer){});
 }
 
-template<class T, class Allocator>
-constexpr std::size_t Vector<T, Allocator>::capacity() const noexcept{
+template<class T, class Allocator, growth_policy GrowthPolicy, class StatsPolicy>
+constexpr std::size_t Vector<T, Allocator, GrowthPolicy, StatsPolicy>::capacity() const noexcept{
     return m_max_size;
 }
 
-template<class T, class Allocator>
-constexpr void Vector<T, Allocator>::shrink_to_fit(){
-    pointer new_elements = std::move( m_elements);
-    try { 
-        m_elements = std::allocator_traits<Allocator>::allocate(allocator, m_current_size);
-    }catch(...){
-        deallocate_elements(new_elements);
-        m_max_size = m_current_size;
+template<class T, class Allocator, growth_policy GrowthPolicy, class StatsPolicy>
+constexpr void Vector<T, Allocator, GrowthPolicy, StatsPolicy>::shrink_to_fit(){
+    if( m_current_size == m_max_size)
+        return;
+
+    if( m_current_size == 0){
         deallocate_elements(m_elements);
+        m_elements = nullptr;
+        m_max_size = 0;
+        return;
     }
-    for(size_type i=0; i < m_current_size; ++i)
-        std::allocator_traits<Allocator>::construct(allocator, m_elements + i, new_elements[i]);
-    deallocate_elements(new_elements);
-    m_max_size = m_current_size;
+    reallocate(m_current_size, m_current_size, 0, [](pointer){});
 }
 
-template<class T, class Allocator>
-constexpr void Vector<T, Allocator>::clear() noexcept{
+template<class T, class Allocator, growth_policy GrowthPolicy, class StatsPolicy>
+constexpr void Vector<T, Allocator, GrowthPolicy, StatsPolicy>::clear() noexcept{
     if ( m_max_size == 0)
         return;
 
@@ -436,105 +553,23 @@ constexpr void Vector<T, Allocator>::clear() noexcept{
     m_elements = nullptr;
     m_max_size = 0;
     m_current_size = 0;
+    m_stats.on_size(m_current_size);
 }
 
 
-template<class T, class Allocator>
-constexpr Vector<T, Allocator>::iterator Vector<T, Allocator>::insert( const_iterator pos,
+template<class T, class Allocator, growth_policy GrowthPolicy, class StatsPolicy>
+constexpr Vector<T, Allocator, GrowthPolicy, StatsPolicy>::iterator Vector<T, Allocator, GrowthPolicy, StatsPolicy>::insert( const_iterator pos,
                                                                       const_reference value){
-    // Check if pos is inside the container
-    // Since our iterator is random access iterator
-    // We have comparator to test
-    if( pos < begin() || end() < pos)
-        throw std::invalid_argument("insert position not in container");
-
-    difference_type insert_pos = std::distance(begin(), pos);
-    if( m_current_size  == m_max_size) {
-        pointer new_element = std::allocator_traits<Allocator>::allocate(allocator,
-                                                                              std::bit_ceil(m_current_size + 1));
-
-        for(size_type i=0; i < insert_pos;++i)
-            std::allocator_traits<Allocator>::construct(allocator, &new_element[i], m_elements[i]);
-
-        std::allocator_traits<Allocator>::construct(allocator, &new_element[insert_pos], value);
-
-        for(size_type i=insert_pos; i < m_current_size; ++i)
-            std::allocator_traits<Allocator>::construct(allocator, &new_element[i + 1],m_elements[i]);
-
-        destroy_elements(begin(), end());
-        deallocate_elements(m_elements);
-
-        m_elements = new_element;
-        ++m_current_size;
-        m_max_size = std::bit_ceil(m_current_size);
-    } else {
-
-        // We allocate the last one as N - 1 to up the iteration 
-        // to be able to put value inside
-        std::allocator_traits<Allocator>::construct(allocator,
-                                                    &m_elements[m_current_size],
-                                                    m_elements[m_current_size - 1]);
-
-        // Iteration of N-1 to pos to shift the variable
-        for(iterator it = end() - 1; it > pos; --it){
-            *it = *(it-1);
-        }
-        *pos = value;
-        ++m_current_size;
-    }
-    return pos;
+    return emplace(pos, value);
 }
 
-template<class T, class Allocator>
-constexpr Vector<T, Allocator>::iterator Vector<T, Allocator>::insert( const_iterator pos, T&& value){
-    
-    // Check if pos is inside the container
-    // Since our iterator is random access iterator
-    // We have comparator to test
-    if( pos < begin() || end() < pos)
-        throw std::invalid_argument("insert position not in container");
-
-    difference_type insert_pos = std::distance(begin(), pos);
-    
-    if( m_current_size == m_max_size){
-        pointer new_element = std::allocator_traits<Allocator>::allocate(allocator,
-                                                                              std::bit_ceil(m_max_size + 1));
-
-        for(size_type i=0; i < insert_pos;++i)
-            std::allocator_traits<Allocator>::construct(allocator, &new_element[i], m_elements[i]);
-
-        std::allocator_traits<Allocator>::construct(allocator, &new_element[insert_pos], std::move(value));
-
-        for(size_type i=insert_pos; i < m_current_size; ++i)
-            std::allocator_traits<Allocator>::construct(allocator, &new_element[i + 1],m_elements[i]);
-
-        destroy_elements(begin(), end());
-        deallocate_elements(m_elements);
-
-        m_elements = new_element;
-        ++m_current_size;
-        m_max_size = std::bit_ceil(m_current_size);
-        new_element = nullptr;
-    } else {
-        // We allocate the last one as N - 1 to up the iteration 
-        // to be able to put value inside
-        std::allocator_traits<Allocator>::construct(allocator,
-                                                    &m_elements[m_current_size],
-                                                    m_elements[m_current_size - 1]);
-
-        // Iteration of N-1 to pos to shift the variable
-        for(size_type i=m_current_size - 1; i > insert_pos; --i){
-            *( begin() + i) = *( begin() + i - 1);
-        }
-
-        *( begin() + insert_pos) = std::move(value);
-        ++m_current_size;
-    }
-    return pos;
+template<class T, class Allocator, growth_policy GrowthPolicy, class StatsPolicy>
+constexpr Vector<T, Allocator, GrowthPolicy, StatsPolicy>::iterator Vector<T, Allocator, GrowthPolicy, StatsPolicy>::insert( const_iterator pos, T&& value){
+    return emplace(pos, std::move(value));
 }
 
-template<class T, class Allocator>
-constexpr Vector<T, Allocator>::iterator Vector<T, Allocator>::insert( const_iterator pos, size_type count, const_reference value){
+template<class T, class Allocator, growth_policy GrowthPolicy, class StatsPolicy>
+constexpr Vector<T, Allocator, GrowthPolicy, StatsPolicy>::iterator Vector<T, Allocator, GrowthPolicy, StatsPolicy>::insert( const_iterator pos, size_type count, const_reference value){
 
     // Check if pos is inside the container
     // Since our iterator is random access iterator
@@ -542,57 +577,35 @@ constexpr Vector<T, Allocator>::iterator Vector<T, Allocator>::insert( const_ite
     if( pos < begin() || end() < pos)
         throw std::invalid_argument("insert position not in container");
 
-    difference_type insert_pos = std::distance(begin(), pos);
-    
-    if( m_current_size + count > m_max_size){
-        pointer new_element = std::allocator_traits<Allocator>::allocate(allocator,
-                                                                              std::bit_ceil(m_current_size + count));
-
-        for(size_type i=0; i < insert_pos;++i)
-            std::allocator_traits<Allocator>::construct(allocator, &new_element[i], m_elements[i]);
-        
-        for(size_type i=insert_pos;i < insert_pos + count;++i)
-            std::allocator_traits<Allocator>::construct(allocator, &new_element[i], value);
-
-        for(size_type i=insert_pos ; i < m_current_size; ++i)
-            std::allocator_traits<Allocator>::construct(allocator, &new_element[i + count + 1],m_elements[i]);
-
-        destroy_elements(begin(), end());
-        deallocate_elements(m_elements);
-
-        m_elements = new_element;
-        m_current_size += count;
-        m_max_size = std::bit_ceil(m_current_size);
-    } else { 
-        
-        // Put value N-count to N-1 -> N to N+count-1
-        for(size_type i=0; i < count; ++i){
-            std::allocator_traits<Allocator>::construct(allocator, 
-                                                        &m_elements[m_current_size+i],
-                                                        m_elements[m_current_size-count+i]);
-        }
-
-        // Shift value pos, N-count to pos+count to N-1
-        for(size_type i=m_current_size; i > insert_pos + count;++i){
-            *(begin() + i) = *(begin() + i - 1);
-        }
-        
-        // put value in pos, pos+count
-        for(size_type i=insert_pos; i < insert_pos + count;++i){
-            *(begin() + i) = value;
-        }
+    size_type insert_pos = static_cast<size_type>(std::distance(begin(), pos));
+    if( count == 0)
+        return begin() + static_cast<difference_type>(insert_pos);
 
+    if( m_current_size + count > m_max_size){
+        reallocate(grow_capacity(m_max_size, m_current_size + count), insert_pos, count, [&](pointer gap){
+            construct_n(gap, count, value);
+        });
         m_current_size += count;
-
-
-
+    } else {
+        // value can be an element of the container, keep a copy before shifting
+        value_type copy(value);
+        yadej::insert_in_place(allocator, m_elements, m_current_size, insert_pos, count,
+            [&](pointer dest, size_type, size_type n){ construct_n(dest, n, copy); },
+            [&](pointer dest, size_type, size_type n){ std::fill_n(dest, n, copy); });
+        m_stats.template on_relocate<T>(m_current_size - insert_pos - count);
     }
-    return pos;
+    m_stats.on_size(m_current_size);
+    return begin() + static_cast<difference_type>(insert_pos);
 }
-template<class T, class Allocator>
+template<class T, class Allocator, growth_policy GrowthPolicy, class StatsPolicy>
 template<class InputIt> requires is_iterator<InputIt>
-constexpr Vector<T, Allocator>::iterator Vector<T, Allocator>::insert( const_iterator pos, InputIt first, InputIt last){
+constexpr Vector<T, Allocator, GrowthPolicy, StatsPolicy>::iterator Vector<T, Allocator, GrowthPolicy, StatsPolicy>::insert( const_iterator pos, InputIt first, InputIt last){
+    return insert_counted(pos, first, static_cast<size_type>(std::distance(first, last)));
+}
 
+template<class T, class Allocator, growth_policy GrowthPolicy, class StatsPolicy>
+template<class InputIt>
+constexpr Vector<T, Allocator, GrowthPolicy, StatsPolicy>::iterator Vector<T, Allocator, GrowthPolicy, StatsPolicy>::insert_counted( const_iterator pos, InputIt first, size_type size_insert){
 
     // Check if pos is inside the container
     // Since our iterator is random access iterator
@@ -600,42 +613,90 @@ constexpr Vector<T, Allocator>::iterator Vector<T, Allocator>::insert( const_ite
     if( pos < begin() || end() < pos)
         throw std::invalid_argument("insert position not in container");
 
-    difference_type insert_pos = std::distance(begin(), pos);
-    difference_type size_insert = std::distance(first, last);
-
-    pointer new_element = std::allocator_traits<Allocator>::allocate(allocator,
-                                                                          std::bit_ceil(m_current_size + size_insert+ 1));
+    size_type insert_pos = static_cast<size_type>(std::distance(begin(), pos));
+    if( size_insert == 0)
+        return begin() + static_cast<difference_type>(insert_pos);
 
-    for(size_type i=0; i < insert_pos;++i)
-        std::allocator_traits<Allocator>::construct(allocator, &new_element[i], m_elements[i]);
-   
-    // Get first input to roll up in the new elements
-    InputIt cycle = first;
-    for(size_type i=insert_pos;cycle != last;++i, ++cycle)
-        std::allocator_traits<Allocator>::construct(allocator, &new_element[i], *cycle);
+    if( m_current_size + size_insert > m_max_size){
+        reallocate(grow_capacity(m_max_size, m_current_size + size_insert), insert_pos, size_insert, [&](pointer gap){
+            construct_range(gap, first, size_insert);
+        });
+        m_current_size += size_insert;
+    } else {
+        using step = std::iter_difference_t<InputIt>;
+        yadej::insert_in_place(allocator, m_elements, m_current_size, insert_pos, size_insert,
+            [&](pointer dest, size_type from, size_type n){ construct_range(dest, std::next(first, static_cast<step>(from)), n); },
+            [&](pointer dest, size_type from, size_type n){ std::copy_n(std::next(first, static_cast<step>(from)), n, dest); });
+        m_stats.template on_relocate<T>(m_current_size - insert_pos - size_insert);
+    }
+    m_stats.on_size(m_current_size);
+    return begin() + static_cast<difference_type>(insert_pos);
+}
 
-    for(size_type i=insert_pos ; i < m_current_size; ++i)
-        std::allocator_traits<Allocator>::construct(allocator, &new_element[i + size_insert + 1],m_elements[i]);
+template<class T, class Allocator, growth_policy GrowthPolicy, class StatsPolicy>
+template<container_compatible_range<T> Range>
+constexpr Vector<T, Allocator, GrowthPolicy, StatsPolicy>::iterator Vector<T, Allocator, GrowthPolicy, StatsPolicy>::insert_range( const_iterator pos, Range&& range){
+    if constexpr (std::ranges::sized_range<Range> || std::ranges::forward_range<Range>){
+        return insert_counted(pos, std::ranges::begin(range), static_cast<size_type>(std::ranges::distance(range)));
+    } else {
+        // Single pass range, its size is only known once read
+        Vector buffer(from_range, std::forward<Range>(range), allocator);
+        return insert_counted(pos, std::make_move_iterator(buffer.begin()), buffer.size());
+    }
+}
 
-    destroy_elements(begin(), end());
-    deallocate_elements(m_elements);
+template<class T, class Allocator, growth_policy GrowthPolicy, class StatsPolicy>
+template<container_compatible_range<T> Range>
+constexpr void Vector<T, Allocator, GrowthPolicy, StatsPolicy>::append_range( Range&& range){
+    if constexpr (std::ranges::sized_range<Range> || std::ranges::forward_range<Range>){
+        insert_counted(end(), std::ranges::begin(range), static_cast<size_type>(std::ranges::distance(range)));
+    } else {
+        for(auto&& value : range)
+            emplace_back(std::forward<decltype(value)>(value));
+    }
+}
 
-    m_elements = new_element;
-    m_current_size += size_insert;
-    m_max_size = std::bit_ceil(m_current_size);
-    new_element = nullptr;
-    return pos;
+template<class T, class Allocator, growth_policy GrowthPolicy, class StatsPolicy>
+template<container_compatible_range<T> Range>
+constexpr void Vector<T, Allocator, GrowthPolicy, StatsPolicy>::assign_range( Range&& range){
+    if constexpr (std::ranges::sized_range<Range> || std::ranges::forward_range<Range>){
+        const auto count = static_cast<size_type>(std::ranges::distance(range));
+        if( count > m_max_size){
+            // Build the new buffer first, the old elements survive an exception
+            size_type new_max_size = grow_capacity(0, count);
+            pointer new_elements = allocate_elements(new_max_size);
+            try {
+                construct_range(new_elements, std::ranges::begin(range), count);
+            } catch(...) {
+                std::allocator_traits<Allocator>::deallocate(allocator, new_elements, new_max_size);
+                throw;
+            }
+            clear();
+            m_elements = new_elements;
+            m_max_size = new_max_size;
+        } else {
+            destroy_elements(begin(), end());
+            m_current_size = 0;
+            construct_range(m_elements, std::ranges::begin(range), count);
+        }
+        m_current_size = count;
+        m_stats.on_size(m_current_size);
+    } else {
+        destroy_elements(begin(), end());
+        m_current_size = 0;
+        m_stats.on_size(m_current_size);
+        append_range(std::forward<Range>(range));
+    }
 }
 
-template<class T, class Allocator>
-constexpr Vector<T, Allocator>::iterator Vector<T, Allocator>::insert( const_iterator pos, std::initializer_list<T> ilist){
-    insert(pos, ilist.begin(), ilist.end());
-    return pos;
+template<class T, class Allocator, growth_policy GrowthPolicy, class StatsPolicy>
+constexpr Vector<T, Allocator, GrowthPolicy, StatsPolicy>::iterator Vector<T, Allocator, GrowthPolicy, StatsPolicy>::insert( const_iterator pos, std::initializer_list<T> ilist){
+    return insert(pos, ilist.begin(), ilist.end());
 }
 
-template<class T, class Allocator>
+template<class T, class Allocator, growth_policy GrowthPolicy, class StatsPolicy>
 template<class... Args>
-constexpr Vector<T, Allocator>::iterator Vector<T, Allocator>::emplace( const_iterator pos, Args&&... args){
+constexpr Vector<T, Allocator, GrowthPolicy, StatsPolicy>::iterator Vector<T, Allocator, GrowthPolicy, StatsPolicy>::emplace( const_iterator pos, Args&&... args){
 
      // Check if pos is inside the container
     // Since our iterator is random access iterator
@@ -643,236 +704,320 @@ constexpr Vector<T, Allocator>::iterator Vector<T, Allocator>::emplace( const_it
     if( pos < begin() || end() < pos)
         throw std::invalid_argument("insert position not in container");
 
-    difference_type insert_pos = std::distance(begin(), pos);
-    
-    if( m_current_size == m_max_size){
-        pointer new_element = std::allocator_traits<Allocator>::allocate(allocator,
-                                                                              std::bit_ceil(m_max_size + 1));
-
-        for(size_type i=0; i < insert_pos;++i)
-            std::allocator_traits<Allocator>::construct(allocator, &new_element[i], m_elements[i]);
-
-        std::allocator_traits<Allocator>::construct(allocator,
-                                                    &new_element[insert_pos], 
-                                                    new T(std::forward<T>(args)...));
-
-        for(size_type i=insert_pos; i < m_current_size; ++i)
-            std::allocator_traits<Allocator>::construct(allocator, &new_element[i + 1],m_elements[i]);
-
-        destroy_elements(begin(), end());
-        deallocate_elements(m_elements);
+    size_type insert_pos = static_cast<size_type>(std::distance(begin(), pos));
 
-        m_elements = new_element;
+    if( m_current_size == m_max_size){
+        reallocate(grow_capacity(m_max_size, m_current_size + 1), insert_pos, 1, [&](pointer gap){
+            std::allocator_traits<Allocator>::construct(allocator, gap, std::forward<Args>(args)...);
+            m_stats.template on_construct<T, Args&&...>(1);
+        });
         ++m_current_size;
-        m_max_size = std::bit_ceil(m_current_size);
-        new_element = nullptr;
-    } else {
-        // We allocate the last one as N - 1 to up the iteration 
-        // to be able to put value inside
-        std::allocator_traits<Allocator>::construct(allocator,
-                                                    &m_elements[m_current_size],
-                                                    m_elements[m_current_size - 1]);
-
-        // Iteration of N-1 to pos to shift the variable
-        for(size_type i=m_current_size - 1; i > insert_pos; --i){
-            *( begin() + i) = *( begin() + i - 1);
-        }
-
-        *( begin() + insert_pos) = new T(std::forward<T>(args)...);
+    } else if( insert_pos == m_current_size){
+        std::allocator_traits<Allocator>::construct(allocator, m_elements + m_current_size, std::forward<Args>(args)...);
+        m_stats.template on_construct<T, Args&&...>(1);
         ++m_current_size;
+    } else {
+        // args can refer to an element of the container, build the value before shifting
+        value_type new_value(std::forward<Args>(args)...);
+        yadej::insert_in_place(allocator, m_elements, m_current_size, insert_pos, 1,
+            [&](pointer dest, size_type, size_type){ std::allocator_traits<Allocator>::construct(allocator, dest, std::move(new_value)); },
+            [&](pointer dest, size_type, size_type){ *dest = std::move(new_value); });
+        m_stats.template on_relocate<T>(m_current_size - insert_pos - 1);
+        m_stats.template on_construct<T, Args&&...>(1);
+        m_stats.template on_construct<T, value_type&&>(1);
     }
-    
-    return pos;
+    m_stats.on_size(m_current_size);
+    return begin() + static_cast<difference_type>(insert_pos);
 }
 
-template<class T, class Allocator>
-constexpr void Vector<T, Allocator>::erase( Vector<T, Allocator>::iterator pos){
-    if( pos < begin() || pos > end())
+template<class T, class Allocator, growth_policy GrowthPolicy, class StatsPolicy>
+constexpr void Vector<T, Allocator, GrowthPolicy, StatsPolicy>::erase( Vector<T, Allocator, GrowthPolicy, StatsPolicy>::iterator pos){
+    if( pos < begin() || pos >= end())
         return;
-    
-    difference_type erase_pos = std::distance(begin(), pos);
-    for( size_type i=erase_pos; i < m_current_size; ++i){
-        *( begin() + i) = *( begin() + i + 1);
-    }
-    destroy_elements(end()-1, end());
-    m_current_size--;
+
+    size_type erase_pos = static_cast<size_type>(std::distance(begin(), pos));
+    yadej::erase_in_place(allocator, m_elements, m_current_size, erase_pos, 1);
+    m_stats.template on_relocate<T>(m_current_size - erase_pos);
+    m_stats.on_size(m_current_size);
 }
 
-template<class T, class Allocator>
-constexpr void Vector<T, Allocator>::erase( Vector<T, Allocator>::iterator first,
-                                            Vector<T, Allocator>::iterator last){
-    if( first < begin() || first > end() || first < begin() || last > end())
+template<class T, class Allocator, growth_policy GrowthPolicy, class StatsPolicy>
+constexpr void Vector<T, Allocator, GrowthPolicy, StatsPolicy>::erase( Vector<T, Allocator, GrowthPolicy, StatsPolicy>::iterator first,
+                                            Vector<T, Allocator, GrowthPolicy, StatsPolicy>::iterator last){
+    if( first < begin() || first > end() || last < first || last > end())
         return;
-    difference_type erase_pos = std::distance(begin(), first);
-    difference_type end_pos = std::distance(first, last);
-    for( size_type i=erase_pos; i < m_current_size - end_pos; ++i){
-        *( begin() + i) = *( begin() + i + end_pos);
-    }
-    destroy_elements(end()-end_pos, end());
-    m_current_size -= end_pos;
+    size_type erase_pos = static_cast<size_type>(std::distance(begin(), first));
+    size_type erase_count = static_cast<size_type>(std::distance(first, last));
+    yadej::erase_in_place(allocator, m_elements, m_current_size, erase_pos, erase_count);
+    m_stats.template on_relocate<T>(m_current_size - erase_pos);
+    m_stats.on_size(m_current_size);
 
 }
 
-template<class T, class Allocator>
-constexpr void Vector<T, Allocator>::push_back( const_reference value){
-    if( m_current_size == m_max_size){
-        size_type new_max_size = std::bit_ceil(m_max_size +1);
-        pointer new_elements = std::allocator_traits<Allocator>::allocate(allocator, new_max_size);
-
-        for(size_type i=0; i < m_max_size; ++i)
-            std::allocator_traits<Allocator>::construct(allocator, &new_elements[i], m_elements[i]);
-
-        destroy_elements(begin(), end());
-        deallocate_elements(m_elements);
-
-        m_elements = std::move(new_elements);
-        new_elements = nullptr;
-        m_max_size = new_max_size;
-    }
-
-    std::allocator_traits<Allocator>::construct(allocator, m_elements + m_current_size, value);
-    ++m_current_size;
+template<class T, class Allocator, growth_policy GrowthPolicy, class StatsPolicy>
+constexpr void Vector<T, Allocator, GrowthPolicy, StatsPolicy>::push_back( const_reference value){
+    emplace_back(value);
 }
 
-template<class T, class Allocator>
-constexpr void Vector<T, Allocator>::push_back( value_type&& value){
-    if( m_current_size == m_max_size){
-        size_type new_max_size = std::bit_ceil(m_max_size +1);
-        pointer new_elements = std::allocator_traits<Allocator>::allocate(allocator, new_max_size);
-
-        for(size_type i=0; i < m_max_size; ++i)
-            std::allocator_traits<Allocator>::construct(allocator, &new_elements[i], m_elements[i]);
-
-        destroy_elements(begin(), end());
-        deallocate_elements(m_elements);
-
-        m_elements = std::move(new_elements);
-        new_elements = nullptr;
-        m_max_size = new_max_size;
-    }
-    std::allocator_traits<Allocator>::construct(allocator, m_elements + m_current_size, value);
-    ++m_current_size;
+template<class T, class Allocator, growth_policy GrowthPolicy, class StatsPolicy>
+constexpr void Vector<T, Allocator, GrowthPolicy, StatsPolicy>::push_back( value_type&& value){
+    emplace_back(std::move(value));
 }
 
-template<class T, class Allocator>
+template<class T, class Allocator, growth_policy GrowthPolicy, class StatsPolicy>
 template<class... Args>
-constexpr T& Vector<T, Allocator>::emplace_back(Args&&... args){
-     if( m_current_size == m_max_size){
-        size_type new_max_size = std::bit_ceil(m_max_size +1);
-        pointer new_elements = std::allocator_traits<Allocator>::allocate(allocator, new_max_size);
-
-        for(size_type i=0; i < m_max_size; ++i)
-            std::allocator_traits<Allocator>::construct(allocator, &new_elements[i], m_elements[i]);
-
-        destroy_elements(begin(), end());
-        deallocate_elements(m_elements);
-
-        m_elements = std::move(new_elements);
-        new_elements = nullptr;
-        m_max_size = new_max_size;
+constexpr T& Vector<T, Allocator, GrowthPolicy, StatsPolicy>::emplace_back(Args&&... args){
+    if( m_current_size == m_max_size){
+        // The new element is built before the old ones are relocated
+        // so args can still refer to an element of the container
+        reallocate(grow_capacity(m_max_size, m_current_size + 1), m_current_size, 1, [&](pointer gap){
+            std::allocator_traits<Allocator>::construct(allocator, gap, std::forward<Args>(args)...);
+            m_stats.template on_construct<T, Args&&...>(1);
+        });
+    } else {
+        std::allocator_traits<Allocator>::construct(allocator, m_elements + m_current_size, std::forward<Args>(args)...);
+        m_stats.template on_construct<T, Args&&...>(1);
     }
-    // Make the allocation
-    reference new_element = new T(std::forward<Args>(args)...);
-    std::allocator_traits<Allocator>::construct(allocator, &new_element[m_current_size],new_element);
     ++m_current_size;
-    return new_element;
-
+    m_stats.on_size(m_current_size);
+    return m_elements[m_current_size - 1];
 }
 
-template<class T, class Allocator>
-constexpr void Vector<T, Allocator>::pop_back(){
+template<class T, class Allocator, growth_policy GrowthPolicy, class StatsPolicy>
+constexpr void Vector<T, Allocator, GrowthPolicy, StatsPolicy>::pop_back(){
     if(m_current_size == 0)
         return;
 
     std::allocator_traits<Allocator>::destroy(allocator, &m_elements[m_current_size - 1]);
     m_current_size--;
+    m_stats.on_size(m_current_size);
 }
 
-template<class T, class Allocator>
-constexpr void Vector<T, Allocator>::resize(size_type count){
+template<class T, class Allocator, growth_policy GrowthPolicy, class StatsPolicy>
+constexpr void Vector<T, Allocator, GrowthPolicy, StatsPolicy>::resize(size_type count){
     if( count == m_current_size)
         return;
 
     if( count < m_current_size){
-        Vector<T, Allocator>::iterator begin_destroyed_element = begin();
-        destroy_elements(begin_destroyed_element+count, end());
-    } else if( count > m_current_size && count < m_max_size){
-        for(size_type i=m_current_size; i < count; ++i)
-            std::allocator_traits<Allocator>::construct(allocator, m_elements + i, T());
+        Vector<T, Allocator, GrowthPolicy, StatsPolicy>::iterator begin_destroyed_element = begin();
+        destroy_elements(begin_destroyed_element+static_cast<difference_type>(count), end());
+    } else if( count <= m_max_size){
+        construct_n(m_elements + m_current_size, count - m_current_size);
     }else{
 
-        // Last possibility count > size and count > capacity 
+        // Last possibility count > size and count > capacity
         // So that we need some reallocation
-        size_type new_max_size = std::bit_ceil(count);
-        pointer new_elements = std::allocator_traits<Allocator>::allocate(allocator, new_max_size);
-
-        for(size_type i=0; i < m_current_size; ++i)
-            std::allocator_traits<Allocator>::construct(allocator, &new_elements[i], m_elements[i]);
-
-        for(size_type i=m_current_size; i < count; ++i)
-            std::allocator_traits<Allocator>::construct(allocator, &new_elements[i], T());
-
-
-        destroy_elements(begin(), end());
-        deallocate_elements(m_elements);
-
-        m_elements = std::move(new_elements);
-        //new_elements = nullptr;
-        m_max_size = new_max_size;
+        reallocate(grow_capacity(m_max_size, count), m_current_size, count - m_current_size, [&](pointer gap){
+            construct_n(gap, count - m_current_size);
+        });
     }
     m_current_size = count;
+    m_stats.on_size(m_current_size);
 }
 
-template<class T, class Allocator>
-constexpr void Vector<T, Allocator>::resize(size_type count, const_reference value) {
+template<class T, class Allocator, growth_policy GrowthPolicy, class StatsPolicy>
+constexpr void Vector<T, Allocator, GrowthPolicy, StatsPolicy>::resize(size_type count, const_reference value) {
     if( count == m_current_size)
         return;
 
     if( count < m_current_size){
-        Vector<T, Allocator>::iterator begin_destroyed_element = begin();
-        destroy_elements(begin_destroyed_element+count, end());
-    } else if( count > m_current_size && count < m_max_size){
-        
-        for(size_type i=m_current_size; i < count; ++i)
-            std::allocator_traits<Allocator>::construct(allocator, &m_elements[i], value);
+        Vector<T, Allocator, GrowthPolicy, StatsPolicy>::iterator begin_destroyed_element = begin();
+        destroy_elements(begin_destroyed_element+static_cast<difference_type>(count), end());
+    } else if( count <= m_max_size){
+        construct_n(m_elements + m_current_size, count - m_current_size, value);
     } else {
 
-        // Last possibility count > size and count > capacity 
+        // Last possibility count > size and count > capacity
         // So that we need some reallocation
-        size_type new_max_size = std::bit_ceil(count);
-        pointer new_elements = std::allocator_traits<Allocator>::allocate(allocator, new_max_size);
+        reallocate(grow_capacity(m_max_size, count), m_current_size, count - m_current_size, [&](pointer gap){
+            construct_n(gap, count - m_current_size, value);
+        });
+    }
+    m_current_size = count;
+    m_stats.on_size(m_current_size);
+}
 
-        for(size_type i=0; i < m_current_size; ++i)
-            std::allocator_traits<Allocator>::construct(allocator, &new_elements[i], m_elements[i]);
+template<class T, class Allocator, growth_policy GrowthPolicy, class StatsPolicy>
+constexpr void Vector<T, Allocator, GrowthPolicy, StatsPolicy>::resize_for_overwrite(size_type count){
+    if( count <= m_current_size){
+        resize(count);
+        return;
+    }
 
-        for(size_type i=m_current_size; i < count; ++i)
-            std::allocator_traits<Allocator>::construct(allocator, &new_elements[i], value);
+    if( count <= m_max_size){
+        construct_for_overwrite(m_elements + m_current_size, count - m_current_size);
+    } else {
+        reallocate(grow_capacity(m_max_size, count), m_current_size, count - m_current_size, [&](pointer gap){
+            construct_for_overwrite(gap, count - m_current_size);
+        });
+    }
+    m_current_size = count;
+    m_stats.on_size(m_current_size);
+}
 
-        destroy_elements(begin(), end());
-        deallocate_elements(m_elements);
+template<class T, class Allocator, growth_policy GrowthPolicy, class StatsPolicy>
+template<class Operation>
+constexpr void Vector<T, Allocator, GrowthPolicy, StatsPolicy>::resize_and_overwrite(size_type count, Operation op){
+    const size_type old_size = m_current_size;
+    resize_for_overwrite(std::max(count, old_size));
 
-        m_elements = std::move(new_elements);
-        //new_elements = nullptr;
-        m_max_size = new_max_size;
+    size_type kept = 0;
+    try {
+        kept = static_cast<size_type>(op(std::span<T>(m_elements, count)));
+    } catch(...) {
+        // The elements written past the old size are dropped
+        destroy_elements(begin() + static_cast<difference_type>(old_size), end());
+        m_current_size = old_size;
+        m_stats.on_size(m_current_size);
+        throw;
     }
-    m_current_size = count;
+    if( kept > count){
+        resize(old_size);
+        throw std::length_error("resize_and_overwrite operation kept more elements than given");
+    }
+    resize(kept);
+}
+
+// Swapping vectors whose allocators differ and do not propagate is undefined,
+// as for std::vector
+template<class T, class Allocator, growth_policy GrowthPolicy, class StatsPolicy>
+constexpr void Vector<T, Allocator, GrowthPolicy, StatsPolicy>::swap(Vector& other) noexcept{
+    if constexpr (std::allocator_traits<Allocator>::propagate_on_container_swap::value){
+        using std::swap;
+        swap(allocator, other.allocator);
+    }
+    std::swap(m_elements, other.m_elements);
+    std::swap(m_current_size, other.m_current_size);
+    std::swap(m_max_size, other.m_max_size);
+    m_stats.on_adopt(m_max_size, m_max_size * sizeof(T));
+    m_stats.on_size(m_current_size);
+    other.m_stats.on_adopt(other.m_max_size, other.m_max_size * sizeof(T));
+    other.m_stats.on_size(other.m_current_size);
 }
 
-template<class T, class Allocator>
-void Vector<T, Allocator>::destroy_elements(Vector<T, Allocator>::iterator first,
-                                            Vector<T, Allocator>::iterator last){
+template<class T, class Allocator, growth_policy GrowthPolicy, class StatsPolicy>
+constexpr void swap(Vector<T, Allocator, GrowthPolicy, StatsPolicy>& l_arg,
+                    Vector<T, Allocator, GrowthPolicy, StatsPolicy>& r_arg) noexcept{
+    l_arg.swap(r_arg);
+}
+
+template<class T, class Allocator, growth_policy GrowthPolicy, class StatsPolicy>
+void Vector<T, Allocator, GrowthPolicy, StatsPolicy>::destroy_elements(Vector<T, Allocator, GrowthPolicy, StatsPolicy>::iterator first,
+                                            Vector<T, Allocator, GrowthPolicy, StatsPolicy>::iterator last){
     for(; first != last; first++){
         std::allocator_traits<Allocator>::destroy(allocator, first.get());
     }
 }
 
-template<class T, class Allocator>
-void Vector<T, Allocator>::deallocate_elements(pointer elements){
+template<class T, class Allocator, growth_policy GrowthPolicy, class StatsPolicy>
+void Vector<T, Allocator, GrowthPolicy, StatsPolicy>::deallocate_elements(pointer elements){
     if(m_max_size == 0)
         return;
 
     std::allocator_traits<Allocator>::deallocate(allocator, elements, m_max_size);
+    m_stats.on_deallocate(m_max_size, m_max_size * sizeof(T));
+}
+
+template<class T, class Allocator, growth_policy GrowthPolicy, class StatsPolicy>
+constexpr std::size_t Vector<T, Allocator, GrowthPolicy, StatsPolicy>::grow_capacity(size_type capacity, size_type required){
+    return GrowthPolicy::template next_capacity<T>(capacity, required);
+}
+
+template<class T, class Allocator, growth_policy GrowthPolicy, class StatsPolicy>
+constexpr T* Vector<T, Allocator, GrowthPolicy, StatsPolicy>::allocate_elements(size_type count){
+    if( count == 0)
+        return nullptr;
+    pointer elements = std::allocator_traits<Allocator>::allocate(allocator, count);
+    m_stats.on_allocate(count, count * sizeof(T));
+    return elements;
+}
+
+template<class T, class Allocator, growth_policy GrowthPolicy, class StatsPolicy>
+constexpr void Vector<T, Allocator, GrowthPolicy, StatsPolicy>::steal_elements(Vector& other) noexcept{
+    m_elements = other.m_elements;
+    m_current_size = other.m_current_size;
+    m_max_size = other.m_max_size;
+    m_stats.on_adopt(m_max_size, m_max_size * sizeof(T));
+    m_stats.on_size(m_current_size);
+    other.m_elements = nullptr;
+    other.m_max_size = 0;
+    other.m_current_size = 0;
+    other.m_stats.on_size(0);
 }
 
+template<class T, class Allocator, growth_policy GrowthPolicy, class StatsPolicy>
+template<class Construct>
+constexpr void Vector<T, Allocator, GrowthPolicy, StatsPolicy>::reallocate(size_type new_cap,
+                                                size_type gap_pos,
+                                                size_type gap_count,
+                                                Construct&& construct_gap){
+    pointer new_elements = allocate_elements(new_cap);
+    try {
+        construct_gap(new_elements + gap_pos);
+    } catch(...) {
+        std::allocator_traits<Allocator>::deallocate(allocator, new_elements, new_cap);
+        throw;
+    }
+
+    try {
+        relocate_around(allocator, m_elements, m_current_size, new_elements, gap_pos, gap_count);
+    } catch(...) {
+        destroy_n(allocator, new_elements + gap_pos, gap_count);
+        std::allocator_traits<Allocator>::deallocate(allocator, new_elements, new_cap);
+        throw;
+    }
+
+    m_stats.template on_relocate<T>(m_current_size);
+    deallocate_elements(m_elements);
+    m_elements = new_elements;
+    m_max_size = new_cap;
 }
 
+template<class T, class Allocator, growth_policy GrowthPolicy, class StatsPolicy>
+template<class... Args>
+constexpr void Vector<T, Allocator, GrowthPolicy, StatsPolicy>::construct_n(pointer dest, size_type count, const Args&... args){
+    yadej::construct_n(allocator, dest, count, args...);
+    m_stats.template on_construct<T, const Args&...>(count);
+}
+
+template<class T, class Allocator, growth_policy GrowthPolicy, class StatsPolicy>
+constexpr void Vector<T, Allocator, GrowthPolicy, StatsPolicy>::construct_for_overwrite(pointer dest, size_type count){
+    // Placement new is not usable in constant evaluation, fall back to value-initialization
+    if( std::is_constant_evaluated()){
+        construct_n(dest, count);
+        return;
+    }
+    if constexpr (!std::is_trivially_default_constructible_v<T>){
+        size_type i = 0;
+        try {
+            for(; i < count; ++i)
+                ::new (static_cast<void*>(dest + i)) T;
+        } catch(...) {
+            for(size_type j=0; j < i; ++j)
+                std::allocator_traits<Allocator>::destroy(allocator, dest + j);
+            throw;
+        }
+    }
+}
+
+template<class T, class Allocator, growth_policy GrowthPolicy, class StatsPolicy>
+template<class InputIt>
+constexpr void Vector<T, Allocator, GrowthPolicy, StatsPolicy>::construct_range(pointer dest, InputIt first, size_type count){
+    yadej::construct_range(allocator, dest, first, count);
+    m_stats.template on_construct<T, decltype(*first)>(count);
+}
+
+// Vector whose data() is aligned on Align bytes (32 for AVX loads, 64 for
+// a cache line, 4096 for a page), whatever the alignment of T
+template<class T, std::size_t Align, growth_policy GrowthPolicy = growth::Doubling, class StatsPolicy = stats::Default>
+using AlignedVector = Vector<T, AlignedAllocator<T, Align>, GrowthPolicy, StatsPolicy>;
+
+namespace pmr {
+
+// Vector drawing its memory from a std::pmr::memory_resource
+template<class T, growth_policy GrowthPolicy = growth::Doubling, class StatsPolicy = stats::Default>
+using Vector = yadej::Vector<T, std::pmr::polymorphic_allocator<T>, GrowthPolicy, StatsPolicy>;
+
+}
+
+}
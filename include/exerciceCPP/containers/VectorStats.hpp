@@ -0,0 +1,247 @@
+#pragma once
+
+#include <algorithm> // remove max
+#include <atomic> // atomic
+#include <cstddef> // size_t
+#include <mutex> // mutex lock_guard
+#include <ostream> // ostream
+#include <string> // string
+#include <type_traits> // is_same_v remove_cvref_t
+#include <utility> // move
+#include <vector> // vector
+#include "Relocation.hpp"
+
+namespace yadej {
+
+namespace stats {
+
+// Statistics policies are given as the last template parameter of Vector.
+// Vector calls the on_* hooks on every allocation, relocation and
+// construction of an element, NoStats implements them as empty inline
+// functions and takes no room thanks to [[no_unique_address]].
+struct NoStats {
+    constexpr void on_allocate(std::size_t, std::size_t) noexcept {}
+    constexpr void on_deallocate(std::size_t, std::size_t) noexcept {}
+    constexpr void on_adopt(std::size_t, std::size_t) noexcept {}
+    template<class T>
+    constexpr void on_relocate(std::size_t) noexcept {}
+    template<class T, class... Args>
+    constexpr void on_construct(std::size_t) noexcept {}
+    constexpr void on_size(std::size_t) noexcept {}
+};
+
+// Snapshot of the counters of one vector
+struct Snapshot {
+    std::string label;
+    std::size_t allocations{0};
+    std::size_t bytes_allocated{0};
+    std::size_t peak_capacity{0};
+    std::size_t capacity{0};
+    std::size_t size{0};
+    std::size_t bytes_relocated{0};
+    std::size_t copies{0};
+    std::size_t moves{0};
+    std::size_t element_size{0};
+    // Slots allocated but not used
+    std::size_t wasted_capacity() const noexcept { return capacity - size; }
+    std::size_t wasted_bytes() const noexcept { return wasted_capacity() * element_size; }
+};
+
+class Counting;
+
+// Process wide list of the living Counting vectors, plus the totals of
+// the ones already destroyed. Safe to dump from any thread.
+class Registry {
+public:
+    static Registry& instance(){
+        // Never destroyed, vectors with static storage can outlive it
+        static Registry* registry = new Registry();
+        return *registry;
+    }
+
+    std::vector<Snapshot> snapshot() const;
+    // Counters summed over every vector destroyed so far
+    Snapshot retired() const;
+    // One line per living vector, sorted by wasted bytes, then the retired totals
+    void dump(std::ostream& out) const;
+
+private:
+    friend class Counting;
+    void add(const Counting* stats);
+    void remove(const Counting* stats);
+
+    mutable std::mutex m_mutex;
+    std::vector<const Counting*> m_living;
+    Snapshot m_retired{"<retired>"};
+};
+
+// Record every event in relaxed atomics and register in the Registry.
+// A copied or moved vector starts with fresh counters.
+class Counting {
+public:
+    Counting(){
+        Registry::instance().add(this);
+    }
+    Counting(const Counting&): Counting(){}
+    Counting& operator=(const Counting&){
+        return *this;
+    }
+    ~Counting(){
+        Registry::instance().remove(this);
+    }
+
+    // Name shown in the Registry dump
+    void set_label(std::string label){
+        std::lock_guard lock(Registry::instance().m_mutex);
+        m_label = std::move(label);
+    }
+
+    void on_allocate(std::size_t count, std::size_t bytes) noexcept{
+        m_allocations.fetch_add(1, std::memory_order_relaxed);
+        m_bytes_allocated.fetch_add(bytes, std::memory_order_relaxed);
+        on_adopt(count, bytes);
+    }
+
+    // Buffer taken from another vector, without allocation
+    void on_adopt(std::size_t count, std::size_t bytes) noexcept{
+        if( count == 0)
+            return;
+        m_element_size.store(bytes / count, std::memory_order_relaxed);
+        m_capacity.store(count, std::memory_order_relaxed);
+        if( count > m_peak_capacity.load(std::memory_order_relaxed))
+            m_peak_capacity.store(count, std::memory_order_relaxed);
+    }
+
+    void on_deallocate(std::size_t count, std::size_t) noexcept{
+        if( m_capacity.load(std::memory_order_relaxed) == count)
+            m_capacity.store(0, std::memory_order_relaxed);
+    }
+
+    // Elements moved to another place, by memmove, move or copy
+    // depending on what relocate picks for T
+    template<class T>
+    void on_relocate(std::size_t count) noexcept{
+        m_bytes_relocated.fetch_add(count * sizeof(T), std::memory_order_relaxed);
+        if constexpr (is_trivially_relocatable_v<T>)
+            return;
+        else if constexpr (std::is_nothrow_move_constructible_v<T> || !std::is_copy_constructible_v<T>)
+            m_moves.fetch_add(count, std::memory_order_relaxed);
+        else
+            m_copies.fetch_add(count, std::memory_order_relaxed);
+    }
+
+    // count elements built from Args, a single T argument is a copy or a move,
+    // any other constructor is not counted
+    template<class T, class... Args>
+    void on_construct(std::size_t count) noexcept{
+        if constexpr (sizeof...(Args) == 1)
+            on_construct_from<T, Args...>(count);
+    }
+
+    void on_size(std::size_t size) noexcept{
+        m_size.store(size, std::memory_order_relaxed);
+    }
+
+    Snapshot snapshot() const{
+        Snapshot result;
+        result.label = m_label;
+        result.allocations = m_allocations.load(std::memory_order_relaxed);
+        result.bytes_allocated = m_bytes_allocated.load(std::memory_order_relaxed);
+        result.peak_capacity = m_peak_capacity.load(std::memory_order_relaxed);
+        result.capacity = m_capacity.load(std::memory_order_relaxed);
+        result.size = std::min(m_size.load(std::memory_order_relaxed), result.capacity);
+        result.bytes_relocated = m_bytes_relocated.load(std::memory_order_relaxed);
+        result.copies = m_copies.load(std::memory_order_relaxed);
+        result.moves = m_moves.load(std::memory_order_relaxed);
+        result.element_size = m_element_size.load(std::memory_order_relaxed);
+        return result;
+    }
+
+private:
+    template<class T, class Arg>
+    void on_construct_from(std::size_t count) noexcept{
+        if constexpr (std::is_same_v<std::remove_cvref_t<Arg>, T>){
+            if constexpr (std::is_rvalue_reference_v<Arg&&> && !std::is_const_v<std::remove_reference_t<Arg>>)
+                m_moves.fetch_add(count, std::memory_order_relaxed);
+            else
+                m_copies.fetch_add(count, std::memory_order_relaxed);
+        }
+    }
+
+    std::string m_label;
+    std::atomic<std::size_t> m_allocations{0};
+    std::atomic<std::size_t> m_bytes_allocated{0};
+    std::atomic<std::size_t> m_peak_capacity{0};
+    std::atomic<std::size_t> m_capacity{0};
+    std::atomic<std::size_t> m_size{0};
+    std::atomic<std::size_t> m_bytes_relocated{0};
+    std::atomic<std::size_t> m_copies{0};
+    std::atomic<std::size_t> m_moves{0};
+    std::atomic<std::size_t> m_element_size{0};
+};
+
+inline void Registry::add(const Counting* stats){
+    std::lock_guard lock(m_mutex);
+    m_living.push_back(stats);
+}
+
+inline void Registry::remove(const Counting* stats){
+    std::lock_guard lock(m_mutex);
+    Snapshot last = stats->snapshot();
+    m_retired.allocations += last.allocations;
+    m_retired.bytes_allocated += last.bytes_allocated;
+    m_retired.peak_capacity = std::max(m_retired.peak_capacity, last.peak_capacity);
+    m_retired.bytes_relocated += last.bytes_relocated;
+    m_retired.copies += last.copies;
+    m_retired.moves += last.moves;
+    m_living.erase(std::remove(m_living.begin(), m_living.end(), stats), m_living.end());
+}
+
+inline std::vector<Snapshot> Registry::snapshot() const{
+    std::lock_guard lock(m_mutex);
+    std::vector<Snapshot> result;
+    result.reserve(m_living.size());
+    for(const Counting* stats : m_living)
+        result.push_back(stats->snapshot());
+    return result;
+}
+
+inline Snapshot Registry::retired() const{
+    std::lock_guard lock(m_mutex);
+    return m_retired;
+}
+
+inline void Registry::dump(std::ostream& out) const{
+    std::vector<Snapshot> living = snapshot();
+    std::sort(living.begin(), living.end(), [](const Snapshot& l_arg, const Snapshot& r_arg){
+        return l_arg.wasted_bytes() > r_arg.wasted_bytes();
+    });
+
+    auto print = [&out](const Snapshot& stats){
+        out << (stats.label.empty() ? "<unnamed>" : stats.label)
+            << " allocations=" << stats.allocations
+            << " bytes_allocated=" << stats.bytes_allocated
+            << " size=" << stats.size
+            << " capacity=" << stats.capacity
+            << " peak_capacity=" << stats.peak_capacity
+            << " wasted_bytes=" << stats.wasted_bytes()
+            << " bytes_relocated=" << stats.bytes_relocated
+            << " copies=" << stats.copies
+            << " moves=" << stats.moves << '\n';
+    };
+    for(const Snapshot& stats : living)
+        print(stats);
+    print(retired());
+}
+
+// Policy used when Vector is not given one: NoStats unless the
+// EXERCICECPP_VECTOR_STATS macro is defined (exerciceCPP_ENABLE_VECTOR_STATS)
+#ifdef EXERCICECPP_VECTOR_STATS
+using Default = Counting;
+#else
+using Default = NoStats;
+#endif
+
+}
+
+}
@@ -0,0 +1,318 @@
+#pragma once
+
+#include <algorithm> // min count
+#include <array> // array
+#include <atomic> // atomic wait notify
+#include <cerrno> // errno EINTR
+#include <concepts> // invocable convertible_to
+#include <cstddef> // size_t byte
+#include <cstdint> // uint64_t
+#include <cstring> // memcpy
+#include <exception> // exception_ptr current_exception rethrow_exception
+#include <filesystem> // path
+#include <span> // span
+#include <stdexcept> // invalid_argument length_error
+#include <string_view> // string_view
+#include <system_error> // system_error generic_category
+#include <thread> // thread
+#include <type_traits> // is_trivially_copyable_v invoke_result_t
+#include <fcntl.h> // open posix_fadvise
+#include <unistd.h> // read close
+#include "../containers/Vector.hpp"
+#include "../memory/CachePadded.hpp"
+
+namespace yadej {
+
+namespace io {
+
+// Sizes of the buffers of a ChunkReader. The reader never holds more than
+// chunk_size * chunks bytes of the file, whatever its size.
+struct ChunkOptions {
+    std::size_t chunk_size = std::size_t{1} << 20;
+    // 2 is double buffering: one chunk decoded while the next one loads
+    std::size_t chunks = 2;
+};
+
+// Reads a file chunk by chunk from a background thread, ahead of the caller.
+//
+// The chunks live in a ring of ChunkOptions::chunks buffers. next() hands
+// the oldest loaded chunk to the caller and gives the previous one back to
+// the reader thread, which refills it with the following part of the file.
+// When every buffer is loaded and not yet consumed the reader thread sleeps:
+// a slow consumer slows the reads down instead of growing the memory.
+//
+//     yadej::io::ChunkReader reader("huge.bin", {.chunk_size = 4 << 20});
+//     for(auto chunk = reader.next(); !chunk.empty(); chunk = reader.next())
+//         process(chunk);
+class ChunkReader {
+public:
+    explicit ChunkReader(const std::filesystem::path& path, ChunkOptions options = {});
+    ChunkReader(const ChunkReader&) = delete;
+    ChunkReader& operator=(const ChunkReader&) = delete;
+    // Stops the reader thread, the file may not be read to the end
+    ~ChunkReader();
+
+    // Next chunk of the file, valid until the following call. Every chunk
+    // but the last is chunk_size bytes long, an empty span is the end of the
+    // file. An error of the reader thread is rethrown here.
+    std::span<const std::byte> next();
+
+    // Offset in the file of the chunk returned by the last next()
+    std::uint64_t offset() const noexcept{ return m_offset; }
+    std::size_t chunk_size() const noexcept{ return m_chunk_size; }
+    std::size_t memory_budget() const noexcept{ return m_buffer.size(); }
+
+    // Backpressure: how many times the reader thread found every buffer
+    // full and waited for the consumer, and how many times next() waited
+    // for the disk. The larger one tells which side is the bottleneck.
+    std::uint64_t reader_waits() const noexcept{ return m_reader_waits.load(std::memory_order_relaxed); }
+    std::uint64_t consumer_waits() const noexcept{ return m_consumer_waits; }
+
+private:
+    void read_loop() noexcept;
+    // Fills the buffer unless the file ends first, returns the bytes read
+    std::size_t read_chunk(std::byte* dest);
+
+    int m_fd{-1};
+    std::size_t m_chunk_size;
+    std::size_t m_chunks;
+    Vector<std::byte> m_buffer;
+    // Bytes in every buffer, 0 marks the end of the file
+    Vector<std::size_t> m_sizes;
+    std::exception_ptr m_error;
+
+    // Chunks loaded by the reader thread and given back by the consumer,
+    // apart as they are written by different threads
+    CachePadded<std::atomic<std::uint64_t>> m_loaded;
+    CachePadded<std::atomic<std::uint64_t>> m_released;
+    std::atomic<bool> m_stop{false};
+    std::atomic<std::uint64_t> m_reader_waits{0};
+
+    // Consumer side
+    std::uint64_t m_taken{0};
+    std::uint64_t m_offset{0};
+    std::size_t m_last_size{0};
+    std::uint64_t m_consumer_waits{0};
+    bool m_finished{false};
+
+    std::thread m_thread;
+};
+
+inline ChunkReader::ChunkReader(const std::filesystem::path& path, ChunkOptions options)
+    : m_chunk_size(options.chunk_size), m_chunks(options.chunks){
+    if( m_chunk_size == 0 || m_chunks < 2)
+        throw std::invalid_argument("ChunkReader needs at least two chunks of at least one byte");
+    m_buffer.resize_for_overwrite(m_chunk_size * m_chunks);
+    m_sizes.resize(m_chunks);
+    m_fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if( m_fd < 0)
+        throw std::system_error(errno, std::generic_category(), "ChunkReader open");
+    // Only a hint, larger read ahead from the kernel
+    ::posix_fadvise(m_fd, 0, 0, POSIX_FADV_SEQUENTIAL);
+    try {
+        m_thread = std::thread([this]{ read_loop(); });
+    } catch(...) {
+        ::close(m_fd);
+        throw;
+    }
+}
+
+inline ChunkReader::~ChunkReader(){
+    // A bump of m_released wakes the reader thread if it waits for a buffer
+    m_stop.store(true, std::memory_order_release);
+    m_released->fetch_add(1, std::memory_order_release);
+    m_released->notify_one();
+    m_thread.join();
+    ::close(m_fd);
+}
+
+inline std::span<const std::byte> ChunkReader::next(){
+    if( m_finished)
+        return {};
+    if( m_taken != 0){
+        m_offset += m_last_size;
+        m_released->fetch_add(1, std::memory_order_release);
+        m_released->notify_one();
+    }
+
+    std::uint64_t loaded = m_loaded->load(std::memory_order_acquire);
+    if( loaded == m_taken){
+        ++m_consumer_waits;
+        do {
+            m_loaded->wait(loaded, std::memory_order_acquire);
+            loaded = m_loaded->load(std::memory_order_acquire);
+        } while( loaded == m_taken);
+    }
+
+    const std::size_t slot = m_taken % m_chunks;
+    ++m_taken;
+    m_last_size = m_sizes[slot];
+    if( m_last_size == 0){
+        m_finished = true;
+        if( m_error)
+            std::rethrow_exception(m_error);
+        return {};
+    }
+    return {m_buffer.data() + slot * m_chunk_size, m_last_size};
+}
+
+inline void ChunkReader::read_loop() noexcept{
+    for(std::uint64_t index=0; ; ++index){
+        // Wait for the buffer of this chunk to be given back
+        std::uint64_t released = m_released->load(std::memory_order_acquire);
+        if( index - released >= m_chunks){
+            m_reader_waits.fetch_add(1, std::memory_order_relaxed);
+            do {
+                // Checked between the load and the wait, the destructor bumps
+                // m_released after setting m_stop
+                if( m_stop.load(std::memory_order_acquire))
+                    return;
+                m_released->wait(released, std::memory_order_acquire);
+                released = m_released->load(std::memory_order_acquire);
+            } while( index - released >= m_chunks);
+        }
+        if( m_stop.load(std::memory_order_acquire))
+            return;
+
+        const std::size_t slot = index % m_chunks;
+        std::size_t size = 0;
+        try {
+            size = read_chunk(m_buffer.data() + slot * m_chunk_size);
+        } catch(...) {
+            m_error = std::current_exception();
+        }
+        m_sizes[slot] = size;
+        m_loaded->store(index + 1, std::memory_order_release);
+        m_loaded->notify_one();
+        // The end of the file, or an error, ends as an empty chunk
+        if( size == 0)
+            return;
+    }
+}
+
+inline std::size_t ChunkReader::read_chunk(std::byte* dest){
+    std::size_t size = 0;
+    while( size < m_chunk_size){
+        const ::ssize_t count = ::read(m_fd, dest + size, m_chunk_size - size);
+        if( count < 0){
+            if( errno == EINTR)
+                continue;
+            throw std::system_error(errno, std::generic_category(), "ChunkReader read");
+        }
+        if( count == 0)
+            break;
+        size += static_cast<std::size_t>(count);
+    }
+    return size;
+}
+
+// Appends to out the fixed size records of the file, each the raw bytes of
+// a T as serialize writes them. The records go straight from the chunks
+// into the uninitialized end of out, one memcpy per chunk. Returns the
+// number of records appended, throws length_error when the file does not
+// end on a whole record.
+template<class T, class Allocator, growth_policy GrowthPolicy, class StatsPolicy>
+std::uint64_t read_records(ChunkReader& reader, Vector<T, Allocator, GrowthPolicy, StatsPolicy>& out){
+    static_assert(std::is_trivially_copyable_v<T>, "Only trivially copyable records are read as raw bytes");
+    const std::size_t first = out.size();
+    // Record cut between two chunks
+    std::array<std::byte, sizeof(T)> partial;
+    std::size_t partial_size = 0;
+
+    for(std::span<const std::byte> chunk = reader.next(); !chunk.empty(); chunk = reader.next()){
+        if( partial_size != 0){
+            const std::size_t missing = std::min(sizeof(T) - partial_size, chunk.size());
+            std::memcpy(partial.data() + partial_size, chunk.data(), missing);
+            partial_size += missing;
+            chunk = chunk.subspan(missing);
+            if( partial_size < sizeof(T))
+                continue;
+            out.emplace_back();
+            std::memcpy(&out.back(), partial.data(), sizeof(T));
+            partial_size = 0;
+        }
+
+        const std::size_t count = chunk.size() / sizeof(T);
+        if( count != 0){
+            const std::size_t old_size = out.size();
+            out.resize_and_overwrite(old_size + count, [&](std::span<T> elements){
+                std::memcpy(elements.data() + old_size, chunk.data(), count * sizeof(T));
+                return elements.size();
+            });
+        }
+        partial_size = chunk.size() - count * sizeof(T);
+        std::memcpy(partial.data(), chunk.data() + count * sizeof(T), partial_size);
+    }
+    if( partial_size != 0)
+        throw std::length_error("read_records file size is not a multiple of the record size");
+    return out.size() - first;
+}
+
+// Appends to out decode(line) for every line of the file, without the
+// '\n'. A last line without '\n' is decoded too. The lines are seen in
+// place in the chunks, only a line cut between two chunks is copied aside,
+// and the results are written in the uninitialized end of out. Returns the
+// number of lines, throws length_error for a line longer than a chunk: it
+// would not fit in the memory budget.
+//
+//     yadej::Vector<double> prices;
+//     yadej::io::read_lines(reader, prices, [](std::string_view line){ return parse_price(line); });
+template<class T, class Allocator, growth_policy GrowthPolicy, class StatsPolicy, class Decode>
+    requires std::invocable<Decode&, std::string_view>
+          && std::convertible_to<std::invoke_result_t<Decode&, std::string_view>, T>
+std::uint64_t read_lines(ChunkReader& reader, Vector<T, Allocator, GrowthPolicy, StatsPolicy>& out, Decode decode){
+    const std::size_t first = out.size();
+    // Line cut between two chunks
+    Vector<char> partial;
+    partial.reserve(reader.chunk_size());
+
+    for(std::span<const std::byte> chunk = reader.next(); !chunk.empty(); chunk = reader.next()){
+        const std::string_view text(reinterpret_cast<const char*>(chunk.data()), chunk.size());
+        const std::size_t last = text.rfind('\n');
+        if( last == std::string_view::npos){
+            if( partial.size() + text.size() > reader.chunk_size())
+                throw std::length_error("read_lines line longer than a chunk");
+            partial.append_range(text);
+            continue;
+        }
+
+        // Lines ended in this chunk, '\n' between them, then the start of
+        // the next one
+        std::string_view lines = text.substr(0, last);
+        const std::string_view rest = text.substr(last + 1);
+        bool more = true;
+        if( !partial.empty()){
+            const std::size_t cut = lines.find('\n');
+            const std::string_view head = lines.substr(0, cut);
+            if( partial.size() + head.size() > reader.chunk_size())
+                throw std::length_error("read_lines line longer than a chunk");
+            partial.append_range(head);
+            out.push_back(decode(std::string_view(partial.data(), partial.size())));
+            partial.clear();
+            more = cut != std::string_view::npos;
+            if( more)
+                lines.remove_prefix(cut + 1);
+        }
+
+        if( more){
+            const std::size_t old_size = out.size();
+            const auto count = static_cast<std::size_t>(std::count(lines.begin(), lines.end(), '\n')) + 1;
+            out.resize_and_overwrite(old_size + count, [&](std::span<T> elements){
+                for(std::size_t i=old_size; i < elements.size(); ++i){
+                    const std::size_t cut = std::min(lines.find('\n'), lines.size());
+                    elements[i] = decode(lines.substr(0, cut));
+                    lines.remove_prefix(std::min(cut + 1, lines.size()));
+                }
+                return elements.size();
+            });
+        }
+        partial.append_range(rest);
+    }
+    if( !partial.empty())
+        out.push_back(decode(std::string_view(partial.data(), partial.size())));
+    return out.size() - first;
+}
+
+}
+
+}
@@ -0,0 +1,560 @@
+#pragma once
+
+#include <algorithm> // min
+#include <array> // array
+#include <bit> // endian rotl
+#include <cerrno> // errno EINTR
+#include <concepts> // convertible_to
+#include <cstddef> // size_t byte
+#include <cstdint> // uint32_t uint64_t uintptr_t
+#include <cstring> // memcpy
+#include <filesystem> // path
+#include <memory> // allocator
+#include <span> // span as_bytes
+#include <stdexcept> // invalid_argument length_error logic_error out_of_range runtime_error
+#include <system_error> // system_error generic_category
+#include <type_traits> // is_trivially_copyable_v
+#include <utility> // exchange pair
+#include <fcntl.h> // open
+#include <sys/mman.h> // mmap munmap
+#include <sys/stat.h> // fstat
+#include <unistd.h> // write pwrite close
+#include "../containers/Iterator.hpp"
+#include "../containers/MappedVector.hpp"
+#include "../containers/Vector.hpp"
+
+namespace yadej {
+
+namespace io {
+
+// Binary format of a Vector of trivially copyable elements:
+//
+//     offset  size
+//          0     8  magic "YADEJVEC"
+//          8     4  format version
+//         12     4  flags, 0
+//         16     8  element size
+//         24     8  element count
+//         32     8  alignment of the elements
+//         40     8  checksum of the payload (Checksum)
+//         48    16  zero
+//         64        payload, at the first multiple of the alignment
+//
+// The header fields are little endian, the payload is the raw memory of
+// the elements: the format is only read and written on little endian hosts.
+inline constexpr std::array<char, 8> magic{'Y', 'A', 'D', 'E', 'J', 'V', 'E', 'C'};
+inline constexpr std::uint32_t format_version = 1;
+inline constexpr std::size_t header_size = 64;
+
+struct Header {
+    std::uint32_t version{format_version};
+    std::uint32_t flags{0};
+    std::uint64_t element_size{0};
+    std::uint64_t count{0};
+    std::uint64_t alignment{1};
+    std::uint64_t checksum{0};
+
+    // Offset of the payload from the start of the header
+    std::uint64_t payload_offset() const noexcept{
+        return (header_size + alignment - 1) / alignment * alignment;
+    }
+};
+
+template<class T>
+Header header_of(std::uint64_t count, std::uint64_t checksum) noexcept{
+    Header header;
+    header.element_size = sizeof(T);
+    header.count = count;
+    header.alignment = alignof(T);
+    header.checksum = checksum;
+    return header;
+}
+
+inline void store_little(std::byte* dest, std::uint64_t value, std::size_t bytes) noexcept{
+    for(std::size_t i=0; i < bytes; ++i)
+        dest[i] = static_cast<std::byte>(value >> (8 * i));
+}
+
+inline std::uint64_t load_little(const std::byte* source, std::size_t bytes) noexcept{
+    std::uint64_t value = 0;
+    for(std::size_t i=0; i < bytes; ++i)
+        value |= std::to_integer<std::uint64_t>(source[i]) << (8 * i);
+    return value;
+}
+
+// Header and the zero padding up to the payload
+inline Vector<std::byte> encode(const Header& header){
+    Vector<std::byte> bytes(header.payload_offset(), std::byte{0});
+    std::memcpy(bytes.data(), magic.data(), magic.size());
+    store_little(bytes.data() + 8, header.version, 4);
+    store_little(bytes.data() + 12, header.flags, 4);
+    store_little(bytes.data() + 16, header.element_size, 8);
+    store_little(bytes.data() + 24, header.count, 8);
+    store_little(bytes.data() + 32, header.alignment, 8);
+    store_little(bytes.data() + 40, header.checksum, 8);
+    return bytes;
+}
+
+// Throws std::invalid_argument when bytes does not start with a valid header
+inline Header decode(std::span<const std::byte> bytes){
+    if( bytes.size() < header_size)
+        throw std::invalid_argument("Buffer smaller than a header");
+    if( std::memcmp(bytes.data(), magic.data(), magic.size()) != 0)
+        throw std::invalid_argument("Bad magic, not a serialized Vector");
+    Header header;
+    header.version = static_cast<std::uint32_t>(load_little(bytes.data() + 8, 4));
+    header.flags = static_cast<std::uint32_t>(load_little(bytes.data() + 12, 4));
+    header.element_size = load_little(bytes.data() + 16, 8);
+    header.count = load_little(bytes.data() + 24, 8);
+    header.alignment = load_little(bytes.data() + 32, 8);
+    header.checksum = load_little(bytes.data() + 40, 8);
+    if( header.version != format_version)
+        throw std::invalid_argument("Unsupported format version");
+    if( header.alignment == 0 || (header.alignment & (header.alignment - 1)) != 0)
+        throw std::invalid_argument("Alignment is not a power of two");
+    return header;
+}
+
+// 64 bit checksum of a byte stream, fed in pieces of any size. It is the
+// XXH64 hash with seed 0: four independent multiply accumulate lanes over
+// 32 byte stripes, fast enough to keep up with a disk.
+class Checksum {
+public:
+    void update(std::span<const std::byte> bytes) noexcept;
+    std::uint64_t digest() const noexcept;
+
+private:
+    static constexpr std::uint64_t prime1 = 0x9E3779B185EBCA87ull;
+    static constexpr std::uint64_t prime2 = 0xC2B2AE3D27D4EB4Full;
+    static constexpr std::uint64_t prime3 = 0x165667B19E3779F9ull;
+    static constexpr std::uint64_t prime4 = 0x85EBCA77C2B2AE63ull;
+    static constexpr std::uint64_t prime5 = 0x27D4EB2F165667C5ull;
+    static constexpr std::size_t stripe = 32;
+
+    static std::uint64_t round(std::uint64_t lane, std::uint64_t word) noexcept{
+        return std::rotl(lane + word * prime2, 31) * prime1;
+    }
+    static std::uint64_t word(const std::byte* source) noexcept{
+        std::uint64_t value;
+        std::memcpy(&value, source, sizeof(value));
+        return value;
+    }
+    void consume(const std::byte* source) noexcept{
+        for(std::size_t lane=0; lane < 4; ++lane)
+            m_lanes[lane] = round(m_lanes[lane], word(source + 8 * lane));
+    }
+
+    std::uint64_t m_lanes[4]{prime1 + prime2, prime2, 0, 0 - prime1};
+    std::byte m_pending[stripe]{};
+    std::size_t m_pending_size{0};
+    std::uint64_t m_total{0};
+};
+
+inline void Checksum::update(std::span<const std::byte> bytes) noexcept{
+    const std::byte* source = bytes.data();
+    std::size_t size = bytes.size();
+    m_total += size;
+    if( size == 0)
+        return;
+    if( m_pending_size != 0){
+        const std::size_t taken = std::min(size, stripe - m_pending_size);
+        std::memcpy(m_pending + m_pending_size, source, taken);
+        m_pending_size += taken;
+        source += taken;
+        size -= taken;
+        if( m_pending_size < stripe)
+            return;
+        consume(m_pending);
+        m_pending_size = 0;
+    }
+    for(; size >= stripe; source += stripe, size -= stripe)
+        consume(source);
+    std::memcpy(m_pending, source, size);
+    m_pending_size = size;
+}
+
+inline std::uint64_t Checksum::digest() const noexcept{
+    std::uint64_t hash;
+    if( m_total >= stripe){
+        hash = std::rotl(m_lanes[0], 1) + std::rotl(m_lanes[1], 7) + std::rotl(m_lanes[2], 12) + std::rotl(m_lanes[3], 18);
+        for(std::uint64_t lane : m_lanes)
+            hash = (hash ^ round(0, lane)) * prime1 + prime4;
+    } else {
+        hash = m_lanes[2] + prime5;
+    }
+    hash += m_total;
+
+    const std::byte* tail = m_pending;
+    std::size_t size = m_pending_size;
+    for(; size >= 8; tail += 8, size -= 8)
+        hash = std::rotl(hash ^ round(0, word(tail)), 27) * prime1 + prime4;
+    if( size >= 4){
+        std::uint32_t half;
+        std::memcpy(&half, tail, sizeof(half));
+        hash = std::rotl(hash ^ (half * prime1), 23) * prime2 + prime3;
+        tail += 4;
+        size -= 4;
+    }
+    for(; size > 0; ++tail, --size)
+        hash = std::rotl(hash ^ (std::to_integer<std::uint64_t>(*tail) * prime5), 11) * prime1;
+
+    hash ^= hash >> 33;
+    hash *= prime2;
+    hash ^= hash >> 29;
+    hash *= prime3;
+    hash ^= hash >> 32;
+    return hash;
+}
+
+inline std::uint64_t checksum(std::span<const std::byte> bytes) noexcept{
+    Checksum sum;
+    sum.update(bytes);
+    return sum.digest();
+}
+
+// Destination of the serialized bytes
+template<class W>
+concept writer = requires(W& out, std::span<const std::byte> bytes){
+    out.write(bytes);
+};
+
+// Writer that can go back and patch what it wrote, for the header of a
+// VectorWriter
+template<class W>
+concept seekable_writer = writer<W> && requires(W& out, std::uint64_t offset, std::span<const std::byte> bytes){
+    out.write_at(offset, bytes);
+    { out.position() } -> std::convertible_to<std::uint64_t>;
+};
+
+// Writes to a growing Vector of bytes
+class BufferWriter {
+public:
+    void write(std::span<const std::byte> bytes){
+        const std::size_t offset = m_buffer.size();
+        m_buffer.resize_for_overwrite(offset + bytes.size());
+        if( !bytes.empty())
+            std::memcpy(m_buffer.data() + offset, bytes.data(), bytes.size());
+    }
+
+    void write_at(std::uint64_t offset, std::span<const std::byte> bytes){
+        if( offset > m_buffer.size() || bytes.size() > m_buffer.size() - offset)
+            throw std::out_of_range("write_at past the end of the buffer");
+        if( !bytes.empty())
+            std::memcpy(m_buffer.data() + offset, bytes.data(), bytes.size());
+    }
+
+    std::uint64_t position() const noexcept{ return m_buffer.size(); }
+    std::span<const std::byte> bytes() const noexcept{ return {m_buffer.data(), m_buffer.size()}; }
+    Vector<std::byte> take() noexcept{ return std::exchange(m_buffer, Vector<std::byte>()); }
+
+private:
+    Vector<std::byte> m_buffer;
+};
+
+// Writes to a file, created or truncated
+class FileWriter {
+public:
+    explicit FileWriter(const std::filesystem::path& path);
+    FileWriter(FileWriter&& other) noexcept
+        : m_fd(std::exchange(other.m_fd, -1)), m_position(std::exchange(other.m_position, 0)){}
+    FileWriter(const FileWriter&) = delete;
+    FileWriter& operator=(FileWriter&& other) noexcept;
+    FileWriter& operator=(const FileWriter&) = delete;
+    ~FileWriter(){ close(); }
+
+    void write(std::span<const std::byte> bytes);
+    void write_at(std::uint64_t offset, std::span<const std::byte> bytes);
+    std::uint64_t position() const noexcept{ return m_position; }
+    void close() noexcept;
+
+private:
+    [[noreturn]] static void throw_errno(const char* what){
+        throw std::system_error(errno, std::generic_category(), what);
+    }
+
+    int m_fd{-1};
+    std::uint64_t m_position{0};
+};
+
+inline FileWriter::FileWriter(const std::filesystem::path& path){
+    m_fd = ::open(path.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+    if( m_fd < 0)
+        throw_errno("FileWriter open");
+}
+
+inline FileWriter& FileWriter::operator=(FileWriter&& other) noexcept{
+    if( this != &other){
+        close();
+        m_fd = std::exchange(other.m_fd, -1);
+        m_position = std::exchange(other.m_position, 0);
+    }
+    return *this;
+}
+
+inline void FileWriter::write(std::span<const std::byte> bytes){
+    // A write may be partial, for big buffers and on signals
+    while( !bytes.empty()){
+        const ::ssize_t written = ::write(m_fd, bytes.data(), bytes.size());
+        if( written < 0){
+            if( errno == EINTR)
+                continue;
+            throw_errno("FileWriter write");
+        }
+        const auto count = static_cast<std::size_t>(written);
+        bytes = bytes.subspan(count);
+        m_position += count;
+    }
+}
+
+inline void FileWriter::write_at(std::uint64_t offset, std::span<const std::byte> bytes){
+    while( !bytes.empty()){
+        const ::ssize_t written = ::pwrite(m_fd, bytes.data(), bytes.size(), static_cast<::off_t>(offset));
+        if( written < 0){
+            if( errno == EINTR)
+                continue;
+            throw_errno("FileWriter pwrite");
+        }
+        const auto count = static_cast<std::size_t>(written);
+        bytes = bytes.subspan(count);
+        offset += count;
+    }
+}
+
+inline void FileWriter::close() noexcept{
+    if( m_fd >= 0)
+        ::close(m_fd);
+    m_fd = -1;
+}
+
+// The header with its padding, then the elements in a single bulk write
+template<class T, writer Writer>
+void serialize(std::span<const T> elements, Writer& out){
+    static_assert(std::is_trivially_copyable_v<T>, "Only trivially copyable elements are serialized as raw bytes");
+    static_assert(std::endian::native == std::endian::little, "The format is little endian");
+    const std::span<const std::byte> payload = std::as_bytes(elements);
+    const Vector<std::byte> header = encode(header_of<T>(elements.size(), checksum(payload)));
+    out.write(std::span<const std::byte>(header.data(), header.size()));
+    out.write(payload);
+}
+
+template<class T, class Allocator, growth_policy GrowthPolicy, class StatsPolicy, writer Writer>
+void serialize(const Vector<T, Allocator, GrowthPolicy, StatsPolicy>& vector, Writer& out){
+    serialize(std::span<const T>(vector.data(), vector.size()), out);
+}
+
+// Header and payload of a serialized Vector of T, checked against T and
+// the size of bytes
+template<class T>
+std::pair<Header, std::span<const std::byte>> parse(std::span<const std::byte> bytes){
+    const Header header = decode(bytes);
+    if( header.element_size != sizeof(T))
+        throw std::invalid_argument("Element size does not match");
+    const std::uint64_t offset = header.payload_offset();
+    // Even an empty payload starts inside the buffer
+    if( offset > bytes.size())
+        throw std::length_error("Buffer smaller than its header and padding");
+    if( header.count > (bytes.size() - offset) / sizeof(T))
+        throw std::length_error("Buffer smaller than its payload");
+    return {header, bytes.subspan(static_cast<std::size_t>(offset), static_cast<std::size_t>(header.count) * sizeof(T))};
+}
+
+// Read only view of the elements of a serialized Vector, straight in the
+// buffer it was received in or in a MappedFile: opening it only reads the
+// header. The checksum is only checked by verify(), a pass over the whole
+// payload.
+//
+//     yadej::io::MappedFile file("snapshot.bin", yadej::MapAdvice::sequential);
+//     yadej::io::VectorView<Point> points(file.bytes());
+template<class T>
+class VectorView {
+    static_assert(std::is_trivially_copyable_v<T>, "Only trivially copyable elements are serialized as raw bytes");
+    static_assert(std::endian::native == std::endian::little, "The format is little endian");
+public:
+    using value_type = T;
+    using size_type = std::size_t;
+    using difference_type = std::ptrdiff_t;
+    using const_reference = const T&;
+    using const_pointer = const T*;
+    using const_iterator = iterator_base<const T>;
+    using iterator = const_iterator;
+
+    VectorView() = default;
+    // The payload must be aligned for T, as it is in a mapping or in a
+    // buffer from operator new; see deserialize for any other buffer
+    explicit VectorView(std::span<const std::byte> bytes);
+
+    const_reference at(size_type position) const{
+        if( position >= m_size)
+            throw std::out_of_range("Index out of range");
+        return m_elements[position];
+    }
+    const_reference operator[](size_type position) const noexcept{ return m_elements[position]; }
+    const_reference front() const noexcept{ return m_elements[0]; }
+    const_reference back() const noexcept{ return m_elements[m_size - 1]; }
+    const_pointer data() const noexcept{ return m_elements; }
+    std::span<const T> span() const noexcept{ return {m_elements, m_size}; }
+
+    const_iterator begin() const noexcept{ return const_iterator(m_elements); }
+    const_iterator end() const noexcept{ return const_iterator(m_elements + m_size); }
+    const_iterator cbegin() const noexcept{ return begin(); }
+    const_iterator cend() const noexcept{ return end(); }
+
+    bool empty() const noexcept{ return m_size == 0; }
+    size_type size() const noexcept{ return m_size; }
+
+    const Header& header() const noexcept{ return m_header; }
+    // Checksum of the payload matches the header
+    bool verify() const noexcept{ return checksum(std::as_bytes(span())) == m_header.checksum; }
+
+private:
+    Header m_header;
+    const T* m_elements{nullptr};
+    size_type m_size{0};
+};
+
+template<class T>
+VectorView<T>::VectorView(std::span<const std::byte> bytes){
+    const auto [header, payload] = parse<T>(bytes);
+    if( reinterpret_cast<std::uintptr_t>(payload.data()) % alignof(T) != 0)
+        throw std::invalid_argument("Payload not aligned for the element type");
+    m_header = header;
+    // The bytes are the object representation of the elements
+    m_elements = reinterpret_cast<const T*>(payload.data());
+    m_size = static_cast<size_type>(header.count);
+}
+
+// Copy of the elements in a new Vector, one memcpy, from any buffer.
+// Throws std::runtime_error when the checksum does not match.
+template<class T, class Allocator = std::allocator<T>>
+Vector<T, Allocator> deserialize(std::span<const std::byte> bytes, const Allocator& alloc = Allocator()){
+    static_assert(std::is_trivially_copyable_v<T>, "Only trivially copyable elements are serialized as raw bytes");
+    static_assert(std::endian::native == std::endian::little, "The format is little endian");
+    const auto [header, payload] = parse<T>(bytes);
+    if( checksum(payload) != header.checksum)
+        throw std::runtime_error("Checksum mismatch");
+    Vector<T, Allocator> elements(alloc);
+    elements.resize_for_overwrite(static_cast<std::size_t>(header.count));
+    if( !payload.empty())
+        std::memcpy(static_cast<void*>(elements.data()), payload.data(), payload.size());
+    return elements;
+}
+
+// Serialized Vector written in several appends, when the elements are
+// produced bit by bit. The header is written last, at its place before the
+// payload: until finish() the output has no valid magic.
+//
+//     yadej::io::FileWriter file("out.bin");
+//     yadej::io::VectorWriter<Row, yadej::io::FileWriter> rows(file);
+//     while( read_block(block))
+//         rows.append(block);
+//     rows.finish();
+template<class T, seekable_writer Writer>
+class VectorWriter {
+    static_assert(std::is_trivially_copyable_v<T>, "Only trivially copyable elements are serialized as raw bytes");
+    static_assert(std::endian::native == std::endian::little, "The format is little endian");
+public:
+    explicit VectorWriter(Writer& out);
+
+    void append(std::span<const T> elements);
+    void push_back(const T& value){ append(std::span<const T>(&value, 1)); }
+    // Writes the header, nothing can be appended after
+    void finish();
+
+    std::uint64_t size() const noexcept{ return m_count; }
+
+private:
+    Writer& m_out;
+    std::uint64_t m_start;
+    std::uint64_t m_count{0};
+    Checksum m_checksum;
+    bool m_finished{false};
+};
+
+template<class T, seekable_writer Writer>
+VectorWriter<T, Writer>::VectorWriter(Writer& out): m_out(out), m_start(out.position()){
+    // Room for the header, zero for now
+    const Vector<std::byte> placeholder(header_of<T>(0, 0).payload_offset(), std::byte{0});
+    m_out.write(std::span<const std::byte>(placeholder.data(), placeholder.size()));
+}
+
+template<class T, seekable_writer Writer>
+void VectorWriter<T, Writer>::append(std::span<const T> elements){
+    if( m_finished)
+        throw std::logic_error("VectorWriter already finished");
+    const std::span<const std::byte> bytes = std::as_bytes(elements);
+    m_out.write(bytes);
+    m_checksum.update(bytes);
+    m_count += elements.size();
+}
+
+template<class T, seekable_writer Writer>
+void VectorWriter<T, Writer>::finish(){
+    if( m_finished)
+        throw std::logic_error("VectorWriter already finished");
+    const Vector<std::byte> header = encode(header_of<T>(m_count, m_checksum.digest()));
+    m_out.write_at(m_start, std::span<const std::byte>(header.data(), header.size()));
+    m_finished = true;
+}
+
+// Whole file mapped read only, for VectorView
+class MappedFile {
+public:
+    explicit MappedFile(const std::filesystem::path& path, MapAdvice advice = MapAdvice::normal);
+    MappedFile(MappedFile&& other) noexcept
+        : m_data(std::exchange(other.m_data, nullptr)), m_size(std::exchange(other.m_size, 0)){}
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(MappedFile&& other) noexcept;
+    MappedFile& operator=(const MappedFile&) = delete;
+    ~MappedFile(){ unmap(); }
+
+    std::span<const std::byte> bytes() const noexcept{ return {m_data, m_size}; }
+    bool advise(MapAdvice advice) noexcept{ return m_data == nullptr || advise_mapping(m_data, m_size, advice); }
+
+private:
+    void unmap() noexcept{
+        if( m_data)
+            ::munmap(m_data, m_size);
+        m_data = nullptr;
+    }
+
+    std::byte* m_data{nullptr};
+    std::size_t m_size{0};
+};
+
+inline MappedFile::MappedFile(const std::filesystem::path& path, MapAdvice advice){
+    const int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if( fd < 0)
+        throw std::system_error(errno, std::generic_category(), "MappedFile open");
+    struct stat status{};
+    if( ::fstat(fd, &status) != 0){
+        const int error = errno;
+        ::close(fd);
+        throw std::system_error(error, std::generic_category(), "MappedFile fstat");
+    }
+    m_size = static_cast<std::size_t>(status.st_size);
+    if( m_size != 0){
+        void* mapping = ::mmap(nullptr, m_size, PROT_READ, MAP_PRIVATE, fd, 0);
+        if( mapping == MAP_FAILED){
+            const int error = errno;
+            ::close(fd);
+            throw std::system_error(error, std::generic_category(), "MappedFile mmap");
+        }
+        m_data = static_cast<std::byte*>(mapping);
+        advise(advice);
+    }
+    // The mapping keeps the file
+    ::close(fd);
+}
+
+inline MappedFile& MappedFile::operator=(MappedFile&& other) noexcept{
+    if( this != &other){
+        unmap();
+        m_data = std::exchange(other.m_data, nullptr);
+        m_size = std::exchange(other.m_size, 0);
+    }
+    return *this;
+}
+
+}
+
+}
@@ -0,0 +1,51 @@
+#pragma once
+
+#include <cstddef> // size_t
+#include <limits> // numeric_limits
+#include <new> // operator new align_val_t bad_array_new_length
+#include <type_traits> // true_type
+
+namespace yadej {
+
+// Allocator giving buffers aligned on Align bytes (or alignof(T) if bigger),
+// the allocator of AlignedVector: aligned SIMD loads on data(), buffers
+// starting on their own cache line or page.
+// Stateless, every instance with the same Align compares equal.
+template<class T, std::size_t Align>
+class AlignedAllocator {
+    static_assert(Align != 0 && (Align & (Align - 1)) == 0, "Align must be a power of two");
+public:
+    using value_type = T;
+    using size_type = std::size_t;
+    using difference_type = std::ptrdiff_t;
+    using propagate_on_container_move_assignment = std::true_type;
+    using is_always_equal = std::true_type;
+
+    static constexpr std::size_t alignment = Align > alignof(T) ? Align : alignof(T);
+
+    template<class U>
+    struct rebind {
+        using other = AlignedAllocator<U, Align>;
+    };
+
+    constexpr AlignedAllocator() noexcept = default;
+    template<class U>
+    constexpr AlignedAllocator(const AlignedAllocator<U, Align>&) noexcept {}
+
+    [[nodiscard]] T* allocate(std::size_t count){
+        if( count > std::numeric_limits<std::size_t>::max() / sizeof(T))
+            throw std::bad_array_new_length();
+        return static_cast<T*>(::operator new(count * sizeof(T), std::align_val_t{alignment}));
+    }
+
+    void deallocate(T* pointer, std::size_t count) noexcept{
+        ::operator delete(pointer, count * sizeof(T), std::align_val_t{alignment});
+    }
+
+    template<class U>
+    friend constexpr bool operator==(const AlignedAllocator&, const AlignedAllocator<U, Align>&) noexcept{
+        return true;
+    }
+};
+
+}
@@ -0,0 +1,173 @@
+#pragma once
+
+#include <algorithm> // max
+#include <cstddef> // size_t byte max_align_t
+#include <memory> // align
+#include <memory_resource> // memory_resource get_default_resource
+
+namespace yadej {
+
+// Monotonic arena for request scoped batches of containers.
+//
+// Memory is handed out by bumping a pointer inside chunks taken from the
+// upstream resource, each new chunk being twice as big as the previous one.
+// deallocate only gives back the last block (a vector growing at the top of
+// the arena reuses its own memory), everything else stays until release()
+// or reset(). reset() keeps the biggest chunk so the next request with the
+// same footprint does not touch the upstream resource at all.
+//
+//     yadej::ArenaResource arena;
+//     for(const Request& request : requests){
+//         yadej::pmr::Vector<Row> rows(&arena);
+//         ...
+//         arena.reset();
+//     }
+class ArenaResource : public std::pmr::memory_resource {
+public:
+    static constexpr std::size_t default_chunk_size = 4096;
+
+    explicit ArenaResource(std::pmr::memory_resource* upstream = std::pmr::get_default_resource()) noexcept
+        : ArenaResource(default_chunk_size, upstream){}
+    explicit ArenaResource(std::size_t initial_size,
+                           std::pmr::memory_resource* upstream = std::pmr::get_default_resource()) noexcept
+        : m_upstream(upstream), m_next_chunk_size(std::max<std::size_t>(initial_size, min_chunk_size)){}
+    // The first blocks are taken from buffer, which is never given to upstream
+    ArenaResource(void* buffer, std::size_t size,
+                  std::pmr::memory_resource* upstream = std::pmr::get_default_resource()) noexcept
+        : m_upstream(upstream),
+          m_current(static_cast<std::byte*>(buffer)),
+          m_end(static_cast<std::byte*>(buffer) + size),
+          m_next_chunk_size(std::max<std::size_t>(size * 2, min_chunk_size)),
+          m_buffer(static_cast<std::byte*>(buffer)),
+          m_buffer_size(size){}
+
+    ArenaResource(const ArenaResource&) = delete;
+    ArenaResource& operator=(const ArenaResource&) = delete;
+
+    ~ArenaResource() override{
+        release();
+    }
+
+    // Give every chunk back to upstream
+    void release() noexcept;
+    // Forget every block but keep the biggest chunk for the next batch
+    void reset() noexcept;
+
+    std::pmr::memory_resource* upstream_resource() const noexcept{ return m_upstream; }
+    // Bytes handed out since the last release or reset
+    std::size_t bytes_used() const noexcept{ return m_bytes_used; }
+    // Bytes taken from upstream and still owned
+    std::size_t bytes_reserved() const noexcept{ return m_bytes_reserved; }
+
+protected:
+    void* do_allocate(std::size_t bytes, std::size_t alignment) override;
+    void do_deallocate(void* pointer, std::size_t bytes, std::size_t alignment) override;
+    bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override{
+        return this == &other;
+    }
+
+private:
+    // Header written at the start of every upstream chunk
+    struct Chunk {
+        Chunk* previous;
+        std::size_t size;
+    };
+    static constexpr std::size_t min_chunk_size = 2 * sizeof(Chunk);
+
+    void add_chunk(std::size_t bytes, std::size_t alignment);
+    void use_chunk(Chunk* chunk) noexcept;
+
+    std::pmr::memory_resource* m_upstream;
+    Chunk* m_chunks{nullptr};
+    std::byte* m_current{nullptr};
+    std::byte* m_end{nullptr};
+    // Start of the last block, the only one deallocate can give back
+    std::byte* m_last{nullptr};
+    std::size_t m_next_chunk_size;
+    std::byte* m_buffer{nullptr};
+    std::size_t m_buffer_size{0};
+    std::size_t m_bytes_used{0};
+    std::size_t m_bytes_reserved{0};
+};
+
+inline void* ArenaResource::do_allocate(std::size_t bytes, std::size_t alignment){
+    void* pointer = m_current;
+    std::size_t space = static_cast<std::size_t>(m_end - m_current);
+    if( m_current == nullptr || std::align(alignment, bytes, pointer, space) == nullptr){
+        add_chunk(bytes, alignment);
+        pointer = m_current;
+        space = static_cast<std::size_t>(m_end - m_current);
+        std::align(alignment, bytes, pointer, space);
+    }
+    m_last = static_cast<std::byte*>(pointer);
+    m_current = m_last + bytes;
+    m_bytes_used += bytes;
+    return pointer;
+}
+
+inline void ArenaResource::do_deallocate(void* pointer, std::size_t bytes, std::size_t){
+    // Only the top of the arena can be rewound
+    if( pointer == m_last && m_last + bytes == m_current){
+        m_current = m_last;
+        m_last = nullptr;
+        m_bytes_used -= bytes;
+    }
+}
+
+inline void ArenaResource::add_chunk(std::size_t bytes, std::size_t alignment){
+    std::size_t needed = sizeof(Chunk) + bytes + alignment;
+    std::size_t size = std::max(m_next_chunk_size, needed);
+    auto* chunk = static_cast<Chunk*>(m_upstream->allocate(size, alignof(std::max_align_t)));
+    chunk->previous = m_chunks;
+    chunk->size = size;
+    m_chunks = chunk;
+    m_bytes_reserved += size;
+    m_next_chunk_size = size * 2;
+    use_chunk(chunk);
+}
+
+inline void ArenaResource::use_chunk(Chunk* chunk) noexcept{
+    m_current = reinterpret_cast<std::byte*>(chunk + 1);
+    m_end = reinterpret_cast<std::byte*>(chunk) + chunk->size;
+    m_last = nullptr;
+}
+
+inline void ArenaResource::release() noexcept{
+    while( m_chunks != nullptr){
+        Chunk* previous = m_chunks->previous;
+        m_upstream->deallocate(m_chunks, m_chunks->size, alignof(std::max_align_t));
+        m_chunks = previous;
+    }
+    m_current = m_buffer;
+    m_end = m_buffer + m_buffer_size;
+    m_last = nullptr;
+    m_bytes_used = 0;
+    m_bytes_reserved = 0;
+}
+
+inline void ArenaResource::reset() noexcept{
+    Chunk* biggest = nullptr;
+    while( m_chunks != nullptr){
+        Chunk* previous = m_chunks->previous;
+        if( biggest == nullptr || m_chunks->size > biggest->size){
+            if( biggest != nullptr)
+                m_upstream->deallocate(biggest, biggest->size, alignof(std::max_align_t));
+            biggest = m_chunks;
+        } else {
+            m_upstream->deallocate(m_chunks, m_chunks->size, alignof(std::max_align_t));
+        }
+        m_chunks = previous;
+    }
+    m_bytes_used = 0;
+    m_bytes_reserved = 0;
+    if( biggest == nullptr){
+        release();
+        return;
+    }
+    biggest->previous = nullptr;
+    m_chunks = biggest;
+    m_bytes_reserved = biggest->size;
+    use_chunk(biggest);
+}
+
+}
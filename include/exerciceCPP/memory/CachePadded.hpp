@@ -0,0 +1,48 @@
+#pragma once
+
+#include <cstddef> // size_t
+#include <type_traits> // is_constructible_v is_same_v remove_cvref_t
+#include <utility> // forward
+
+namespace yadej {
+
+// Smallest distance between two objects written by different threads for
+// them not to false-share. std::hardware_destructive_interference_size is
+// not fit for a header, its value moves with -mtune. x86-64 and aarch64
+// prefetch cache lines by pairs, so two lines apart is the safe distance.
+#if defined(__x86_64__) || defined(__aarch64__) || defined(__powerpc64__)
+inline constexpr std::size_t destructive_interference_size = 128;
+#else
+inline constexpr std::size_t destructive_interference_size = 64;
+#endif
+
+// Size of a cache line, the alignment for buffers streamed by SIMD loads
+inline constexpr std::size_t cache_line_size = 64;
+
+// T alone on its cache lines: aligned on and padded to
+// destructive_interference_size. An array of CachePadded, one per thread,
+// never has two threads writing to the same line.
+//
+//     yadej::Vector<yadej::CachePadded<yadej::Vector<double>>> per_thread(workers);
+//     per_thread[index]->push_back(value);
+template<class T>
+class alignas(destructive_interference_size) CachePadded {
+public:
+    constexpr CachePadded() = default;
+    template<class... Args>
+        requires (std::is_constructible_v<T, Args...>
+                  && !(sizeof...(Args) == 1 && (std::is_same_v<std::remove_cvref_t<Args>, CachePadded> && ...)))
+    constexpr explicit CachePadded(Args&&... args): m_value(std::forward<Args>(args)...){}
+
+    constexpr T& get() noexcept{ return m_value; }
+    constexpr const T& get() const noexcept{ return m_value; }
+    constexpr T& operator*() noexcept{ return m_value; }
+    constexpr const T& operator*() const noexcept{ return m_value; }
+    constexpr T* operator->() noexcept{ return &m_value; }
+    constexpr const T* operator->() const noexcept{ return &m_value; }
+
+private:
+    T m_value{};
+};
+
+}
@@ -0,0 +1,108 @@
+#pragma once
+
+#include <cstddef> // size_t ptrdiff_t
+#include <cstdint> // uintptr_t
+#include <limits> // numeric_limits
+#include <new> // operator new align_val_t bad_alloc bad_array_new_length
+#include <type_traits> // true_type
+#include <sys/mman.h> // mmap munmap madvise
+
+namespace yadej {
+
+// Size of a transparent huge page on x86-64 and aarch64 with 4 KiB pages
+inline constexpr std::size_t huge_page_size = std::size_t{2} << 20;
+
+// Allocator backing big buffers with huge pages, for random access over
+// vectors much bigger than what the TLB covers with 4 KiB pages.
+//
+// Buffers of Threshold bytes or more are mapped on their own, rounded up
+// to huge_page_size and aligned on it. MAP_HUGETLB is tried first, it only
+// succeeds when the admin reserved huge pages (vm.nr_hugepages). Otherwise
+// the mapping is made of normal pages and given to the kernel with
+// madvise(MADV_HUGEPAGE), which backs it with transparent huge pages when
+// /sys/kernel/mm/transparent_hugepage/enabled is "always" or "madvise".
+// Smaller buffers come from operator new, a huge page for a 100 bytes
+// vector would be a waste.
+//
+//     yadej::Vector<Edge, yadej::HugePageAllocator<Edge>> edges;
+template<class T, std::size_t Threshold = huge_page_size>
+class HugePageAllocator {
+public:
+    using value_type = T;
+    using size_type = std::size_t;
+    using difference_type = std::ptrdiff_t;
+    using propagate_on_container_move_assignment = std::true_type;
+    using is_always_equal = std::true_type;
+
+    static constexpr std::size_t threshold = Threshold;
+
+    template<class U>
+    struct rebind {
+        using other = HugePageAllocator<U, Threshold>;
+    };
+
+    constexpr HugePageAllocator() noexcept = default;
+    template<class U>
+    constexpr HugePageAllocator(const HugePageAllocator<U, Threshold>&) noexcept {}
+
+    [[nodiscard]] T* allocate(std::size_t count){
+        if( count > (std::numeric_limits<std::size_t>::max() - 2 * huge_page_size) / sizeof(T))
+            throw std::bad_array_new_length();
+        const std::size_t bytes = count * sizeof(T);
+        if( bytes < Threshold)
+            return static_cast<T*>(::operator new(bytes, std::align_val_t{alignof(T)}));
+        return static_cast<T*>(map(mapped_size(bytes)));
+    }
+
+    void deallocate(T* pointer, std::size_t count) noexcept{
+        const std::size_t bytes = count * sizeof(T);
+        if( bytes < Threshold)
+            ::operator delete(pointer, bytes, std::align_val_t{alignof(T)});
+        else
+            ::munmap(pointer, mapped_size(bytes));
+    }
+
+    template<class U>
+    friend constexpr bool operator==(const HugePageAllocator&, const HugePageAllocator<U, Threshold>&) noexcept{
+        return true;
+    }
+
+private:
+    static std::size_t mapped_size(std::size_t bytes) noexcept{
+        return (bytes + huge_page_size - 1) / huge_page_size * huge_page_size;
+    }
+
+    // size bytes aligned on huge_page_size, size being a multiple of it
+    static void* map(std::size_t size);
+};
+
+template<class T, std::size_t Threshold>
+void* HugePageAllocator<T, Threshold>::map(std::size_t size){
+#ifdef MAP_HUGETLB
+    void* huge = ::mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+    if( huge != MAP_FAILED)
+        return huge;
+#endif
+
+    // Map one huge page more and trim both ends to get the alignment,
+    // transparent huge pages are only used for aligned 2 MiB ranges
+    void* raw = ::mmap(nullptr, size + huge_page_size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if( raw == MAP_FAILED)
+        throw std::bad_alloc();
+    const auto first = reinterpret_cast<std::uintptr_t>(raw);
+    const std::uintptr_t aligned = (first + huge_page_size - 1) / huge_page_size * huge_page_size;
+    if( aligned != first)
+        ::munmap(raw, aligned - first);
+    const std::size_t tail = huge_page_size - (aligned - first);
+    if( tail != 0)
+        ::munmap(reinterpret_cast<void*>(aligned + size), tail);
+
+    void* result = reinterpret_cast<void*>(aligned);
+#ifdef MADV_HUGEPAGE
+    // Only a hint, the buffer still works with normal pages when it fails
+    ::madvise(result, size, MADV_HUGEPAGE);
+#endif
+    return result;
+}
+
+}
@@ -0,0 +1,311 @@
+#pragma once
+
+#include <atomic> // atomic
+#include <bit> // bit_width
+#include <cstddef> // size_t ptrdiff_t byte
+#include <cstdint> // uintptr_t
+#include <limits> // numeric_limits
+#include <mutex> // mutex lock_guard
+#include <new> // operator new align_val_t bad_array_new_length
+#include <type_traits> // true_type
+#include <vector> // vector
+#include "CachePadded.hpp"
+
+namespace yadej {
+
+namespace pool {
+
+// Size classes of the pool: every power of two from 16 bytes to 16 KiB,
+// the byte sizes of the bit_ceil capacities a Vector grows through.
+// Bigger blocks go to operator new.
+inline constexpr std::size_t min_block_size = 16;
+inline constexpr std::size_t max_block_size = 16 * 1024;
+inline constexpr std::size_t class_count = 11;
+// Blocks are carved from slabs aligned on their size, the owner of a block
+// is found by masking its address
+inline constexpr std::size_t slab_size = 256 * 1024;
+// Blocks freed by another thread are given back to their owner by batches
+inline constexpr std::size_t remote_batch_size = 32;
+
+inline constexpr std::size_t class_of(std::size_t bytes) noexcept{
+    return bytes <= min_block_size ? 0 : static_cast<std::size_t>(std::bit_width(bytes - 1)) - 4;
+}
+
+inline constexpr std::size_t block_size(std::size_t size_class) noexcept{
+    return min_block_size << size_class;
+}
+
+static_assert(block_size(class_count - 1) == max_block_size);
+
+struct Node {
+    Node* next;
+};
+
+class Cache;
+
+// First bytes of every slab
+struct Slab {
+    Cache* owner;
+};
+
+// Blocks of one thread. Only the thread using the cache touches the free
+// lists, the other threads push the blocks they free on the remote lists.
+// A cache outlives its thread: when the thread exits it goes back to the
+// Registry with its free blocks and the next new thread adopts it.
+class Cache {
+public:
+    void* allocate(std::size_t size_class);
+    void deallocate(void* block, std::size_t size_class) noexcept;
+    // Give the pending remote batches to their owners
+    void flush() noexcept;
+    // Put the list head..tail of blocks of this cache on its remote list,
+    // from any thread
+    void push_remote(Node* head, Node* tail, std::size_t size_class) noexcept;
+
+private:
+    friend class Registry;
+
+    struct Batch {
+        Cache* owner{nullptr};
+        Node* head{nullptr};
+        Node* tail{nullptr};
+        std::size_t count{0};
+    };
+
+    void refill(std::size_t size_class);
+    void flush(std::size_t size_class) noexcept;
+
+    Node* m_free[class_count]{};
+    // Unused end of the last slab of each class
+    std::byte* m_bump[class_count]{};
+    std::byte* m_bump_end[class_count]{};
+    // Blocks of other caches freed by this thread, not given back yet
+    Batch m_batches[class_count]{};
+    // Blocks of this cache freed by other threads
+    CachePadded<std::atomic<Node*>> m_remote[class_count]{};
+    bool m_in_use{false};
+};
+
+// Process wide list of the caches, never destroyed: a block freed while
+// the static objects are destroyed still finds its owner
+class Registry {
+public:
+    static Registry& instance(){
+        static Registry* registry = new Registry();
+        return *registry;
+    }
+
+    // A released cache if there is one, a new one otherwise
+    Cache* acquire();
+    void release(Cache* cache) noexcept;
+
+    // Slabs taken from operator new since the start, they are never given back
+    std::size_t slabs() const noexcept{ return m_slabs.load(std::memory_order_relaxed); }
+    void* new_slab(Cache* owner);
+
+private:
+    std::mutex m_mutex;
+    std::vector<Cache*> m_caches;
+    std::atomic<std::size_t> m_slabs{0};
+};
+
+inline thread_local Cache* t_cache = nullptr;
+inline thread_local bool t_exited = false;
+
+// Gives the cache of the thread back to the Registry when the thread exits
+struct CacheRelease {
+    ~CacheRelease(){
+        t_exited = true;
+        if( t_cache){
+            Registry::instance().release(t_cache);
+            t_cache = nullptr;
+        }
+    }
+};
+
+inline thread_local CacheRelease t_release;
+
+// Cache of the calling thread. A thread still allocating after its
+// thread_local objects are destroyed keeps its last cache for good.
+inline Cache& local_cache(){
+    if( t_cache)
+        return *t_cache;
+    t_cache = Registry::instance().acquire();
+    if( !t_exited)
+        static_cast<void>(&t_release);
+    return *t_cache;
+}
+
+inline Slab* slab_of(void* block) noexcept{
+    return reinterpret_cast<Slab*>(reinterpret_cast<std::uintptr_t>(block) & ~(slab_size - 1));
+}
+
+inline void* Cache::allocate(std::size_t size_class){
+    if( !m_free[size_class]){
+        m_free[size_class] = m_remote[size_class]->exchange(nullptr, std::memory_order_acquire);
+        if( !m_free[size_class]){
+            const std::size_t size = block_size(size_class);
+            if( static_cast<std::size_t>(m_bump_end[size_class] - m_bump[size_class]) < size)
+                refill(size_class);
+            void* block = m_bump[size_class];
+            m_bump[size_class] += size;
+            return block;
+        }
+    }
+    Node* node = m_free[size_class];
+    m_free[size_class] = node->next;
+    return node;
+}
+
+inline void Cache::deallocate(void* block, std::size_t size_class) noexcept{
+    Node* node = static_cast<Node*>(block);
+    Cache* owner = slab_of(block)->owner;
+    if( owner == this){
+        node->next = m_free[size_class];
+        m_free[size_class] = node;
+        return;
+    }
+
+    Batch& batch = m_batches[size_class];
+    if( batch.owner != owner)
+        flush(size_class);
+    batch.owner = owner;
+    node->next = batch.head;
+    batch.head = node;
+    if( !batch.tail)
+        batch.tail = node;
+    if( ++batch.count == remote_batch_size)
+        flush(size_class);
+}
+
+inline void Cache::flush() noexcept{
+    for(std::size_t size_class=0; size_class < class_count; ++size_class)
+        flush(size_class);
+}
+
+inline void Cache::flush(std::size_t size_class) noexcept{
+    Batch& batch = m_batches[size_class];
+    if( !batch.head)
+        return;
+    batch.owner->push_remote(batch.head, batch.tail, size_class);
+    batch = Batch{};
+}
+
+inline void Cache::push_remote(Node* head, Node* tail, std::size_t size_class) noexcept{
+    // The whole list goes in with one compare exchange. The owner only
+    // takes the entire list, a node is never popped alone: no ABA.
+    std::atomic<Node*>& remote = *m_remote[size_class];
+    Node* top = remote.load(std::memory_order_relaxed);
+    do {
+        tail->next = top;
+    } while( !remote.compare_exchange_weak(top, head, std::memory_order_release, std::memory_order_relaxed));
+}
+
+inline void Cache::refill(std::size_t size_class){
+    // The end of the previous slab is too small for a block, it is lost
+    auto* slab = static_cast<std::byte*>(Registry::instance().new_slab(this));
+    const std::size_t size = block_size(size_class);
+    // Blocks stay aligned on their size, the first ones make room for the header
+    const std::size_t header = (sizeof(Slab) + size - 1) / size * size;
+    m_bump[size_class] = slab + header;
+    m_bump_end[size_class] = slab + slab_size;
+}
+
+inline Cache* Registry::acquire(){
+    std::lock_guard lock(m_mutex);
+    for(Cache* cache : m_caches){
+        if( !cache->m_in_use){
+            cache->m_in_use = true;
+            return cache;
+        }
+    }
+    m_caches.reserve(m_caches.size() + 1);
+    Cache* cache = new Cache();
+    cache->m_in_use = true;
+    m_caches.push_back(cache);
+    return cache;
+}
+
+inline void Registry::release(Cache* cache) noexcept{
+    cache->flush();
+    std::lock_guard lock(m_mutex);
+    cache->m_in_use = false;
+}
+
+inline void* Registry::new_slab(Cache* owner){
+    void* memory = ::operator new(slab_size, std::align_val_t{slab_size});
+    ::new(memory) Slab{owner};
+    m_slabs.fetch_add(1, std::memory_order_relaxed);
+    return memory;
+}
+
+inline void* allocate(std::size_t size_class){
+    return local_cache().allocate(size_class);
+}
+
+// A thread without a cache (it never allocated, or it is exiting) gives
+// the block straight back to its owner
+inline void deallocate(void* block, std::size_t size_class) noexcept{
+    if( t_cache){
+        t_cache->deallocate(block, size_class);
+        return;
+    }
+    Node* node = static_cast<Node*>(block);
+    slab_of(block)->owner->push_remote(node, node, size_class);
+}
+
+// Give the blocks of other threads freed by the calling thread back to
+// their owners now instead of when a batch is full or the thread exits
+inline void flush(){
+    if( t_cache)
+        t_cache->flush();
+}
+
+}
+
+// Allocator for many small short lived containers. Buffers up to
+// pool::max_block_size bytes come from thread local free lists, one per
+// power of two size class, without any lock or atomic operation when
+// freed by the thread that allocated them. A buffer freed by another
+// thread goes back to its owner in a batch of pool::remote_batch_size.
+// The memory of the pool is never given back to the system, a thread
+// exiting leaves its free blocks to the next thread created.
+//
+//     yadej::Vector<int, yadej::PoolAllocator<int>> indices;
+template<class T>
+class PoolAllocator {
+public:
+    using value_type = T;
+    using size_type = std::size_t;
+    using difference_type = std::ptrdiff_t;
+    using propagate_on_container_move_assignment = std::true_type;
+    using is_always_equal = std::true_type;
+
+    constexpr PoolAllocator() noexcept = default;
+    template<class U>
+    constexpr PoolAllocator(const PoolAllocator<U>&) noexcept {}
+
+    [[nodiscard]] T* allocate(std::size_t count){
+        if( count > std::numeric_limits<std::size_t>::max() / sizeof(T))
+            throw std::bad_array_new_length();
+        const std::size_t bytes = count * sizeof(T);
+        if( bytes > pool::max_block_size)
+            return static_cast<T*>(::operator new(bytes, std::align_val_t{alignof(T)}));
+        return static_cast<T*>(pool::allocate(pool::class_of(bytes)));
+    }
+
+    void deallocate(T* pointer, std::size_t count) noexcept{
+        const std::size_t bytes = count * sizeof(T);
+        if( bytes > pool::max_block_size)
+            ::operator delete(pointer, bytes, std::align_val_t{alignof(T)});
+        else
+            pool::deallocate(pointer, pool::class_of(bytes));
+    }
+
+    template<class U>
+    friend constexpr bool operator==(const PoolAllocator&, const PoolAllocator<U>&) noexcept{
+        return true;
+    }
+};
+
+}
@@ -0,0 +1,274 @@
+#pragma once
+
+#include <algorithm> // sort inplace_merge min max
+#include <cstddef> // size_t
+#include <functional> // plus less
+#include <iterator> // iter_value_t
+#include <numeric> // accumulate
+#include <ranges> // sized_range data size
+#include <stdexcept> // length_error
+#include <type_traits> // remove_cvref_t
+#include <utility> // move
+#include <vector> // vector
+#include <unistd.h> // sysconf
+#include "ThreadPool.hpp"
+
+namespace yadej {
+
+namespace parallel {
+
+// Parallel algorithms over contiguous ranges (Vector, SmallVector, spans...).
+//
+// The range is cut in chunks sized so that a chunk of input and output fits
+// in half of the L2 cache, and small enough to give every worker several
+// chunks to balance the load. Ranges under serial_threshold elements, or a
+// pool of one worker, run serially on the calling thread. Every algorithm
+// has an overload taking the ThreadPool, the default is ThreadPool::instance().
+//
+// Like the std execution policies, reduce and inclusive_scan expect an
+// associative operation, and the functions given to for_each, transform
+// and copy_if are called concurrently.
+
+inline constexpr std::size_t serial_threshold = 1 << 15;
+
+// What the algorithms need from a contiguous range: a pointer and a size.
+// Looser than std::ranges::contiguous_range, a const Vector has const data()
+// but its const iterators still give T&.
+template<class Range>
+concept data_range = std::ranges::sized_range<Range> && requires(Range& range) { std::ranges::data(range); };
+
+namespace detail {
+
+// L2 cache size of the machine, 256 KiB when it can not be read
+inline std::size_t cache_size() noexcept{
+    static const std::size_t size = []{
+        long bytes = -1;
+#ifdef _SC_LEVEL2_CACHE_SIZE
+        bytes = ::sysconf(_SC_LEVEL2_CACHE_SIZE);
+#endif
+        return bytes > 0 ? static_cast<std::size_t>(bytes) : std::size_t{256 * 1024};
+    }();
+    return size;
+}
+
+// Elements per chunk for count elements of element_bytes, count when serial
+inline std::size_t chunk_size(const ThreadPool& pool, std::size_t count, std::size_t element_bytes) noexcept{
+    if( count < serial_threshold || pool.size() <= 1)
+        return std::max<std::size_t>(count, 1);
+    const std::size_t fits_cache = std::max<std::size_t>(cache_size() / 2 / std::max<std::size_t>(element_bytes, 1), 1);
+    // Eight chunks per worker at least, for the stealing to even the load
+    const std::size_t balanced = (count + pool.size() * 8 - 1) / (pool.size() * 8);
+    return std::max<std::size_t>(std::min(fits_cache, balanced), 1024);
+}
+
+// Call body(first, last, chunk_index) on every chunk of [0, count), splitting
+// the range in halves so that idle workers steal big pieces first
+template<class Body>
+void for_chunks(ThreadPool& pool, std::size_t count, std::size_t chunk, Body&& body){
+    if( count <= chunk){
+        if( count != 0)
+            body(std::size_t{0}, count, std::size_t{0});
+        return;
+    }
+
+    TaskGroup group(pool);
+    auto split = [&](auto& self, std::size_t first, std::size_t last) -> void {
+        while( last - first > chunk){
+            const std::size_t chunks = (last - first + chunk - 1) / chunk;
+            const std::size_t middle = first + chunks / 2 * chunk;
+            group.run([&self, middle, last]{ self(self, middle, last); });
+            last = middle;
+        }
+        body(first, last, first / chunk);
+    };
+    try {
+        split(split, 0, count);
+    } catch(...) {
+        // The queued tasks call split, they have to end before it goes out
+        // of scope. The error of body wins over theirs.
+        try {
+            group.wait();
+        } catch(...) {}
+        throw;
+    }
+    group.wait();
+}
+
+inline std::size_t chunk_count(std::size_t count, std::size_t chunk) noexcept{
+    return (count + chunk - 1) / chunk;
+}
+
+}
+
+template<data_range Range, class Function>
+void for_each(ThreadPool& pool, Range&& range, Function f){
+    auto* data = std::ranges::data(range);
+    const std::size_t count = std::ranges::size(range);
+    detail::for_chunks(pool, count, detail::chunk_size(pool, count, sizeof(*data)),
+                       [&](std::size_t first, std::size_t last, std::size_t){
+        for(std::size_t i=first; i < last; ++i)
+            f(data[i]);
+    });
+}
+
+template<data_range Range, class Function>
+void for_each(Range&& range, Function f){
+    for_each(ThreadPool::instance(), std::forward<Range>(range), std::move(f));
+}
+
+// out[i] = op(in[i]), out must hold at least in.size() elements and can be in
+template<data_range Input, data_range Output, class Operation>
+void transform(ThreadPool& pool, Input&& in, Output&& out, Operation op){
+    const auto* source = std::ranges::data(in);
+    auto* dest = std::ranges::data(out);
+    const std::size_t count = std::ranges::size(in);
+    if( std::ranges::size(out) < count)
+        throw std::length_error("parallel::transform output smaller than input");
+    detail::for_chunks(pool, count, detail::chunk_size(pool, count, sizeof(*source) + sizeof(*dest)),
+                       [&](std::size_t first, std::size_t last, std::size_t){
+        for(std::size_t i=first; i < last; ++i)
+            dest[i] = op(source[i]);
+    });
+}
+
+template<data_range Input, data_range Output, class Operation>
+void transform(Input&& in, Output&& out, Operation op){
+    transform(ThreadPool::instance(), std::forward<Input>(in), std::forward<Output>(out), std::move(op));
+}
+
+// init op range[0] op range[1] ..., the partial results of the chunks are
+// combined in order so op only needs to be associative
+template<data_range Range, class T, class Operation = std::plus<>>
+T reduce(ThreadPool& pool, Range&& range, T init, Operation op = {}){
+    const auto* data = std::ranges::data(range);
+    const std::size_t count = std::ranges::size(range);
+    const std::size_t chunk = detail::chunk_size(pool, count, sizeof(*data));
+    std::vector<T> partial(detail::chunk_count(count, chunk));
+    detail::for_chunks(pool, count, chunk, [&](std::size_t first, std::size_t last, std::size_t index){
+        T sum = data[first];
+        for(std::size_t i=first + 1; i < last; ++i)
+            sum = op(std::move(sum), data[i]);
+        partial[index] = std::move(sum);
+    });
+    for(T& sum : partial)
+        init = op(std::move(init), std::move(sum));
+    return init;
+}
+
+template<data_range Range, class T, class Operation = std::plus<>>
+T reduce(Range&& range, T init, Operation op = {}){
+    return reduce(ThreadPool::instance(), std::forward<Range>(range), std::move(init), std::move(op));
+}
+
+// Each chunk is sorted by a worker, then the sorted runs are merged pairwise,
+// the merges of one round running in parallel. Not stable.
+template<data_range Range, class Compare = std::less<>>
+void sort(ThreadPool& pool, Range&& range, Compare comp = {}){
+    auto* data = std::ranges::data(range);
+    const std::size_t count = std::ranges::size(range);
+    const std::size_t chunk = detail::chunk_size(pool, count, sizeof(*data));
+    detail::for_chunks(pool, count, chunk, [&](std::size_t first, std::size_t last, std::size_t){
+        std::sort(data + first, data + last, comp);
+    });
+
+    for(std::size_t width=chunk; width < count; width *= 2){
+        TaskGroup group(pool);
+        for(std::size_t first=0; first + width < count; first += 2 * width){
+            const std::size_t middle = first + width;
+            const std::size_t last = std::min(first + 2 * width, count);
+            group.run([=, &comp]{ std::inplace_merge(data + first, data + middle, data + last, comp); });
+        }
+        group.wait();
+    }
+}
+
+template<data_range Range, class Compare = std::less<>>
+void sort(Range&& range, Compare comp = {}){
+    sort(ThreadPool::instance(), std::forward<Range>(range), std::move(comp));
+}
+
+// out[i] = in[0] op ... op in[i], out can be in. Three passes: the chunk
+// totals in parallel, their prefix serially, then every chunk scanned from
+// its prefix in parallel.
+template<data_range Input, data_range Output, class Operation = std::plus<>>
+void inclusive_scan(ThreadPool& pool, Input&& in, Output&& out, Operation op = {}){
+    const auto* source = std::ranges::data(in);
+    auto* dest = std::ranges::data(out);
+    using T = std::remove_cvref_t<decltype(*dest)>;
+    const std::size_t count = std::ranges::size(in);
+    if( std::ranges::size(out) < count)
+        throw std::length_error("parallel::inclusive_scan output smaller than input");
+    const std::size_t chunk = detail::chunk_size(pool, count, sizeof(*source) + sizeof(*dest));
+
+    const std::size_t chunks = detail::chunk_count(count, chunk);
+    if( chunks <= 1){
+        if( count != 0)
+            std::inclusive_scan(source, source + count, dest, op);
+        return;
+    }
+
+    std::vector<T> totals(chunks);
+    detail::for_chunks(pool, count, chunk, [&](std::size_t first, std::size_t last, std::size_t index){
+        T sum = source[first];
+        for(std::size_t i=first + 1; i < last; ++i)
+            sum = op(std::move(sum), source[i]);
+        totals[index] = std::move(sum);
+    });
+    for(std::size_t i=1; i < chunks; ++i)
+        totals[i] = op(totals[i - 1], totals[i]);
+
+    detail::for_chunks(pool, count, chunk, [&](std::size_t first, std::size_t last, std::size_t index){
+        T sum = index == 0 ? T(source[first]) : op(totals[index - 1], source[first]);
+        dest[first] = sum;
+        for(std::size_t i=first + 1; i < last; ++i){
+            sum = op(std::move(sum), source[i]);
+            dest[i] = sum;
+        }
+    });
+}
+
+template<data_range Input, data_range Output, class Operation = std::plus<>>
+void inclusive_scan(Input&& in, Output&& out, Operation op = {}){
+    inclusive_scan(ThreadPool::instance(), std::forward<Input>(in), std::forward<Output>(out), std::move(op));
+}
+
+// Copy the elements matching pred to the front of out, in order, and return
+// how many were copied. out must be able to hold every element of in and
+// must not overlap it.
+// pred is called twice per element, a counting pass then a copying pass.
+template<data_range Input, data_range Output, class Predicate>
+std::size_t copy_if(ThreadPool& pool, Input&& in, Output&& out, Predicate pred){
+    const auto* source = std::ranges::data(in);
+    auto* dest = std::ranges::data(out);
+    const std::size_t count = std::ranges::size(in);
+    if( std::ranges::size(out) < count)
+        throw std::length_error("parallel::copy_if output smaller than input");
+    const std::size_t chunk = detail::chunk_size(pool, count, sizeof(*source) + sizeof(*dest));
+
+    std::vector<std::size_t> offsets(detail::chunk_count(count, chunk) + 1, 0);
+    detail::for_chunks(pool, count, chunk, [&](std::size_t first, std::size_t last, std::size_t index){
+        std::size_t matches = 0;
+        for(std::size_t i=first; i < last; ++i)
+            matches += pred(source[i]) ? std::size_t{1} : std::size_t{0};
+        offsets[index + 1] = matches;
+    });
+    std::partial_sum(offsets.begin(), offsets.end(), offsets.begin());
+
+    detail::for_chunks(pool, count, chunk, [&](std::size_t first, std::size_t last, std::size_t index){
+        std::size_t position = offsets[index];
+        for(std::size_t i=first; i < last; ++i){
+            if( pred(source[i]))
+                dest[position++] = source[i];
+        }
+    });
+    return offsets.back();
+}
+
+template<data_range Input, data_range Output, class Predicate>
+std::size_t copy_if(Input&& in, Output&& out, Predicate pred){
+    return copy_if(ThreadPool::instance(), std::forward<Input>(in), std::forward<Output>(out), std::move(pred));
+}
+
+}
+
+}
@@ -0,0 +1,228 @@
+#pragma once
+
+#include <algorithm> // max
+#include <atomic> // atomic wait notify
+#include <cstddef> // size_t
+#include <deque> // deque
+#include <exception> // exception_ptr current_exception rethrow_exception
+#include <functional> // function
+#include <memory> // unique_ptr make_unique
+#include <mutex> // mutex lock_guard
+#include <thread> // thread yield hardware_concurrency
+#include <utility> // forward move
+#include <vector> // vector
+#include "../memory/CachePadded.hpp"
+
+namespace yadej {
+
+namespace parallel {
+
+// Work stealing thread pool.
+//
+// Every worker owns a deque of tasks: it pushes and pops at the back (the
+// most recent, still hot in cache, task first) and, when its deque is empty,
+// steals from the front of the others. Tasks submitted from a thread which is
+// not a worker go to an extra injection deque. A thread waiting on a TaskGroup
+// runs pending tasks instead of blocking, so nested parallel calls from inside
+// a task never starve the pool.
+class ThreadPool {
+public:
+    using Task = std::function<void()>;
+
+    explicit ThreadPool(std::size_t threads = default_thread_count());
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+    // Run the tasks left then join the workers
+    ~ThreadPool();
+
+    // Pool shared by the parallel algorithms, one worker per hardware thread
+    static ThreadPool& instance();
+    static std::size_t default_thread_count() noexcept{
+        return std::max(1u, std::thread::hardware_concurrency());
+    }
+
+    // Number of workers
+    std::size_t size() const noexcept{ return m_threads.size(); }
+
+    void submit(Task task);
+    // Run one pending task on the calling thread, false when there was none
+    bool run_pending_task();
+
+private:
+    // Padded, the owner and the thieves of a deque do not slow the neighbours
+    struct alignas(destructive_interference_size) Queue {
+        std::mutex mutex;
+        std::deque<Task> tasks;
+    };
+
+    void worker_loop(std::size_t index);
+    // Own deque from the back, then the others from the front
+    bool pop_task(std::size_t index, Task& task);
+    // Index of the deque of the calling thread, the injection deque for strangers
+    std::size_t current_queue() const noexcept;
+
+    std::vector<std::unique_ptr<Queue>> m_queues;
+    std::vector<std::thread> m_threads;
+    std::atomic<std::size_t> m_pending{0};
+    // Bumped on every submit and on stop, idle workers sleep on it
+    std::atomic<std::size_t> m_signal{0};
+    std::atomic<bool> m_stop{false};
+
+    // Worker identity of the calling thread
+    static inline thread_local const ThreadPool* t_pool = nullptr;
+    static inline thread_local std::size_t t_index = 0;
+};
+
+// Set of tasks waited together. The first exception thrown by a task is
+// kept and rethrown by wait, the other tasks still run.
+class TaskGroup {
+public:
+    explicit TaskGroup(ThreadPool& pool = ThreadPool::instance()) noexcept: m_pool(pool){}
+    TaskGroup(const TaskGroup&) = delete;
+    TaskGroup& operator=(const TaskGroup&) = delete;
+    ~TaskGroup(){
+        wait_all();
+    }
+
+    template<class F>
+    void run(F&& task);
+    // Help the pool until every task of the group is done
+    void wait();
+
+private:
+    void wait_all() noexcept;
+
+    ThreadPool& m_pool;
+    std::atomic<std::size_t> m_running{0};
+    std::mutex m_error_mutex;
+    std::exception_ptr m_error;
+};
+
+inline ThreadPool::ThreadPool(std::size_t threads){
+    threads = std::max<std::size_t>(threads, 1);
+    // One deque per worker plus the injection deque
+    for(std::size_t i=0; i <= threads; ++i)
+        m_queues.push_back(std::make_unique<Queue>());
+    m_threads.reserve(threads);
+    for(std::size_t i=0; i < threads; ++i)
+        m_threads.emplace_back([this, i]{ worker_loop(i); });
+}
+
+inline ThreadPool::~ThreadPool(){
+    m_stop.store(true, std::memory_order_release);
+    m_signal.fetch_add(1, std::memory_order_release);
+    m_signal.notify_all();
+    for(std::thread& thread : m_threads)
+        thread.join();
+}
+
+inline ThreadPool& ThreadPool::instance(){
+    static ThreadPool pool;
+    return pool;
+}
+
+inline void ThreadPool::submit(Task task){
+    Queue& queue = *m_queues[current_queue()];
+    {
+        std::lock_guard lock(queue.mutex);
+        queue.tasks.push_back(std::move(task));
+    }
+    m_pending.fetch_add(1, std::memory_order_release);
+    m_signal.fetch_add(1, std::memory_order_release);
+    m_signal.notify_one();
+}
+
+inline bool ThreadPool::run_pending_task(){
+    Task task;
+    if( !pop_task(current_queue(), task))
+        return false;
+    task();
+    return true;
+}
+
+inline void ThreadPool::worker_loop(std::size_t index){
+    t_pool = this;
+    t_index = index;
+    Task task;
+    while( true){
+        // Read before looking for a task, a submit after it wakes the wait below
+        const std::size_t signal = m_signal.load(std::memory_order_acquire);
+        if( pop_task(index, task)){
+            task();
+            task = nullptr;
+            continue;
+        }
+        if( m_stop.load(std::memory_order_acquire))
+            return;
+        m_signal.wait(signal, std::memory_order_acquire);
+    }
+}
+
+inline bool ThreadPool::pop_task(std::size_t index, Task& task){
+    if( m_pending.load(std::memory_order_acquire) == 0)
+        return false;
+
+    {
+        Queue& own = *m_queues[index];
+        std::lock_guard lock(own.mutex);
+        if( !own.tasks.empty()){
+            task = std::move(own.tasks.back());
+            own.tasks.pop_back();
+            m_pending.fetch_sub(1, std::memory_order_acq_rel);
+            return true;
+        }
+    }
+    for(std::size_t offset=1; offset < m_queues.size(); ++offset){
+        Queue& victim = *m_queues[(index + offset) % m_queues.size()];
+        std::lock_guard lock(victim.mutex);
+        if( !victim.tasks.empty()){
+            task = std::move(victim.tasks.front());
+            victim.tasks.pop_front();
+            m_pending.fetch_sub(1, std::memory_order_acq_rel);
+            return true;
+        }
+    }
+    return false;
+}
+
+inline std::size_t ThreadPool::current_queue() const noexcept{
+    return t_pool == this ? t_index : m_threads.size();
+}
+
+template<class F>
+void TaskGroup::run(F&& task){
+    m_running.fetch_add(1, std::memory_order_relaxed);
+    try {
+        m_pool.submit([this, task = std::forward<F>(task)]() mutable {
+            try {
+                task();
+            } catch(...) {
+                std::lock_guard lock(m_error_mutex);
+                if( !m_error)
+                    m_error = std::current_exception();
+            }
+            m_running.fetch_sub(1, std::memory_order_release);
+        });
+    } catch(...) {
+        m_running.fetch_sub(1, std::memory_order_relaxed);
+        throw;
+    }
+}
+
+inline void TaskGroup::wait(){
+    wait_all();
+    std::lock_guard lock(m_error_mutex);
+    if( m_error)
+        std::rethrow_exception(std::exchange(m_error, nullptr));
+}
+
+inline void TaskGroup::wait_all() noexcept{
+    while( m_running.load(std::memory_order_acquire) != 0){
+        if( !m_pool.run_pending_task())
+            std::this_thread::yield();
+    }
+}
+
+}
+
+}
@@ -0,0 +1,563 @@
+#pragma once
+
+#include <algorithm> // min
+#include <atomic> // atomic
+#include <cstddef> // size_t
+#include <cstdint> // int32_t int64_t uint32_t uint64_t
+#include <cstring> // memcpy
+#include <ranges> // sized_range data size
+#include <stdexcept> // length_error out_of_range
+#include <type_traits> // is_same_v remove_pointer_t remove_cv_t
+#include <utility> // declval
+#include "../containers/Vector.hpp"
+
+namespace yadej {
+
+namespace simd {
+
+// Numeric kernels over contiguous buffers of arithmetic values (a Vector,
+// its data(), a span...).
+//
+// Every kernel is compiled once per instruction set, with GCC vector
+// extensions and a target attribute, and the widest one supported by the
+// CPU is picked at the first call. set_isa forces a narrower one, for tests
+// and benchmarks. Loads are unaligned, a simd::AlignedBuffer keeps its
+// buffer on a 64 bytes boundary so that they never cross a cache line.
+//
+// The lanes are summed in another order than a scalar loop, float results
+// of sum and dot may differ in the last bits. min and max are unspecified
+// when the range holds a NaN.
+
+enum class Isa { scalar, sse2, avx2, avx512 };
+
+// Element types with kernels
+template<class T>
+concept element = std::is_same_v<T, float> || std::is_same_v<T, double>
+                  || std::is_same_v<T, std::int32_t> || std::is_same_v<T, std::uint32_t>
+                  || std::is_same_v<T, std::int64_t> || std::is_same_v<T, std::uint64_t>;
+
+template<class Range>
+using range_element_t = std::remove_cv_t<std::remove_pointer_t<decltype(std::ranges::data(std::declval<Range&>()))>>;
+
+template<class Range>
+concept element_range = std::ranges::sized_range<Range>
+                        && requires(Range& range) { std::ranges::data(range); }
+                        && element<range_element_t<Range>>;
+
+// Width of an AVX-512 register
+inline constexpr std::size_t max_alignment = 64;
+
+// Vector whose data() is aligned for the widest loads. Named apart from
+// yadej::Vector, which it would shadow inside yadej::simd
+template<element T>
+using AlignedBuffer = AlignedVector<T, max_alignment>;
+
+namespace detail {
+
+template<class T, std::size_t Bytes>
+struct pack {
+    typedef T type __attribute__((vector_size(Bytes)));
+};
+
+template<class T, std::size_t Bytes>
+using pack_t = typename pack<T, Bytes>::type;
+
+// Vectors are passed by reference, by value their ABI depends on the target
+template<class V, class T>
+[[gnu::always_inline]] inline void load(V& vector, const T* data) noexcept{
+    std::memcpy(&vector, data, sizeof(V));
+}
+
+template<class V, class T>
+[[gnu::always_inline]] inline void store(T* data, const V& vector) noexcept{
+    std::memcpy(data, &vector, sizeof(V));
+}
+
+template<class V, class T>
+[[gnu::always_inline]] inline void broadcast(V& vector, T value) noexcept{
+    for(std::size_t i=0; i < sizeof(V) / sizeof(T); ++i)
+        vector[i] = value;
+}
+
+// True when one lane of the comparison result is set
+template<class M>
+[[gnu::always_inline]] inline bool any(const M& mask) noexcept{
+    std::uint64_t words[sizeof(M) / sizeof(std::uint64_t)];
+    std::memcpy(words, &mask, sizeof(M));
+    std::uint64_t bits = 0;
+    for(std::uint64_t word : words)
+        bits |= word;
+    return bits != 0;
+}
+
+// Bytes is the register width, 0 for the scalar loops
+template<class T, std::size_t Bytes>
+[[gnu::always_inline]] inline T sum(const T* data, std::size_t size) noexcept{
+    T result = 0;
+    std::size_t i = 0;
+    if constexpr (Bytes != 0){
+        using V = pack_t<T, Bytes>;
+        constexpr std::size_t lanes = Bytes / sizeof(T);
+        // Two accumulators to hide the latency of the adds
+        V first{}, second{}, values, next;
+        for(; i + 2 * lanes <= size; i += 2 * lanes){
+            load(values, data + i);
+            load(next, data + i + lanes);
+            first += values;
+            second += next;
+        }
+        first += second;
+        for(std::size_t lane=0; lane < lanes; ++lane)
+            result += first[lane];
+    }
+    for(; i < size; ++i)
+        result += data[i];
+    return result;
+}
+
+template<class T, std::size_t Bytes>
+[[gnu::always_inline]] inline T dot(const T* l_data, const T* r_data, std::size_t size) noexcept{
+    T result = 0;
+    std::size_t i = 0;
+    if constexpr (Bytes != 0){
+        using V = pack_t<T, Bytes>;
+        constexpr std::size_t lanes = Bytes / sizeof(T);
+        V first{}, second{}, l_values, r_values, l_next, r_next;
+        for(; i + 2 * lanes <= size; i += 2 * lanes){
+            load(l_values, l_data + i);
+            load(r_values, r_data + i);
+            load(l_next, l_data + i + lanes);
+            load(r_next, r_data + i + lanes);
+            first += l_values * r_values;
+            second += l_next * r_next;
+        }
+        first += second;
+        for(std::size_t lane=0; lane < lanes; ++lane)
+            result += first[lane];
+    }
+    for(; i < size; ++i)
+        result += l_data[i] * r_data[i];
+    return result;
+}
+
+// Keep in best the smallest (Min) or biggest of best and value, lane by lane
+template<bool Min, class V>
+[[gnu::always_inline]] inline void keep(V& best, const V& value) noexcept{
+    if constexpr (Min)
+        best = value < best ? value : best;
+    else
+        best = value > best ? value : best;
+}
+
+// size must not be 0
+template<class T, std::size_t Bytes, bool Min>
+[[gnu::always_inline]] inline T extremum(const T* data, std::size_t size) noexcept{
+    T result = data[0];
+    std::size_t i = 1;
+    if constexpr (Bytes != 0){
+        using V = pack_t<T, Bytes>;
+        constexpr std::size_t lanes = Bytes / sizeof(T);
+        if( size >= lanes){
+            V best, values;
+            load(best, data);
+            for(i=lanes; i + lanes <= size; i += lanes){
+                load(values, data + i);
+                keep<Min>(best, values);
+            }
+            for(std::size_t lane=0; lane < lanes; ++lane)
+                keep<Min>(result, static_cast<T>(best[lane]));
+        }
+    }
+    for(; i < size; ++i)
+        keep<Min>(result, data[i]);
+    return result;
+}
+
+// Index of the first element equal to value, size when there is none
+template<class T, std::size_t Bytes>
+[[gnu::always_inline]] inline std::size_t find(const T* data, std::size_t size, T value) noexcept{
+    std::size_t i = 0;
+    if constexpr (Bytes != 0){
+        using V = pack_t<T, Bytes>;
+        constexpr std::size_t lanes = Bytes / sizeof(T);
+        V needle, values;
+        broadcast(needle, value);
+        for(; i + lanes <= size; i += lanes){
+            load(values, data + i);
+            const auto equal = values == needle;
+            if( any(equal)){
+                for(std::size_t lane=0; lane < lanes; ++lane)
+                    if( equal[lane])
+                        return i + lane;
+            }
+        }
+    }
+    for(; i < size; ++i)
+        if( data[i] == value)
+            return i;
+    return size;
+}
+
+template<class T, std::size_t Bytes>
+[[gnu::always_inline]] inline std::size_t count(const T* data, std::size_t size, T value) noexcept{
+    std::size_t result = 0;
+    std::size_t i = 0;
+    if constexpr (Bytes != 0){
+        using V = pack_t<T, Bytes>;
+        using M = decltype(V{} == V{});
+        constexpr std::size_t lanes = Bytes / sizeof(T);
+        // A lane of the counters can hold 2^31 hits, flush them long before
+        constexpr std::size_t block = lanes << 30;
+        V needle, values;
+        broadcast(needle, value);
+        while( i + lanes <= size){
+            const std::size_t last = i + std::min(size - i, block) / lanes * lanes;
+            M hits{};
+            for(; i < last; i += lanes){
+                load(values, data + i);
+                // Equal lanes are -1
+                hits -= values == needle;
+            }
+            for(std::size_t lane=0; lane < lanes; ++lane)
+                result += static_cast<std::size_t>(hits[lane]);
+        }
+    }
+    for(; i < size; ++i)
+        result += data[i] == value;
+    return result;
+}
+
+template<class T, std::size_t Bytes>
+[[gnu::always_inline]] inline void fill(T* data, std::size_t size, T value) noexcept{
+    std::size_t i = 0;
+    if constexpr (Bytes != 0){
+        using V = pack_t<T, Bytes>;
+        constexpr std::size_t lanes = Bytes / sizeof(T);
+        V values;
+        broadcast(values, value);
+        for(; i + lanes <= size; i += lanes)
+            store(data + i, values);
+    }
+    for(; i < size; ++i)
+        data[i] = value;
+}
+
+// out[i] = l_data[i] op r_data[i] with operation applying op in place,
+// out may be one of the inputs
+template<class T, std::size_t Bytes, class Operation>
+[[gnu::always_inline]] inline void element_wise(const T* l_data, const T* r_data, T* out, std::size_t size,
+                                                Operation operation) noexcept{
+    std::size_t i = 0;
+    if constexpr (Bytes != 0){
+        using V = pack_t<T, Bytes>;
+        constexpr std::size_t lanes = Bytes / sizeof(T);
+        V l_values, r_values;
+        for(; i + lanes <= size; i += lanes){
+            load(l_values, l_data + i);
+            load(r_values, r_data + i);
+            operation(l_values, r_values);
+            store(out + i, l_values);
+        }
+    }
+    for(; i < size; ++i){
+        T value = l_data[i];
+        operation(value, r_data[i]);
+        out[i] = value;
+    }
+}
+
+// out[i] = a[i] * b[i] + c[i], a single rounding when the target has FMA
+template<class T, std::size_t Bytes>
+[[gnu::always_inline]] inline void fma(const T* a, const T* b, const T* c, T* out, std::size_t size) noexcept{
+    std::size_t i = 0;
+    if constexpr (Bytes != 0){
+        using V = pack_t<T, Bytes>;
+        constexpr std::size_t lanes = Bytes / sizeof(T);
+        V a_values, b_values, c_values;
+        for(; i + lanes <= size; i += lanes){
+            load(a_values, a + i);
+            load(b_values, b + i);
+            load(c_values, c + i);
+            a_values = a_values * b_values + c_values;
+            store(out + i, a_values);
+        }
+    }
+    for(; i < size; ++i)
+        out[i] = a[i] * b[i] + c[i];
+}
+
+// In place operations, on a value or on every lane
+struct plus {
+    template<class V>
+    [[gnu::always_inline]] void operator()(V& l_arg, const V& r_arg) const noexcept{ l_arg += r_arg; }
+};
+
+struct multiplies {
+    template<class V>
+    [[gnu::always_inline]] void operator()(V& l_arg, const V& r_arg) const noexcept{ l_arg *= r_arg; }
+};
+
+// One set of entry points per instruction set, the target attribute lets
+// the compiler use its registers whatever the flags of the build
+#define YADEJ_SIMD_KERNELS(Name, Bytes, ...)                                                                       \
+    struct Name {                                                                                                 \
+        template<class T>                                                                                         \
+        __VA_ARGS__ static T sum(const T* data, std::size_t size) noexcept{                                       \
+            return detail::sum<T, Bytes>(data, size);                                                             \
+        }                                                                                                         \
+        template<class T>                                                                                         \
+        __VA_ARGS__ static T dot(const T* l_data, const T* r_data, std::size_t size) noexcept{                    \
+            return detail::dot<T, Bytes>(l_data, r_data, size);                                                   \
+        }                                                                                                         \
+        template<class T>                                                                                         \
+        __VA_ARGS__ static T min(const T* data, std::size_t size) noexcept{                                       \
+            return detail::extremum<T, Bytes, true>(data, size);                                                  \
+        }                                                                                                         \
+        template<class T>                                                                                         \
+        __VA_ARGS__ static T max(const T* data, std::size_t size) noexcept{                                       \
+            return detail::extremum<T, Bytes, false>(data, size);                                                 \
+        }                                                                                                         \
+        template<class T>                                                                                         \
+        __VA_ARGS__ static std::size_t find(const T* data, std::size_t size, T value) noexcept{                   \
+            return detail::find<T, Bytes>(data, size, value);                                                     \
+        }                                                                                                         \
+        template<class T>                                                                                         \
+        __VA_ARGS__ static std::size_t count(const T* data, std::size_t size, T value) noexcept{                  \
+            return detail::count<T, Bytes>(data, size, value);                                                    \
+        }                                                                                                         \
+        template<class T>                                                                                         \
+        __VA_ARGS__ static void fill(T* data, std::size_t size, T value) noexcept{                                \
+            detail::fill<T, Bytes>(data, size, value);                                                            \
+        }                                                                                                         \
+        template<class T>                                                                                         \
+        __VA_ARGS__ static void add(const T* l_data, const T* r_data, T* out, std::size_t size) noexcept{         \
+            detail::element_wise<T, Bytes>(l_data, r_data, out, size, plus{});                                    \
+        }                                                                                                         \
+        template<class T>                                                                                         \
+        __VA_ARGS__ static void mul(const T* l_data, const T* r_data, T* out, std::size_t size) noexcept{         \
+            detail::element_wise<T, Bytes>(l_data, r_data, out, size, multiplies{});                              \
+        }                                                                                                         \
+        template<class T>                                                                                         \
+        __VA_ARGS__ static void fma(const T* a, const T* b, const T* c, T* out, std::size_t size) noexcept{       \
+            detail::fma<T, Bytes>(a, b, c, out, size);                                                            \
+        }                                                                                                         \
+    }
+
+YADEJ_SIMD_KERNELS(Scalar, 0);
+#if defined(__x86_64__) || defined(__i386__)
+YADEJ_SIMD_KERNELS(Sse2, 16, [[gnu::target("sse2")]]);
+YADEJ_SIMD_KERNELS(Avx2, 32, [[gnu::target("avx2,fma")]]);
+YADEJ_SIMD_KERNELS(Avx512, 64, [[gnu::target("avx512f,avx512dq,avx512vl,avx512bw,fma")]]);
+#else
+using Sse2 = Scalar;
+using Avx2 = Scalar;
+using Avx512 = Scalar;
+#endif
+
+#undef YADEJ_SIMD_KERNELS
+
+template<class T>
+struct Table {
+    T (*sum)(const T*, std::size_t) noexcept;
+    T (*dot)(const T*, const T*, std::size_t) noexcept;
+    T (*min)(const T*, std::size_t) noexcept;
+    T (*max)(const T*, std::size_t) noexcept;
+    std::size_t (*find)(const T*, std::size_t, T) noexcept;
+    std::size_t (*count)(const T*, std::size_t, T) noexcept;
+    void (*fill)(T*, std::size_t, T) noexcept;
+    void (*add)(const T*, const T*, T*, std::size_t) noexcept;
+    void (*mul)(const T*, const T*, T*, std::size_t) noexcept;
+    void (*fma)(const T*, const T*, const T*, T*, std::size_t) noexcept;
+};
+
+template<class Kernels, class T>
+constexpr Table<T> make_table() noexcept{
+    return {&Kernels::template sum<T>, &Kernels::template dot<T>,
+            &Kernels::template min<T>, &Kernels::template max<T>,
+            &Kernels::template find<T>, &Kernels::template count<T>,
+            &Kernels::template fill<T>, &Kernels::template add<T>,
+            &Kernels::template mul<T>, &Kernels::template fma<T>};
+}
+
+inline Isa detect() noexcept{
+#if defined(__x86_64__) || defined(__i386__)
+    __builtin_cpu_init();
+    if( __builtin_cpu_supports("avx512f") && __builtin_cpu_supports("avx512dq")
+        && __builtin_cpu_supports("avx512vl") && __builtin_cpu_supports("avx512bw"))
+        return Isa::avx512;
+    if( __builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma"))
+        return Isa::avx2;
+    if( __builtin_cpu_supports("sse2"))
+        return Isa::sse2;
+#endif
+    return Isa::scalar;
+}
+
+inline std::atomic<Isa>& active() noexcept{
+    static std::atomic<Isa> isa{detect()};
+    return isa;
+}
+
+template<class T>
+const Table<T>& table() noexcept{
+    static constexpr Table<T> tables[] = {make_table<Scalar, T>(), make_table<Sse2, T>(),
+                                          make_table<Avx2, T>(), make_table<Avx512, T>()};
+    return tables[static_cast<std::size_t>(active().load(std::memory_order_relaxed))];
+}
+
+template<class Range>
+void check_same_size(const char* what, const Range& range, std::size_t size){
+    if( std::ranges::size(range) != size)
+        throw std::length_error(what);
+}
+
+}
+
+// Widest instruction set of the CPU
+inline Isa supported_isa() noexcept{
+    static const Isa isa = detail::detect();
+    return isa;
+}
+
+// Instruction set used by the kernels
+inline Isa active_isa() noexcept{
+    return detail::active().load(std::memory_order_relaxed);
+}
+
+// Use isa, or the widest supported one below it, return the one picked
+inline Isa set_isa(Isa isa) noexcept{
+    if( isa > supported_isa())
+        isa = supported_isa();
+    detail::active().store(isa, std::memory_order_relaxed);
+    return isa;
+}
+
+template<element T>
+T sum(const T* data, std::size_t size) noexcept{
+    return detail::table<T>().sum(data, size);
+}
+
+template<element_range Range>
+range_element_t<Range> sum(const Range& range) noexcept{
+    return sum(std::ranges::data(range), std::ranges::size(range));
+}
+
+template<element T>
+T dot(const T* l_data, const T* r_data, std::size_t size) noexcept{
+    return detail::table<T>().dot(l_data, r_data, size);
+}
+
+template<element_range LRange, element_range RRange>
+    requires std::is_same_v<range_element_t<LRange>, range_element_t<RRange>>
+range_element_t<LRange> dot(const LRange& l_range, const RRange& r_range){
+    detail::check_same_size("yadej::simd::dot ranges of different sizes", r_range, std::ranges::size(l_range));
+    return dot(std::ranges::data(l_range), std::ranges::data(r_range), std::ranges::size(l_range));
+}
+
+// size must not be 0
+template<element T>
+T min(const T* data, std::size_t size) noexcept{
+    return detail::table<T>().min(data, size);
+}
+
+template<element_range Range>
+range_element_t<Range> min(const Range& range){
+    if( std::ranges::size(range) == 0)
+        throw std::out_of_range("yadej::simd::min of an empty range");
+    return min(std::ranges::data(range), std::ranges::size(range));
+}
+
+// size must not be 0
+template<element T>
+T max(const T* data, std::size_t size) noexcept{
+    return detail::table<T>().max(data, size);
+}
+
+template<element_range Range>
+range_element_t<Range> max(const Range& range){
+    if( std::ranges::size(range) == 0)
+        throw std::out_of_range("yadej::simd::max of an empty range");
+    return max(std::ranges::data(range), std::ranges::size(range));
+}
+
+// Index of the first element equal to value, size when there is none
+template<element T>
+std::size_t find(const T* data, std::size_t size, T value) noexcept{
+    return detail::table<T>().find(data, size, value);
+}
+
+template<element_range Range>
+std::size_t find(const Range& range, range_element_t<Range> value) noexcept{
+    return find(std::ranges::data(range), std::ranges::size(range), value);
+}
+
+template<element T>
+std::size_t count(const T* data, std::size_t size, T value) noexcept{
+    return detail::table<T>().count(data, size, value);
+}
+
+template<element_range Range>
+std::size_t count(const Range& range, range_element_t<Range> value) noexcept{
+    return count(std::ranges::data(range), std::ranges::size(range), value);
+}
+
+template<element T>
+void fill(T* data, std::size_t size, T value) noexcept{
+    detail::table<T>().fill(data, size, value);
+}
+
+template<element_range Range>
+void fill(Range&& range, range_element_t<Range> value) noexcept{
+    fill(std::ranges::data(range), std::ranges::size(range), value);
+}
+
+// out[i] = l_data[i] + r_data[i], out may be one of the inputs
+template<element T>
+void add(const T* l_data, const T* r_data, T* out, std::size_t size) noexcept{
+    detail::table<T>().add(l_data, r_data, out, size);
+}
+
+template<element_range LRange, element_range RRange, element_range Out>
+    requires std::is_same_v<range_element_t<LRange>, range_element_t<Out>>
+             && std::is_same_v<range_element_t<RRange>, range_element_t<Out>>
+void add(const LRange& l_range, const RRange& r_range, Out&& out){
+    detail::check_same_size("yadej::simd::add ranges of different sizes", l_range, std::ranges::size(out));
+    detail::check_same_size("yadej::simd::add ranges of different sizes", r_range, std::ranges::size(out));
+    add(std::ranges::data(l_range), std::ranges::data(r_range), std::ranges::data(out), std::ranges::size(out));
+}
+
+// out[i] = l_data[i] * r_data[i], out may be one of the inputs
+template<element T>
+void mul(const T* l_data, const T* r_data, T* out, std::size_t size) noexcept{
+    detail::table<T>().mul(l_data, r_data, out, size);
+}
+
+template<element_range LRange, element_range RRange, element_range Out>
+    requires std::is_same_v<range_element_t<LRange>, range_element_t<Out>>
+             && std::is_same_v<range_element_t<RRange>, range_element_t<Out>>
+void mul(const LRange& l_range, const RRange& r_range, Out&& out){
+    detail::check_same_size("yadej::simd::mul ranges of different sizes", l_range, std::ranges::size(out));
+    detail::check_same_size("yadej::simd::mul ranges of different sizes", r_range, std::ranges::size(out));
+    mul(std::ranges::data(l_range), std::ranges::data(r_range), std::ranges::data(out), std::ranges::size(out));
+}
+
+// out[i] = a[i] * b[i] + c[i], out may be one of the inputs
+template<element T>
+void fma(const T* a, const T* b, const T* c, T* out, std::size_t size) noexcept{
+    detail::table<T>().fma(a, b, c, out, size);
+}
+
+template<element_range A, element_range B, element_range C, element_range Out>
+    requires std::is_same_v<range_element_t<A>, range_element_t<Out>>
+             && std::is_same_v<range_element_t<B>, range_element_t<Out>>
+             && std::is_same_v<range_element_t<C>, range_element_t<Out>>
+void fma(const A& a, const B& b, const C& c, Out&& out){
+    detail::check_same_size("yadej::simd::fma ranges of different sizes", a, std::ranges::size(out));
+    detail::check_same_size("yadej::simd::fma ranges of different sizes", b, std::ranges::size(out));
+    detail::check_same_size("yadej::simd::fma ranges of different sizes", c, std::ranges::size(out));
+    fma(std::ranges::data(a), std::ranges::data(b), std::ranges::data(c), std::ranges::data(out), std::ranges::size(out));
+}
+
+}
+
+}
@@ -0,0 +1,110 @@
+#pragma once
+
+#include <gtest/gtest.h>
+#include <cstddef>
+#include <iterator>
+#include <stdexcept>
+
+// Copies and moves count down, the one reaching 0 throws. When sticky every
+// copy and move after it throws too, until countdown is set again.
+struct Fragile {
+    inline static int countdown = 0;
+    inline static bool sticky = false;
+    // Fragile objects alive, to catch a leaked or twice destroyed element
+    inline static int live = 0;
+
+    explicit Fragile(int v): value(v){ ++live; }
+    Fragile(const Fragile& other): value(other.value){ tick(); ++live; }
+    Fragile(Fragile&& other): value(other.value){ tick(); ++live; }
+    Fragile& operator=(const Fragile&) = default;
+    Fragile& operator=(Fragile&&) = default;
+    ~Fragile(){ --live; }
+
+    static void tick(){
+        if( countdown < 0 || (countdown > 0 && --countdown == 0)){
+            countdown = sticky ? -1 : 0;
+            throw std::runtime_error("fragile copy");
+        }
+    }
+    int value;
+};
+
+template<class Container>
+void expect_sequence(const Container& vec, int count){
+    ASSERT_EQ(vec.size(), static_cast<std::size_t>(count));
+    for(int i=0; i < count; ++i)
+        EXPECT_EQ(vec[static_cast<std::size_t>(i)].value, i);
+}
+
+// Insertions of Fragile elements into a container of Fragile, instantiated
+// by each container test with INSTANTIATE_TYPED_TEST_SUITE_P. The container
+// must have room for 16 elements, growing or not.
+template<class Container>
+class InsertRollback : public ::testing::Test {
+protected:
+    void TearDown() override{
+        Fragile::countdown = 0;
+        Fragile::sticky = false;
+    }
+
+    // Run insert on 0 1 2 3 4 5 making each copy or move throw in turn,
+    // including the ones of the rollback. A failed insert must leave the
+    // sequence as it was, the one that succeeds must put count 9 at 2.
+    template<class Insert>
+    void expect_rollback(int count, Insert insert){
+        for(bool sticky : {false, true}){
+            for(int countdown=1; ; ++countdown){
+                const int live = Fragile::live;
+                Container vec;
+                for(int i=0; i < 6; ++i)
+                    vec.emplace_back(i);
+
+                Fragile::sticky = sticky;
+                Fragile::countdown = countdown;
+                bool failed = false;
+                try {
+                    insert(vec);
+                } catch(const std::runtime_error&) {
+                    failed = true;
+                }
+                Fragile::countdown = 0;
+                ASSERT_EQ(Fragile::live, live + static_cast<int>(vec.size()));
+                if( failed){
+                    expect_sequence(vec, 6);
+                    continue;
+                }
+
+                ASSERT_EQ(vec.size(), static_cast<std::size_t>(6 + count));
+                for(int i=0; i < count; ++i)
+                    EXPECT_EQ(vec[static_cast<std::size_t>(2 + i)].value, 9);
+                vec.erase(vec.begin() + 2, vec.begin() + 2 + count);
+                expect_sequence(vec, 6);
+                break;
+            }
+        }
+    }
+};
+
+TYPED_TEST_SUITE_P(InsertRollback);
+
+TYPED_TEST_P(InsertRollback, TestInsertCount)
+{
+    const Fragile value(9);
+    // Inside the elements after the insert position then past them
+    this->expect_rollback(2, [&](TypeParam& vec){ vec.insert(vec.begin() + 2, 2, value); });
+    this->expect_rollback(10, [&](TypeParam& vec){ vec.insert(vec.begin() + 2, 10, value); });
+}
+
+TYPED_TEST_P(InsertRollback, TestInsertRange)
+{
+    const Fragile range[] = {Fragile(9), Fragile(9), Fragile(9), Fragile(9), Fragile(9)};
+    this->expect_rollback(2, [&](TypeParam& vec){ vec.insert(vec.begin() + 2, std::begin(range), std::begin(range) + 2); });
+    this->expect_rollback(5, [&](TypeParam& vec){ vec.insert(vec.begin() + 2, std::begin(range), std::end(range)); });
+}
+
+TYPED_TEST_P(InsertRollback, TestEmplace)
+{
+    this->expect_rollback(1, [](TypeParam& vec){ vec.emplace(vec.begin() + 2, 9); });
+}
+
+REGISTER_TYPED_TEST_SUITE_P(InsertRollback, TestInsertCount, TestInsertRange, TestEmplace);
@@ -0,0 +1,25 @@
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include <type_traits>
+
+// Allocator tagged with an id, propagating on every assignment and swap
+template<class T>
+struct TaggedAllocator {
+    using value_type = T;
+    using propagate_on_container_copy_assignment = std::true_type;
+    using propagate_on_container_move_assignment = std::true_type;
+    using propagate_on_container_swap = std::true_type;
+
+    int id{0};
+    TaggedAllocator() = default;
+    explicit TaggedAllocator(int tag): id(tag){}
+    template<class U>
+    TaggedAllocator(const TaggedAllocator<U>& other): id(other.id){}
+
+    T* allocate(std::size_t count){ return std::allocator<T>().allocate(count); }
+    void deallocate(T* pointer, std::size_t count){ std::allocator<T>().deallocate(pointer, count); }
+    TaggedAllocator select_on_container_copy_construction() const{ return TaggedAllocator(id + 100); }
+    bool operator==(const TaggedAllocator& other) const{ return id == other.id; }
+};
@@ -0,0 +1,34 @@
+#pragma once
+
+#include <gtest/gtest.h>
+#include <cstdint>
+#include <cstddef>
+#include <filesystem>
+#include <fstream>
+#include <string>
+
+// Record written to and read back from the files
+struct Sample {
+    std::uint64_t timestamp;
+    double value;
+};
+
+// Fresh file named after the test, removed at the end of it
+class TempFileTest : public ::testing::Test {
+protected:
+    void SetUp() override{
+        const ::testing::TestInfo* test = ::testing::UnitTest::GetInstance()->current_test_info();
+        m_path = std::filesystem::temp_directory_path()
+               / (std::string(test->test_suite_name()) + "_" + test->name());
+        std::filesystem::remove(m_path);
+    }
+    void TearDown() override{
+        std::filesystem::remove(m_path);
+    }
+    // Replace the content of the file by size bytes from data
+    void write_file(const void* data, std::size_t size){
+        std::ofstream file(m_path, std::ios::binary | std::ios::trunc);
+        file.write(static_cast<const char*>(data), static_cast<std::streamsize>(size));
+    }
+    std::filesystem::path m_path;
+};
@@ -0,0 +1,109 @@
+#include "exerciceCPP/memory/AlignedAllocator.hpp"
+#include "exerciceCPP/memory/CachePadded.hpp"
+#include "exerciceCPP/containers/Vector.hpp"
+#include <gtest/gtest.h>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <thread>
+#include <type_traits>
+
+static_assert(yadej::AlignedAllocator<char, 64>::alignment == 64);
+static_assert(yadej::AlignedAllocator<long double, 1>::alignment == alignof(long double));
+static_assert(std::is_same_v<std::allocator_traits<yadej::AlignedAllocator<int, 32>>::rebind_alloc<double>,
+                             yadej::AlignedAllocator<double, 32>>);
+static_assert(sizeof(yadej::CachePadded<char>) == yadej::destructive_interference_size);
+static_assert(alignof(yadej::CachePadded<yadej::Vector<int>>) == yadej::destructive_interference_size);
+
+template<class T>
+bool is_aligned(const T* pointer, std::size_t alignment){
+    return reinterpret_cast<std::uintptr_t>(pointer) % alignment == 0;
+}
+
+template<class T>
+class AlignmentAlignedVector : public ::testing::Test {};
+
+template<std::size_t Align>
+using Alignment = std::integral_constant<std::size_t, Align>;
+using Alignments = ::testing::Types<Alignment<32>, Alignment<64>, Alignment<4096>>;
+TYPED_TEST_SUITE(AlignmentAlignedVector, Alignments);
+
+TYPED_TEST(AlignmentAlignedVector, TestGrowth)
+{
+    constexpr std::size_t align = TypeParam::value;
+    yadej::AlignedVector<std::uint8_t, align> bytes;
+    yadej::AlignedVector<std::string, align> strings;
+    for(std::size_t i=0; i < 300; ++i){
+        bytes.push_back(static_cast<std::uint8_t>(i));
+        strings.emplace_back(i, 'x');
+        ASSERT_TRUE(is_aligned(bytes.data(), align));
+        ASSERT_TRUE(is_aligned(strings.data(), align));
+    }
+    bytes.insert(bytes.begin() + 7, 100, std::uint8_t{1});
+    EXPECT_TRUE(is_aligned(bytes.data(), align));
+    bytes.shrink_to_fit();
+    EXPECT_TRUE(is_aligned(bytes.data(), align));
+
+    const yadej::AlignedVector<std::string, align> copy(strings);
+    EXPECT_TRUE(is_aligned(copy.data(), align));
+    EXPECT_EQ(copy[299].size(), 299);
+    yadej::AlignedVector<std::string, align> moved(std::move(strings));
+    EXPECT_TRUE(is_aligned(moved.data(), align));
+    EXPECT_EQ(moved.size(), 300);
+}
+
+TEST(AllocatorAlignedVector, TestEquality)
+{
+    yadej::AlignedAllocator<int, 64> ints;
+    yadej::AlignedAllocator<double, 64> doubles(ints);
+    EXPECT_TRUE(ints == doubles);
+
+    int* values = ints.allocate(10);
+    EXPECT_TRUE(is_aligned(values, 64));
+    ints.deallocate(values, 10);
+
+    // Equal allocators, the buffer is stolen
+    yadej::AlignedVector<int, 64> source = {1, 2, 3};
+    const int* data = source.data();
+    yadej::AlignedVector<int, 64> target;
+    target = std::move(source);
+    EXPECT_EQ(target.data(), data);
+}
+
+TEST(PaddingCachePadded, TestPerThreadVectors)
+{
+    constexpr std::size_t threads = 4;
+    yadej::Vector<yadej::CachePadded<yadej::Vector<std::uint64_t>>> per_thread(threads);
+    for(std::size_t i=0; i + 1 < threads; ++i){
+        const auto distance = reinterpret_cast<std::uintptr_t>(&per_thread[i + 1].get())
+                              - reinterpret_cast<std::uintptr_t>(&per_thread[i].get());
+        EXPECT_GE(distance, yadej::destructive_interference_size);
+        EXPECT_TRUE(is_aligned(&per_thread[i], yadej::destructive_interference_size));
+    }
+
+    std::vector<std::thread> workers;
+    for(std::size_t i=0; i < threads; ++i){
+        workers.emplace_back([&per_thread, i]{
+            for(std::uint64_t value=0; value < 1000; ++value)
+                per_thread[i]->push_back(value * i);
+        });
+    }
+    for(std::thread& worker : workers)
+        worker.join();
+    for(std::size_t i=0; i < threads; ++i){
+        ASSERT_EQ(per_thread[i]->size(), 1000);
+        EXPECT_EQ((*per_thread[i])[999], 999 * i);
+    }
+
+    const yadej::CachePadded<std::string> name(3, 'a');
+    EXPECT_EQ(*name, "aaa");
+    yadej::CachePadded<std::string> copy(name);
+    EXPECT_EQ(copy->size(), 3);
+}
+
+
+int main(int argc, char **argv)
+{
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -0,0 +1,105 @@
+#include "exerciceCPP/memory/ArenaResource.hpp"
+#include "exerciceCPP/containers/Vector.hpp"
+#include <gtest/gtest.h>
+#include <cstddef>
+#include <cstdint>
+#include <memory_resource>
+#include <string>
+
+// Upstream resource counting what the arena takes from it
+class CountingResource : public std::pmr::memory_resource {
+public:
+    std::size_t allocations{0};
+    std::size_t bytes{0};
+
+private:
+    void* do_allocate(std::size_t size, std::size_t alignment) override{
+        ++allocations;
+        bytes += size;
+        return std::pmr::new_delete_resource()->allocate(size, alignment);
+    }
+    void do_deallocate(void* pointer, std::size_t size, std::size_t alignment) override{
+        bytes -= size;
+        std::pmr::new_delete_resource()->deallocate(pointer, size, alignment);
+    }
+    bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override{
+        return this == &other;
+    }
+};
+
+TEST(AllocateArenaResource, TestAlignmentAndGrowth)
+{
+    CountingResource upstream;
+    yadej::ArenaResource arena(256, &upstream);
+    void* small = arena.allocate(3, 1);
+    void* aligned = arena.allocate(64, 64);
+    EXPECT_EQ(reinterpret_cast<std::uintptr_t>(aligned) % 64, 0);
+    EXPECT_NE(small, aligned);
+    EXPECT_EQ(upstream.allocations, 1);
+
+    // Bigger than the chunk size, a dedicated chunk is taken
+    void* big = arena.allocate(10000, 8);
+    EXPECT_NE(big, nullptr);
+    EXPECT_EQ(upstream.allocations, 2);
+    EXPECT_EQ(arena.bytes_used(), 10067);
+
+    arena.release();
+    EXPECT_EQ(upstream.bytes, 0);
+    EXPECT_EQ(arena.bytes_used(), 0);
+}
+
+TEST(DeallocateArenaResource, TestRewindLastBlock)
+{
+    yadej::ArenaResource arena;
+    void* first = arena.allocate(32, 8);
+    void* second = arena.allocate(32, 8);
+    arena.deallocate(first, 32, 8);
+    EXPECT_EQ(arena.bytes_used(), 64);
+    arena.deallocate(second, 32, 8);
+    EXPECT_EQ(arena.bytes_used(), 32);
+    EXPECT_EQ(arena.allocate(32, 8), second);
+}
+
+TEST(ResetArenaResource, TestChunkReuse)
+{
+    CountingResource upstream;
+    yadej::ArenaResource arena(128, &upstream);
+    for(int request=0; request < 3; ++request){
+        yadej::pmr::Vector<std::string> rows(&arena);
+        for(int i=0; i < 200; ++i)
+            rows.push_back(std::string(40, 'r'));
+        EXPECT_EQ(rows[199], std::string(40, 'r'));
+        rows.clear();
+        arena.reset();
+    }
+    // The biggest chunk was kept, the last requests did not touch upstream
+    std::size_t allocations = upstream.allocations;
+    {
+        yadej::pmr::Vector<std::string> rows(&arena);
+        for(int i=0; i < 200; ++i)
+            rows.push_back(std::string(40, 'r'));
+    }
+    EXPECT_EQ(upstream.allocations, allocations);
+    EXPECT_EQ(upstream.bytes, arena.bytes_reserved());
+}
+
+TEST(BufferArenaResource, TestInitialBuffer)
+{
+    alignas(std::max_align_t) std::byte buffer[512];
+    CountingResource upstream;
+    yadej::ArenaResource arena(buffer, sizeof(buffer), &upstream);
+    yadej::pmr::Vector<int> vec(&arena);
+    vec.reserve(16);
+    EXPECT_GE(static_cast<void*>(vec.data()), static_cast<void*>(buffer));
+    EXPECT_LT(static_cast<void*>(vec.data()), static_cast<void*>(buffer + sizeof(buffer)));
+    EXPECT_EQ(upstream.allocations, 0);
+    vec.reserve(1000);
+    EXPECT_EQ(upstream.allocations, 1);
+}
+
+
+int main(int argc, char **argv)
+{
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -0,0 +1,124 @@
+#include "exerciceCPP/io/ChunkReader.hpp"
+#include <gtest/gtest.h>
+#include "TempFile.hpp"
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <thread>
+#include <vector>
+
+class ChunkReaderFile : public TempFileTest {};
+
+TEST_F(ChunkReaderFile, TestChunks)
+{
+    std::string content;
+    for(int i=0; i < 10000; ++i)
+        content += static_cast<char>('a' + i % 26);
+    write_file(content.data(), content.size());
+
+    for(std::size_t chunks=2; chunks <= 4; ++chunks){
+        yadej::io::ChunkReader reader(m_path, {.chunk_size = 999, .chunks = chunks});
+        EXPECT_EQ(reader.memory_budget(), 999 * chunks);
+        std::string read;
+        for(auto chunk = reader.next(); !chunk.empty(); chunk = reader.next()){
+            ASSERT_EQ(reader.offset(), read.size());
+            ASSERT_TRUE(chunk.size() == 999 || read.size() + chunk.size() == content.size());
+            read.append(reinterpret_cast<const char*>(chunk.data()), chunk.size());
+        }
+        EXPECT_EQ(read, content);
+        EXPECT_TRUE(reader.next().empty());
+    }
+
+    // Stopped before the end
+    yadej::io::ChunkReader reader(m_path, {.chunk_size = 16});
+    EXPECT_EQ(reader.next().size(), 16);
+
+    EXPECT_THROW(yadej::io::ChunkReader(m_path, {.chunk_size = 16, .chunks = 1}), std::invalid_argument);
+    EXPECT_THROW(yadej::io::ChunkReader(m_path / "missing"), std::system_error);
+}
+
+TEST_F(ChunkReaderFile, TestBackpressure)
+{
+    const std::vector<std::byte> content(64 * 100, std::byte{1});
+    write_file(content.data(), content.size());
+    yadej::io::ChunkReader reader(m_path, {.chunk_size = 64, .chunks = 3});
+    std::size_t size = 0;
+    for(auto chunk = reader.next(); !chunk.empty(); chunk = reader.next()){
+        // Slower than the reads: the reader thread runs out of buffers
+        std::this_thread::sleep_for(std::chrono::microseconds(200));
+        size += chunk.size();
+    }
+    EXPECT_EQ(size, content.size());
+    EXPECT_GT(reader.reader_waits(), 0);
+}
+
+TEST_F(ChunkReaderFile, TestRecords)
+{
+    std::vector<Sample> samples;
+    for(std::uint64_t i=0; i < 5000; ++i)
+        samples.push_back({i, static_cast<double>(i) / 4});
+    write_file(samples.data(), samples.size() * sizeof(Sample));
+
+    // Records cut between the chunks
+    yadej::io::ChunkReader reader(m_path, {.chunk_size = 1000});
+    yadej::Vector<Sample> out;
+    out.push_back({42, 0.0});
+    EXPECT_EQ(yadej::io::read_records(reader, out), 5000);
+    ASSERT_EQ(out.size(), 5001);
+    EXPECT_EQ(out[0].timestamp, 42);
+    for(std::uint64_t i=0; i < 5000; ++i){
+        ASSERT_EQ(out[i + 1].timestamp, i);
+        ASSERT_EQ(out[i + 1].value, static_cast<double>(i) / 4);
+    }
+
+    write_file(samples.data(), 10 * sizeof(Sample) + 3);
+    yadej::io::ChunkReader truncated(m_path, {.chunk_size = 7});
+    EXPECT_THROW(yadej::io::read_records(truncated, out), std::length_error);
+}
+
+TEST_F(ChunkReaderFile, TestLines)
+{
+    std::string content;
+    std::vector<std::string> expected;
+    for(int i=0; i < 300; ++i){
+        // Lines of 0 to 11 characters
+        expected.push_back(std::string(static_cast<std::size_t>(i % 12), static_cast<char>('a' + i % 26)));
+        content += expected.back() + '\n';
+    }
+    expected.push_back("last");
+    content += "last";
+    write_file(content.data(), content.size());
+
+    for(std::size_t chunk_size=12; chunk_size < 40; chunk_size += 5){
+        yadej::io::ChunkReader reader(m_path, {.chunk_size = chunk_size});
+        yadej::Vector<std::string> lines;
+        EXPECT_EQ(yadej::io::read_lines(reader, lines, [](std::string_view line){ return std::string(line); }), expected.size());
+        ASSERT_EQ(lines.size(), expected.size());
+        for(std::size_t i=0; i < expected.size(); ++i)
+            ASSERT_EQ(lines[i], expected[i]);
+    }
+
+    // Decoded straight into the Vector
+    const std::string numbers = "1\n22\n333\n";
+    write_file(numbers.data(), numbers.size());
+    yadej::io::ChunkReader reader(m_path, {.chunk_size = 4});
+    yadej::Vector<std::size_t> lengths;
+    yadej::io::read_lines(reader, lengths, [](std::string_view line){ return line.size(); });
+    ASSERT_EQ(lengths.size(), 3);
+    EXPECT_EQ(lengths[2], 3);
+
+    yadej::io::ChunkReader small(m_path, {.chunk_size = 2});
+    EXPECT_THROW(yadej::io::read_lines(small, lengths, [](std::string_view line){ return line.size(); }), std::length_error);
+}
+
+
+int main(int argc, char **argv)
+{
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -0,0 +1,107 @@
+#include "exerciceCPP/containers/ConcurrentVector.hpp"
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+TEST(PushBackConcurrentVector, TestSingleThread)
+{
+    yadej::ConcurrentVector<std::string> vec;
+    EXPECT_TRUE(vec.empty());
+    std::string& first = vec.push_back("first");
+    for(int i=0; i < 1000; ++i)
+        vec.emplace_back(3, static_cast<char>('a' + i % 26));
+    // Growth never moves a published element
+    EXPECT_EQ(&first, &vec[0]);
+    EXPECT_EQ(first, "first");
+    ASSERT_EQ(vec.size(), 1001);
+    EXPECT_EQ(vec[1000], "lll");
+    EXPECT_GE(vec.capacity(), 1001);
+    EXPECT_THROW(vec.at(1001), std::out_of_range);
+    EXPECT_EQ(vec.try_get(1001), nullptr);
+
+    vec.clear();
+    EXPECT_TRUE(vec.empty());
+    EXPECT_EQ(vec.capacity(), 0);
+    vec.reserve(100);
+    EXPECT_EQ(vec.capacity(), 224);
+}
+
+TEST(StressConcurrentVector, TestManyWriters)
+{
+    constexpr std::size_t threads = 8;
+    constexpr std::size_t per_thread = 50000;
+    yadej::ConcurrentVector<std::size_t> vec;
+    std::atomic<bool> done{false};
+    std::atomic<std::size_t> wrong_reads{0};
+
+    // Reads while the writers run only see ready elements
+    std::thread reader([&]{
+        while( !done.load()){
+            const std::size_t size = vec.size();
+            for(std::size_t i=0; i < size; i += 97){
+                const std::size_t* value = vec.try_get(i);
+                if( value != nullptr && *value >= threads * per_thread)
+                    ++wrong_reads;
+            }
+        }
+    });
+
+    std::vector<std::thread> writers;
+    std::vector<std::vector<const std::size_t*>> addresses(threads);
+    for(std::size_t t=0; t < threads; ++t){
+        writers.emplace_back([&, t]{
+            for(std::size_t i=0; i < per_thread; ++i)
+                addresses[t].push_back(&vec.push_back(t * per_thread + i));
+        });
+    }
+    for(std::thread& writer : writers)
+        writer.join();
+    done = true;
+    reader.join();
+
+    ASSERT_EQ(vec.size(), threads * per_thread);
+    EXPECT_EQ(wrong_reads, 0);
+    std::vector<bool> seen(threads * per_thread, false);
+    for(std::size_t i=0; i < vec.size(); ++i){
+        ASSERT_NE(vec.try_get(i), nullptr);
+        seen[vec[i]] = true;
+    }
+    EXPECT_TRUE(std::all_of(seen.begin(), seen.end(), [](bool value){ return value; }));
+    // Every reference returned by push_back still points to its value
+    for(std::size_t t=0; t < threads; ++t)
+        for(std::size_t i=0; i < per_thread; ++i)
+            ASSERT_EQ(*addresses[t][i], t * per_thread + i);
+}
+
+struct ThrowOnNegative {
+    explicit ThrowOnNegative(int number): value(std::to_string(number)){
+        if( number < 0)
+            throw std::invalid_argument("negative");
+    }
+    std::string value;
+};
+
+TEST(ExceptionConcurrentVector, TestSlotSkipped)
+{
+    yadej::ConcurrentVector<ThrowOnNegative> vec;
+    vec.emplace_back(1);
+    EXPECT_THROW(vec.emplace_back(-1), std::invalid_argument);
+    vec.emplace_back(2);
+    // The slot of the failed construction is claimed but never ready
+    EXPECT_EQ(vec.size(), 3);
+    EXPECT_EQ(vec.try_get(1), nullptr);
+    EXPECT_THROW(vec.at(1), std::out_of_range);
+    EXPECT_EQ(vec.at(2).value, "2");
+}
+
+
+int main(int argc, char **argv)
+{
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -0,0 +1,171 @@
+#include "exerciceCPP/containers/CowVector.hpp"
+#include "exerciceCPP/containers/Vector.hpp"
+#include <gtest/gtest.h>
+#include <atomic>
+#include <cstddef>
+#include <memory_resource>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+TEST(SharingCowVector, TestCopyOnWrite)
+{
+    yadej::CowVector<std::string> original = {"a", "b", "c"};
+    EXPECT_EQ(original.use_count(), 1);
+
+    yadej::CowVector<std::string> copy = original;
+    EXPECT_EQ(copy.data(), original.data());
+    EXPECT_EQ(original.use_count(), 2);
+    EXPECT_TRUE(copy == original);
+
+    copy.set(1, "B");
+    EXPECT_NE(copy.data(), original.data());
+    EXPECT_EQ(original[1], "b");
+    EXPECT_EQ(copy[1], "B");
+    EXPECT_EQ(original.use_count(), 1);
+    EXPECT_EQ(copy.use_count(), 1);
+    EXPECT_FALSE(copy == original);
+
+    // Unique, the buffer is written in place
+    const std::string* data = copy.data();
+    copy.write(0) = "A";
+    copy.push_back("D");
+    EXPECT_EQ(copy.size(), 4);
+    EXPECT_EQ(copy.front(), "A");
+    EXPECT_EQ(copy.back(), "D");
+    if( copy.capacity() == 4){
+        EXPECT_EQ(copy.data(), data);
+    }
+
+    EXPECT_THROW(static_cast<void>(original.at(3)), std::out_of_range);
+    EXPECT_THROW(original.set(3, "x"), std::out_of_range);
+}
+
+TEST(SharingCowVector, TestEditClear)
+{
+    yadej::Vector<int> values;
+    for(int i=0; i < 100; ++i)
+        values.push_back(i);
+    const int* buffer = values.data();
+    // The vector buffer is taken as it is
+    yadej::CowVector<int> shared(std::move(values));
+    EXPECT_EQ(shared.data(), buffer);
+
+    yadej::CowVector<int> snapshot = shared;
+    yadej::Vector<int>& edited = shared.edit();
+    for(int& value : edited)
+        value *= 2;
+    edited.erase(edited.begin(), edited.begin() + 50);
+    EXPECT_EQ(shared.size(), 50);
+    EXPECT_EQ(shared[0], 100);
+    EXPECT_EQ(snapshot.size(), 100);
+    EXPECT_EQ(snapshot.data(), buffer);
+
+    int sum = 0;
+    for(int value : snapshot)
+        sum += value;
+    EXPECT_EQ(sum, 4950);
+
+    yadej::CowVector<int> other = snapshot;
+    other.clear();
+    EXPECT_TRUE(other.empty());
+    EXPECT_EQ(snapshot.use_count(), 1);
+    other.emplace_back(7);
+    EXPECT_EQ(other[0], 7);
+
+    yadej::CowVector<int> empty;
+    EXPECT_EQ(empty.use_count(), 0);
+    EXPECT_EQ(empty.begin(), empty.end());
+    swap(empty, other);
+    EXPECT_EQ(empty.size(), 1);
+    EXPECT_TRUE(other.empty());
+}
+
+TEST(SharingCowVector, TestAllocator)
+{
+    std::pmr::monotonic_buffer_resource resource;
+    using PmrCow = yadej::CowVector<int, std::pmr::polymorphic_allocator<int>>;
+    PmrCow values(3, 1, &resource);
+    PmrCow copy = values;
+    copy.push_back(2);
+    EXPECT_EQ(copy.get_allocator().resource(), &resource);
+    EXPECT_EQ(copy.edit().get_allocator().resource(), &resource);
+    EXPECT_EQ(values.size(), 3);
+}
+
+TEST(AtomicCowVector, TestPublish)
+{
+    yadej::AtomicCowVector<int> slot;
+    EXPECT_TRUE(slot.load().empty());
+
+    slot.store(yadej::CowVector<int>{1, 2, 3});
+    yadej::CowVector<int> first = slot.load();
+    EXPECT_EQ(first.size(), 3);
+    EXPECT_EQ(first.use_count(), 2);
+
+    yadej::CowVector<int> next = first;
+    next.push_back(4);
+    yadej::CowVector<int> previous = slot.exchange(std::move(next));
+    EXPECT_EQ(previous.data(), first.data());
+    EXPECT_EQ(slot.load().size(), 4);
+    EXPECT_EQ(first.use_count(), 2);
+
+    // Republishing a buffer still held elsewhere
+    slot.store(first);
+    EXPECT_EQ(slot.load().data(), first.data());
+}
+
+TEST(AtomicCowVector, TestConcurrentReaders)
+{
+    // Every version holds size copies of its version number
+    constexpr int versions = 2000;
+    auto make_version = [](int version){
+        return yadej::CowVector<int>(static_cast<std::size_t>(version % 64 + 1), version);
+    };
+    yadej::AtomicCowVector<int> slot(make_version(0));
+    std::atomic<bool> done{false};
+    std::atomic<int> errors{0};
+
+    std::vector<std::thread> readers;
+    for(int t=0; t < 4; ++t){
+        readers.emplace_back([&]{
+            int last = 0;
+            while( !done.load(std::memory_order_acquire)){
+                const yadej::CowVector<int> snapshot = slot.load();
+                const int version = snapshot[0];
+                if( version < last || snapshot.size() != static_cast<std::size_t>(version % 64 + 1))
+                    ++errors;
+                for(int value : snapshot)
+                    if( value != version)
+                        ++errors;
+                last = version;
+            }
+        });
+    }
+    yadej::CowVector<int> kept;
+    for(int version=1; version <= versions; ++version){
+        slot.store(make_version(version));
+        // Now and then an old version comes back, with the same buffer
+        if( version % 100 == 0){
+            kept = slot.load();
+            slot.store(make_version(version + 1));
+            slot.store(kept);
+        }
+    }
+    done.store(true, std::memory_order_release);
+    for(std::thread& reader : readers)
+        reader.join();
+    EXPECT_EQ(errors.load(), 0);
+    EXPECT_EQ(slot.load()[0], versions);
+    // The slot and the temporary, every pending load gave its count back
+    kept.clear();
+    EXPECT_EQ(slot.load().use_count(), 2);
+}
+
+
+int main(int argc, char **argv)
+{
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
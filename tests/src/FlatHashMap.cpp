@@ -0,0 +1,143 @@
+#include "exerciceCPP/containers/FlatHashMap.hpp"
+#include "exerciceCPP/memory/PoolAllocator.hpp"
+#include <gtest/gtest.h>
+#include <cstddef>
+#include <cstdint>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <unordered_map>
+#include <utility>
+
+static_assert(yadej::is_trivially_relocatable_v<std::pair<const int, double>>);
+static_assert(!yadej::is_trivially_relocatable_v<std::pair<const int, std::string>>);
+
+// Every key in the same group, to exercise long probe sequences
+struct BadHash {
+    std::size_t operator()(int key) const noexcept{ return static_cast<std::size_t>(key % 3); }
+};
+
+TEST(LookupFlatHashMap, TestInsertFind)
+{
+    yadej::FlatHashMap<std::string, int> map = {{"a", 1}, {"b", 2}, {"a", 3}};
+    EXPECT_EQ(map.size(), 2);
+    EXPECT_EQ(map.at("a"), 1);
+    EXPECT_THROW(static_cast<void>(map.at("c")), std::out_of_range);
+
+    EXPECT_TRUE(map.try_emplace("c", 3).second);
+    EXPECT_FALSE(map.insert({"c", 4}).second);
+    map["d"] = 4;
+    ++map["a"];
+    EXPECT_EQ(map.size(), 4);
+    EXPECT_EQ(map.at("a"), 2);
+    EXPECT_EQ(map.find("c")->second, 3);
+    EXPECT_EQ(map.find("e"), map.end());
+    EXPECT_TRUE(map.contains("d"));
+    EXPECT_EQ(map.count("e"), 0);
+
+    int sum = 0;
+    for(const auto& [key, value] : map)
+        sum += value;
+    EXPECT_EQ(sum, 2 + 2 + 3 + 4);
+
+    const yadej::FlatHashMap<std::string, int> copy = map;
+    EXPECT_EQ(copy.size(), 4);
+    EXPECT_EQ(copy.at("d"), 4);
+    yadej::FlatHashMap<std::string, int> moved = std::move(map);
+    EXPECT_EQ(moved.size(), 4);
+    EXPECT_TRUE(map.empty());
+    EXPECT_EQ(map.begin(), map.end());
+}
+
+TEST(LookupFlatHashMap, TestAgainstUnorderedMap)
+{
+    std::mt19937 random(3);
+    yadej::FlatHashMap<std::uint64_t, std::string> map;
+    std::unordered_map<std::uint64_t, std::string> model;
+    for(int step=0; step < 200000; ++step){
+        const std::uint64_t key = random() % 5000;
+        switch( random() % 4){
+        case 0:
+        case 1:
+            EXPECT_EQ(map.try_emplace(key, std::to_string(step)).second,
+                      model.try_emplace(key, std::to_string(step)).second);
+            break;
+        case 2:
+            EXPECT_EQ(map.erase(key), model.erase(key));
+            break;
+        default:
+            EXPECT_EQ(map.contains(key), model.contains(key));
+            if( model.contains(key)){
+                EXPECT_EQ(map.at(key), model.at(key));
+            }
+        }
+    }
+    ASSERT_EQ(map.size(), model.size());
+    std::size_t seen = 0;
+    for(const auto& [key, value] : map){
+        EXPECT_EQ(model.at(key), value);
+        ++seen;
+    }
+    EXPECT_EQ(seen, model.size());
+    EXPECT_LE(map.load_factor(), map.max_load_factor());
+}
+
+TEST(ModifyFlatHashMap, TestEraseAndReuse)
+{
+    yadej::FlatHashMap<int, int> map;
+    map.reserve(1000);
+    const std::size_t capacity = map.capacity();
+    EXPECT_GE(capacity, 1000);
+    // Deleted slots are cleaned, the table does not grow
+    for(int round=0; round < 100; ++round){
+        for(int i=0; i < 1000; ++i)
+            map.try_emplace(round * 1000 + i, i);
+        for(auto it = map.begin(); it != map.end(); )
+            it = map.erase(it);
+    }
+    EXPECT_TRUE(map.empty());
+    EXPECT_EQ(map.capacity(), capacity);
+
+    map.try_emplace(1, 1);
+    map.clear();
+    EXPECT_TRUE(map.empty());
+    EXPECT_EQ(map.capacity(), capacity);
+}
+
+TEST(ModifyFlatHashMap, TestCollisionsAndLoadFactor)
+{
+    yadej::FlatHashMap<int, int, BadHash> map;
+    for(int i=0; i < 300; ++i)
+        map.try_emplace(i, -i);
+    for(int i=0; i < 300; i += 2)
+        EXPECT_EQ(map.erase(i), 1);
+    for(int i=0; i < 300; ++i)
+        EXPECT_EQ(map.contains(i), i % 2 == 1);
+
+    map.max_load_factor(0.5f);
+    EXPECT_LE(map.load_factor(), 0.5f);
+    for(int i=1; i < 300; i += 2)
+        EXPECT_EQ(map.at(i), -i);
+    EXPECT_THROW(map.max_load_factor(1.0f), std::invalid_argument);
+    EXPECT_THROW(map.max_load_factor(0.0f), std::invalid_argument);
+}
+
+TEST(AllocatorFlatHashMap, TestPoolAllocator)
+{
+    using Pooled = yadej::FlatHashMap<int, std::string, std::hash<int>, std::equal_to<int>,
+                                      yadej::PoolAllocator<std::pair<const int, std::string>>>;
+    Pooled map;
+    for(int i=0; i < 500; ++i)
+        map.try_emplace(i, std::to_string(i));
+    Pooled copy;
+    copy = map;
+    for(int i=0; i < 500; ++i)
+        EXPECT_EQ(copy.at(i), std::to_string(i));
+}
+
+
+int main(int argc, char **argv)
+{
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -0,0 +1,156 @@
+#include "exerciceCPP/containers/FlatMap.hpp"
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <cstddef>
+#include <functional>
+#include <map>
+#include <random>
+#include <set>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+TEST(SearchFlatMap, TestBranchlessLowerBound)
+{
+    std::vector<int> keys;
+    for(int count=0; count < 70; ++count){
+        for(int key=-1; key <= 2 * count + 1; ++key){
+            const auto expected = static_cast<std::size_t>(std::lower_bound(keys.begin(), keys.end(), key) - keys.begin());
+            ASSERT_EQ(yadej::branchless_lower_bound(keys.data(), keys.size(), key, std::less<int>()), expected);
+        }
+        keys.push_back(2 * count);
+    }
+}
+
+TEST(BuildFlatMap, TestSortAndDedupe)
+{
+    yadej::FlatMap<int, std::string> map = {{3, "c"}, {1, "a"}, {2, "b"}, {1, "z"}};
+    EXPECT_EQ(map.size(), 3);
+    EXPECT_EQ(map.at(1), "a");
+    EXPECT_EQ(map.at(3), "c");
+    EXPECT_TRUE(std::is_sorted(map.keys().begin(), map.keys().end()));
+    EXPECT_THROW(static_cast<void>(map.at(4)), std::out_of_range);
+
+    yadej::FlatMap<int, int> columns(yadej::Vector<int>{5, 4, 5}, yadej::Vector<int>{50, 40, 0});
+    EXPECT_EQ(columns.size(), 2);
+    EXPECT_EQ(columns.at(5), 50);
+    EXPECT_THROW((yadej::FlatMap<int, int>(yadej::Vector<int>{1}, yadej::Vector<int>{})), std::length_error);
+
+    const yadej::FlatMap<int, int> sorted(yadej::sorted_unique, yadej::Vector<int>{1, 2}, yadej::Vector<int>{10, 20});
+    EXPECT_EQ(sorted.at(2), 20);
+    int expected = 1;
+    for(const auto& [key, value] : sorted){
+        EXPECT_EQ(key, expected);
+        EXPECT_EQ(value, 10 * expected);
+        ++expected;
+    }
+}
+
+TEST(ModifyFlatMap, TestIntegralKeys)
+{
+    // operator[] only takes keys, whatever their integral type
+    yadej::FlatMap<int, std::string> names;
+    names[std::size_t{20}] = "twenty";
+    EXPECT_EQ(names.size(), 1);
+    EXPECT_EQ(names.at(20), "twenty");
+
+    yadej::FlatMap<std::size_t, int> sizes;
+    sizes[std::size_t{3}] = 3;
+    sizes[3] += 1;
+    EXPECT_EQ(sizes.at(3), 4);
+
+    yadej::FlatMap<long, int> longs;
+    longs[5] = 5;
+    EXPECT_EQ((*longs.begin()).first, 5);
+}
+
+TEST(ModifyFlatMap, TestInsertErase)
+{
+    yadej::FlatMap<std::string, int> map;
+    EXPECT_TRUE(map.try_emplace("b", 2).second);
+    EXPECT_TRUE(map.insert({"a", 1}).second);
+    EXPECT_FALSE(map.insert({"a", 5}).second);
+    map["c"] = 3;
+    ++map["a"];
+    EXPECT_EQ(map.size(), 3);
+    EXPECT_EQ(map.at("a"), 2);
+    EXPECT_EQ((*map.find("c")).second, 3);
+    EXPECT_EQ(map.find("d"), map.end());
+    EXPECT_EQ(map.lower_bound("bb").index(), 2);
+    EXPECT_EQ(map.erase("b"), 1);
+    EXPECT_EQ(map.erase("b"), 0);
+    EXPECT_FALSE(map.contains("b"));
+    EXPECT_EQ(map.count("c"), 1);
+    map.erase(map.find("a"));
+    EXPECT_EQ(map.size(), 1);
+    EXPECT_EQ(map.keys().front(), "c");
+}
+
+TEST(ModifyFlatMap, TestInsertBatch)
+{
+    std::mt19937 random(7);
+    yadej::FlatMap<int, int> map;
+    std::map<int, int> model;
+    for(int round=0; round < 50; ++round){
+        std::vector<std::pair<int, int>> batch;
+        for(int i=0; i < 100; ++i)
+            batch.emplace_back(static_cast<int>(random() % 2000), round);
+        if( round % 2 == 0){
+            map.insert_batch(batch);
+        } else {
+            std::sort(batch.begin(), batch.end());
+            batch.erase(std::unique(batch.begin(), batch.end(),
+                [](const auto& l_arg, const auto& r_arg){ return l_arg.first == r_arg.first; }), batch.end());
+            map.insert_batch(yadej::sorted_unique, batch);
+        }
+        for(const auto& [key, value] : batch)
+            model.emplace(key, value);
+    }
+    ASSERT_EQ(map.size(), model.size());
+    std::size_t position = 0;
+    for(const auto& [key, value] : model){
+        EXPECT_EQ(map.keys()[position], key);
+        EXPECT_EQ(map.values()[position], value);
+        ++position;
+    }
+}
+
+TEST(FlatSetTest, TestSet)
+{
+    yadej::FlatSet<int> set = {5, 1, 3, 1};
+    EXPECT_EQ(set.size(), 3);
+    EXPECT_TRUE(set.contains(3));
+    EXPECT_FALSE(set.contains(2));
+    EXPECT_EQ(*set.find(5), 5);
+    EXPECT_EQ(set.find(4), set.end());
+    EXPECT_EQ(*set.lower_bound(2), 3);
+
+    EXPECT_TRUE(set.insert(2).second);
+    EXPECT_FALSE(set.insert(3).second);
+    set.insert_batch(std::vector<int>{9, 0, 5, 7, 0});
+    set.insert_batch(yadej::sorted_unique, std::vector<int>{4, 6, 8});
+    EXPECT_EQ(set.erase(7), 1);
+    EXPECT_EQ(set.erase(7), 0);
+    const std::vector<int> expected = {0, 1, 2, 3, 4, 5, 6, 8, 9};
+    EXPECT_TRUE(std::equal(set.begin(), set.end(), expected.begin(), expected.end()));
+
+    const yadej::FlatSet<std::string, std::greater<std::string>> names(yadej::from_range, std::set<std::string>{"a", "b"});
+    EXPECT_EQ(names[0], "b");
+
+    // Same length keys are equal, the first one is kept
+    const auto by_length = [](const std::string& l_arg, const std::string& r_arg){ return l_arg.size() < r_arg.size(); };
+    const yadej::FlatSet<std::string, decltype(by_length)> lengths({"ccc", "b", "aaa", "dd", "a", "bbb", "e", "ff"}, by_length);
+    ASSERT_EQ(lengths.size(), 3);
+    EXPECT_EQ(lengths[0], "b");
+    EXPECT_EQ(lengths[1], "dd");
+    EXPECT_EQ(lengths[2], "ccc");
+    EXPECT_TRUE(names == (yadej::FlatSet<std::string, std::greater<std::string>>{"a", "b"}));
+}
+
+
+int main(int argc, char **argv)
+{
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -0,0 +1,71 @@
+#include "exerciceCPP/memory/HugePageAllocator.hpp"
+#include "exerciceCPP/containers/Vector.hpp"
+#include <gtest/gtest.h>
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <string>
+#include <type_traits>
+
+static_assert(std::is_same_v<std::allocator_traits<yadej::HugePageAllocator<int>>::rebind_alloc<char>,
+                             yadej::HugePageAllocator<char>>);
+
+template<class T>
+bool is_aligned(const T* pointer, std::size_t alignment){
+    return reinterpret_cast<std::uintptr_t>(pointer) % alignment == 0;
+}
+
+TEST(AllocateHugePageAllocator, TestThreshold)
+{
+    yadej::HugePageAllocator<std::uint64_t> allocator;
+
+    // Under the threshold, a plain heap block
+    std::uint64_t* small = allocator.allocate(16);
+    small[15] = 42;
+    EXPECT_EQ(small[15], 42);
+    allocator.deallocate(small, 16);
+
+    // At the threshold and above, a mapping aligned on a huge page
+    for(std::size_t count : {yadej::huge_page_size / 8, yadej::huge_page_size / 8 + 1, yadej::huge_page_size}){
+        std::uint64_t* big = allocator.allocate(count);
+        EXPECT_TRUE(is_aligned(big, yadej::huge_page_size));
+        big[0] = 1;
+        big[count - 1] = 2;
+        EXPECT_EQ(big[0] + big[count - 1], 3);
+        allocator.deallocate(big, count);
+    }
+
+    EXPECT_THROW(static_cast<void>(allocator.allocate(std::numeric_limits<std::size_t>::max() / 4)),
+                 std::bad_array_new_length);
+}
+
+TEST(VectorHugePageAllocator, TestGrowth)
+{
+    // A low threshold so that the vector crosses it while growing
+    yadej::Vector<std::uint32_t, yadej::HugePageAllocator<std::uint32_t, 4096>> values;
+    for(std::uint32_t i=0; i < 1000000; ++i){
+        values.push_back(i);
+        if( values.capacity() * sizeof(std::uint32_t) >= 4096)
+            ASSERT_TRUE(is_aligned(values.data(), yadej::huge_page_size));
+    }
+    for(std::uint32_t i=0; i < values.size(); i += 997)
+        ASSERT_EQ(values[i], i);
+
+    auto copy = values;
+    EXPECT_EQ(copy[999999], 999999);
+    values.shrink_to_fit();
+    EXPECT_EQ(values.size(), 1000000);
+    values.clear();
+    EXPECT_EQ(copy.size(), 1000000);
+
+    yadej::Vector<std::string, yadej::HugePageAllocator<std::string>> strings(3, "edge");
+    strings.emplace_back(40, 'x');
+    EXPECT_EQ(strings[3].size(), 40);
+}
+
+
+int main(int argc, char **argv)
+{
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
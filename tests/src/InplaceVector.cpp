@@ -0,0 +1,95 @@
+#include "exerciceCPP/containers/InplaceVector.hpp"
+#include <gtest/gtest.h>
+#include "InsertRollback.hpp"
+#include <cstddef>
+#include <iterator>
+#include <new>
+#include <stdexcept>
+#include <string>
+
+constexpr int constexpr_sum(){
+    yadej::InplaceVector<int, 8> vec = {1, 2, 3};
+    vec.push_back(4);
+    vec.insert(vec.begin(), 0);
+    vec.erase(vec.begin() + 2);
+    int sum = 0;
+    for(auto it = vec.begin(); it != vec.end(); ++it)
+        sum += *it;
+    return sum;
+}
+
+constexpr bool constexpr_overflow(){
+    yadej::InplaceVector<int, 2> vec;
+    vec.try_push_back(1);
+    vec.try_push_back(2);
+    return vec.try_push_back(3) == nullptr && vec.size() == 2;
+}
+
+static_assert(constexpr_sum() == 8);
+static_assert(constexpr_overflow());
+
+TEST(ConstructorsInplaceVector, CheckValues)
+{
+    yadej::InplaceVector<int, 4> vec;
+    EXPECT_TRUE(vec.empty());
+    EXPECT_EQ(vec.capacity(), 4);
+
+    yadej::InplaceVector<int, 4> count(3, 7);
+    ASSERT_EQ(count.size(), 3);
+    EXPECT_EQ(count[2], 7);
+
+    yadej::InplaceVector<std::string, 4> strings = {"a", "b"};
+    yadej::InplaceVector<std::string, 4> copy(strings);
+    EXPECT_EQ(copy[1], "b");
+    yadej::InplaceVector<std::string, 4> moved(std::move(copy));
+    EXPECT_EQ(moved[0], "a");
+    EXPECT_TRUE(copy.empty());
+
+    EXPECT_THROW((yadej::InplaceVector<int, 4>(5)), std::bad_alloc);
+}
+
+TEST(OverflowInplaceVector, TestTryPushBack)
+{
+    yadej::InplaceVector<std::string, 2> vec;
+    std::string* first = vec.try_push_back("first");
+    ASSERT_NE(first, nullptr);
+    EXPECT_EQ(*first, "first");
+    EXPECT_NE(vec.try_emplace_back(3, 'x'), nullptr);
+    EXPECT_EQ(vec.try_emplace_back(3, 'y'), nullptr);
+    EXPECT_EQ(vec.try_push_back("third"), nullptr);
+    EXPECT_EQ(vec.size(), 2);
+    EXPECT_EQ(vec.back(), "xxx");
+
+    EXPECT_THROW(vec.push_back("third"), std::bad_alloc);
+    EXPECT_THROW(vec.insert(vec.begin(), "third"), std::bad_alloc);
+    EXPECT_EQ(vec.size(), 2);
+}
+
+TEST(InsertEraseInplaceVector, TestPosition)
+{
+    yadej::InplaceVector<std::string, 8> vec = {"a", "d"};
+    vec.insert(vec.begin() + 1, "b");
+    vec.emplace(vec.begin() + 2, 1, 'c');
+    vec.insert(vec.end(), 2, "e");
+    ASSERT_EQ(vec.size(), 6);
+    EXPECT_EQ(vec[2], "c");
+    EXPECT_EQ(vec[5], "e");
+
+    vec.erase(vec.begin());
+    vec.erase(vec.begin() + 2, vec.end());
+    ASSERT_EQ(vec.size(), 2);
+    EXPECT_EQ(vec.front(), "b");
+    EXPECT_EQ(vec.back(), "c");
+    vec.resize(4, "z");
+    EXPECT_EQ(vec[3], "z");
+}
+
+
+using InsertRollbackInplaceVector = ::testing::Types<yadej::InplaceVector<Fragile, 16>>;
+INSTANTIATE_TYPED_TEST_SUITE_P(InplaceVector, InsertRollback, InsertRollbackInplaceVector);
+
+int main(int argc, char **argv)
+{
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
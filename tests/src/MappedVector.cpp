@@ -0,0 +1,83 @@
+#include "exerciceCPP/containers/MappedVector.hpp"
+#include <gtest/gtest.h>
+#include "TempFile.hpp"
+#include <cstdint>
+#include <filesystem>
+#include <numeric>
+#include <stdexcept>
+#include <string>
+
+class MappedVectorFile : public TempFileTest {};
+
+TEST_F(MappedVectorFile, TestGrowAndReopen)
+{
+    {
+        yadej::MappedVector<Sample> vec(m_path);
+        EXPECT_TRUE(vec.empty());
+        for(std::uint64_t i=0; i < 10000; ++i)
+            vec.push_back(Sample{i, i * 0.5});
+        EXPECT_GE(vec.capacity(), 10000);
+        EXPECT_EQ(vec[9999].timestamp, 9999);
+        vec.flush();
+    }
+    // Truncated to the size on close, the file is the raw array
+    EXPECT_EQ(std::filesystem::file_size(m_path), 10000 * sizeof(Sample));
+
+    yadej::MappedVector<Sample> reopened(m_path, yadej::MapMode::read_only);
+    ASSERT_EQ(reopened.size(), 10000);
+    EXPECT_EQ(reopened.capacity(), 10000);
+    EXPECT_DOUBLE_EQ(reopened.back().value, 4999.5);
+    EXPECT_TRUE(reopened.advise(yadej::MapAdvice::sequential));
+    std::uint64_t sum = 0;
+    for(const Sample& sample : reopened)
+        sum += sample.timestamp;
+    EXPECT_EQ(sum, 9999ULL * 10000 / 2);
+    EXPECT_THROW(reopened.push_back(Sample{}), std::logic_error);
+    EXPECT_THROW(reopened.clear(), std::logic_error);
+    EXPECT_EQ(reopened.size(), 10000);
+}
+
+TEST_F(MappedVectorFile, TestInsertErase)
+{
+    yadej::MappedVector<int> vec(m_path);
+    vec.resize(4, 7);
+    vec.insert(vec.begin() + 1, 1);
+    int values[] = {2, 3};
+    vec.insert(vec.end(), values, values + 2);
+    ASSERT_EQ(vec.size(), 7);
+    EXPECT_EQ(vec[1], 1);
+    EXPECT_EQ(vec.back(), 3);
+
+    vec.erase(vec.begin());
+    vec.erase(vec.begin() + 1, vec.begin() + 4);
+    ASSERT_EQ(vec.size(), 3);
+    EXPECT_EQ(vec[0], 1);
+    EXPECT_EQ(vec[1], 2);
+    EXPECT_THROW(vec.at(3), std::out_of_range);
+
+    vec.shrink_to_fit();
+    EXPECT_EQ(vec.capacity(), 3);
+    EXPECT_EQ(std::filesystem::file_size(m_path), 3 * sizeof(int));
+    vec.advise(yadej::MapAdvice::willneed);
+
+    yadej::MappedVector<int> moved(std::move(vec));
+    EXPECT_EQ(moved.size(), 3);
+    EXPECT_EQ(moved[2], 3);
+}
+
+TEST_F(MappedVectorFile, TestBadFile)
+{
+    {
+        yadej::MappedVector<char> bytes(m_path);
+        bytes.resize(3, 'x');
+    }
+    EXPECT_THROW(yadej::MappedVector<int>{m_path}, std::length_error);
+    EXPECT_THROW((yadej::MappedVector<int>(m_path.string() + ".missing", yadej::MapMode::read_only)), std::system_error);
+}
+
+
+int main(int argc, char **argv)
+{
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -0,0 +1,133 @@
+#include "exerciceCPP/parallel/Algorithms.hpp"
+#include "exerciceCPP/parallel/ThreadPool.hpp"
+#include "exerciceCPP/containers/Vector.hpp"
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <numeric>
+#include <span>
+#include <stdexcept>
+
+// Big enough to go past serial_threshold and be cut in many chunks
+constexpr std::size_t big_size = 1 << 20;
+
+yadej::Vector<std::uint64_t> make_values(std::size_t count){
+    yadej::Vector<std::uint64_t> values;
+    values.resize_for_overwrite(count);
+    std::uint64_t state = 12345;
+    for(std::uint64_t& value : values){
+        state = state * 6364136223846793005ULL + 1442695040888963407ULL;
+        value = state >> 40;
+    }
+    return values;
+}
+
+TEST(ThreadPoolParallel, TestTaskGroup)
+{
+    yadej::parallel::ThreadPool pool(4);
+    EXPECT_EQ(pool.size(), 4);
+    std::atomic<int> sum{0};
+    {
+        yadej::parallel::TaskGroup group(pool);
+        for(int i=1; i <= 100; ++i)
+            group.run([&sum, i]{ sum += i; });
+        group.wait();
+    }
+    EXPECT_EQ(sum, 5050);
+
+    // Nested groups wait by running tasks, they do not block the workers
+    std::atomic<int> nested{0};
+    yadej::parallel::TaskGroup outer(pool);
+    for(int i=0; i < 8; ++i){
+        outer.run([&]{
+            yadej::parallel::TaskGroup inner(pool);
+            for(int j=0; j < 8; ++j)
+                inner.run([&]{ ++nested; });
+            inner.wait();
+        });
+    }
+    outer.wait();
+    EXPECT_EQ(nested, 64);
+
+    yadej::parallel::TaskGroup failing(pool);
+    failing.run([]{ throw std::runtime_error("task failed"); });
+    failing.run([]{});
+    EXPECT_THROW(failing.wait(), std::runtime_error);
+}
+
+TEST(AlgorithmsParallel, TestForEachTransformReduce)
+{
+    yadej::parallel::ThreadPool pool(4);
+    yadej::Vector<std::uint64_t> values = make_values(big_size);
+    const std::uint64_t expected = std::accumulate(values.begin(), values.end(), std::uint64_t{0});
+    EXPECT_EQ(yadej::parallel::reduce(pool, values, std::uint64_t{0}), expected);
+
+    yadej::parallel::for_each(pool, values, [](std::uint64_t& value){ value *= 2; });
+    EXPECT_EQ(yadej::parallel::reduce(pool, values, std::uint64_t{0}), expected * 2);
+
+    yadej::Vector<double> halves(big_size);
+    yadej::parallel::transform(pool, values, halves, [](std::uint64_t value){ return static_cast<double>(value) / 2; });
+    EXPECT_DOUBLE_EQ(halves[777], static_cast<double>(values[777]) / 2);
+    EXPECT_THROW(yadej::parallel::transform(pool, values, std::span<double>(halves).first(10),
+                                            [](std::uint64_t value){ return static_cast<double>(value); }),
+                 std::length_error);
+
+    // The first chunk runs on the calling thread, the queued ones are waited for before the throw leaves
+    std::atomic<std::size_t> visited{0};
+    EXPECT_THROW(yadej::parallel::for_each(pool, values, [&](std::uint64_t& value){
+                     if( &value == values.data())
+                         throw std::runtime_error("first element");
+                     visited.fetch_add(1, std::memory_order_relaxed);
+                 }),
+                 std::runtime_error);
+    EXPECT_GE(visited.load(), big_size / 2);
+
+    // Small ranges run serially on the default pool
+    yadej::Vector<int> small = {1, 2, 3};
+    EXPECT_EQ(yadej::parallel::reduce(small, 10), 16);
+    EXPECT_EQ(yadej::parallel::reduce(yadej::Vector<int>{}, 7), 7);
+}
+
+TEST(AlgorithmsParallel, TestSort)
+{
+    yadej::parallel::ThreadPool pool(4);
+    yadej::Vector<std::uint64_t> values = make_values(big_size + 12345);
+    yadej::Vector<std::uint64_t> expected(values);
+    std::sort(expected.begin(), expected.end());
+    yadej::parallel::sort(pool, values);
+    EXPECT_TRUE(std::equal(values.begin(), values.end(), expected.begin()));
+
+    yadej::parallel::sort(pool, values, std::greater<>{});
+    EXPECT_TRUE(std::is_sorted(values.begin(), values.end(), std::greater<>{}));
+}
+
+TEST(AlgorithmsParallel, TestScanAndCopyIf)
+{
+    yadej::parallel::ThreadPool pool(4);
+    yadej::Vector<std::uint64_t> values = make_values(big_size);
+    yadej::Vector<std::uint64_t> expected(big_size);
+    std::inclusive_scan(values.begin(), values.end(), expected.begin());
+
+    yadej::Vector<std::uint64_t> scanned(big_size);
+    yadej::parallel::inclusive_scan(pool, values, scanned);
+    EXPECT_TRUE(std::equal(scanned.begin(), scanned.end(), expected.begin()));
+    // In place
+    yadej::parallel::inclusive_scan(pool, values, values);
+    EXPECT_EQ(values[big_size - 1], expected[big_size - 1]);
+    EXPECT_EQ(values[4321], expected[4321]);
+
+    yadej::Vector<std::uint64_t> odd(big_size);
+    const std::size_t kept = yadej::parallel::copy_if(pool, expected, odd, [](std::uint64_t value){ return value % 2 == 1; });
+    yadej::Vector<std::uint64_t> serial(big_size);
+    auto serial_end = std::copy_if(expected.begin(), expected.end(), serial.begin(), [](std::uint64_t value){ return value % 2 == 1; });
+    ASSERT_EQ(kept, static_cast<std::size_t>(serial_end - serial.begin()));
+    EXPECT_TRUE(std::equal(odd.begin(), odd.begin() + static_cast<std::ptrdiff_t>(kept), serial.begin()));
+}
+
+
+int main(int argc, char **argv)
+{
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -0,0 +1,231 @@
+#include "exerciceCPP/containers/PersistentVector.hpp"
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <cstddef>
+#include <iterator>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+static_assert(std::random_access_iterator<yadej::PersistentVector<int>::const_iterator>);
+
+// Live instances, to check that every element is destroyed once
+struct Counted {
+    static inline int live = 0;
+
+    Counted(int v = 0): value(v){ ++live; }
+    Counted(const Counted& other): value(other.value){ ++live; }
+    Counted& operator=(const Counted&) = default;
+    ~Counted(){ --live; }
+
+    int value;
+};
+
+TEST(VersionsPersistentVector, TestPushSetPop)
+{
+    const yadej::PersistentVector<std::string> empty;
+    const yadej::PersistentVector<std::string> one = empty.push_back("a");
+    const yadej::PersistentVector<std::string> two = one.push_back("b");
+    const yadej::PersistentVector<std::string> changed = two.set(0, "A");
+    const yadej::PersistentVector<std::string> popped = changed.pop_back();
+
+    EXPECT_TRUE(empty.empty());
+    EXPECT_EQ(one.size(), 1);
+    EXPECT_EQ(one[0], "a");
+    EXPECT_EQ(two.size(), 2);
+    EXPECT_EQ(two[0], "a");
+    EXPECT_EQ(two.back(), "b");
+    EXPECT_EQ(changed[0], "A");
+    EXPECT_EQ(changed[1], "b");
+    EXPECT_EQ(popped.size(), 1);
+    EXPECT_EQ(popped.front(), "A");
+    EXPECT_TRUE(popped.pop_back().empty());
+    EXPECT_TRUE(empty.pop_back().empty());
+
+    EXPECT_THROW(static_cast<void>(two.at(2)), std::out_of_range);
+    EXPECT_THROW(static_cast<void>(two.set(2, "c")), std::out_of_range);
+}
+
+TEST(VersionsPersistentVector, TestStructuralSharing)
+{
+    yadej::PersistentVector<int> base;
+    for(int i=0; i < 5000; ++i)
+        base = std::move(base).push_back(i);
+
+    const yadej::PersistentVector<int> changed = base.set(100, -1);
+    EXPECT_EQ(base[100], 100);
+    EXPECT_EQ(changed[100], -1);
+    // Only the leaf of 100 and the path to it are copied
+    EXPECT_NE(base.leaf_data(100), changed.leaf_data(100));
+    EXPECT_EQ(base.leaf_data(0), changed.leaf_data(0));
+    EXPECT_EQ(base.leaf_data(4000), changed.leaf_data(4000));
+
+    const yadej::PersistentVector<int> longer = base.push_back(5000);
+    EXPECT_EQ(base.leaf_data(2000), longer.leaf_data(2000));
+    EXPECT_EQ(base.size(), 5000);
+    EXPECT_EQ(longer.size(), 5001);
+
+    // A unique version is written in place
+    yadej::PersistentVector<int> unique = changed;
+    unique = changed.set(200, -2);
+    const int* leaf = unique.leaf_data(200);
+    unique = std::move(unique).set(201, -3);
+    EXPECT_EQ(unique.leaf_data(200), leaf);
+    EXPECT_EQ(unique[200], -2);
+    EXPECT_EQ(unique[201], -3);
+    EXPECT_EQ(changed[201], 201);
+}
+
+TEST(VersionsPersistentVector, TestLevels)
+{
+    // Three levels of inner nodes, then back to a lone tail
+    const std::size_t count = 32 * 32 * 32 + 33;
+    yadej::PersistentVector<int> vector;
+    std::vector<yadej::PersistentVector<int>> versions;
+    for(std::size_t i=0; i < count; ++i){
+        vector = std::move(vector).push_back(static_cast<int>(i));
+        if( i % 1000 == 0)
+            versions.push_back(vector);
+    }
+    ASSERT_EQ(vector.size(), count);
+    for(std::size_t i=0; i < count; ++i)
+        ASSERT_EQ(vector[i], static_cast<int>(i));
+
+    while( !vector.empty()){
+        vector = vector.pop_back();
+        if( !vector.empty())
+            ASSERT_EQ(vector.back(), static_cast<int>(vector.size() - 1));
+    }
+    for(std::size_t v=0; v < versions.size(); ++v){
+        ASSERT_EQ(versions[v].size(), v * 1000 + 1);
+        for(std::size_t i=0; i < versions[v].size(); i += 97)
+            ASSERT_EQ(versions[v][i], static_cast<int>(i));
+    }
+}
+
+TEST(VersionsPersistentVector, TestRandomVersions)
+{
+    // Random changes to random versions, against std::vector copies
+    std::mt19937 random(42);
+    std::vector<yadej::PersistentVector<Counted>> versions(1);
+    std::vector<std::vector<int>> models(1);
+    for(int step=0; step < 20000; ++step){
+        const std::size_t from = random() % versions.size();
+        yadej::PersistentVector<Counted> next = versions[from];
+        std::vector<int> model = models[from];
+        const unsigned action = random() % 8;
+        if( action < 5 || model.empty()){
+            const int count = static_cast<int>(random() % 70);
+            for(int i=0; i < count; ++i){
+                next = std::move(next).push_back(step);
+                model.push_back(step);
+            }
+        } else if( action < 7){
+            const std::size_t position = random() % model.size();
+            next = next.set(position, -step);
+            model[position] = -step;
+        } else {
+            const std::size_t count = std::min<std::size_t>(model.size(), random() % 70);
+            for(std::size_t i=0; i < count; ++i){
+                next = next.pop_back();
+                model.pop_back();
+            }
+        }
+        if( versions.size() < 64){
+            versions.push_back(std::move(next));
+            models.push_back(std::move(model));
+        } else {
+            const std::size_t replaced = random() % versions.size();
+            versions[replaced] = std::move(next);
+            models[replaced] = std::move(model);
+        }
+    }
+    for(std::size_t v=0; v < versions.size(); ++v){
+        ASSERT_EQ(versions[v].size(), models[v].size());
+        EXPECT_TRUE(std::equal(versions[v].begin(), versions[v].end(), models[v].begin(),
+                               [](const Counted& l_arg, int r_arg){ return l_arg.value == r_arg; }));
+    }
+    versions.clear();
+    EXPECT_EQ(Counted::live, 0);
+}
+
+TEST(TransientPersistentVector, TestBatch)
+{
+    const yadej::PersistentVector<int> base = {1, 2, 3};
+    auto batch = base.transient();
+    for(int i=0; i < 2000; ++i)
+        batch.push_back(i);
+    batch.set(0, 10).pop_back();
+    EXPECT_THROW(batch.set(5000, 0), std::out_of_range);
+    EXPECT_EQ(batch.size(), 2002);
+    EXPECT_EQ(batch[0], 10);
+
+    const yadej::PersistentVector<int> built = std::move(batch).persistent();
+    EXPECT_TRUE(batch.empty());
+    EXPECT_EQ(base.size(), 3);
+    EXPECT_EQ(base[0], 1);
+    EXPECT_EQ(built.size(), 2002);
+    EXPECT_EQ(built[0], 10);
+    EXPECT_EQ(built[3], 0);
+    EXPECT_EQ(built.back(), 1998);
+
+    const std::vector<int> values = {4, 5, 6};
+    const yadej::PersistentVector<int> ranged(yadej::from_range, values);
+    EXPECT_TRUE(std::equal(ranged.begin(), ranged.end(), values.begin(), values.end()));
+}
+
+TEST(IteratorPersistentVector, TestRandomAccess)
+{
+    auto batch = yadej::PersistentVector<int>().transient();
+    for(int i=0; i < 3000; ++i)
+        batch.push_back(i);
+    const yadej::PersistentVector<int> vector = std::move(batch).persistent();
+
+    int expected = 0;
+    for(int value : vector)
+        EXPECT_EQ(value, expected++);
+    EXPECT_EQ(expected, 3000);
+
+    auto it = vector.end();
+    --it;
+    EXPECT_EQ(*it, 2999);
+    it -= 1000;
+    EXPECT_EQ(*it, 1999);
+    EXPECT_EQ(it[-1999], 0);
+    EXPECT_EQ(*(it + 1000), 2999);
+    EXPECT_EQ(vector.end() - vector.begin(), 3000);
+    EXPECT_TRUE(vector.begin() < it);
+    EXPECT_EQ(*std::lower_bound(vector.begin(), vector.end(), 1234), 1234);
+    EXPECT_EQ(std::distance(vector.cbegin(), vector.cend()), 3000);
+}
+
+TEST(ThreadsPersistentVector, TestReleaseFromThreads)
+{
+    yadej::PersistentVector<std::string> base;
+    for(int i=0; i < 4000; ++i)
+        base = std::move(base).push_back(std::to_string(i));
+
+    std::vector<std::thread> threads;
+    for(int t=0; t < 4; ++t){
+        threads.emplace_back([copy = base, t]() mutable {
+            for(int i=0; i < 1000; ++i){
+                const std::size_t position = static_cast<std::size_t>(i * 4 + t);
+                yadej::PersistentVector<std::string> next = copy.set(position, "x");
+                copy = next.push_back("y").pop_back();
+            }
+        });
+    }
+    for(std::thread& thread : threads)
+        thread.join();
+    for(int i=0; i < 4000; ++i)
+        EXPECT_EQ(base[static_cast<std::size_t>(i)], std::to_string(i));
+}
+
+
+int main(int argc, char **argv)
+{
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -0,0 +1,116 @@
+#include "exerciceCPP/memory/PoolAllocator.hpp"
+#include "exerciceCPP/containers/Vector.hpp"
+#include <gtest/gtest.h>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+static_assert(yadej::pool::class_of(1) == 0);
+static_assert(yadej::pool::class_of(16) == 0);
+static_assert(yadej::pool::class_of(17) == 1);
+static_assert(yadej::pool::class_of(4096) == 8);
+static_assert(yadej::pool::class_of(yadej::pool::max_block_size) == yadej::pool::class_count - 1);
+static_assert(std::is_same_v<std::allocator_traits<yadej::PoolAllocator<int>>::rebind_alloc<char>,
+                             yadej::PoolAllocator<char>>);
+
+template<class T>
+using PoolVector = yadej::Vector<T, yadej::PoolAllocator<T>>;
+
+TEST(AllocatePoolAllocator, TestReuse)
+{
+    yadej::PoolAllocator<std::uint64_t> allocator;
+    std::uint64_t* first = allocator.allocate(8);
+    EXPECT_EQ(reinterpret_cast<std::uintptr_t>(first) % 64, 0);
+    first[7] = 7;
+    allocator.deallocate(first, 8);
+    // Last freed, first given back
+    std::uint64_t* second = allocator.allocate(7);
+    EXPECT_EQ(first, second);
+    allocator.deallocate(second, 7);
+
+    // Bigger than the classes, straight from operator new
+    std::uint64_t* big = allocator.allocate(yadej::pool::max_block_size);
+    big[yadej::pool::max_block_size - 1] = 1;
+    allocator.deallocate(big, yadej::pool::max_block_size);
+}
+
+TEST(VectorPoolAllocator, TestChurn)
+{
+    auto round = []{
+        PoolVector<int> values;
+        for(int i=0; i < 100; ++i)
+            values.push_back(i);
+        PoolVector<std::string> strings(3, "abc");
+        strings.insert(strings.begin(), "first");
+        return values[99] + static_cast<int>(strings[0].size());
+    };
+    EXPECT_EQ(round(), 104);
+    const std::size_t slabs = yadej::pool::Registry::instance().slabs();
+    for(int i=0; i < 1000; ++i)
+        ASSERT_EQ(round(), 104);
+    // Every round reuses the blocks freed by the previous one
+    EXPECT_EQ(yadej::pool::Registry::instance().slabs(), slabs);
+}
+
+TEST(ThreadsPoolAllocator, TestRemoteFree)
+{
+    constexpr int count = 1000;
+    std::vector<PoolVector<int>> made(count);
+    for(int i=0; i < count; ++i)
+        made[static_cast<std::size_t>(i)] = PoolVector<int>(10, i);
+    const int* first = made[0].data();
+
+    // Freed by another thread, the blocks come back by batches
+    std::thread([&made]{
+        made.clear();
+    }).join();
+
+    std::vector<PoolVector<int>> again(count);
+    bool reused = false;
+    for(int i=0; i < count; ++i){
+        again[static_cast<std::size_t>(i)] = PoolVector<int>(10, -i);
+        reused = reused || again[static_cast<std::size_t>(i)].data() == first;
+    }
+    EXPECT_TRUE(reused);
+    EXPECT_EQ(again[999][9], -999);
+}
+
+TEST(ThreadsPoolAllocator, TestAdoption)
+{
+    // A thread exiting leaves its cache, with its free blocks, to the next one
+    const int* freed = nullptr;
+    std::thread([&freed]{
+        PoolVector<int> values(100, 1);
+        freed = values.data();
+    }).join();
+    const int* adopted = nullptr;
+    std::thread([&adopted]{
+        PoolVector<int> values(100, 2);
+        adopted = values.data();
+    }).join();
+    EXPECT_EQ(freed, adopted);
+
+    std::vector<std::thread> threads;
+    for(int t=0; t < 4; ++t){
+        threads.emplace_back([]{
+            for(int round=0; round < 2000; ++round){
+                PoolVector<std::uint64_t> values;
+                for(std::uint64_t i=0; i < 50; ++i)
+                    values.push_back(i);
+                ASSERT_EQ(values[49], 49);
+            }
+        });
+    }
+    for(std::thread& thread : threads)
+        thread.join();
+}
+
+
+int main(int argc, char **argv)
+{
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -0,0 +1,75 @@
+#include "exerciceCPP/containers/SearchIndex.hpp"
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+TEST(LookupSearchIndex, TestEverySize)
+{
+    // Every tree shape from empty to a few full levels, duplicates included
+    yadej::Vector<int> sorted;
+    for(int count=0; count < 140; ++count){
+        const yadej::SearchIndex<int> index(sorted);
+        ASSERT_EQ(index.size(), sorted.size());
+        for(int key=-1; key <= count + 1; ++key){
+            const auto expected = static_cast<std::size_t>(std::lower_bound(sorted.begin(), sorted.end(), key) - sorted.begin());
+            ASSERT_EQ(index.lower_bound(key), expected);
+            ASSERT_EQ(index.contains(key), std::binary_search(sorted.begin(), sorted.end(), key));
+        }
+        sorted.push_back(count % 3 == 0 ? count - 1 : count);
+    }
+}
+
+TEST(LookupSearchIndex, TestBatch)
+{
+    std::mt19937 random(11);
+    std::vector<std::uint32_t> sorted(100000);
+    for(std::uint32_t& value : sorted)
+        value = random() % 1000000;
+    std::sort(sorted.begin(), sorted.end());
+    const yadej::SearchIndex<std::uint32_t> index(sorted);
+
+    std::vector<std::uint32_t> keys(1001);
+    for(std::uint32_t& key : keys)
+        key = random() % 1100000;
+    std::vector<std::size_t> positions(keys.size());
+    index.lower_bound_batch(keys, positions);
+    std::unique_ptr<bool[]> found(new bool[keys.size()]);
+    index.contains_batch(keys, std::span<bool>(found.get(), keys.size()));
+    for(std::size_t i=0; i < keys.size(); ++i){
+        const auto expected = static_cast<std::size_t>(std::lower_bound(sorted.begin(), sorted.end(), keys[i]) - sorted.begin());
+        EXPECT_EQ(positions[i], expected);
+        EXPECT_EQ(index.lower_bound(keys[i]), expected);
+        EXPECT_EQ(found[i], std::binary_search(sorted.begin(), sorted.end(), keys[i]));
+    }
+    EXPECT_THROW(index.lower_bound_batch(keys, std::span<std::size_t>(positions.data(), 3)), std::length_error);
+}
+
+TEST(LookupSearchIndex, TestCompare)
+{
+    const std::vector<std::string> sorted = {"d", "c", "b", "a"};
+    const yadej::SearchIndex<std::string, std::greater<std::string>> index(sorted);
+    EXPECT_EQ(index.lower_bound("c"), 1);
+    EXPECT_EQ(index.lower_bound("bb"), 2);
+    EXPECT_EQ(index.lower_bound("0"), 4);
+    EXPECT_TRUE(index.contains("a"));
+    EXPECT_FALSE(index.contains("e"));
+
+    const yadej::SearchIndex<int> empty;
+    EXPECT_TRUE(empty.empty());
+    EXPECT_EQ(empty.lower_bound(3), 0);
+    EXPECT_FALSE(empty.contains(3));
+}
+
+
+int main(int argc, char **argv)
+{
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -0,0 +1,93 @@
+#include "exerciceCPP/containers/SegmentedVector.hpp"
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <numeric>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+TEST(ConstructorsSegmentedVector, CheckValues)
+{
+    yadej::SegmentedVector<int, 4> vec;
+    EXPECT_TRUE(vec.empty());
+    EXPECT_EQ(vec.capacity(), 0);
+
+    yadej::SegmentedVector<int, 4> count(10, 7);
+    ASSERT_EQ(count.size(), 10);
+    EXPECT_EQ(count[9], 7);
+    EXPECT_EQ(count.capacity(), 12);
+
+    yadej::SegmentedVector<std::string, 2> strings = {"a", "b", "c"};
+    yadej::SegmentedVector<std::string, 2> copy(strings);
+    EXPECT_EQ(copy[2], "c");
+    yadej::SegmentedVector<std::string, 2> moved(std::move(copy));
+    EXPECT_EQ(moved.back(), "c");
+    EXPECT_TRUE(copy.empty());
+    copy = moved;
+    EXPECT_EQ(copy.front(), "a");
+    EXPECT_THROW(copy.at(3), std::out_of_range);
+}
+
+TEST(StableReferencesSegmentedVector, TestPushBack)
+{
+    yadej::SegmentedVector<std::string, 8> vec;
+    vec.push_back("first");
+    const std::string* first = &vec[0];
+    for(int i=0; i < 1000; ++i)
+        vec.emplace_back(std::to_string(i));
+    // Appending never moves an element
+    EXPECT_EQ(first, &vec[0]);
+    EXPECT_EQ(*first, "first");
+    EXPECT_EQ(vec[1000], "999");
+    EXPECT_EQ(vec.capacity(), 1008);
+
+    vec.resize(10);
+    EXPECT_EQ(vec.size(), 10);
+    vec.shrink_to_fit();
+    EXPECT_EQ(vec.capacity(), 16);
+    vec.pop_back();
+    EXPECT_EQ(vec.back(), "7");
+    vec.clear();
+    EXPECT_TRUE(vec.empty());
+    EXPECT_EQ(vec.capacity(), 16);
+}
+
+TEST(IteratorSegmentedVector, TestRandomAccess)
+{
+    yadej::SegmentedVector<int, 16> vec;
+    for(int i=0; i < 100; ++i)
+        vec.push_back(99 - i);
+    EXPECT_EQ(vec.end() - vec.begin(), 100);
+    EXPECT_EQ(*(vec.begin() + 17), 82);
+    EXPECT_EQ(vec.begin()[40], 59);
+
+    std::sort(vec.begin(), vec.end());
+    EXPECT_TRUE(std::is_sorted(vec.begin(), vec.end()));
+    EXPECT_EQ(vec[0], 0);
+    EXPECT_EQ(*std::lower_bound(vec.cbegin(), vec.cend(), 42), 42);
+
+    const auto& const_vec = vec;
+    EXPECT_EQ(std::accumulate(const_vec.begin(), const_vec.end(), 0), 4950);
+}
+
+TEST(ChunksSegmentedVector, TestSpans)
+{
+    yadej::SegmentedVector<int, 16> vec(40, 1);
+    ASSERT_EQ(vec.chunk_count(), 3);
+    EXPECT_EQ(vec.chunk(0).size(), 16);
+    EXPECT_EQ(vec.chunk(2).size(), 8);
+    EXPECT_EQ(vec.chunk(1).data(), &vec[16]);
+
+    int sum = 0;
+    for(std::size_t i=0; i < vec.chunk_count(); ++i)
+        for(int value : vec.chunk(i))
+            sum += value;
+    EXPECT_EQ(sum, 40);
+}
+
+
+int main(int argc, char **argv)
+{
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -0,0 +1,148 @@
+#include "exerciceCPP/io/Serialization.hpp"
+#include <gtest/gtest.h>
+#include "TempFile.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <span>
+#include <stdexcept>
+#include <string>
+
+static std::span<const std::byte> bytes_of(const std::string& text){
+    return std::as_bytes(std::span<const char>(text.data(), text.size()));
+}
+
+TEST(ChecksumSerialization, TestKnownValues)
+{
+    // XXH64 with seed 0
+    EXPECT_EQ(yadej::io::checksum(bytes_of("")), 0xEF46DB3751D8E999ull);
+    EXPECT_EQ(yadej::io::checksum(bytes_of("abc")), 0x44BC2CF5AD770999ull);
+    const std::string text = "Nobody inspects the spammish repetition";
+    EXPECT_EQ(yadej::io::checksum(bytes_of(text)), 0xFBCEA83C8A378BF1ull);
+
+    // Same digest whatever the pieces
+    std::string long_text;
+    for(int i=0; i < 100; ++i)
+        long_text += std::to_string(i * i);
+    const std::uint64_t whole = yadej::io::checksum(bytes_of(long_text));
+    for(std::size_t piece=1; piece < 70; piece += 3){
+        yadej::io::Checksum sum;
+        for(std::size_t first=0; first < long_text.size(); first += piece)
+            sum.update(bytes_of(long_text.substr(first, piece)));
+        ASSERT_EQ(sum.digest(), whole);
+    }
+}
+
+TEST(BufferSerialization, TestRoundTrip)
+{
+    yadej::Vector<Sample> samples;
+    for(std::uint64_t i=0; i < 1000; ++i)
+        samples.push_back({i, static_cast<double>(i) / 2});
+    yadej::io::BufferWriter out;
+    yadej::io::serialize(samples, out);
+    EXPECT_EQ(out.position(), yadej::io::header_size + 1000 * sizeof(Sample));
+
+    // The Vector of bytes comes from operator new, aligned for Sample
+    const yadej::Vector<std::byte> buffer = out.take();
+    const std::span<const std::byte> bytes(buffer.data(), buffer.size());
+    const yadej::io::VectorView<Sample> view(bytes);
+    ASSERT_EQ(view.size(), 1000);
+    EXPECT_EQ(static_cast<const void*>(view.data()), static_cast<const void*>(buffer.data() + yadej::io::header_size));
+    EXPECT_EQ(view[999].timestamp, 999);
+    EXPECT_EQ(view.back().value, 499.5);
+    EXPECT_TRUE(view.verify());
+    EXPECT_THROW(static_cast<void>(view.at(1000)), std::out_of_range);
+    std::uint64_t sum = 0;
+    for(const Sample& sample : view)
+        sum += sample.timestamp;
+    EXPECT_EQ(sum, 999 * 1000 / 2);
+
+    const yadej::Vector<Sample> copy = yadej::io::deserialize<Sample>(bytes);
+    ASSERT_EQ(copy.size(), 1000);
+    EXPECT_EQ(copy[10].timestamp, 10);
+
+    // Wrong element type, truncated buffer, damaged payload, bad magic
+    EXPECT_THROW(yadej::io::VectorView<std::uint32_t>{bytes}, std::invalid_argument);
+    EXPECT_THROW(yadej::io::VectorView<Sample>{bytes.first(bytes.size() - 1)}, std::length_error);
+    yadej::Vector<std::byte> damaged = buffer;
+    damaged[yadej::io::header_size + 5] ^= std::byte{1};
+    const std::span<const std::byte> damaged_bytes(damaged.data(), damaged.size());
+    EXPECT_FALSE(yadej::io::VectorView<Sample>(damaged_bytes).verify());
+    EXPECT_THROW(yadej::io::deserialize<Sample>(damaged_bytes), std::runtime_error);
+    damaged[0] = std::byte{'X'};
+    EXPECT_THROW(yadej::io::VectorView<Sample>{damaged_bytes}, std::invalid_argument);
+}
+
+TEST(BufferSerialization, TestEmptyAndUnaligned)
+{
+    yadej::io::BufferWriter out;
+    yadej::io::serialize(yadej::Vector<int>(), out);
+    const yadej::io::VectorView<int> empty(out.bytes());
+    EXPECT_TRUE(empty.empty());
+    EXPECT_TRUE(empty.verify());
+
+    // An empty payload aligned past the end of the buffer
+    yadej::Vector<std::byte> padded(out.bytes().begin(), out.bytes().end());
+    yadej::io::store_little(padded.data() + 32, 4096, 8);
+    EXPECT_THROW(yadej::io::VectorView<int>(std::span<const std::byte>(padded.data(), padded.size())), std::length_error);
+
+    yadej::io::BufferWriter values;
+    yadej::io::serialize(yadej::Vector<std::uint64_t>{1, 2, 3}, values);
+    // One byte off: no view, a copy still works
+    yadej::Vector<std::byte> shifted(values.bytes().size() + 1, std::byte{0});
+    std::memcpy(shifted.data() + 1, values.bytes().data(), values.bytes().size());
+    const std::span<const std::byte> unaligned(shifted.data() + 1, values.bytes().size());
+    EXPECT_THROW(yadej::io::VectorView<std::uint64_t>{unaligned}, std::invalid_argument);
+    const yadej::Vector<std::uint64_t> copy = yadej::io::deserialize<std::uint64_t>(unaligned);
+    ASSERT_EQ(copy.size(), 3);
+    EXPECT_EQ(copy[2], 3);
+}
+
+class SerializationFile : public TempFileTest {};
+
+TEST_F(SerializationFile, TestStreamingWriterAndMappedView)
+{
+    {
+        yadej::io::FileWriter file(m_path);
+        yadej::io::VectorWriter<Sample, yadej::io::FileWriter> writer(file);
+        yadej::Vector<Sample> block;
+        for(std::uint64_t round=0; round < 10; ++round){
+            block.clear();
+            for(std::uint64_t i=0; i < 777; ++i)
+                block.push_back({round * 777 + i, 1.0});
+            writer.append(std::span<const Sample>(block.data(), block.size()));
+        }
+        writer.push_back({7770, 2.0});
+        writer.finish();
+        EXPECT_THROW(writer.push_back({0, 0.0}), std::logic_error);
+    }
+    EXPECT_EQ(std::filesystem::file_size(m_path), yadej::io::header_size + 7771 * sizeof(Sample));
+
+    const yadej::io::MappedFile file(m_path, yadej::MapAdvice::sequential);
+    const yadej::io::VectorView<Sample> view(file.bytes());
+    ASSERT_EQ(view.size(), 7771);
+    EXPECT_TRUE(view.verify());
+    for(std::uint64_t i=0; i < view.size(); ++i)
+        ASSERT_EQ(view[i].timestamp, i);
+    EXPECT_EQ(view.back().value, 2.0);
+}
+
+TEST_F(SerializationFile, TestUnfinishedWriter)
+{
+    {
+        yadej::io::FileWriter file(m_path);
+        yadej::io::VectorWriter<int, yadej::io::FileWriter> writer(file);
+        writer.push_back(1);
+    }
+    const yadej::io::MappedFile file(m_path);
+    EXPECT_THROW(yadej::io::VectorView<int>{file.bytes()}, std::invalid_argument);
+    EXPECT_THROW(yadej::io::MappedFile(m_path / "missing"), std::system_error);
+}
+
+
+int main(int argc, char **argv)
+{
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -0,0 +1,167 @@
+#include "exerciceCPP/simd/Kernels.hpp"
+#include "exerciceCPP/containers/Vector.hpp"
+#include <gtest/gtest.h>
+#include <cstdint>
+#include <cstddef>
+#include <limits>
+#include <span>
+#include <stdexcept>
+
+// Sizes around the register widths, to go through the vector loops and
+// the scalar tails of every instruction set
+constexpr std::size_t sizes[] = {0, 1, 3, 4, 7, 8, 15, 16, 17, 31, 33, 64, 100, 1023};
+
+template<class T>
+yadej::simd::AlignedBuffer<T> make_values(std::size_t count, std::uint64_t seed){
+    yadej::simd::AlignedBuffer<T> values;
+    values.resize_for_overwrite(count);
+    std::uint64_t state = seed;
+    for(T& value : values){
+        state = state * 6364136223846793005ULL + 1442695040888963407ULL;
+        // Small integers, float sums stay exact whatever the order
+        value = static_cast<T>(state >> 58);
+    }
+    return values;
+}
+
+// Run the test body once per instruction set of the CPU
+template<class Body>
+void for_each_isa(Body body){
+    const yadej::simd::Isa supported = yadej::simd::supported_isa();
+    for(int isa = 0; isa <= static_cast<int>(supported); ++isa){
+        SCOPED_TRACE(isa);
+        EXPECT_EQ(yadej::simd::set_isa(static_cast<yadej::simd::Isa>(isa)), static_cast<yadej::simd::Isa>(isa));
+        body();
+    }
+    yadej::simd::set_isa(supported);
+}
+
+template<class T>
+class KernelsSimd : public ::testing::Test {};
+
+using ElementTypes = ::testing::Types<float, double, std::int32_t, std::uint32_t, std::int64_t, std::uint64_t>;
+TYPED_TEST_SUITE(KernelsSimd, ElementTypes);
+
+TYPED_TEST(KernelsSimd, TestReductions)
+{
+    using T = TypeParam;
+    for_each_isa([]{
+        for(std::size_t size : sizes){
+            SCOPED_TRACE(size);
+            const yadej::simd::AlignedBuffer<T> l_values = make_values<T>(size, 1);
+            const yadej::simd::AlignedBuffer<T> r_values = make_values<T>(size, 2);
+            T sum = 0, dot = 0;
+            for(std::size_t i=0; i < size; ++i){
+                sum += l_values[i];
+                dot += l_values[i] * r_values[i];
+            }
+            EXPECT_EQ(yadej::simd::sum(l_values), sum);
+            EXPECT_EQ(yadej::simd::dot(l_values, r_values), dot);
+            if( size == 0){
+                EXPECT_THROW(yadej::simd::min(l_values), std::out_of_range);
+                continue;
+            }
+            T min = l_values[0], max = l_values[0];
+            for(std::size_t i=0; i < size; ++i){
+                min = l_values[i] < min ? l_values[i] : min;
+                max = l_values[i] > max ? l_values[i] : max;
+            }
+            EXPECT_EQ(yadej::simd::min(l_values), min);
+            EXPECT_EQ(yadej::simd::max(l_values), max);
+        }
+    });
+}
+
+TYPED_TEST(KernelsSimd, TestFindCount)
+{
+    using T = TypeParam;
+    for_each_isa([]{
+        for(std::size_t size : sizes){
+            SCOPED_TRACE(size);
+            yadej::simd::AlignedBuffer<T> values = make_values<T>(size, 3);
+            for(T needle : {T(0), T(7), T(63), T(100)}){
+                std::size_t first = size, count = 0;
+                for(std::size_t i=0; i < size; ++i){
+                    if( values[i] == needle){
+                        first = first == size ? i : first;
+                        ++count;
+                    }
+                }
+                EXPECT_EQ(yadej::simd::find(values, needle), first);
+                EXPECT_EQ(yadej::simd::count(values, needle), count);
+            }
+            if( size != 0){
+                values[size - 1] = T(100);
+                EXPECT_EQ(yadej::simd::find(values, T(100)), size - 1);
+                EXPECT_EQ(yadej::simd::count(values, T(100)), 1);
+            }
+        }
+    });
+}
+
+TYPED_TEST(KernelsSimd, TestElementWise)
+{
+    using T = TypeParam;
+    for_each_isa([]{
+        for(std::size_t size : sizes){
+            SCOPED_TRACE(size);
+            const yadej::simd::AlignedBuffer<T> a = make_values<T>(size, 4);
+            const yadej::simd::AlignedBuffer<T> b = make_values<T>(size, 5);
+            const yadej::simd::AlignedBuffer<T> c = make_values<T>(size, 6);
+            yadej::simd::AlignedBuffer<T> out(size);
+
+            yadej::simd::add(a, b, out);
+            for(std::size_t i=0; i < size; ++i)
+                EXPECT_EQ(out[i], T(a[i] + b[i]));
+            yadej::simd::mul(a, b, out);
+            for(std::size_t i=0; i < size; ++i)
+                EXPECT_EQ(out[i], T(a[i] * b[i]));
+            yadej::simd::fma(a, b, c, out);
+            for(std::size_t i=0; i < size; ++i)
+                EXPECT_EQ(out[i], T(a[i] * b[i] + c[i]));
+            // In place
+            yadej::simd::add(out, a, out);
+            for(std::size_t i=0; i < size; ++i)
+                EXPECT_EQ(out[i], T(a[i] * b[i] + c[i] + a[i]));
+
+            yadej::simd::fill(out, T(9));
+            EXPECT_EQ(yadej::simd::count(out, T(9)), size);
+        }
+    });
+}
+
+TEST(AlignmentSimd, TestVectorData)
+{
+    yadej::simd::AlignedBuffer<float> values;
+    for(int i=0; i < 1000; ++i){
+        values.push_back(static_cast<float>(i));
+        EXPECT_EQ(reinterpret_cast<std::uintptr_t>(values.data()) % yadej::simd::max_alignment, 0);
+    }
+    EXPECT_EQ(yadej::simd::sum(values), 499500.0F);
+}
+
+TEST(RangesSimd, TestPointersAndSpans)
+{
+    yadej::Vector<std::int32_t> values = {5, -3, 8, 1, -9, 4, 2, 7, 0};
+    EXPECT_EQ(yadej::simd::sum(values.data(), values.size()), 15);
+    EXPECT_EQ(yadej::simd::min(std::span<const std::int32_t>(values.data(), values.size())), -9);
+    EXPECT_EQ(yadej::simd::max(values.data() + 3, 3), 4);
+    EXPECT_EQ(yadej::simd::find(values, 42), values.size());
+
+    yadej::Vector<std::int32_t> shorter(3);
+    EXPECT_THROW(yadej::simd::add(values, values, shorter), std::length_error);
+    EXPECT_THROW(yadej::simd::dot(values, shorter), std::length_error);
+
+    // Lanes of a float count are 32 bits wide, every kernel returns a size_t
+    yadej::simd::AlignedBuffer<float> zeros(100000, 0.0F);
+    EXPECT_EQ(yadej::simd::count(zeros, 0.0F), 100000);
+    EXPECT_EQ(yadej::simd::find(zeros, -0.0F), 0);
+    EXPECT_EQ(yadej::simd::find(zeros, std::numeric_limits<float>::quiet_NaN()), zeros.size());
+}
+
+
+int main(int argc, char **argv)
+{
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -0,0 +1,173 @@
+#include "exerciceCPP/containers/SmallVector.hpp"
+#include <gtest/gtest.h>
+#include "InsertRollback.hpp"
+#include "TaggedAllocator.hpp"
+#include <cstddef>
+#include <iterator>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <utility>
+
+// Allocator counting the calls to allocate, to check the inline storage is used
+template<class T>
+struct CountingAllocator {
+    using value_type = T;
+    inline static std::size_t allocations = 0;
+
+    CountingAllocator() = default;
+    template<class U>
+    CountingAllocator(const CountingAllocator<U>&){}
+
+    T* allocate(std::size_t n){
+        ++allocations;
+        return std::allocator<T>().allocate(n);
+    }
+    void deallocate(T* p, std::size_t n){
+        std::allocator<T>().deallocate(p, n);
+    }
+    friend bool operator==(const CountingAllocator&, const CountingAllocator&){ return true; }
+};
+
+TEST(ConstructorsSmallVector, CheckValues)
+{
+    yadej::SmallVector<int, 4> vec;
+    EXPECT_TRUE(vec.empty());
+    EXPECT_TRUE(vec.is_inline());
+    EXPECT_EQ(vec.capacity(), 4);
+
+    yadej::SmallVector<int, 4> init = {1, 2, 3};
+    ASSERT_EQ(init.size(), 3);
+    EXPECT_EQ(init[2], 3);
+    EXPECT_TRUE(init.is_inline());
+
+    yadej::SmallVector<int, 4> count(6, 7);
+    ASSERT_EQ(count.size(), 6);
+    EXPECT_EQ(count[5], 7);
+    EXPECT_FALSE(count.is_inline());
+
+    yadej::SmallVector<int, 4> copy(count);
+    EXPECT_EQ(copy.size(), 6);
+    EXPECT_EQ(copy[0], 7);
+
+    yadej::SmallVector<int, 4> moved(std::move(copy));
+    EXPECT_EQ(moved.size(), 6);
+    EXPECT_TRUE(copy.empty());
+    EXPECT_TRUE(copy.is_inline());
+
+    yadej::SmallVector<std::string, 4> strings = {"a", "b"};
+    yadej::SmallVector<std::string, 4> moved_strings(std::move(strings));
+    EXPECT_EQ(moved_strings[1], "b");
+    EXPECT_TRUE(moved_strings.is_inline());
+    strings = moved_strings;
+    EXPECT_EQ(strings[0], "a");
+}
+
+TEST(SpillSmallVector, TestAllocations)
+{
+    using Small = yadej::SmallVector<int, 8, CountingAllocator<int>>;
+    CountingAllocator<int>::allocations = 0;
+    Small vec;
+    for(int i=0; i < 8; ++i)
+        vec.push_back(i);
+    EXPECT_EQ(CountingAllocator<int>::allocations, 0);
+    EXPECT_TRUE(vec.is_inline());
+
+    vec.push_back(8);
+    EXPECT_EQ(CountingAllocator<int>::allocations, 1);
+    EXPECT_FALSE(vec.is_inline());
+    EXPECT_EQ(vec.capacity(), 16);
+    for(int i=0; i < 9; ++i)
+        EXPECT_EQ(vec[i], i);
+
+    vec.resize(3);
+    vec.shrink_to_fit();
+    EXPECT_TRUE(vec.is_inline());
+    EXPECT_EQ(vec[2], 2);
+
+    vec.resize(20);
+    vec.clear();
+    EXPECT_TRUE(vec.is_inline());
+    EXPECT_EQ(vec.capacity(), 8);
+}
+
+TEST(InsertEraseSmallVector, TestPosition)
+{
+    yadej::SmallVector<std::string, 4> vec = {"a", "d"};
+    vec.insert(vec.begin() + 1, "b");
+    vec.emplace(vec.begin() + 2, 1, 'c');
+    EXPECT_TRUE(vec.is_inline());
+    vec.insert(vec.end(), 2, "e");
+    EXPECT_FALSE(vec.is_inline());
+    ASSERT_EQ(vec.size(), 6);
+    EXPECT_EQ(vec[0], "a");
+    EXPECT_EQ(vec[2], "c");
+    EXPECT_EQ(vec[3], "d");
+    EXPECT_EQ(vec[5], "e");
+
+    vec.erase(vec.begin());
+    vec.erase(vec.begin() + 2, vec.end());
+    ASSERT_EQ(vec.size(), 2);
+    EXPECT_EQ(vec.front(), "b");
+    EXPECT_EQ(vec.back(), "c");
+
+    yadej::SmallVector<std::string, 4> other = {"x", "y"};
+    vec.insert(vec.begin() + 1, other.begin(), other.end());
+    EXPECT_EQ(vec[1], "x");
+    EXPECT_EQ(vec[3], "c");
+    EXPECT_THROW(vec.at(4), std::out_of_range);
+}
+
+
+TEST(AllocatorSmallVector, TestPropagation)
+{
+    using Tagged = yadej::SmallVector<std::string, 2, TaggedAllocator<std::string>>;
+    Tagged first({"a", "b", "c"}, TaggedAllocator<std::string>(1));
+    Tagged copy(first);
+    EXPECT_EQ(copy.get_allocator().id, 101);
+    EXPECT_EQ(copy[2], "c");
+
+    Tagged second({"d"}, TaggedAllocator<std::string>(2));
+    copy = second;
+    EXPECT_EQ(copy.get_allocator().id, 2);
+    copy = std::move(first);
+    EXPECT_EQ(copy.get_allocator().id, 1);
+    ASSERT_EQ(copy.size(), 3);
+    EXPECT_EQ(first.size(), 0);
+
+    // A heap buffer of another allocator is moved element by element
+    Tagged other(std::move(copy), TaggedAllocator<std::string>(3));
+    EXPECT_EQ(other.get_allocator().id, 3);
+    ASSERT_EQ(other.size(), 3);
+    EXPECT_EQ(other[0], "a");
+    Tagged same(std::move(other), TaggedAllocator<std::string>(3));
+    EXPECT_EQ(same[2], "c");
+    EXPECT_EQ(other.size(), 0);
+}
+
+TEST(MoveSmallVector, TestNoexcept)
+{
+    static_assert(std::is_nothrow_move_constructible_v<yadej::SmallVector<std::string, 4>>);
+    static_assert(std::is_nothrow_move_assignable_v<yadej::SmallVector<std::string, 4>>);
+    static_assert(!std::is_nothrow_move_constructible_v<yadej::SmallVector<Fragile, 4>>);
+
+    // Growing the outer Vector moves the inner heap buffers instead of copying them
+    yadej::Vector<yadej::SmallVector<std::string, 2>> outer;
+    outer.push_back({"a", "b", "c"});
+    const std::string* spilled = outer[0].data();
+    for(int i=0; i < 20; ++i)
+        outer.push_back({"d"});
+    EXPECT_EQ(outer[0].data(), spilled);
+    EXPECT_EQ(outer[0][2], "c");
+}
+
+// Spilling to the heap past 8 elements, or inserting in place
+using InsertRollbackSmallVector = ::testing::Types<yadej::SmallVector<Fragile, 8>, yadej::SmallVector<Fragile, 16>>;
+INSTANTIATE_TYPED_TEST_SUITE_P(SmallVector, InsertRollback, InsertRollbackSmallVector);
+
+int main(int argc, char **argv)
+{
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
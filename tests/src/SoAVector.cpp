@@ -0,0 +1,124 @@
+#include "exerciceCPP/containers/SoAVector.hpp"
+#include <gtest/gtest.h>
+#include <cstdint>
+#include <numeric>
+#include <stdexcept>
+#include <string>
+#include <tuple>
+
+using Records = yadej::SoAVector<int, double, std::string>;
+
+TEST(ConstructorsSoAVector, CheckValues)
+{
+    Records empty;
+    EXPECT_TRUE(empty.empty());
+    EXPECT_EQ(empty.capacity(), 0);
+
+    Records count(3, {7, 1.5, "x"});
+    ASSERT_EQ(count.size(), 3);
+    EXPECT_EQ(std::get<2>(count[2]), "x");
+
+    Records records = {{1, 1.0, "one"}, {2, 2.0, "two"}};
+    Records copy(records);
+    EXPECT_EQ(std::get<0>(copy.back()), 2);
+    Records moved(std::move(copy));
+    EXPECT_EQ(std::get<2>(moved.front()), "one");
+    EXPECT_TRUE(copy.empty());
+    copy = moved;
+    EXPECT_EQ(copy.size(), 2);
+    EXPECT_THROW(copy.at(2), std::out_of_range);
+}
+
+TEST(ColumnsSoAVector, TestAlignedSpans)
+{
+    yadej::SoAVector<std::uint8_t, double, int> vec;
+    for(int i=0; i < 100; ++i)
+        vec.emplace_back(static_cast<std::uint8_t>(i), i * 0.5, i);
+
+    auto ids = vec.column<2>();
+    ASSERT_EQ(ids.size(), 100);
+    EXPECT_EQ(std::accumulate(ids.begin(), ids.end(), 0), 4950);
+    for(double& value : vec.column<1>())
+        value *= 2;
+    EXPECT_DOUBLE_EQ(std::get<1>(vec[10]), 10.0);
+
+    // Every column starts on its own cache line
+    EXPECT_EQ(reinterpret_cast<std::uintptr_t>(vec.data<0>()) % Records::column_alignment, 0);
+    EXPECT_EQ(reinterpret_cast<std::uintptr_t>(vec.data<1>()) % Records::column_alignment, 0);
+    EXPECT_EQ(reinterpret_cast<std::uintptr_t>(vec.data<2>()) % Records::column_alignment, 0);
+}
+
+TEST(InsertEraseSoAVector, TestAllColumns)
+{
+    Records vec = {{1, 1.0, "a"}, {4, 4.0, "d"}};
+    vec.insert(vec.cbegin() + 1, {2, 2.0, "b"});
+    vec.emplace(vec.cbegin() + 2, 3, 3.0, "c");
+    vec.insert(vec.cend(), 2, {5, 5.0, "e"});
+    ASSERT_EQ(vec.size(), 6);
+    for(int i=0; i < 5; ++i)
+        EXPECT_EQ(vec.column<0>()[i], i + 1);
+    EXPECT_EQ(vec.column<2>()[2], "c");
+    EXPECT_EQ(vec.column<2>()[5], "e");
+
+    vec.erase(vec.cbegin());
+    vec.erase(vec.cbegin() + 2, vec.cend());
+    // Out of the container, nothing is erased as for Vector
+    vec.erase(vec.cend());
+    vec.erase(vec.cbegin() + 1, vec.cend() + 1);
+    ASSERT_EQ(vec.size(), 2);
+    EXPECT_EQ(vec.column<2>()[0], "b");
+    EXPECT_DOUBLE_EQ(vec.column<1>()[1], 3.0);
+
+    vec.resize(4);
+    EXPECT_EQ(std::get<2>(vec[3]), "");
+    vec.resize(1);
+    vec.pop_back();
+    EXPECT_TRUE(vec.empty());
+    EXPECT_THROW(vec.insert(vec.cend() + 1, {0, 0.0, ""}), std::invalid_argument);
+}
+
+TEST(IteratorSoAVector, TestRowProxy)
+{
+    Records vec = {{1, 1.0, "a"}, {2, 2.0, "b"}, {3, 3.0, "c"}};
+    int sum = 0;
+    for(auto [id, value, name] : vec){
+        sum += id;
+        name += "!";
+    }
+    EXPECT_EQ(sum, 6);
+    EXPECT_EQ(vec.column<2>()[1], "b!");
+    EXPECT_EQ(vec.end() - vec.begin(), 3);
+    EXPECT_EQ(std::get<0>(vec.begin()[2]), 3);
+
+    const Records& const_vec = vec;
+    EXPECT_EQ(std::get<2>(*const_vec.begin()), "a!");
+}
+
+struct ThrowingField {
+    ThrowingField() = default;
+    ThrowingField(const ThrowingField& other): value(other.value){
+        if( value < 0)
+            throw std::invalid_argument("negative");
+    }
+    ThrowingField(ThrowingField&&) noexcept = default;
+    int value{0};
+};
+
+TEST(ExceptionSoAVector, TestRowRollback)
+{
+    yadej::SoAVector<std::string, ThrowingField> vec;
+    vec.emplace_back("first", ThrowingField{});
+    vec.reserve(4);
+    ThrowingField bad;
+    bad.value = -1;
+    EXPECT_THROW(vec.insert(vec.cbegin(), {"never", bad}), std::invalid_argument);
+    ASSERT_EQ(vec.size(), 1);
+    EXPECT_EQ(vec.column<0>()[0], "first");
+}
+
+
+int main(int argc, char **argv)
+{
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -1,6 +1,18 @@
 #include "exerciceCPP/containers/Vector.hpp"
 #include <gtest/gtest.h>
+#include "InsertRollback.hpp"
+#include "TaggedAllocator.hpp"
+#include <algorithm>
+#include <cstddef>
 #include <initializer_list>
+#include <iterator>
+#include <list>
+#include <memory_resource>
+#include <ranges>
+#include <span>
+#include <sstream>
+#include <stdexcept>
+#include <string>
 
 TEST(ConstrutorsVector, CheckValues)
 {
@@ -93,6 +105,250 @@ TEST(SizeTestVector, TestSize)
    
 }
 
+// Not trivially copyable but safe to memmove
+struct RelocatableHandle {
+    int value;
+    RelocatableHandle(int v): value(v){}
+    RelocatableHandle(const RelocatableHandle& other): value(other.value){}
+};
+
+template<>
+struct yadej::is_trivially_relocatable<RelocatableHandle> : std::true_type {};
+
+TEST(RelocationVector, TestTrivialAndNonTrivial)
+{
+    static_assert(yadej::is_trivially_relocatable_v<int>);
+    static_assert(!yadej::is_trivially_relocatable_v<std::string>);
+    static_assert(yadej::is_trivially_relocatable_v<RelocatableHandle>);
+
+    yadej::Vector<std::string> strings;
+    for(int i=0; i < 100; ++i)
+        strings.push_back(std::to_string(i));
+    strings.insert(strings.begin() + 10, "inserted");
+    strings.erase(strings.begin(), strings.begin() + 5);
+    EXPECT_EQ(strings.size(), 96);
+    EXPECT_EQ(strings[5], "inserted");
+    EXPECT_EQ(strings[6], "10");
+    EXPECT_EQ(strings.back(), "99");
+
+    yadej::Vector<RelocatableHandle> handles;
+    for(int i=0; i < 100; ++i)
+        handles.emplace_back(i);
+    handles.insert(handles.begin() + 1, 3, RelocatableHandle(-1));
+    EXPECT_EQ(handles[0].value, 0);
+    EXPECT_EQ(handles[3].value, -1);
+    EXPECT_EQ(handles[4].value, 1);
+    EXPECT_EQ(handles[102].value, 99);
+
+    // push_back of an element of the same vector while it grows
+    yadej::Vector<std::string> self = {"a", "b"};
+    self.push_back(self[0]);
+    self.push_back(self[1]);
+    EXPECT_EQ(self[2], "a");
+    EXPECT_EQ(self[3], "b");
+}
+
+TEST(GrowthPolicyVector, TestCapacity)
+{
+    yadej::Vector<int> doubling(5, 0);
+    EXPECT_EQ(doubling.capacity(), 8);
+    for(int i=0; i < 4; ++i)
+        doubling.push_back(i);
+    EXPECT_EQ(doubling.capacity(), 16);
+
+    yadej::Vector<int, std::allocator<int>, yadej::growth::OneAndHalf> half(5, 0);
+    EXPECT_EQ(half.capacity(), 5);
+    half.push_back(1);
+    EXPECT_EQ(half.capacity(), 7);
+    half.insert(half.begin(), 2, 3);
+    EXPECT_EQ(half.capacity(), 10);
+
+    yadej::Vector<int, std::allocator<int>, yadej::growth::FixedIncrement<100>> fixed;
+    fixed.push_back(1);
+    EXPECT_EQ(fixed.capacity(), 100);
+    fixed.resize(101);
+    EXPECT_EQ(fixed.capacity(), 200);
+
+    // Under a page the inner policy is used as is
+    yadej::Vector<int, std::allocator<int>, yadej::growth::PageAligned<>> paged(1000);
+    EXPECT_EQ(paged.capacity(), 1000);
+    paged.resize(1100);
+    EXPECT_EQ(paged.capacity(), 2048);
+    EXPECT_EQ(paged[1099], 0);
+}
+
+TEST(AllocatorVector, TestPropagation)
+{
+    using Tagged = yadej::Vector<std::string, TaggedAllocator<std::string>>;
+    Tagged first({"a", "b"}, TaggedAllocator<std::string>(1));
+    Tagged copy(first);
+    EXPECT_EQ(copy.get_allocator().id, 101);
+    EXPECT_EQ(copy[1], "b");
+
+    Tagged second({"c"}, TaggedAllocator<std::string>(2));
+    copy = second;
+    EXPECT_EQ(copy.get_allocator().id, 2);
+    copy = std::move(first);
+    EXPECT_EQ(copy.get_allocator().id, 1);
+    EXPECT_EQ(copy.size(), 2);
+    EXPECT_EQ(first.size(), 0);
+
+    swap(copy, second);
+    EXPECT_EQ(copy.get_allocator().id, 2);
+    EXPECT_EQ(second.get_allocator().id, 1);
+    EXPECT_EQ(second[0], "a");
+    EXPECT_EQ(copy[0], "c");
+}
+
+TEST(AllocatorVector, TestPmr)
+{
+    std::pmr::monotonic_buffer_resource left;
+    std::pmr::monotonic_buffer_resource right;
+    yadej::pmr::Vector<std::string> vec(&left);
+    vec.push_back("first string long enough to allocate");
+    vec.push_back("second");
+
+    // polymorphic_allocator never propagates, the copy takes the default resource
+    yadej::pmr::Vector<std::string> copy(vec);
+    EXPECT_EQ(copy.get_allocator().resource(), std::pmr::get_default_resource());
+
+    yadej::pmr::Vector<std::string> other(&right);
+    other = std::move(vec);
+    EXPECT_EQ(other.get_allocator().resource(), &right);
+    ASSERT_EQ(other.size(), 2);
+    EXPECT_EQ(other[0], "first string long enough to allocate");
+    EXPECT_EQ(other[1], "second");
+
+    yadej::pmr::Vector<std::string> same(&right);
+    const std::string* data = other.data();
+    same = std::move(other);
+    EXPECT_EQ(same.data(), data);
+    EXPECT_EQ(other.size(), 0);
+}
+
+TEST(OverwriteVector, TestResizeForOverwrite)
+{
+    yadej::Vector<int> vec = {1, 2};
+    vec.resize_for_overwrite(100);
+    ASSERT_EQ(vec.size(), 100);
+    EXPECT_EQ(vec[1], 2);
+    for(int i=2; i < 100; ++i)
+        vec[i] = i;
+    EXPECT_EQ(vec.back(), 99);
+    vec.resize_for_overwrite(10);
+    EXPECT_EQ(vec.size(), 10);
+
+    // Class types still get their default constructor
+    yadej::Vector<std::string> strings;
+    strings.resize_for_overwrite(3);
+    EXPECT_EQ(strings[2], "");
+}
+
+TEST(OverwriteVector, TestResizeAndOverwrite)
+{
+    const std::string message = "received bytes";
+    yadej::Vector<char> buffer = {'>', ' '};
+    // Receive at most 64 bytes after the current content
+    buffer.resize_and_overwrite(buffer.size() + 64, [&](std::span<char> raw){
+        EXPECT_EQ(raw.size(), 66);
+        std::copy(message.begin(), message.end(), raw.begin() + 2);
+        return 2 + message.size();
+    });
+    ASSERT_EQ(buffer.size(), 16);
+    EXPECT_EQ(std::string(buffer.begin(), buffer.end()), "> received bytes");
+    EXPECT_GE(buffer.capacity(), 66);
+
+    buffer.resize_and_overwrite(4, [](std::span<char> raw){
+        raw[0] = '<';
+        return raw.size();
+    });
+    EXPECT_EQ(std::string(buffer.begin(), buffer.end()), "< re");
+
+    EXPECT_THROW(buffer.resize_and_overwrite(8, [](std::span<char>) -> std::size_t {
+        throw std::runtime_error("read failed");
+    }), std::runtime_error);
+    EXPECT_EQ(buffer.size(), 4);
+    EXPECT_THROW(buffer.resize_and_overwrite(8, [](std::span<char>){ return 9; }), std::length_error);
+    EXPECT_EQ(buffer.size(), 4);
+}
+
+static_assert(std::contiguous_iterator<yadej::Vector<int>::iterator>);
+static_assert(std::ranges::contiguous_range<yadej::Vector<int>>);
+
+TEST(RangeVector, TestRangeOperations)
+{
+    // Sized range, one allocation
+    yadej::Vector<int> vec(yadej::from_range, std::views::iota(0, 10));
+    ASSERT_EQ(vec.size(), 10);
+    EXPECT_EQ(vec[9], 9);
+
+    std::list<int> list = {100, 101};
+    vec.reserve(20);
+    const int* data = vec.data();
+    vec.insert_range(vec.begin() + 1, list);
+    EXPECT_EQ(vec.data(), data);
+    EXPECT_EQ(vec[1], 100);
+    EXPECT_EQ(vec[3], 1);
+
+    const int raw[] = {7, 8, 9};
+    vec.append_range(raw);
+    ASSERT_EQ(vec.size(), 15);
+    EXPECT_EQ(vec.back(), 9);
+
+    vec.assign_range(std::views::iota(0, 3));
+    ASSERT_EQ(vec.size(), 3);
+    EXPECT_EQ(vec.data(), data);
+    vec.assign_range(std::views::iota(0, 100));
+    EXPECT_EQ(vec.size(), 100);
+    EXPECT_EQ(vec[99], 99);
+
+    // Single pass range, its size is unknown
+    std::istringstream input("4 5 6");
+    yadej::Vector<std::string> words = {"a", "b"};
+    words.insert_range(words.begin() + 1, std::views::istream<std::string>(input));
+    ASSERT_EQ(words.size(), 5);
+    EXPECT_EQ(words[1], "4");
+    EXPECT_EQ(words[4], "b");
+
+    // Vector is itself a contiguous range
+    yadej::Vector<int> copy(yadej::from_range, vec);
+    EXPECT_EQ(copy[50], 50);
+    EXPECT_THROW(copy.at(100), std::out_of_range);
+    EXPECT_EQ(std::span<const int>(copy).size(), 100);
+}
+
+TEST(StatsVector, TestCounters)
+{
+    using Plain = yadej::Vector<int, std::allocator<int>, yadej::growth::Doubling, yadej::stats::NoStats>;
+    static_assert(sizeof(Plain) <= 4 * sizeof(void*), "NoStats must not take any room");
+
+    using Counted = yadej::Vector<std::string, std::allocator<std::string>, yadej::growth::Doubling, yadej::stats::Counting>;
+    Counted vec;
+    vec.stats().set_label("test vector");
+    std::string value = "value";
+    for(int i=0; i < 5; ++i)
+        vec.push_back(value);
+    vec.push_back(std::move(value));
+
+    yadej::stats::Snapshot snapshot = vec.stats().snapshot();
+    EXPECT_EQ(snapshot.allocations, 4);
+    EXPECT_EQ(snapshot.capacity, 8);
+    EXPECT_EQ(snapshot.peak_capacity, 8);
+    EXPECT_EQ(snapshot.size, 6);
+    EXPECT_EQ(snapshot.wasted_capacity(), 2);
+    EXPECT_EQ(snapshot.copies, 5);
+    // 1 + 2 + 4 elements relocated by moves plus the moved value
+    EXPECT_EQ(snapshot.moves, 8);
+    EXPECT_EQ(snapshot.bytes_relocated, 7 * sizeof(std::string));
+
+    std::ostringstream dump;
+    yadej::stats::Registry::instance().dump(dump);
+    EXPECT_NE(dump.str().find("test vector allocations=4"), std::string::npos);
+}
+
+
+using InsertRollbackVector = ::testing::Types<yadej::Vector<Fragile>>;
+INSTANTIATE_TYPED_TEST_SUITE_P(Vector, InsertRollback, InsertRollbackVector);
 
 int main(int argc, char **argv)
 {